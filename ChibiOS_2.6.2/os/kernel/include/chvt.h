@@ -36,6 +36,16 @@
 #ifndef _CHVT_H_
 #define _CHVT_H_
 
+/**
+ * @brief   Tickless mode.
+ * @details If enabled the port timer is programmed one-shot for the next
+ *          virtual timer deadline instead of interrupting every tick, see
+ *          @p CH_USE_TICKLESS in @p chconf.h.
+ */
+#if !defined(CH_USE_TICKLESS) || defined(__DOXYGEN__)
+#define CH_USE_TICKLESS                 FALSE
+#endif
+
 /**
  * @name    Time conversion utilities
  * @{
@@ -122,12 +132,17 @@ typedef struct {
                                                 list.                       */
   systime_t             vt_time;    /**< @brief Must be initialized to -1.  */
   volatile systime_t    vt_systime; /**< @brief System Time counter.        */
+#if CH_USE_TICKLESS || defined(__DOXYGEN__)
+  systime_t             vt_alarm;   /**< @brief System time the port timer
+                                                is programmed for.          */
+#endif
 } VTList;
 
 /**
  * @name    Macro Functions
  * @{
  */
+#if !CH_USE_TICKLESS || defined(__DOXYGEN__)
 /**
  * @brief   Virtual timers ticker.
  * @note    The system lock is released before entering the callback and
@@ -154,6 +169,7 @@ typedef struct {
     }                                                                       \
   }                                                                         \
 }
+#endif /* !CH_USE_TICKLESS */
 
 /**
  * @brief   Returns @p TRUE if the specified timer is armed.
@@ -208,12 +224,18 @@ typedef struct {
  *          invocation.
  * @note    The counter can reach its maximum and then restart from zero.
  * @note    This function is designed to work with the @p chThdSleepUntil().
+ * @note    In tickless mode the time is read from the port timer, the
+ *          virtual timers list may lag behind it until the next alarm.
  *
  * @return              The system time in ticks.
  *
  * @api
  */
+#if !CH_USE_TICKLESS || defined(__DOXYGEN__)
 #define chTimeNow() (vtlist.vt_systime)
+#else
+#define chTimeNow() port_tickless_now()
+#endif
 
 /**
  * @brief   Returns the elapsed time since the specified start time.
@@ -253,6 +275,10 @@ extern "C" {
   void _vt_init(void);
   void chVTSetI(VirtualTimer *vtp, systime_t time, vtfunc_t vtfunc, void *par);
   void chVTResetI(VirtualTimer *vtp);
+#if CH_USE_TICKLESS
+  systime_t chVTDoTicklessI(void);
+  void _vt_tickless_arm(systime_t limit);
+#endif
 #ifdef __cplusplus
 }
 #endif
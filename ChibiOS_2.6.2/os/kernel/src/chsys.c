@@ -131,13 +131,41 @@ void chSysInit(void) {
  * @note    The frequency of the timer determines the system tick granularity
  *          and, together with the @p CH_TIME_QUANTUM macro, the round robin
  *          interval.
+ * @note    In tickless mode the handler runs on the port timer alarm and
+ *          accounts for all the ticks elapsed since the previous call. The
+ *          alarm is limited to the remaining quantum only when another
+ *          thread is ready, a thread made ready by an interrupt other than
+ *          the timer is round robin scheduled from the next alarm onward.
  *
  * @iclass
  */
 void chSysTimerHandlerI(void) {
+#if CH_USE_TICKLESS
+  systime_t n, limit = (systime_t)-1;
+#endif
 
   chDbgCheckClassI();
 
+#if CH_USE_TICKLESS
+  n = chVTDoTicklessI();
+#if CH_TIME_QUANTUM > 0
+  /* Charge the elapsed ticks to the quantum of the running thread.*/
+  if (currp->p_preempt > n)
+    currp->p_preempt -= (tslices_t)n;
+  else
+    currp->p_preempt = 0;
+  /* Wake up again for the round robin only if there is a competitor.*/
+  if (firstprio(&rlist.r_queue) > IDLEPRIO)
+    limit = currp->p_preempt ? currp->p_preempt : CH_TIME_QUANTUM;
+#endif
+#if CH_DBG_THREADS_PROFILING
+  currp->p_time += n;
+#endif
+#if defined(SYSTEM_TICK_EVENT_HOOK)
+  SYSTEM_TICK_EVENT_HOOK();
+#endif
+  _vt_tickless_arm(limit);
+#else /* !CH_USE_TICKLESS */
 #if CH_TIME_QUANTUM > 0
   /* Running thread has not used up quantum yet? */
   if (currp->p_preempt > 0)
@@ -151,6 +179,7 @@ void chSysTimerHandlerI(void) {
 #if defined(SYSTEM_TICK_EVENT_HOOK)
   SYSTEM_TICK_EVENT_HOOK();
 #endif
+#endif /* !CH_USE_TICKLESS */
 }
 
 /** @} */
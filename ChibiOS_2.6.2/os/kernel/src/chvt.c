@@ -52,6 +52,10 @@ void _vt_init(void) {
   vtlist.vt_next = vtlist.vt_prev = (void *)&vtlist;
   vtlist.vt_time = (systime_t)-1;
   vtlist.vt_systime = 0;
+#if CH_USE_TICKLESS
+  vtlist.vt_alarm = port_tickless_max();
+  port_tickless_set(vtlist.vt_alarm);
+#endif
 }
 
 /**
@@ -80,6 +84,10 @@ void chVTSetI(VirtualTimer *vtp, systime_t time, vtfunc_t vtfunc, void *par) {
   chDbgCheck((vtp != NULL) && (vtfunc != NULL) && (time != TIME_IMMEDIATE),
              "chVTSetI");
 
+#if CH_USE_TICKLESS
+  /* The list is relative to the last processed time, not to now.*/
+  time += chTimeNow() - vtlist.vt_systime;
+#endif
   vtp->vt_par = par;
   vtp->vt_func = vtfunc;
   p = vtlist.vt_next;
@@ -93,6 +101,14 @@ void chVTSetI(VirtualTimer *vtp, systime_t time, vtfunc_t vtfunc, void *par) {
   vtp->vt_time = time;
   if (p != (void *)&vtlist)
     p->vt_time -= time;
+#if CH_USE_TICKLESS
+  /* New first timer due before the programmed alarm, bring it forward.*/
+  if ((vtlist.vt_next == vtp) &&
+      (time < (systime_t)(vtlist.vt_alarm - vtlist.vt_systime))) {
+    vtlist.vt_alarm = vtlist.vt_systime + time;
+    port_tickless_set(vtlist.vt_alarm);
+  }
+#endif
 }
 
 /**
@@ -118,4 +134,63 @@ void chVTResetI(VirtualTimer *vtp) {
   vtp->vt_func = (vtfunc_t)NULL;
 }
 
+#if CH_USE_TICKLESS || defined(__DOXYGEN__)
+/**
+ * @brief   Virtual timers handler for tickless mode.
+ * @details Brings the list up to the current port time, firing every
+ *          timer that expired since the last call. Replaces
+ *          @p chVTDoTickI() when @p CH_USE_TICKLESS is enabled.
+ * @note    The system lock is released around the callbacks, as in
+ *          @p chVTDoTickI().
+ *
+ * @return              The number of ticks elapsed since the last call.
+ *
+ * @iclass
+ */
+systime_t chVTDoTicklessI(void) {
+  systime_t now = port_tickless_now();
+  systime_t elapsed = now - vtlist.vt_systime;
+  VirtualTimer *vtp;
+
+  chDbgCheckClassI();
+
+  while (((vtp = vtlist.vt_next) != (void *)&vtlist) &&
+         ((systime_t)(now - vtlist.vt_systime) >= vtp->vt_time)) {
+    vtfunc_t fn = vtp->vt_func;
+    vtlist.vt_systime += vtp->vt_time;
+    vtp->vt_func = (vtfunc_t)NULL;
+    vtp->vt_next->vt_prev = (void *)&vtlist;
+    vtlist.vt_next = vtp->vt_next;
+    chSysUnlockFromIsr();
+    fn(vtp->vt_par);
+    chSysLockFromIsr();
+  }
+  if (vtlist.vt_next != (void *)&vtlist)
+    vtlist.vt_next->vt_time -= now - vtlist.vt_systime;
+  vtlist.vt_systime = now;
+  return elapsed;
+}
+
+/**
+ * @brief   Programs the next tickless alarm.
+ * @details The alarm is set for the first timer deadline or after
+ *          @p limit ticks, whichever comes first, and never further than
+ *          the port timer can reach.
+ * @note    Internal use only.
+ *
+ * @param[in] limit     the maximum number of ticks before the next alarm
+ *
+ * @notapi
+ */
+void _vt_tickless_arm(systime_t limit) {
+
+  if (limit > port_tickless_max())
+    limit = port_tickless_max();
+  if (limit > vtlist.vt_next->vt_time)
+    limit = vtlist.vt_next->vt_time;
+  vtlist.vt_alarm = vtlist.vt_systime + limit;
+  port_tickless_set(vtlist.vt_alarm);
+}
+#endif /* CH_USE_TICKLESS */
+
 /** @} */
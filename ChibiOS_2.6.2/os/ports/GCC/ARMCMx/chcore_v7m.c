@@ -35,6 +35,119 @@
 
 #include "ch.h"
 
+#if CH_USE_TICKLESS || defined(__DOXYGEN__)
+/*===========================================================================*/
+/* Tickless mode support.                                                    */
+/*===========================================================================*/
+
+/**
+ * @brief   Tickless time base, a tick count and the cycle count it began at.
+ */
+typedef struct {
+  systime_t             tb_ticks;   /**< @brief System time at the base.    */
+  uint32_t              tb_cycles;  /**< @brief Cycle count at the base.    */
+} tickless_base_t;
+
+/**
+ * @brief   Two bases, the current one is selected by the sequence counter.
+ * @details The SYSTICK handler writes the other base and then increments
+ *          the sequence so that readers never need the kernel lock.
+ */
+static tickless_base_t tickless_base[2];
+static volatile uint32_t tickless_seq;
+
+/**
+ * @brief   Core cycles per system tick.
+ */
+static uint32_t tickless_period;
+
+/**
+ * @brief   Longest alarm in ticks the SYSTICK can reach.
+ */
+systime_t _port_tickless_max;
+
+/**
+ * @brief   Tickless mode initialization.
+ * @details The period is taken from the SYSTICK reload value programmed by
+ *          the HAL, time zero is the cycle count at this point.
+ */
+static void tickless_init(void) {
+
+  tickless_period = ST_RVR + 1;
+  _port_tickless_max = (systime_t)(0x1000000 / tickless_period);
+  tickless_seq = 0;
+  tickless_base[0].tb_ticks = 0;
+  tickless_base[0].tb_cycles = DWT_CYCCNT;
+}
+
+/**
+ * @brief   Moves the whole ticks elapsed into a new base.
+ * @details Must run more often than the cycle counter wraps, the SYSTICK
+ *          alarm is never further away than @p _port_tickless_max ticks.
+ */
+static void tickless_update(void) {
+  tickless_base_t *obp = &tickless_base[tickless_seq & 1];
+  tickless_base_t *nbp = &tickless_base[(tickless_seq + 1) & 1];
+  uint32_t ticks = (DWT_CYCCNT - obp->tb_cycles) / tickless_period;
+
+  nbp->tb_ticks = obp->tb_ticks + ticks;
+  nbp->tb_cycles = obp->tb_cycles + ticks * tickless_period;
+  asm volatile ("" : : : "memory");
+  tickless_seq++;
+}
+#endif /* CH_USE_TICKLESS */
+
+#if CORTEX_ENABLE_STACK_GUARD || defined(__DOXYGEN__)
+/*===========================================================================*/
+/* Stack guard support.                                                      */
+/*===========================================================================*/
+
+/**
+ * @brief   Guard content when there is no MPU.
+ */
+#define GUARD_PATTERN           0xDEADBEEFU
+
+/**
+ * @brief   Bottom of the process stack, the main thread stack.
+ */
+extern uint32_t __process_stack_base__;
+
+/**
+ * @brief   Stack guard of the main thread.
+ */
+uint32_t _port_main_guard;
+
+/**
+ * @brief   The MPU protects the guards, else the pattern is checked.
+ */
+static bool_t guard_mpu;
+
+/**
+ * @brief   Stack guard initialization.
+ * @details The guard region follows the running thread, at this point the
+ *          main thread. Parts without an MPU read zero regions from the
+ *          MPU type register.
+ */
+static void guard_init(void) {
+
+  _port_main_guard = PORT_GUARD_ALIGN(&__process_stack_base__);
+  _port_guard_fill(_port_main_guard);
+
+  guard_mpu = (MPU_TYPE & MPU_TYPE_DREGION_MASK) != 0;
+  if (guard_mpu) {
+    MPU_RNR = CORTEX_STACK_GUARD_REGION;
+    MPU_RBAR = _port_main_guard;
+    MPU_RASR = MPU_RASR_XN | MPU_RASR_AP_NOACCESS |
+               MPU_RASR_SIZE(__builtin_ctz(CORTEX_STACK_GUARD_SIZE) - 1) |
+               MPU_RASR_ENABLE;
+    SCB_SHCSR |= SHCSR_MEMFAULTENA;
+    MPU_CTRL = MPU_CTRL_PRIVDEFENA | MPU_CTRL_ENABLE;
+    asm volatile ("dsb                                          \n\t"
+                  "isb" : : : "memory");
+  }
+}
+#endif /* CORTEX_ENABLE_STACK_GUARD */
+
 /*===========================================================================*/
 /* Port interrupt handlers.                                                  */
 /*===========================================================================*/
@@ -43,18 +156,35 @@
  * @brief   System Timer vector.
  * @details This interrupt is used as system tick.
  * @note    The timer must be initialized in the startup code.
+ * @note    In tickless mode the interrupt is the one-shot alarm.
  */
 CH_IRQ_HANDLER(SysTickVector) {
 
   CH_IRQ_PROLOGUE();
 
   chSysLockFromIsr();
+#if CH_USE_TICKLESS
+  tickless_update();
+#endif
   chSysTimerHandlerI();
   chSysUnlockFromIsr();
 
   CH_IRQ_EPILOGUE();
 }
 
+#if CORTEX_ENABLE_STACK_GUARD || defined(__DOXYGEN__)
+/**
+ * @brief   MemManage vector.
+ * @details The guard is the only MPU region and the background map allows
+ *          everything else, so a fault means the current thread has run
+ *          into its guard, either directly or by stacking an exception.
+ */
+void MemManageVector(void) {
+
+  _port_guard_fault(currp);
+}
+#endif /* CORTEX_ENABLE_STACK_GUARD */
+
 #if !CORTEX_SIMPLIFIED_PRIORITY || defined(__DOXYGEN__)
 /**
  * @brief   SVC vector.
@@ -128,7 +258,131 @@ void _port_init(void) {
     CORTEX_PRIORITY_MASK(CORTEX_PRIORITY_PENDSV));
   nvicSetSystemHandlerPriority(HANDLER_SYSTICK,
     CORTEX_PRIORITY_MASK(CORTEX_PRIORITY_SYSTICK));
+
+#if CH_USE_TICKLESS
+  tickless_init();
+#endif
+#if CORTEX_ENABLE_STACK_GUARD
+  guard_init();
+#endif
+}
+
+#if CH_USE_TICKLESS || defined(__DOXYGEN__)
+/**
+ * @brief   Current system time in tickless mode.
+ * @details Can be invoked from any context without the kernel lock, the
+ *          read is repeated if the base was replaced twice meanwhile.
+ *
+ * @return              The system time in ticks.
+ */
+systime_t _port_tickless_now(void) {
+  tickless_base_t *tbp;
+  uint32_t seq;
+  systime_t now;
+
+  do {
+    seq = tickless_seq;
+    asm volatile ("" : : : "memory");
+    tbp = &tickless_base[seq & 1];
+    now = tbp->tb_ticks + (DWT_CYCCNT - tbp->tb_cycles) / tickless_period;
+    asm volatile ("" : : : "memory");
+  } while ((uint32_t)(tickless_seq - seq) >= 2);
+  return now;
+}
+
+/**
+ * @brief   Programs the SYSTICK one-shot for the specified system time.
+ * @details Alarms already due or closer than @p CORTEX_TICKLESS_MIN_CYCLES
+ *          pend the SYSTICK exception instead.
+ * @note    Must be invoked from within the kernel lock.
+ *
+ * @param[in] at        the system time of the alarm
+ */
+void _port_tickless_set(systime_t at) {
+  tickless_base_t *tbp = &tickless_base[tickless_seq & 1];
+  int32_t cycles;
+
+  cycles = (int32_t)(tbp->tb_cycles +
+                     (uint32_t)(at - tbp->tb_ticks) * tickless_period -
+                     DWT_CYCCNT);
+  if (cycles < CORTEX_TICKLESS_MIN_CYCLES)
+    SCB_ICSR = ICSR_PENDSTSET;
+  else {
+    /* Too far for the 24 bits counter, the alarm fires early and the
+       handler programs the rest.*/
+    if (cycles > 0x1000000)
+      cycles = 0x1000000;
+    ST_RVR = (uint32_t)cycles - 1;
+    ST_CVR = 0;
+  }
+}
+#endif /* CH_USE_TICKLESS */
+
+#if CORTEX_ENABLE_STACK_GUARD || defined(__DOXYGEN__)
+/**
+ * @brief   Fills a stack guard with the pattern.
+ * @details The pattern is only checked without an MPU, it is written anyway
+ *          so that a guard never looks like unused stack.
+ *
+ * @param[in] guard     the guard address
+ */
+void _port_guard_fill(uint32_t guard) {
+  uint32_t *p = (uint32_t *)guard;
+  unsigned n;
+
+  for (n = 0; n < CORTEX_STACK_GUARD_SIZE / sizeof (uint32_t); n++)
+    p[n] = GUARD_PATTERN;
+}
+
+/**
+ * @brief   Stack guard part of the context switch.
+ * @details With an MPU the guard region is moved under the incoming thread
+ *          stack, a single register write. Without one the guard of the
+ *          outgoing thread is checked, an overflow is then found at the
+ *          next switch rather than when it happens.
+ * @note    Invoked from @p port_switch() within the kernel lock.
+ *
+ * @param[in] ntp       the thread to be switched in
+ * @param[in] otp       the thread to be switched out
+ */
+void _port_guard_switch(Thread *ntp, Thread *otp) {
+
+  if (guard_mpu) {
+    MPU_RBAR = port_stack_guard(ntp) | MPU_RBAR_VALID |
+               CORTEX_STACK_GUARD_REGION;
+    asm volatile ("dsb                                          \n\t"
+                  "isb" : : : "memory");
+  }
+  else {
+    uint32_t *p = (uint32_t *)port_stack_guard(otp);
+    unsigned n;
+
+    for (n = 0; n < CORTEX_STACK_GUARD_SIZE / sizeof (uint32_t); n++) {
+      if (p[n] != GUARD_PATTERN)
+        _port_guard_fault(otp);
+    }
+  }
+}
+
+/**
+ * @brief   Stack guard hit.
+ * @details Disables the MPU so that the hook can report from anywhere,
+ *          then halts the system.
+ *
+ * @param[in] tp        the thread that overflowed its stack
+ */
+void _port_guard_fault(Thread *tp) {
+
+  port_disable();
+  if (guard_mpu) {
+    MPU_CTRL = 0;
+    asm volatile ("dsb                                          \n\t"
+                  "isb" : : : "memory");
+  }
+  CORTEX_STACK_GUARD_HOOK(tp);
+  chSysHalt();
 }
+#endif /* CORTEX_ENABLE_STACK_GUARD */
 
 #if !CH_OPTIMIZE_SPEED
 void _port_lock(void) {
@@ -86,6 +86,56 @@
 #define CORTEX_ENABLE_WFI_IDLE          FALSE
 #endif
 
+/**
+ * @brief   Minimum SYSTICK one-shot interval in tickless mode.
+ * @details Alarms closer than this number of core cycles are served by
+ *          pending the SYSTICK exception immediately.
+ * @note    Only used when @p CH_USE_TICKLESS is enabled.
+ */
+#if !defined(CORTEX_TICKLESS_MIN_CYCLES)
+#define CORTEX_TICKLESS_MIN_CYCLES      100
+#endif
+
+/**
+ * @brief   Stack guard below every thread stack.
+ * @details The lowest @p CORTEX_STACK_GUARD_SIZE bytes of each stack are
+ *          made inaccessible by the MPU while the thread runs, an overflow
+ *          raises a MemManage fault that names the thread. On devices
+ *          without an MPU the guard holds a pattern that is checked when
+ *          the thread is switched out instead.
+ * @note    The working areas grow by twice the guard size.
+ */
+#if !defined(CORTEX_ENABLE_STACK_GUARD)
+#define CORTEX_ENABLE_STACK_GUARD       FALSE
+#endif
+
+/**
+ * @brief   Stack guard size in bytes.
+ * @note    Must be a power of two, the MPU minimum is 32.
+ */
+#if !defined(CORTEX_STACK_GUARD_SIZE)
+#define CORTEX_STACK_GUARD_SIZE         32
+#elif (CORTEX_STACK_GUARD_SIZE < 32) ||                                     \
+      ((CORTEX_STACK_GUARD_SIZE & (CORTEX_STACK_GUARD_SIZE - 1)) != 0)
+#error "invalid size specified for CORTEX_STACK_GUARD_SIZE"
+#endif
+
+/**
+ * @brief   MPU region used by the stack guard.
+ */
+#if !defined(CORTEX_STACK_GUARD_REGION)
+#define CORTEX_STACK_GUARD_REGION       7
+#endif
+
+/**
+ * @brief   Stack guard hit hook.
+ * @details Invoked with the offending thread, interrupts disabled and the
+ *          MPU off, the system is halted when it returns.
+ */
+#if !defined(CORTEX_STACK_GUARD_HOOK)
+#define CORTEX_STACK_GUARD_HOOK(tp)
+#endif
+
 /**
  * @brief   SYSTICK handler priority.
  * @note    The default SYSTICK handler priority is calculated as the priority
@@ -301,11 +351,55 @@ struct intctx {
  * @brief   Platform dependent part of the @p Thread structure.
  * @details In this port the structure just holds a pointer to the @p intctx
  *          structure representing the stack pointer at context switch time.
+ * @note    The stack guard address follows @p r13, the switch code only
+ *          knows the offset of @p r13.
  */
 struct context {
   struct intctx *r13;
+#if CORTEX_ENABLE_STACK_GUARD || defined(__DOXYGEN__)
+  uint32_t guard;       /**< @brief Stack guard, zero for the main thread.  */
+#endif
 };
 
+#if CORTEX_ENABLE_STACK_GUARD || defined(__DOXYGEN__)
+/**
+ * @brief   Rounds an address up to the stack guard alignment.
+ */
+#define PORT_GUARD_ALIGN(p)                                                 \
+  (((uint32_t)(p) + (CORTEX_STACK_GUARD_SIZE - 1)) &                        \
+   ~(uint32_t)(CORTEX_STACK_GUARD_SIZE - 1))
+
+/**
+ * @brief   Working area space reserved for the guard and its alignment.
+ */
+#define PORT_GUARD_REQUIRED_STACK       (2 * CORTEX_STACK_GUARD_SIZE)
+
+/**
+ * @brief   Places the guard at the bottom of a new thread stack.
+ */
+#define PORT_GUARD_SETUP(workspace) {                                       \
+  tp->p_ctx.guard = PORT_GUARD_ALIGN((Thread *)(workspace) + 1);            \
+  _port_guard_fill(tp->p_ctx.guard);                                        \
+}
+
+/**
+ * @brief   Stack guard address of a thread.
+ * @details The main thread runs on the process stack, its guard is found
+ *          at the bottom of it.
+ */
+#define port_stack_guard(tp)                                                \
+  ((tp)->p_ctx.guard != 0 ? (tp)->p_ctx.guard : _port_main_guard)
+
+/**
+ * @brief   Moves the guard to the incoming thread or checks the outgoing one.
+ */
+#define port_guard_switch(ntp, otp) _port_guard_switch(ntp, otp)
+#else
+#define PORT_GUARD_REQUIRED_STACK       0
+#define PORT_GUARD_SETUP(workspace)
+#define port_guard_switch(ntp, otp)
+#endif
+
 /**
  * @brief   Platform dependent part of the @p chThdCreateI() API.
  * @details This code usually setup the context switching frame represented
@@ -318,6 +412,7 @@ struct context {
   tp->p_ctx.r13->r4 = (void *)(pf);                                         \
   tp->p_ctx.r13->r5 = (void *)(arg);                                        \
   tp->p_ctx.r13->lr = (void *)(_port_thread_start);                         \
+  PORT_GUARD_SETUP(workspace);                                              \
 }
 
 /**
@@ -331,7 +426,8 @@ struct context {
 #define THD_WA_SIZE(n) STACK_ALIGN(sizeof(Thread) +                         \
                                    sizeof(struct intctx) +                  \
                                    sizeof(struct extctx) +                  \
-                                   (n) + (PORT_INT_REQUIRED_STACK))
+                                   (n) + (PORT_INT_REQUIRED_STACK) +        \
+                                   (PORT_GUARD_REQUIRED_STACK))
 
 /**
  * @brief   Static working area allocation.
@@ -373,6 +469,26 @@ struct context {
  */
 #define port_init() _port_init()
 
+#if CH_USE_TICKLESS || defined(__DOXYGEN__)
+/**
+ * @brief   Current system time in tickless mode.
+ * @details The time is derived from the DWT cycle counter, the SYSTICK is
+ *          only used as a one-shot alarm.
+ */
+#define port_tickless_now() _port_tickless_now()
+
+/**
+ * @brief   Programs the tickless alarm for the specified system time.
+ * @note    Must be invoked from within the kernel lock.
+ */
+#define port_tickless_set(at) _port_tickless_set(at)
+
+/**
+ * @brief   Longest alarm in ticks the 24 bits SYSTICK can reach.
+ */
+#define port_tickless_max() (_port_tickless_max)
+#endif /* CH_USE_TICKLESS */
+
 /**
  * @brief   Kernel-lock action.
  * @details Usually this function just disables interrupts but may perform
@@ -496,13 +612,20 @@ struct context {
  * @param[in] ntp       the thread to be switched in
  * @param[in] otp       the thread to be switched out
  */
-#if !CH_DBG_ENABLE_STACK_CHECK || defined(__DOXYGEN__)
+#if (!CH_DBG_ENABLE_STACK_CHECK && !CORTEX_ENABLE_STACK_GUARD) ||           \
+    defined(__DOXYGEN__)
 #define port_switch(ntp, otp) _port_switch(ntp, otp)
+#elif !CH_DBG_ENABLE_STACK_CHECK
+#define port_switch(ntp, otp) {                                             \
+  port_guard_switch(ntp, otp);                                              \
+  _port_switch(ntp, otp);                                                   \
+}
 #else
 #define port_switch(ntp, otp) {                                             \
   register struct intctx *r13 asm ("r13");                                  \
   if ((stkalign_t *)(r13 - 1) < otp->p_stklimit)                            \
     chDbgPanic("stack overflow");                                           \
+  port_guard_switch(ntp, otp);                                              \
   _port_switch(ntp, otp);                                                   \
 }
 #endif
@@ -517,6 +640,17 @@ extern "C" {
   void _port_exit_from_isr(void);
   void _port_switch(Thread *ntp, Thread *otp);
   void _port_thread_start(void);
+#if CH_USE_TICKLESS
+  extern systime_t _port_tickless_max;
+  systime_t _port_tickless_now(void);
+  void _port_tickless_set(systime_t at);
+#endif
+#if CORTEX_ENABLE_STACK_GUARD
+  extern uint32_t _port_main_guard;
+  void _port_guard_fill(uint32_t guard);
+  void _port_guard_switch(Thread *ntp, Thread *otp);
+  void _port_guard_fault(Thread *tp);
+#endif
 #if !CH_OPTIMIZE_SPEED
   void _port_lock(void);
   void _port_unlock(void);
@@ -198,6 +198,44 @@ typedef struct {
 #define AIRCR_PRIGROUP_MASK     (0x7U << 8)
 #define AIRCR_PRIGROUP(n)       ((n) << 8)
 
+#define SHCSR_MEMFAULTENA       (0x1U << 16)
+#define SHCSR_BUSFAULTENA       (0x1U << 17)
+#define SHCSR_USGFAULTENA       (0x1U << 18)
+
+#define CFSR_MMARVALID          (0x1U << 7)
+#define CFSR_MSTKERR            (0x1U << 4)
+#define CFSR_DACCVIOL           (0x1U << 1)
+
+/**
+ * @brief Structure representing the MPU I/O space.
+ */
+typedef struct {
+  IOREG32       TYPE;
+  IOREG32       CTRL;
+  IOREG32       RNR;
+  IOREG32       RBAR;
+  IOREG32       RASR;
+} CMx_MPU;
+
+/**
+ * @brief MPU peripheral base address.
+ */
+#define MPUBase                 ((CMx_MPU *)0xE000ED90U)
+#define MPU_TYPE                (MPUBase->TYPE)
+#define MPU_CTRL                (MPUBase->CTRL)
+#define MPU_RNR                 (MPUBase->RNR)
+#define MPU_RBAR                (MPUBase->RBAR)
+#define MPU_RASR                (MPUBase->RASR)
+
+#define MPU_TYPE_DREGION_MASK   (0xFFU << 8)
+#define MPU_CTRL_ENABLE         (0x1U << 0)
+#define MPU_CTRL_PRIVDEFENA     (0x1U << 2)
+#define MPU_RBAR_VALID          (0x1U << 4)
+#define MPU_RASR_ENABLE         (0x1U << 0)
+#define MPU_RASR_SIZE(n)        ((n) << 1)
+#define MPU_RASR_AP_NOACCESS    (0x0U << 24)
+#define MPU_RASR_XN             (0x1U << 28)
+
 /**
  * @brief Structure representing the FPU I/O space.
  */
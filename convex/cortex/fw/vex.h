@@ -56,6 +56,10 @@
 // Must come first - contains compatibility definitions
 #include "vexcompat.h"
 
+#include "vexring.h"
+#include "vextime.h"
+#include "vexstack.h"
+
 #include "vexanalog.h"
 #include "vexdigital.h"
 #include "vexencoder.h"
@@ -126,6 +130,30 @@
 #define AUDIO_TASK_STACK_SIZE       0xD0
 /** @} */
 
+/*-----------------------------------------------------------------------------*/
+/** @brief      Timing for a periodic loop, see vexPeriodicWait                */
+/*-----------------------------------------------------------------------------*/
+typedef struct _vexPeriodic {
+    systime_t   deadline;   ///< start of the current period
+    systime_t   period;     ///< period in system ticks
+    uint32_t    cycles;     ///< number of times the loop has run
+    uint32_t    overruns;   ///< number of times the loop ran past its deadline
+    int32_t     lateness;   ///< worst case ticks past a deadline
+    } vexPeriodic;
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Competition mode, see vexModeGet                               */
+/*-----------------------------------------------------------------------------*/
+typedef enum {
+    kVexModeDisabled = 0,
+    kVexModeAutonomous,
+    kVexModeOperator
+    } tVexMode;
+
+/** @brief event flag broadcast for a change to mode m, see vexModeListen
+ */
+#define VEX_MODE_FLAG(m)            (1 << (m))
+
 /*-----------------------------------------------------------------------------*/
 // Serial ports swap around depending on the board
 #ifdef  BOARD_OLIMEX_STM32_P103
@@ -160,9 +188,21 @@ void        vexTaskRegisterPersistant(char *name, bool_t p );
 bool_t      vexTaskIsRegistered( Thread *tp );
 bool_t      vexTaskPersistentGet( Thread *tp );
 void        vexTaskPersistentSet( Thread *tp, bool_t p );
+void        vexTaskDebug(vexStream *chp, int argc, char *argv[]);
 
 void        vexTaskEmergencyStop( void );
+void        vexTaskEmergencyStopI( void );
+void        vexTaskEmergencyClear( void );
+void        vexTaskEmergencyButtonSet( int16_t btn );
+void        vexTaskEmergencyDebug(vexStream *chp, int argc, char *argv[]);
+void        vexTaskTerminateListen( EventListener *el, eventmask_t mask );
+tVexMode    vexModeGet( void );
+void        vexModeListen( EventListener *el, eventmask_t mask );
+void        vexModeDebug(vexStream *chp, int argc, char *argv[]);
 void        vexSleep( int32_t msec );
+eventmask_t vexSleepEvents( eventmask_t mask, int32_t msec );
+void        vexPeriodicInit( vexPeriodic *p, int32_t msec );
+void        vexPeriodicWait( vexPeriodic *p );
 
 //#define     VEX_WATCHDOG_ENABLE     1
 void        vexWatchdogInit(void);
@@ -277,6 +277,7 @@ vexMotorConfigure( vexMotorCfg *cfg, int16_t cfg_num )
                 vexImeSetType( _cfg->channel, _cfg->mtype );
                 // set the get position callback
                 vexMotorPositionGetCallback( _cfg->port, vexImeGetCount, _cfg->channel );
+                vexMotorPositionTimeCallback( _cfg->port, vexImeGetCountWithTime, _cfg->channel );
                 // set the set position callback
                 vexMotorPositionSetCallback( _cfg->port, vexImeSetCount, _cfg->channel );
                 // set the id request callback
@@ -286,6 +287,7 @@ vexMotorConfigure( vexMotorCfg *cfg, int16_t cfg_num )
             case    kVexSensorQuadEncoder:
                 // set the get position callback
                 vexMotorPositionGetCallback( _cfg->port, vexEncoderGet, _cfg->channel );
+                vexMotorPositionTimeCallback( _cfg->port, vexEncoderGetWithTime, _cfg->channel );
                 // set the set position callback
                 vexMotorPositionSetCallback( _cfg->port, vexEncoderSet, _cfg->channel );
                 // set the id request callback
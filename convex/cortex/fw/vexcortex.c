@@ -43,6 +43,7 @@
 /*                                                                             */
 /*-----------------------------------------------------------------------------*/
 
+#include <string.h>
 
 #include "ch.h"         // needs for all ChibiOS programs
 #include "hal.h"        // hardware abstraction layer header
@@ -84,6 +85,7 @@ typedef struct {
     Thread          *tp;
     EventListener   el;
     bool_t          persistent;
+    vexPeriodic     *periodic;
 } vexThread;
 
 /*-----------------------------------------------------------------------------*/
@@ -91,12 +93,50 @@ typedef struct {
 /*-----------------------------------------------------------------------------*/
 static EVENTSOURCE_DECL(task_terminate);
 
+/*-----------------------------------------------------------------------------*/
+/** @brief      The mode change event source and the current mode              */
+/*-----------------------------------------------------------------------------*/
+static EVENTSOURCE_DECL(mode_change);
+static tVexMode    vexMode = kVexModeDisabled;
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Time from the packet with a new state to the monitor and the   */
+/**             user thread reacting, cpu cycles                               */
+/*-----------------------------------------------------------------------------*/
+typedef struct _vexModeLatency {
+    uint32_t    changes;
+    uint32_t    monitor;
+    uint32_t    monitorMax;
+    uint32_t    start;
+    uint32_t    startMax;
+} vexModeLatency;
+
+static vexModeLatency   modeLatency;
+
 /*-----------------------------------------------------------------------------*/
 /** @brief      Storage for the user threads                                   */
 /*-----------------------------------------------------------------------------*/
 #define MAX_THREAD  20
 static  vexThread   myThreads[MAX_THREAD];
 
+// one bit for each free slot in myThreads
+static  uint32_t    myThreadsFree = (1UL << MAX_THREAD) - 1;
+
+/*-----------------------------------------------------------------------------*/
+/*  Each thread can remember its slot in myThreads if chconf.h defines         */
+/*  VEX_THREAD_SLOT and adds an int16_t vex_slot to THREAD_EXT_FIELDS, set to  */
+/*  -1 by THREAD_EXT_INIT_HOOK.  Without that the slot is searched for.        */
+/*-----------------------------------------------------------------------------*/
+static int16_t vexTaskSlotFind( Thread *tp );
+
+#ifdef  VEX_THREAD_SLOT
+#define vexTaskSlotGet(tp)      ((tp)->vex_slot)
+#define vexTaskSlotSet(tp, i)   ((tp)->vex_slot = (i))
+#else
+#define vexTaskSlotGet(tp)      vexTaskSlotFind(tp)
+#define vexTaskSlotSet(tp, i)
+#endif
+
 /*-----------------------------------------------------------------------------*/
 /*  @brief      Cleanup ROBOTC style tasks                                     */
 /*-----------------------------------------------------------------------------*/
@@ -107,6 +147,60 @@ void   CleanupTask( Thread *tp )  __attribute__ ((weak));
 /*-----------------------------------------------------------------------------*/
 static  bool_t      vexKillAll = FALSE;
 
+/*-----------------------------------------------------------------------------*/
+/*  @brief      Emergency stop event, wakes the monitor to start teardown      */
+/*-----------------------------------------------------------------------------*/
+static EVENTSOURCE_DECL(emergency_stop);
+
+/*-----------------------------------------------------------------------------*/
+/*  @brief      Joystick button that triggers emergency stop, -1 for none      */
+/*-----------------------------------------------------------------------------*/
+static  int16_t     vexEmergencyButton = -1;
+
+/*-----------------------------------------------------------------------------*/
+/*  Search myThreads for a thread                                              */
+/*-----------------------------------------------------------------------------*/
+static int16_t
+vexTaskSlotFind( Thread *tp )
+{
+    int16_t     i;
+
+    for(i=0;i<MAX_THREAD;i++)
+        {
+        if( myThreads[ i ].tp == tp )
+            return( i );
+        }
+
+    return( -1 );
+}
+
+/*-----------------------------------------------------------------------------*/
+/*  Get the slot a thread is registered in, -1 if it is not                    */
+/*-----------------------------------------------------------------------------*/
+static int16_t
+vexTaskSlot( Thread *tp )
+{
+    int16_t     i = vexTaskSlotGet( tp );
+
+    // slot may be stale if the thread was dropped by the monitor
+    if( (i < 0) || (i >= MAX_THREAD) || (myThreads[ i ].tp != tp) )
+        return( -1 );
+
+    return( i );
+}
+
+/*-----------------------------------------------------------------------------*/
+/*  Give a slot back                                                           */
+/*-----------------------------------------------------------------------------*/
+static void
+vexTaskSlotFree( int16_t i )
+{
+    chSysLock();
+    myThreads[ i ].tp = (Thread *)0;
+    myThreadsFree |= (1UL << i);
+    chSysUnlock();
+}
+
 /*-----------------------------------------------------------------------------*/
 /** @brief      Register a thread so it can be terminated during vexSleep      */
 /** @param[in]  name string describing the thread                              */
@@ -127,34 +221,35 @@ vexTaskRegister(char *name)
 void
 vexTaskRegisterPersistant(char *name, bool_t p )
 {
-    uint16_t    i;
+    Thread     *tp = chThdSelf();
+    int16_t     i;
 
     // register name
     chRegSetThreadName(name);
 
-    // check the array to see if this thread was already registered
-    for(i=0;i<MAX_THREAD;i++)
+    // if we are already registered just update persistent flag
+    if( (i = vexTaskSlot( tp )) >= 0 )
         {
-        // if we are already in the array
-        if( myThreads[ i ].tp == chThdSelf())
-            {
-            // update persistent flag
-            myThreads[ i ].persistent = p;
-            return;
-            }
+        myThreads[ i ].persistent = p;
+        return;
         }
 
-    // So we are not registered, look for an empty slot
-    for(i=0;i<MAX_THREAD;i++)
+    // So we are not registered, take the lowest free slot
+    chSysLock();
+    if( myThreadsFree == 0 )
         {
-        if( myThreads[ i ].tp == 0 )
-            {
-            myThreads[ i ].tp = chThdSelf();
-            myThreads[ i ].persistent = p;
-            chEvtRegisterMask(&task_terminate, &myThreads[ i ].el, 1);
-            break;
-            }
+        chSysUnlock();
+        return;
         }
+    i = __builtin_ctz( myThreadsFree );
+    myThreadsFree &= ~(1UL << i);
+    myThreads[ i ].tp = tp;
+    vexTaskSlotSet( tp, i );
+    chSysUnlock();
+
+    myThreads[ i ].persistent = p;
+    myThreads[ i ].periodic = NULL;
+    chEvtRegisterMask(&task_terminate, &myThreads[ i ].el, 1);
 }
 
 /*-----------------------------------------------------------------------------*/
@@ -166,19 +261,7 @@ vexTaskRegisterPersistant(char *name, bool_t p )
 bool_t
 vexTaskIsRegistered( Thread *tp )
 {
-    uint16_t    i;
-    bool_t  isreg = FALSE;
-
-    for(i=0;i<MAX_THREAD;i++)
-        {
-        // see if we are already in the array
-        if( myThreads[ i ].tp == tp)
-            {
-            isreg = TRUE;
-            break;
-            }
-        }
-    return(isreg);
+    return( vexTaskSlot( tp ) >= 0 );
 }
 
 /*-----------------------------------------------------------------------------*/
@@ -190,19 +273,12 @@ vexTaskIsRegistered( Thread *tp )
 bool_t
 vexTaskPersistentGet( Thread *tp )
 {
-    uint16_t    i;
-    bool_t      p = FALSE;
+    int16_t     i;
 
-    for(i=0;i<MAX_THREAD;i++)
-        {
-        // see if we are already in the array
-        if( myThreads[ i ].tp == tp)
-            {
-            p = myThreads[ i ].persistent;
-            break;
-            }
-        }
-    return(p);
+    if( (i = vexTaskSlot( tp )) < 0 )
+        return( FALSE );
+
+    return( myThreads[ i ].persistent );
 }
 
 /*-----------------------------------------------------------------------------*/
@@ -214,17 +290,53 @@ vexTaskPersistentGet( Thread *tp )
 void
 vexTaskPersistentSet( Thread *tp, bool_t p )
 {
-    uint16_t    i;
+    int16_t     i;
+
+    if( (i = vexTaskSlot( tp )) >= 0 )
+        myThreads[ i ].persistent = p;
+}
+
+/*-----------------------------------------------------------------------------*/
+/*  Time vexSleep(0) and a registry lookup against the old search, the last    */
+/*  registered thread is looked up as that is the worst case for the search    */
+/*-----------------------------------------------------------------------------*/
+#define VEX_TASK_BENCH_LOOPS    1000
+
+static void
+vexTaskBench( vexStream *chp )
+{
+    Thread     *tp = NULL;
+    uint32_t    t;
+    int16_t     i;
+    volatile int16_t    slot;
 
     for(i=0;i<MAX_THREAD;i++)
         {
-        // see if we are already in the array
-        if( myThreads[ i ].tp == tp)
-            {
-            myThreads[ i ].persistent = p;
-            break;
-            }
+        if( myThreads[ i ].tp != NULL )
+            tp = myThreads[ i ].tp;
         }
+
+    // the shell is not registered and has no events, vexSleep will return
+    t = halGetCounterValue();
+    for(i=0;i<VEX_TASK_BENCH_LOOPS;i++)
+        vexSleep(0);
+    t = halGetCounterValue() - t;
+    vex_chprintf( chp, "vexSleep(0) %d cycles\r\n", t / VEX_TASK_BENCH_LOOPS );
+
+    if( tp == NULL )
+        return;
+
+    t = halGetCounterValue();
+    for(i=0;i<VEX_TASK_BENCH_LOOPS;i++)
+        slot = vexTaskSlot( tp );
+    t = halGetCounterValue() - t;
+    vex_chprintf( chp, "lookup %2d   %d cycles\r\n", slot, t / VEX_TASK_BENCH_LOOPS );
+
+    t = halGetCounterValue();
+    for(i=0;i<VEX_TASK_BENCH_LOOPS;i++)
+        slot = vexTaskSlotFind( tp );
+    t = halGetCounterValue() - t;
+    vex_chprintf( chp, "search %2d   %d cycles\r\n", slot, t / VEX_TASK_BENCH_LOOPS );
 }
 
 /*-----------------------------------------------------------------------------*/
@@ -233,6 +345,9 @@ vexTaskPersistentSet( Thread *tp, bool_t p )
 /** @param[in]  argc    The number of command line arguments                   */
 /** @param[in]  argv    An array of pointers to the command line args          */
 /*-----------------------------------------------------------------------------*/
+/** @details
+ *  "bench" times vexSleep(0) and a registry lookup instead.
+ */
 
 void
 vexTaskDebug(vexStream *chp, int argc, char *argv[])
@@ -240,8 +355,11 @@ vexTaskDebug(vexStream *chp, int argc, char *argv[])
     uint16_t    i;
     Thread  *tp;
 
-    (void)argc;
-    (void)argv;
+    if( (argc > 0) && (strcmp( argv[0], "bench" ) == 0) )
+        {
+        vexTaskBench( chp );
+        return;
+        }
 
     for(i=0;i<MAX_THREAD;i++)
         {
@@ -253,70 +371,245 @@ vexTaskDebug(vexStream *chp, int argc, char *argv[])
             else
             	vex_chprintf(chp,"                 ");
 
-            vex_chprintf( chp, "%2d: %.8X %d\r\n", i, tp, myThreads[ i ].persistent );
+            vex_chprintf( chp, "%2d: %.8X %d", i, tp, myThreads[ i ].persistent );
+
+            // periodic loops show period, cycles, overruns and worst lateness
+            if( myThreads[ i ].periodic != NULL )
+                {
+                vexPeriodic *p = myThreads[ i ].periodic;
+                vex_chprintf( chp, " %3d %8d %5d %3d", p->period, p->cycles, p->overruns, p->lateness );
+                }
+            vex_chprintf( chp, "\r\n" );
             }
         }
 }
 
 /*-----------------------------------------------------------------------------*/
-/** @brief      Stop all tasks                                                 */
+/** @brief      Stop all motors and tasks from an ISR                          */
+/** @note       Call from an ISR or with the system locked                     */
 /*-----------------------------------------------------------------------------*/
 /** @details
- *  Call this to stop all tasks that were registered with vexTaskRegister or
- *  vexTaskRegisterPersistant.  Use as emergency stop, cortex will need rebooting
+ *  All ten motor outputs are zero before this returns, the tasks are torn
+ *  down afterwards by the monitor.  Both stay stopped until
+ *  vexTaskEmergencyClear is called.
  */
 void
-vexTaskEmergencyStop()
+vexTaskEmergencyStopI()
 {
     uint16_t     i;
+
+    vexMotorEmergencyStopI();
+
     // scrap persistent flag
     for(i=0;i<MAX_THREAD;i++)
         myThreads[ i ].persistent = FALSE;
 
     vexKillAll = TRUE;
+
+    chEvtBroadcastI(&emergency_stop);
 }
 
 /*-----------------------------------------------------------------------------*/
-/** @brief      Sleep for given number of ms                                   */
-/** @param[in]  msec number of ms to sleep                                     */
+/** @brief      Stop all tasks                                                 */
+/*-----------------------------------------------------------------------------*/
+/** @details
+ *  Call this to stop all tasks that were registered with vexTaskRegister or
+ *  vexTaskRegisterPersistant.  Use as emergency stop, the motors are stopped
+ *  straight away and stay stopped until vexTaskEmergencyClear is called.
+ */
+void
+vexTaskEmergencyStop()
+{
+    chSysLock();
+    vexTaskEmergencyStopI();
+    chSchRescheduleS();
+    chSysUnlock();
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Clear an emergency stop                                        */
+/*-----------------------------------------------------------------------------*/
+/** @details
+ *  The motors can be commanded again and the monitor goes back to waiting
+ *  for the robot to be enabled.  Tasks that were stopped, including the
+ *  persistent ones, are not restarted.
+ */
+void
+vexTaskEmergencyClear()
+{
+    chSysLock();
+    vexMotorEmergencyClear();
+    vexKillAll = FALSE;
+    chSysUnlock();
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Use a joystick button as emergency stop                        */
+/** @param[in]  btn The button, for example Btn7D, or -1 for none              */
+/*-----------------------------------------------------------------------------*/
+/** @details
+ *  The button is checked by the system task as soon as each SPI frame is
+ *  received, before any user task sees it.
+ */
+void
+vexTaskEmergencyButtonSet( int16_t btn )
+{
+    vexEmergencyButton = btn;
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Debug function, trigger, clear or show the emergency stop      */
+/** @param[in]  chp     A pointer to a vexStream object                        */
+/** @param[in]  argc    The number of command line arguments                   */
+/** @param[in]  argv    An array of pointers to the command line args          */
+/*-----------------------------------------------------------------------------*/
+/** @details
+ *  No arguments stops everything, "clear" releases the latch and "stat"
+ *  only shows the latch and the latency of the last stop.
+ */
+void
+vexTaskEmergencyDebug(vexStream *chp, int argc, char *argv[])
+{
+    vexMotorEmergency *e = vexMotorEmergencyGetPtr();
+    uint32_t    us = STM32_SYSCLK / 1000000;
+
+    if( argc == 0 )
+        vexTaskEmergencyStop();
+    else
+    if( strcmp( argv[0], "clear" ) == 0 )
+        vexTaskEmergencyClear();
+
+    vex_chprintf( chp, "estop %s count %d\r\n", e->latched ? "latched" : "clear", e->count );
+    vex_chprintf( chp, "trigger to pwm zero   %d cycles (%d uS)\r\n", e->pwm, e->pwm / us );
+    vex_chprintf( chp, "trigger to spi frame  %d uS\r\n", e->frame / us );
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Listen for the event that ends the user tasks                  */
+/** @param[in]  el storage for the listener, must not be on a task's stack     */
+/** @param[in]  mask event flags the calling thread receives                   */
 /*-----------------------------------------------------------------------------*/
 /**
  *  @details
- *  Used as a replacement for chThdSleepMilliseconds so calling thread can
- *  be terminated
+ *  For library threads that are not tasks but hold work on behalf of them,
+ *  they receive mask when the competition mode ends and the registered
+ *  tasks are told to terminate.
  */
 void
-vexSleep( int32_t msec )
+vexTaskTerminateListen( EventListener *el, eventmask_t mask )
+{
+    chEvtRegisterMask( &task_terminate, el, mask );
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Get the competition mode                                       */
+/** @return     The mode, changes just before the mode change event            */
+/*-----------------------------------------------------------------------------*/
+tVexMode
+vexModeGet( void )
+{
+    return( vexMode );
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Listen for competition mode changes                            */
+/** @param[in]  el storage for the listener, must not be on a task's stack     */
+/** @param[in]  mask event flags the calling thread receives                   */
+/*-----------------------------------------------------------------------------*/
+/**
+ *  @details
+ *  Threads that stay alive across modes, persistent tasks and library
+ *  threads, use this to switch behavior rather than being restarted. The
+ *  listener flags are VEX_MODE_FLAG of the new mode.
+ */
+void
+vexModeListen( EventListener *el, eventmask_t mask )
+{
+    chEvtRegisterMask( &mode_change, el, mask );
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Set the competition mode and tell the listeners                */
+/** @param[in]  state the competition state word                              */
+/*-----------------------------------------------------------------------------*/
+static void
+vexModeSet( uint16_t state )
+{
+    tVexMode    mode;
+
+    if( (state & kFlagDisabled) == kFlagDisabled )
+        mode = kVexModeDisabled;
+    else
+    if( (state & kFlagAutonomousMode) == kFlagAutonomousMode )
+        mode = kVexModeAutonomous;
+    else
+        mode = kVexModeOperator;
+
+    if( mode != vexMode )
+        {
+        modeLatency.changes++;
+        modeLatency.monitor = halGetCounterValue() - vexSpiStateTimeGet();
+        if( modeLatency.monitor > modeLatency.monitorMax )
+            modeLatency.monitorMax = modeLatency.monitor;
+
+        vexMode = mode;
+        chEvtBroadcastFlags( &mode_change, VEX_MODE_FLAG(mode) );
+        }
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Debug function, show the mode and how fast changes are seen    */
+/** @param[in]  chp     A pointer to a vexStream object                        */
+/** @param[in]  argc    The number of command line arguments                   */
+/** @param[in]  argv    An array of pointers to the command line args          */
+/*-----------------------------------------------------------------------------*/
+void
+vexModeDebug(vexStream *chp, int argc, char *argv[])
 {
-    if( (chEvtWaitAnyTimeout( ALL_EVENTS, MS2ST(msec) ) != 0) || chThdShouldTerminate() )
+    uint32_t    us = STM32_SYSCLK / 1000000;
+
+    (void)argc;
+    (void)argv;
+
+    vex_chprintf( chp, "mode %d changes %d\r\n", vexMode, modeLatency.changes );
+    vex_chprintf( chp, "packet to monitor %d uS max %d uS\r\n", modeLatency.monitor / us, modeLatency.monitorMax / us );
+    vex_chprintf( chp, "packet to user    %d uS max %d uS\r\n", modeLatency.start / us, modeLatency.startMax / us );
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Exit the calling thread if it has been asked to terminate      */
+/** @param[in]  events events received while waiting                          */
+/*-----------------------------------------------------------------------------*/
+
+static void
+vexSleepExit( eventmask_t events )
+{
+    if( (events != 0) || chThdShouldTerminate() )
         {
         // We used to lock here, that was incorrect and has been removed
         // we have been asked to terminate either by the THD_TERMINATE flag being set or
         // by an event sent from the task_terminate event source
-        uint16_t i;
-        for(i=0;i<MAX_THREAD;i++)
+        int16_t i = vexTaskSlot( chThdSelf() );
+
+        if( i >= 0 )
             {
-            if( myThreads[ i ].tp == chThdSelf() )
+            // A persistent thread ?
+            if( myThreads[ i ].persistent == TRUE )
                 {
-                // A persistent thread ?
-                if( myThreads[ i ].persistent == TRUE )
-                    {
-                    // do not terminate unless a real terminate request
-                    if(!chThdShouldTerminate())
-                        return;
-                    }
-                // unregister the event listener
-                chEvtUnregister( &task_terminate, &myThreads[ i ].el );
-
-                // may have been started by the ROBOTC glue code
-                if( CleanupTask )
-                    CleanupTask( myThreads[ i ].tp );
-
-                // If terminated rather than event then clear slot
-                if(chThdShouldTerminate())
-                    myThreads[ i ].tp = (Thread *)0;
-                break;
+                // do not terminate unless a real terminate request
+                if(!chThdShouldTerminate())
+                    return;
                 }
+            // unregister the event listener
+            chEvtUnregister( &task_terminate, &myThreads[ i ].el );
+
+            // may have been started by the ROBOTC glue code
+            if( CleanupTask )
+                CleanupTask( myThreads[ i ].tp );
+
+            // If terminated rather than event then clear slot
+            if(chThdShouldTerminate())
+                vexTaskSlotFree( i );
             }
 
         // terminate ourself
@@ -324,6 +617,117 @@ vexSleep( int32_t msec )
         }
 }
 
+/*-----------------------------------------------------------------------------*/
+/** @brief      Sleep for given number of ms                                   */
+/** @param[in]  msec number of ms to sleep                                     */
+/*-----------------------------------------------------------------------------*/
+/**
+ *  @details
+ *  Used as a replacement for chThdSleepMilliseconds so calling thread can
+ *  be terminated
+ */
+void
+vexSleep( int32_t msec )
+{
+    // MS2ST(0) is not TIME_IMMEDIATE
+    vexSleepExit( chEvtWaitAnyTimeout( ALL_EVENTS, (msec > 0) ? MS2ST(msec) : TIME_IMMEDIATE ) );
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Sleep for given number of ms or until an event in mask arrives */
+/** @param[in]  mask events the caller handles itself                         */
+/** @param[in]  msec most ms to sleep                                          */
+/** @return     The events in mask that were received                          */
+/*-----------------------------------------------------------------------------*/
+/**
+ *  @details
+ *  As vexSleep but a thread can also be woken by chEvtSignal. Any event not
+ *  in mask is still treated as a terminate request so mask must not include
+ *  EVENT_MASK(0), the task_terminate event.
+ */
+eventmask_t
+vexSleepEvents( eventmask_t mask, int32_t msec )
+{
+    eventmask_t events;
+
+    // MS2ST(0) is not TIME_IMMEDIATE
+    events = chEvtWaitAnyTimeout( ALL_EVENTS, (msec > 0) ? MS2ST(msec) : TIME_IMMEDIATE );
+    vexSleepExit( events & ~mask );
+
+    return( events & mask );
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Start a periodic loop for the calling thread                   */
+/** @param[in]  p pointer to storage for the loop timing                       */
+/** @param[in]  msec the loop period in ms                                     */
+/*-----------------------------------------------------------------------------*/
+/**
+ *  @details
+ *  Call after vexTaskRegister, the timing is then shown by the task list.
+ *  p must not be on the stack of the thread.
+ */
+void
+vexPeriodicInit( vexPeriodic *p, int32_t msec )
+{
+    int16_t     i;
+
+    p->period   = MS2ST(msec);
+    p->deadline = chTimeNow();
+    p->cycles   = 0;
+    p->overruns = 0;
+    p->lateness = 0;
+
+    if( (i = vexTaskSlot( chThdSelf() )) >= 0 )
+        myThreads[ i ].periodic = p;
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Wait for the start of the next period                          */
+/** @param[in]  p pointer to the loop timing                                   */
+/*-----------------------------------------------------------------------------*/
+/**
+ *  @details
+ *  Deadlines are absolute so time spent in the loop does not add up as drift.
+ *  If the loop ran past the deadline the missed periods are skipped rather
+ *  than run back to back. Waits on events like vexSleep, chThdSleepUntil can
+ *  not be woken by the terminate event.
+ */
+void
+vexPeriodicWait( vexPeriodic *p )
+{
+    int32_t     late;
+    int32_t     remaining;
+    eventmask_t events;
+
+    p->cycles++;
+    p->deadline += p->period;
+
+    // overrun, move to the next deadline keeping the phase
+    late = (int32_t)(chTimeNow() - p->deadline);
+    if( late > 0 )
+        {
+        p->overruns++;
+        if( late > p->lateness )
+            p->lateness = late;
+        p->deadline += ((late / p->period) + 1) * p->period;
+        }
+
+    // never pass a negative time to the wait, it would be read as ~49 days
+    remaining = (int32_t)(p->deadline - chTimeNow());
+    if( remaining > 0 )
+        events = chEvtWaitAnyTimeout( ALL_EVENTS, (systime_t)remaining );
+    else
+        events = chEvtWaitAnyTimeout( ALL_EVENTS, TIME_IMMEDIATE );
+
+    // how late we were woken
+    late = (int32_t)(chTimeNow() - p->deadline);
+    if( late > p->lateness )
+        p->lateness = late;
+
+    vexSleepExit( events );
+}
+
 /*-----------------------------------------------------------------------------*/
 /*  Stack and working area for the user threads, autonomous or drover control  */
 /*  only one if these can be active so re-use space                            */
@@ -332,13 +736,39 @@ vexSleep( int32_t msec )
 static  WORKING_AREA(waVexUserTask, USER_TASK_STACK_SIZE);
 
 /*-----------------------------------------------------------------------------*/
-/*  Task that runs every 15mS and monitors competition state                   */
+/*  Entry for the user thread, arg is vexAutonomous or vexOperator             */
+/*-----------------------------------------------------------------------------*/
+static msg_t
+vexCortexUserTask(void *arg)
+{
+    // time from the packet that started this mode to the user code running
+    modeLatency.start = halGetCounterValue() - vexSpiStateTimeGet();
+    if( modeLatency.start > modeLatency.startMax )
+        modeLatency.startMax = modeLatency.start;
+
+    return( ((tfunc_t)arg)( NULL ) );
+}
+
+/*-----------------------------------------------------------------------------*/
+/*  Wait for the next competition state change, or 16mS if there is none       */
+/*-----------------------------------------------------------------------------*/
+static void
+vexCortexMonitorWait(void)
+{
+    // the timeout covers emergency stop and no master processor
+    chEvtWaitAnyTimeout( ALL_EVENTS, MS2ST(16) );
+}
+
+/*-----------------------------------------------------------------------------*/
+/*  Task that waits for competition state changes and starts the user thread   */
 /*-----------------------------------------------------------------------------*/
 
 static WORKING_AREA(waVexCortexMonitorTask, MONITOR_TASK_STACK_SIZE);
 static msg_t
 vexCortexMonitorTask(void *arg)
 {
+    static EventListener stateListener;
+    static EventListener estopListener;
     uint16_t    i;
     Thread  *tp = NULL;
     uint16_t    state;
@@ -348,12 +778,19 @@ vexCortexMonitorTask(void *arg)
     chRegSetThreadName("monitor");
     chEvtInit(&task_terminate);
 
+    // vexSpiSend tells us about competition state changes
+    chEvtRegisterMask( vexSpiStateEventGet(), &stateListener, EVENT_MASK(0) );
+    // and emergency stop starts the teardown straight away
+    chEvtRegisterMask( &emergency_stop, &estopListener, EVENT_MASK(1) );
+
     // clear event listeners
     for(i=0;i<MAX_THREAD;i++)
         {
         myThreads[ i ].tp = (Thread *)0;
         myThreads[ i ].persistent = FALSE;
+        myThreads[ i ].periodic = NULL;
         }
+    myThreadsFree = (1UL << MAX_THREAD) - 1;
 
     // wait until all the master cpu resets are done
     // it issues two additional resets after power on
@@ -378,64 +815,74 @@ vexCortexMonitorTask(void *arg)
 
     while (TRUE)
         {
-        chThdSleepMilliseconds(16);
-
-        // If enabled
-        if( (vexControllerCompetitonState() & kFlagDisabled ) != kFlagDisabled )
+        // Nothing starts while emergency stopped or disabled, after a
+        // teardown the next mode starts straight away
+        if( vexKillAll || (vexControllerCompetitonState() & kFlagDisabled ) == kFlagDisabled )
             {
-            if( (vexControllerCompetitonState() & kFlagAutonomousMode ) != kFlagAutonomousMode )
-                {
-                // Operator control
-                // Start the operator thread at higher than normal priority
-                tp = chThdCreateStatic(waVexUserTask, sizeof(waVexUserTask), USER_THREAD_PRIORITY, vexOperator, NULL);
-                state = 0;
-                }
-            else
-                {
-                // Autonomous
-                // Start the operator thread at higher than normal priority
-                tp = chThdCreateStatic(waVexUserTask, sizeof(waVexUserTask), USER_THREAD_PRIORITY, vexAutonomous, NULL);
-                state = kFlagAutonomousMode;
-                }
+            vexCortexMonitorWait();
+            continue;
+            }
 
-            // While we are enabled, either auton or operator, wait here unless kill all flag is set
-            while( (vexControllerCompetitonState() & (kFlagDisabled | kFlagAutonomousMode)) == state )
-               {
-               chThdSleepMilliseconds(16);
+        // persistent threads switch over now, before the user thread starts
+        vexModeSet( vexControllerCompetitonState() );
 
-               // Emergency stop
-               if( vexKillAll )
-                   break;
-               }
+        if( (vexControllerCompetitonState() & kFlagAutonomousMode ) != kFlagAutonomousMode )
+            {
+            // Operator control
+            // Start the operator thread at higher than normal priority
+            tp = chThdCreateStatic(waVexUserTask, sizeof(waVexUserTask), USER_THREAD_PRIORITY, vexCortexUserTask, (void *)vexOperator);
+            state = 0;
+            }
+        else
+            {
+            // Autonomous
+            // Start the operator thread at higher than normal priority
+            tp = chThdCreateStatic(waVexUserTask, sizeof(waVexUserTask), USER_THREAD_PRIORITY, vexCortexUserTask, (void *)vexAutonomous);
+            state = kFlagAutonomousMode;
+            }
 
-            // Broadcast termination event
-            chThdSleepMilliseconds(50);
-            chSysLock();
-            if( chEvtIsListeningI(&task_terminate) )
-                chEvtBroadcastI(&task_terminate);
-            chSysUnlock();
-            chThdSleepMilliseconds(50);
+        // While we are enabled, either auton or operator, wait here unless kill all flag is set
+        while( (vexControllerCompetitonState() & (kFlagDisabled | kFlagAutonomousMode)) == state )
+           {
+           vexCortexMonitorWait();
 
-            // wait for termination
-            chThdWait( tp );
+           // Emergency stop
+           if( vexKillAll )
+               break;
+           }
 
-            // stop all motors
-            vexMotorStopAll();
+        // Broadcast termination event
+        chSysLock();
+        if( chEvtIsListeningI(&task_terminate) )
+            chEvtBroadcastI(&task_terminate);
+        chSysUnlock();
 
-            // wait for all threads to stop
-            for(i=0;i<MAX_THREAD;i++)
+        // wait for termination
+        chThdWait( tp );
+
+        // wait for all threads to stop
+        for(i=0;i<MAX_THREAD;i++)
+            {
+            if( ( myThreads[ i ].tp != 0 ) && (myThreads[ i ].persistent == FALSE) )
                 {
-                if( ( myThreads[ i ].tp != 0 ) && (myThreads[ i ].persistent == FALSE) )
-                    {
-                    chThdWait( myThreads[ i ].tp );
-                    myThreads[ i ].tp = (Thread *)0;
-                    }
+                chThdWait( myThreads[ i ].tp );
+                vexTaskSlotFree( i );
                 }
-
-            // We are done
-            while( vexKillAll )
-                chThdSleepMilliseconds(50);
             }
+
+        // stop all motors, nothing from the old mode can drive them now
+        vexMotorStopAll();
+
+        // persistent threads take over last, the old mode threads are
+        // gone and cannot undo what the mode callbacks set up
+        if( vexKillAll )
+            vexModeSet( kFlagDisabled );
+        else
+            vexModeSet( vexControllerCompetitonState() );
+
+        // We are done
+        while( vexKillAll )
+            chThdSleepMilliseconds(50);
         }
 
     return (msg_t)0;
@@ -452,6 +899,8 @@ static msg_t
 vexCortexSystemTask(void *arg) {
       (void)arg;
       int16_t   m;
+      bool_t    stopped;
+      bool_t    button = FALSE;
 
       chRegSetThreadName("system");
 
@@ -466,11 +915,32 @@ vexCortexSystemTask(void *arg) {
 
           // get motor data
           // motor data 1 through 8 goes to spi slots 0 to 7
+          // locked so an emergency stop cannot land half way through
+          chSysLock();
           for(m=0;m<8;m++)
               vexSpiSetMotor( m, vexMotorGet( m+1 ), vexMotorDirectionGet(m+1) );
+          stopped = vexMotorEmergencyGet();
+          chSysUnlock();
 
           // comms to master
           vexSpiSend();
+
+          // first frame with the motors stopped has gone
+          if( stopped )
+              vexMotorEmergencyFrameSent();
+
+          // emergency stop button, on the press only
+          if( vexEmergencyButton >= 0 )
+              {
+              if( vexControllerGet( (tCtlIndex)vexEmergencyButton ) )
+                  {
+                  if( !button )
+                      vexTaskEmergencyStop();
+                  button = TRUE;
+                  }
+              else
+                  button = FALSE;
+              }
 #ifdef    VEX_WATCHDOG_ENABLE
           vexWatchdogReload();
 #endif
@@ -486,6 +956,9 @@ vexCortexSystemTask(void *arg) {
 void
 vexCortexInit()
 {
+    // Start the microsecond timebase before anything is stamped with it
+    vexTimeInit();
+
     // Init SPI communications
     vexSpiInit();
 
@@ -158,6 +158,86 @@ vexDigitalPinGet( tVexDigitalPin pin )
 
 
 
+/*-----------------------------------------------------------------------------*/
+/*  Pin that triggers emergency stop                                           */
+/*-----------------------------------------------------------------------------*/
+static  tVexDigitalPin  vexDigitalEmergencyPin = kVexDigital_None;
+
+/*-----------------------------------------------------------------------------*/
+/*  Edges queued for a thread, every producer runs at the EXT priority         */
+/*-----------------------------------------------------------------------------*/
+static  vexDigitalEvent vexDigitalEvents[VEX_DIGITAL_EVENTS];
+static  VEXRING_DECL( vexDigitalEventRing, vexDigitalEvents, VEX_DIGITAL_EVENTS );
+static  bool_t          vexDigitalEventsEnabled = FALSE;
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Queue an edge, called from the EXT interrupt handlers          */
+/** @param[in]  pin The pin                                                    */
+/** @param[in]  level The pin state after the edge                             */
+/** @param[in]  value Encoder or interrupt count after the edge                */
+/** @param[in]  time vexTimeUs when the interrupt ran                          */
+/*-----------------------------------------------------------------------------*/
+
+void
+_vexDigitalEventPut( tVexDigitalPin pin, int16_t level, int32_t value, uint32_t time )
+{
+    vexDigitalEvent e;
+
+    if( !vexDigitalEventsEnabled )
+        return;
+
+    e.time  = time;
+    e.value = value;
+    e.pin   = (uint8_t)pin;
+    e.level = (uint8_t)level;
+
+    vexRingPut( &vexDigitalEventRing, &e );
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Start or stop queuing digital events                           */
+/** @param[in]  enable TRUE to queue edges                                     */
+/*-----------------------------------------------------------------------------*/
+/** @details
+ *  Events are off by default so the interrupt handlers stay as short as
+ *  possible, anything left queued is dropped when they are turned on. Call
+ *  it from the thread that takes the events.
+ */
+
+void
+vexDigitalEventEnable( bool_t enable )
+{
+    vexDigitalEventsEnabled = FALSE;
+    vexRingFlush( &vexDigitalEventRing );
+    vexDigitalEventsEnabled = enable;
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Get the oldest digital event                                   */
+/** @param[out] e The event                                                    */
+/** @returns    FALSE if there are none                                        */
+/*-----------------------------------------------------------------------------*/
+/** @details
+ *  Only one thread may take events, the queue holds VEX_DIGITAL_EVENTS and
+ *  edges are counted in vexDigitalEventDropsGet once it is full.
+ */
+
+bool_t
+vexDigitalEventGet( vexDigitalEvent *e )
+{
+    return( vexRingGet( &vexDigitalEventRing, e ) );
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Number of edges that found the event queue full                */
+/*-----------------------------------------------------------------------------*/
+
+uint32_t
+vexDigitalEventDropsGet()
+{
+    return( vexDigitalEventRing.drops );
+}
+
 /*-----------------------------------------------------------------------------*/
 /*  Callback for digital interrupt                                             */
 /*-----------------------------------------------------------------------------*/
@@ -165,11 +245,12 @@ vexDigitalPinGet( tVexDigitalPin pin )
 static void
 _vi_cb(EXTDriver *extp, expchannel_t channel)
 {
+    // stamp the edge before anything else
+    uint32_t time = vexTimeUs();
+
     (void)extp;
     (void)channel;
 
-    chSysLockFromIsr();
-
     int pin;
     for(pin=0;pin<kVexDigital_Num;pin++)
         {
@@ -177,13 +258,23 @@ _vi_cb(EXTDriver *extp, expchannel_t channel)
             {
             if( vexioDefinition[pin].intrCount >= 0 )
                 {
+                // only written here, at the EXT priority, so no lock
                 vexioDefinition[pin].intrCount++;
+
+                // stop motors before anything else can run
+                if( pin == vexDigitalEmergencyPin )
+                    {
+                    chSysLockFromIsr();
+                    vexTaskEmergencyStopI();
+                    chSysUnlockFromIsr();
+                    }
+
+                _vexDigitalEventPut( pin, palReadPad( vexioDefinition[pin].port, vexioDefinition[pin].pad ),
+                                     vexioDefinition[pin].intrCount, time );
                 break;
                 }
             }
         }
-
-    chSysUnlockFromIsr();
 }
 
 /*-----------------------------------------------------------------------------*/
@@ -212,6 +303,25 @@ vexDigitalIntrSet( tVexDigitalPin pin )
     vexioDefinition[pin].intrCount = 0;
 }
 
+/*-----------------------------------------------------------------------------*/
+/** @brief      Set digital pin to trigger emergency stop                      */
+/** @param[in]  pin The pin                                                    */
+/*-----------------------------------------------------------------------------*/
+/** @details
+ *  Call from vexUserSetup.  Either edge stops all motors from the interrupt,
+ *  so a normally closed switch also stops if its wire comes out.
+ */
+
+void
+vexDigitalEmergencyStopSet( tVexDigitalPin pin )
+{
+    if( (pin < kVexDigital_1) || (pin > kVexDigital_12) )
+        return;
+
+    vexDigitalIntrSet( pin );
+    vexDigitalEmergencyPin = pin;
+}
+
 /*-----------------------------------------------------------------------------*/
 /** @brief      Enable any digital pin interrupts                              */
 /*-----------------------------------------------------------------------------*/
@@ -182,6 +182,18 @@ typedef struct _ioDef {
     int32_t         intrCount;
 } ioDef;
 
+/*-----------------------------------------------------------------------------*/
+/** @brief      A timestamped edge on a digital interrupt or encoder pin       */
+/*-----------------------------------------------------------------------------*/
+typedef struct _vexDigitalEvent {
+    uint32_t        time;       ///< vexTimeUs when the interrupt ran
+    int32_t         value;      ///< encoder count or interrupt count
+    uint8_t         pin;        ///< tVexDigitalPin
+    uint8_t         level;      ///< pin state after the edge
+} vexDigitalEvent;
+
+#define VEX_DIGITAL_EVENTS  32  ///< queued events, a power of two
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -198,6 +210,13 @@ tVexDigitalState    vexDigitalPinGet( tVexDigitalPin pin );
 void                vexDigitalIntrSet( tVexDigitalPin pin );
 void                vexDigitalIntrRun(void);
 int32_t             vexDigitalIntrCountGet( tVexDigitalPin pin );
+void                vexDigitalEmergencyStopSet( tVexDigitalPin pin );
+
+void                vexDigitalEventEnable( bool_t enable );
+bool_t              vexDigitalEventGet( vexDigitalEvent *e );
+uint32_t            vexDigitalEventDropsGet(void);
+/** @private                                                                   */
+void                _vexDigitalEventPut( tVexDigitalPin pin, int16_t level, int32_t value, uint32_t time );
 
 // External interrupts
 void                vexExtIrqInit(void);
@@ -67,11 +67,17 @@ static  vexQuadEncoder_t    vexQuadEncoders[kVexQuadEncoder_Num];
 /*  call either the A or B service routine depending on which of the two       */
 /*  encoder inputs is being serviced.                                          */
 /*                                                                             */
+/*  The count is only written by these handlers, they all run at the EXT       */
+/*  priority and cannot preempt each other so no lock is needed. Threads       */
+/*  only read it, a 32 bit read is atomic. Each edge is stamped with the uS    */
+/*  timebase and also queued as a digital event when those are enabled.        */
+/*                                                                             */
 /*-----------------------------------------------------------------------------*/
 
 static inline void
 vexEncoderIrqServiceA( vexQuadEncoder_t *enc )
 {
+    uint32_t time = vexTimeUs();
     int16_t pa;
     int16_t pb;
 
@@ -81,6 +87,9 @@ vexEncoderIrqServiceA( vexQuadEncoder_t *enc )
 
     // we were interrupted by pa
     if( pa ^ pb )enc->count--; else enc->count++;
+    enc->time = time;
+
+    _vexDigitalEventPut( enc->pa, pa, enc->count, time );
 }
 
 /*-----------------------------------------------------------------------------*/
@@ -89,6 +98,7 @@ vexEncoderIrqServiceA( vexQuadEncoder_t *enc )
 static inline void
 vexEncoderIrqServiceB( vexQuadEncoder_t *enc )
 {
+    uint32_t time = vexTimeUs();
     int16_t pa;
     int16_t pb;
 
@@ -98,6 +108,9 @@ vexEncoderIrqServiceB( vexQuadEncoder_t *enc )
 
     // we were interrupted by pb
     if( pa ^ pb )enc->count++; else enc->count--;
+    enc->time = time;
+
+    _vexDigitalEventPut( enc->pb, pb, enc->count, time );
 }
 
 /*-----------------------------------------------------------------------------*/
@@ -109,12 +122,8 @@ _vqe_1_cb_a(EXTDriver *extp, expchannel_t channel)
     (void)extp;
     (void)channel;
 
-    chSysLockFromIsr();
-
     // service encoder
     vexEncoderIrqServiceA( &vexQuadEncoders[kVexQuadEncoder_1] );
-
-    chSysUnlockFromIsr();
 }
 
 /*-----------------------------------------------------------------------------*/
@@ -126,12 +135,8 @@ _vqe_1_cb_b(EXTDriver *extp, expchannel_t channel)
     (void)extp;
     (void)channel;
 
-    chSysLockFromIsr();
-
     // service encoder
     vexEncoderIrqServiceB( &vexQuadEncoders[kVexQuadEncoder_1] );
-
-    chSysUnlockFromIsr();
 }
 
 /*-----------------------------------------------------------------------------*/
@@ -143,12 +148,8 @@ _vqe_2_cb_a(EXTDriver *extp, expchannel_t channel)
     (void)extp;
     (void)channel;
 
-    chSysLockFromIsr();
-
     // service encoder
     vexEncoderIrqServiceA( &vexQuadEncoders[kVexQuadEncoder_2] );
-
-    chSysUnlockFromIsr();
 }
 
 /*-----------------------------------------------------------------------------*/
@@ -160,12 +161,8 @@ _vqe_2_cb_b(EXTDriver *extp, expchannel_t channel)
     (void)extp;
     (void)channel;
 
-    chSysLockFromIsr();
-
     // service encoder
     vexEncoderIrqServiceB( &vexQuadEncoders[kVexQuadEncoder_2] );
-
-    chSysUnlockFromIsr();
 }
 
 /*-----------------------------------------------------------------------------*/
@@ -177,12 +174,8 @@ _vqe_3_cb_a(EXTDriver *extp, expchannel_t channel)
     (void)extp;
     (void)channel;
 
-    chSysLockFromIsr();
-
     // service encoder
     vexEncoderIrqServiceA( &vexQuadEncoders[kVexQuadEncoder_3] );
-
-    chSysUnlockFromIsr();
 }
 
 /*-----------------------------------------------------------------------------*/
@@ -194,12 +187,8 @@ _vqe_3_cb_b(EXTDriver *extp, expchannel_t channel)
     (void)extp;
     (void)channel;
 
-    chSysLockFromIsr();
-
     // service encoder
     vexEncoderIrqServiceB( &vexQuadEncoders[kVexQuadEncoder_3] );
-
-    chSysUnlockFromIsr();
 }
 
 static void
@@ -208,12 +197,8 @@ _vqe_4_cb_a(EXTDriver *extp, expchannel_t channel)
     (void)extp;
     (void)channel;
 
-    chSysLockFromIsr();
-
     // service encoder
     vexEncoderIrqServiceA( &vexQuadEncoders[kVexQuadEncoder_4] );
-
-    chSysUnlockFromIsr();
 }
 
 /*-----------------------------------------------------------------------------*/
@@ -225,12 +210,8 @@ _vqe_4_cb_b(EXTDriver *extp, expchannel_t channel)
     (void)extp;
     (void)channel;
 
-    chSysLockFromIsr();
-
     // service encoder
     vexEncoderIrqServiceB( &vexQuadEncoders[kVexQuadEncoder_4] );
-
-    chSysUnlockFromIsr();
 }
 
 static void
@@ -239,12 +220,8 @@ _vqe_5_cb_a(EXTDriver *extp, expchannel_t channel)
     (void)extp;
     (void)channel;
 
-    chSysLockFromIsr();
-
     // service encoder
     vexEncoderIrqServiceA( &vexQuadEncoders[kVexQuadEncoder_5] );
-
-    chSysUnlockFromIsr();
 }
 
 /*-----------------------------------------------------------------------------*/
@@ -256,12 +233,8 @@ _vqe_5_cb_b(EXTDriver *extp, expchannel_t channel)
     (void)extp;
     (void)channel;
 
-    chSysLockFromIsr();
-
     // service encoder
     vexEncoderIrqServiceB( &vexQuadEncoders[kVexQuadEncoder_5] );
-
-    chSysUnlockFromIsr();
 }
 
 /*-----------------------------------------------------------------------------*/
@@ -406,6 +379,41 @@ vexEncoderGet( int16_t channel )
     return( vexQuadEncoders[channel].count - vexQuadEncoders[channel].offset );
 }
 
+/*-----------------------------------------------------------------------------*/
+/** @brief      Get encoder count and the time of the edge that set it         */
+/** @param[in]  channel The encoder channel                                    */
+/** @param[out] time vexTimeUs of the last edge                                */
+/** @returns    The encoder count                                              */
+/*-----------------------------------------------------------------------------*/
+/** @details
+ *  Velocity from the edge times is not limited by when the caller happens
+ *  to run. The pair is read again if an edge arrived in between, so the
+ *  time always belongs to the count.
+ */
+
+int32_t
+vexEncoderGetWithTime( int16_t channel, uint32_t *time )
+{
+    vexQuadEncoder_t   *enc;
+    uint32_t            t;
+    int32_t             count;
+
+    if( channel < 0 || channel >= kVexQuadEncoder_Num )
+        {
+        *time = 0;
+        return(0);
+        }
+
+    enc = &vexQuadEncoders[channel];
+    do  {
+        t     = enc->time;
+        count = enc->count;
+        } while( t != enc->time );
+
+    *time = t;
+    return( count - enc->offset );
+}
+
 /*-----------------------------------------------------------------------------*/
 /** @brief      Get encoder count                                              */
 /** @param[in]  channel The encoder channel                                    */
@@ -75,6 +75,7 @@ typedef enum {
 
 typedef struct _vexQuadEncoder_t {
     volatile int32_t  count;      ///< current encoder count
+    volatile uint32_t time;       ///< vexTimeUs of the last edge
     int32_t           offset;     ///< current encoder offset (subtracted from count)
     int16_t           state;      ///< flag iondicating encoder is installed
     tVexDigitalPin    pa;         ///< Encoder digital pin a
@@ -96,6 +97,7 @@ void                vexEncoderStart( tVexQuadEncoderChannel channel );
 void                vexEncoderStop( tVexQuadEncoderChannel channel );
 void                vexEncoderStartAll(void);
 int32_t             vexEncoderGet( int16_t channel );
+int32_t             vexEncoderGetWithTime( int16_t channel, uint32_t *time );
 void                vexEncoderSet( int16_t channel, int32_t value );
 int16_t             vexEncoderGetId( int16_t channel );
 void                vexEncoderDebug(vexStream *chp, int argc, char *argv[]);
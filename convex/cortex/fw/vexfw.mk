@@ -4,6 +4,9 @@ VEXFWSRC = ${CONVEX}/fw/vexshell.c \
            ${CONVEX}/fw/vexdigital.c \
            ${CONVEX}/fw/vexconfig.c \
            ${CONVEX}/fw/vexext.c \
+           ${CONVEX}/fw/vexring.c \
+           ${CONVEX}/fw/vextime.c \
+           ${CONVEX}/fw/vexstack.c \
            ${CONVEX}/fw/vexencoder.c \
            ${CONVEX}/fw/vexsonar.c \
            ${CONVEX}/fw/vexmotor.c \
@@ -92,6 +92,56 @@ vexImeGetCount( int16_t channel )
         return(0);
 }
 
+/*-----------------------------------------------------------------------------*/
+/** @brief      return the time the encoder count was read                     */
+/** @param[in]  channel The encoder channel                                    */
+/** @returns    vexTimeUs half way through the I2C read                        */
+/** @note  channel is int16_t to allow this function to be used in callbacks   */
+/*-----------------------------------------------------------------------------*/
+
+uint32_t
+vexImeGetTime( int16_t channel )
+{
+    if( (tVexImeChannels)channel > kImeChannel_8 )
+        return(0);
+
+    if( vexImes.imes[channel].valid )
+        return( vexImes.imes[channel].time );
+    else
+        return(0);
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      return encoder count and the time it was read                  */
+/** @param[in]  channel The encoder channel                                    */
+/** @param[out] time vexTimeUs half way through the I2C read                   */
+/** @returns    The encoder count - the offset                                 */
+/** @note  channel is int16_t to allow this function to be used in callbacks   */
+/*-----------------------------------------------------------------------------*/
+/** @details
+ *  The IME task writes the pair under the lock, so the time always belongs
+ *  to the count.
+ */
+
+int32_t
+vexImeGetCountWithTime( int16_t channel, uint32_t *time )
+{
+    int32_t     count;
+
+    if( ((tVexImeChannels)channel > kImeChannel_8) || !vexImes.imes[channel].valid )
+        {
+        *time = 0;
+        return(0);
+        }
+
+    chSysLock();
+    count = vexImes.imes[channel].count;
+    *time = vexImes.imes[channel].time;
+    chSysUnlock();
+
+    return( count - vexImes.imes[channel].offset );
+}
+
 /*-----------------------------------------------------------------------------*/
 /** @brief      sets encoder count (stores an offset)                          */
 /** @param[in]  channel The encoder channel                                    */
@@ -358,6 +408,8 @@ msg_t
 vexIMEUpdateCounts( imeData *ime )
 {
     msg_t status = RDY_OK;
+    uint32_t stamp;
+    int32_t  count;
 
     if(ime == NULL)
         return(0);
@@ -365,16 +417,20 @@ vexIMEUpdateCounts( imeData *ime )
     // one more message
     ime->data_polls++;
 
-    // get new data
+    // get new data, the count was latched somewhere during the transfer
+    stamp = vexTimeUs();
     if( (status = vexIMEGetData( ime->address, ime->enc_data )) == RDY_OK )
         {
+        stamp += (vexTimeUs() - stamp) / 2;
+
         // 32 bit counter, 48 seems over the top
-        ime->count    =  ((long)ime->enc_data[0] << 8) | ((long)ime->enc_data[1] << 0) | ((long)ime->enc_data[2] << 24) | ((long)ime->enc_data[3] << 16);
+        count         =  ((long)ime->enc_data[0] << 8) | ((long)ime->enc_data[1] << 0) | ((long)ime->enc_data[2] << 24) | ((long)ime->enc_data[3] << 16);
         ime->velocity =  ((long)ime->enc_data[4] << 8) + ((long)ime->enc_data[5] << 0);
 
         if(ime->old_count != IME_COUNT_RESET )
             {
-            ime->delta_count =  ime->count - ime->old_count;
+            ime->delta_count =  count - ime->old_count;
+            ime->delta_time  =  stamp - ime->time;
 
             // calculate rpm based on IME velocity data
             if(ime->velocity != 0)
@@ -383,8 +439,13 @@ vexIMEUpdateCounts( imeData *ime )
                 ime->rpm = 0;
             }
 
-        ime->old_count = ime->count;
+        // count and time change together for vexImeGetCountWithTime
+        chSysLock();
+        ime->count     = count;
+        ime->time      = stamp;
+        chSysUnlock();
 
+        ime->old_count = count;
         }
     else
         {
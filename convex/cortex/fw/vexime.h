@@ -130,6 +130,8 @@ typedef struct _imeData {
     int32_t     offset;         ///< an offset that id deducted from count
     int32_t     velocity;       ///< velocity data from IME
     int32_t     delta_count;    ///< change in count from last time read
+    uint32_t    time;           ///< vexTimeUs when count was read
+    uint32_t    delta_time;     ///< uS between the last two reads
     int32_t     rpm;            ///< calculated rpm (not tested yet)
 
     int32_t     old_count;      ///< count from last poll
@@ -175,6 +177,8 @@ typedef struct _vexImeData {
 
 /*-----------------------------------------------------------------------------*/
 int32_t     vexImeGetCount( int16_t channel );
+uint32_t    vexImeGetTime( int16_t channel );
+int32_t     vexImeGetCountWithTime( int16_t channel, uint32_t *time );
 void        vexImeSetCount( int16_t channel, int32_t value );
 int16_t     vexImeGetId( int16_t channel );
 int16_t     vexImeGetChannelMax(void);
@@ -77,6 +77,9 @@ static  char        lcd_buffer[LCD_BUF_MAX];
 // stack for thread
 static WORKING_AREA(waVexLcdUpdate, LCD_TASK_STACK_SIZE);
 
+// loop timing for the update thread, one period for each line
+static vexPeriodic  vexLcdPeriodic;
+
 /*-----------------------------------------------------------------------------*/
 /*  LCD update thread                                                          */
 /*-----------------------------------------------------------------------------*/
@@ -87,6 +90,7 @@ VexLcdUpdate(void *arg) {
   (void)arg;
   chRegSetThreadName("lcd");
 
+  vexPeriodicInit( &vexLcdPeriodic, 25 );
   while (TRUE) {
         // send data for line 0
         if( vexLcdData[0].enabled )
@@ -94,7 +98,7 @@ VexLcdUpdate(void *arg) {
         if( vexLcdData[1].enabled )
             vexLcdSendMessage( &vexLcdData[1], 0 );
 
-        chThdSleepMilliseconds(25);
+        vexPeriodicWait( &vexLcdPeriodic );
 
         // check for received message from last time
         if( vexLcdData[0].enabled )
@@ -108,7 +112,7 @@ VexLcdUpdate(void *arg) {
         if( vexLcdData[1].enabled )
             vexLcdSendMessage( &vexLcdData[1], 1 );
 
-        chThdSleepMilliseconds(25);
+        vexPeriodicWait( &vexLcdPeriodic );
 
         // check for received message from last time
         if( vexLcdData[0].enabled )
@@ -70,6 +70,9 @@ static  int16_t   m0_new_value = 0;
 static  int16_t   m9_cur_value = 0;
 static  int16_t   m9_new_value = 0;
 
+// emergency stop latch, once set only zero can be commanded
+static  vexMotorEmergency vexEmergency = { FALSE, 0, 0, 0, 0 };
+
 /*-----------------------------------------------------------------------------*/
 /** @brief      Initialize the motors                                          */
 /*-----------------------------------------------------------------------------*/
@@ -85,6 +88,7 @@ vexMotorInit()
         vexMotors[i].type  = kVexMotorUndefined;
         vexMotors[i].reversed = FALSE;
         vexMotors[i].motorPositionGet = NULL;
+        vexMotors[i].motorPositionGetWithTime = NULL;
         vexMotors[i].motorPositionSet = NULL;
         }
 
@@ -116,8 +120,13 @@ vexMotorSet( int16_t index, int16_t value )
     if( value < (-127))
         value = -127;
 
-    // save limited value in array
+    // save limited value in array, nothing but stop while the
+    // emergency stop is latched
+    chSysLock();
+    if( vexEmergency.latched )
+        value = 0;
     vexMotors[ index ].value = value;
+    chSysUnlock();
 }
 
 /*-----------------------------------------------------------------------------*/
@@ -148,6 +157,86 @@ vexMotorStopAll()
         vexMotorSet( i, 0);
 }
 
+/*-----------------------------------------------------------------------------*/
+/** @brief      Latch the emergency stop and zero every motor output           */
+/** @note       Call from an ISR or with the system locked                     */
+/*-----------------------------------------------------------------------------*/
+/** @details
+ *  Ports 1 and 10 are written directly rather than waiting for the next pwm
+ *  interrupt, there is no transition through 0 to wait for when stopping.
+ *  The SPI buffer is zeroed so the frame the system task sends next stops
+ *  ports 2 through 9, it cannot load anything else while the stop is
+ *  latched.  The stop stays latched until vexMotorEmergencyClear is called.
+ */
+
+void
+vexMotorEmergencyStopI()
+{
+    int16_t i;
+
+    vexEmergency.trigger = halGetCounterValue();
+    vexEmergency.latched = TRUE;
+
+    for(i=kVexMotor_1;i<kVexMotorNum;i++)
+        vexMotors[i].value = 0;
+
+    _vexMotorPwmSet_0( 0 );
+    _vexMotorPwmSet_9( 0 );
+    m0_cur_value = 0;
+    m9_cur_value = 0;
+
+    for(i=0;i<8;i++)
+        vexSpiSetMotor( i, 0, vexMotors[i+1].reversed );
+
+    vexEmergency.pwm   = halGetCounterValue() - vexEmergency.trigger;
+    vexEmergency.frame = 0;
+    vexEmergency.count++;
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Release the emergency stop latch                               */
+/*-----------------------------------------------------------------------------*/
+
+void
+vexMotorEmergencyClear()
+{
+    vexEmergency.latched = FALSE;
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Get the emergency stop latch                                   */
+/** @returns    TRUE if the emergency stop is latched                          */
+/*-----------------------------------------------------------------------------*/
+
+bool_t
+vexMotorEmergencyGet()
+{
+    return( vexEmergency.latched );
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Record the time the first stopped SPI frame was sent           */
+/** @note       Called by the system task after a frame loaded while latched   */
+/*-----------------------------------------------------------------------------*/
+
+void
+vexMotorEmergencyFrameSent()
+{
+    if( vexEmergency.latched && vexEmergency.frame == 0 )
+        vexEmergency.frame = halGetCounterValue() - vexEmergency.trigger;
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Get pointer to the emergency stop state                        */
+/** @returns    A pointer to the vexMotorEmergency structure                   */
+/*-----------------------------------------------------------------------------*/
+
+vexMotorEmergency *
+vexMotorEmergencyGetPtr()
+{
+    return( &vexEmergency );
+}
+
 /*-----------------------------------------------------------------------------*/
 /** @brief      Save motor type                                                */
 /** @param[in]  index The motor index                                          */
@@ -268,6 +357,46 @@ vexMotorPositionGet( int16_t index )
         return(0);
 }
 
+/*-----------------------------------------------------------------------------*/
+/** @brief      Get the motor position and the time it was measured            */
+/** @param[in]  index The motor index                                          */
+/** @param[out] time vexTimeUs of the sensor sample                            */
+/** @returns    The motor position                                             */
+/*-----------------------------------------------------------------------------*/
+/** @details
+ *  The time comes from the sensor, the last encoder edge or the IME read.
+ *  Without a timed callback it is the time of this call.
+ */
+
+int32_t
+vexMotorPositionGetWithTime( int16_t index, uint32_t *time )
+{
+    int32_t     position;
+
+    if( (index < kVexMotor_1) || (index >= kVexMotorNum))
+        {
+        *time = 0;
+        return(0);
+        }
+
+    if( vexMotors[ index ].motorPositionGetWithTime == NULL )
+        {
+        *time = vexTimeUs();
+        return( vexMotorPositionGet( index ) );
+        }
+
+    position = vexMotors[ index ].motorPositionGetWithTime( vexMotors[ index ].port, time );
+
+    // 269 needs reversing
+    if( vexMotors[ index ].type == kVexMotor269 )
+        position = -position;
+
+    if(!vexMotors[ index ].reversed )
+        return( position );
+    else
+        return( -position );
+}
+
 /*-----------------------------------------------------------------------------*/
 /** @brief      Set the callback used to get motor position                    */
 /** @param[in]  index The motor index                                          */
@@ -285,6 +414,23 @@ vexMotorPositionGetCallback( int16_t index, int32_t (*cb)(int16_t), int16_t port
     vexMotors[ index ].port = port;
 }
 
+/*-----------------------------------------------------------------------------*/
+/** @brief      Set the callback used to get motor position and sample time    */
+/** @param[in]  index The motor index                                          */
+/** @param[in]  cb function used to get motor position and time               */
+/** @param[in]  port A variable to send to the callback                        */
+/*-----------------------------------------------------------------------------*/
+
+void
+vexMotorPositionTimeCallback( int16_t index, int32_t (*cb)(int16_t, uint32_t *), int16_t port )
+{
+    if( (index < kVexMotor_1) || (index >= kVexMotorNum))
+        return;
+
+    vexMotors[ index ].motorPositionGetWithTime = cb;
+    vexMotors[ index ].port = port;
+}
+
 /*-----------------------------------------------------------------------------*/
 /** @brief      Set the callback used to set motor position                    */
 /** @param[in]  index The motor index                                          */
@@ -340,6 +486,28 @@ vexMotorEncoderIdGet( int16_t index )
         return(-1);
 }
 
+/*-----------------------------------------------------------------------------*/
+/** @brief      Check if two motors read their position from the same sensor   */
+/** @param[in]  a The first motor index                                        */
+/** @param[in]  b The second motor index                                       */
+/** @returns    TRUE if both use the same sensor on the same channel           */
+/*-----------------------------------------------------------------------------*/
+
+bool_t
+vexMotorSensorShared( int16_t a, int16_t b )
+{
+    if( (a < kVexMotor_1) || (a >= kVexMotorNum))
+        return(FALSE);
+    if( (b < kVexMotor_1) || (b >= kVexMotorNum))
+        return(FALSE);
+
+    if( vexMotors[ a ].motorPositionGet == NULL )
+        return(FALSE);
+
+    return( (vexMotors[ a ].motorPositionGet == vexMotors[ b ].motorPositionGet) &&
+            (vexMotors[ a ].port == vexMotors[ b ].port) );
+}
+
 /*-----------------------------------------------------------------------------*/
 /** @brief      Command line debug of motors                                   */
 /** @param[in]  chp     A pointer to a vexStream object                        */
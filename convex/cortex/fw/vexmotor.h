@@ -135,11 +135,28 @@ typedef struct _vexMotor {
     tVexMotorType       type;
     bool_t              reversed;
     int32_t            (*motorPositionGet)( int16_t port );
+    int32_t            (*motorPositionGetWithTime)( int16_t port, uint32_t *time );
     void               (*motorPositionSet)( int16_t port, int32_t value );
     int16_t            (*getEncoderId)( int16_t port );
     int16_t             port;
     } vexMotor;
 
+/*-----------------------------------------------------------------------------*/
+/** @brief      Emergency stop latch and measured latency                      */
+/*-----------------------------------------------------------------------------*/
+/** @details
+ *  Times are DWT cycle counts, trigger is when the stop was requested, pwm
+ *  is how long it took to zero every output and frame is how long until the
+ *  first SPI frame loaded after the stop was sent to the master processor.
+ */
+typedef struct _vexMotorEmergency {
+    bool_t              latched;
+    uint16_t            count;
+    uint32_t            trigger;
+    uint32_t            pwm;
+    uint32_t            frame;
+    } vexMotorEmergency;
+
 /*-----------------------------------------------------------------------------*/
 
 void            vexMotorInit(void);
@@ -154,10 +171,19 @@ bool_t          vexMotorDirectionGet( int16_t index );
 void            vexMotorDebug(vexStream *chp, int argc, char *argv[]);
 void            vexMotorPositionSet( int16_t index, int32_t value );
 int32_t         vexMotorPositionGet( int16_t index );
+int32_t         vexMotorPositionGetWithTime( int16_t index, uint32_t *time );
 void            vexMotorPositionGetCallback( int16_t index, int32_t (*cb)(int16_t), int16_t port );
+void            vexMotorPositionTimeCallback( int16_t index, int32_t (*cb)(int16_t, uint32_t *), int16_t port );
 void            vexMotorPositionSetCallback( int16_t index, void    (*cb)(int16_t, int32_t), int16_t port );
 void            vexMotorEncoderIdCallback( int16_t index, int16_t (*cb)(int16_t), int16_t port );
 int16_t         vexMotorEncoderIdGet( int16_t index );
+bool_t          vexMotorSensorShared( int16_t a, int16_t b );
+
+void            vexMotorEmergencyStopI(void);
+void            vexMotorEmergencyClear(void);
+bool_t          vexMotorEmergencyGet(void);
+void            vexMotorEmergencyFrameSent(void);
+vexMotorEmergency *vexMotorEmergencyGetPtr(void);
 
 // do not call these
 /** @private                                                                   */
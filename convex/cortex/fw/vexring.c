@@ -0,0 +1,138 @@
+/*-----------------------------------------------------------------------------*/
+/*                                                                             */
+/*    Module:     vexring.c                                                    */
+/*    Created:    18 October 2026                                              */
+/*                                                                             */
+/*    Revisions:                                                               */
+/*                V1.00     18 Oct 2026 - Initial release                      */
+/*                                                                             */
+/*-----------------------------------------------------------------------------*/
+/*                                                                             */
+/*    This file is part of ConVEX.                                             */
+/*                                                                             */
+/*    ConVEX is free software; you can redistribute it                         */
+/*    and/or modify it under the terms of the GNU General Public License       */
+/*    as published by the Free Software Foundation; either version 3 of        */
+/*    the License, or (at your option) any later version.                      */
+/*                                                                             */
+/*    ConVEX is distributed in the hope that it will be useful,                */
+/*    but WITHOUT ANY WARRANTY; without even the implied warranty of           */
+/*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            */
+/*    GNU General Public License for more details.                             */
+/*                                                                             */
+/*    You should have received a copy of the GNU General Public License        */
+/*    along with this program.  If not, see <http://www.gnu.org/licenses/>.    */
+/*                                                                             */
+/*-----------------------------------------------------------------------------*/
+/*                                                                             */
+/*    Description:                                                             */
+/*                                                                             */
+/*    Lock free SPSC ring, see vexring.h. The entry is copied before head is   */
+/*    published with release ordering and the consumer reads head with         */
+/*    acquire ordering, the same the other way round for tail. On the cortex   */
+/*    that is a dmb either side, on the host it keeps the stress test honest.  */
+/*                                                                             */
+/*    Nothing here needs more than ch.h so host tools can build it as is.      */
+/*                                                                             */
+/*-----------------------------------------------------------------------------*/
+
+#include <string.h>
+
+#include "ch.h"         // needs for all ChibiOS programs
+#include "vexring.h"
+
+/*-----------------------------------------------------------------------------*/
+/** @file    vexring.c
+  * @brief   Lock free single producer single consumer ring
+*//*---------------------------------------------------------------------------*/
+
+#define vexRingLoad(p)          __atomic_load_n( (p), __ATOMIC_ACQUIRE )
+#define vexRingStore(p, v)      __atomic_store_n( (p), (v), __ATOMIC_RELEASE )
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Set up a ring at runtime                                       */
+/** @param[in]  r the ring                                                     */
+/** @param[in]  buffer storage for the entries                                 */
+/** @param[in]  size bytes per entry                                           */
+/** @param[in]  entries number of entries, a power of two                      */
+/** @returns    FALSE if entries is not a power of two                         */
+/*-----------------------------------------------------------------------------*/
+bool_t
+vexRingInit( vexRing *r, void *buffer, uint16_t size, uint32_t entries )
+{
+    if( !_VEXRING_POW2(entries) )
+        return( FALSE );
+
+    r->head   = 0;
+    r->tail   = 0;
+    r->drops  = 0;
+    r->mask   = entries - 1;
+    r->size   = size;
+    r->buffer = (uint8_t *)buffer;
+
+    return( TRUE );
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Add an entry, producer side                                    */
+/** @param[in]  r the ring                                                     */
+/** @param[in]  entry copied into the ring                                     */
+/** @returns    FALSE if the ring was full, the entry is counted as dropped    */
+/*-----------------------------------------------------------------------------*/
+bool_t
+vexRingPut( vexRing *r, const void *entry )
+{
+    uint32_t    head = r->head;
+
+    if( (head - vexRingLoad( &r->tail )) > r->mask )
+        {
+        r->drops++;
+        return( FALSE );
+        }
+
+    memcpy( r->buffer + ((head & r->mask) * r->size), entry, r->size );
+    vexRingStore( &r->head, head + 1 );
+
+    return( TRUE );
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Take the oldest entry, consumer side                           */
+/** @param[in]  r the ring                                                     */
+/** @param[out] entry where to copy it                                         */
+/** @returns    FALSE if the ring was empty                                    */
+/*-----------------------------------------------------------------------------*/
+bool_t
+vexRingGet( vexRing *r, void *entry )
+{
+    uint32_t    tail = r->tail;
+
+    if( vexRingLoad( &r->head ) == tail )
+        return( FALSE );
+
+    memcpy( entry, r->buffer + ((tail & r->mask) * r->size), r->size );
+    vexRingStore( &r->tail, tail + 1 );
+
+    return( TRUE );
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Number of entries waiting                                      */
+/** @param[in]  r the ring                                                     */
+/** @returns    The count, may already be out of date on either side           */
+/*-----------------------------------------------------------------------------*/
+uint32_t
+vexRingCount( vexRing *r )
+{
+    return( vexRingLoad( &r->head ) - vexRingLoad( &r->tail ) );
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Drop everything waiting, consumer side                         */
+/** @param[in]  r the ring                                                     */
+/*-----------------------------------------------------------------------------*/
+void
+vexRingFlush( vexRing *r )
+{
+    vexRingStore( &r->tail, vexRingLoad( &r->head ) );
+}
@@ -0,0 +1,98 @@
+/*-----------------------------------------------------------------------------*/
+/*                                                                             */
+/*    Module:     vexring.h                                                    */
+/*    Created:    18 October 2026                                              */
+/*                                                                             */
+/*    Revisions:                                                               */
+/*                V1.00     18 Oct 2026 - Initial release                      */
+/*                                                                             */
+/*-----------------------------------------------------------------------------*/
+/*                                                                             */
+/*    This file is part of ConVEX.                                             */
+/*                                                                             */
+/*    ConVEX is free software; you can redistribute it                         */
+/*    and/or modify it under the terms of the GNU General Public License       */
+/*    as published by the Free Software Foundation; either version 3 of        */
+/*    the License, or (at your option) any later version.                      */
+/*                                                                             */
+/*    ConVEX is distributed in the hope that it will be useful,                */
+/*    but WITHOUT ANY WARRANTY; without even the implied warranty of           */
+/*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            */
+/*    GNU General Public License for more details.                             */
+/*                                                                             */
+/*    You should have received a copy of the GNU General Public License        */
+/*    along with this program.  If not, see <http://www.gnu.org/licenses/>.    */
+/*                                                                             */
+/*-----------------------------------------------------------------------------*/
+/*                                                                             */
+/*    Description:                                                             */
+/*                                                                             */
+/*    Lock free single producer, single consumer ring of fixed size entries.   */
+/*    Only the producer writes head and only the consumer writes tail, so an   */
+/*    ISR can queue to a thread without chSysLockFromIsr and the thread can    */
+/*    take entries without chSysLock.                                          */
+/*                                                                             */
+/*    The producer may be several ISRs as long as they share one priority and  */
+/*    so never preempt each other, the same goes for consumers on threads.     */
+/*    The number of entries must be a power of two.                            */
+/*                                                                             */
+/*    host/vexringstress.c runs the same code on two host threads.             */
+/*                                                                             */
+/*-----------------------------------------------------------------------------*/
+
+#ifndef __VEXRING__
+#define __VEXRING__
+
+/*-----------------------------------------------------------------------------*/
+/** @file    vexring.h
+  * @brief   Lock free SPSC ring macros and prototypes
+*//*---------------------------------------------------------------------------*/
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      A ring of entries                                              */
+/*-----------------------------------------------------------------------------*/
+/** @details
+ *  head and tail run freely and wrap at 2^32, head - tail is the number of
+ *  entries waiting.
+ */
+typedef struct _vexRing {
+    volatile uint32_t   head;           ///< written by the producer only
+    volatile uint32_t   tail;           ///< written by the consumer only
+    volatile uint32_t   drops;          ///< puts that found the ring full
+    uint32_t            mask;           ///< entries - 1
+    uint16_t            size;           ///< bytes per entry
+    uint8_t            *buffer;
+    } vexRing;
+
+/** @cond */
+#define _VEXRING_POW2(n)    (((n) != 0) && (((n) & ((n) - 1)) == 0))
+/** @endcond */
+
+/** @brief static initializer, fails to compile unless entries is a power of two
+ */
+#define _VEXRING_DATA(buf, entries) {                                           \
+    0, 0, 0,                                                                    \
+    (entries) - 1 + 0 * sizeof(char[_VEXRING_POW2(entries) ? 1 : -1]),         \
+    sizeof((buf)[0]),                                                           \
+    (uint8_t *)(buf) }
+
+/** @brief declare a ring over an array of entries
+ */
+#define VEXRING_DECL(name, buf, entries)                                        \
+    vexRing name = _VEXRING_DATA(buf, entries)
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+bool_t          vexRingInit( vexRing *r, void *buffer, uint16_t size, uint32_t entries );
+bool_t          vexRingPut( vexRing *r, const void *entry );
+bool_t          vexRingGet( vexRing *r, void *entry );
+uint32_t        vexRingCount( vexRing *r );
+void            vexRingFlush( vexRing *r );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // __VEXRING__
@@ -77,6 +77,21 @@ static  tVexSonarChannel    nextSonar = kVexSonar_1;
 static  tVexSonnarState     nextState = kSonarStatePing;
 static  Thread             *vexSonarThread = NULL;
 
+/*-----------------------------------------------------------------------------*/
+/*  Echo edges, queued by the EXT interrupt for the sonar task                 */
+/*-----------------------------------------------------------------------------*/
+typedef struct _vexSonarEcho {
+    uint32_t        stamp;          ///< vexTimeUs of the edge
+    uint16_t        time;           ///< timer count, uS since the ping
+    uint8_t         channel;
+    uint8_t         level;
+} vexSonarEcho;
+
+#define SONAR_ECHOS     8           ///< a power of two
+
+static  vexSonarEcho        vexSonarEchos[SONAR_ECHOS];
+static  VEXRING_DECL( vexSonarEchoRing, vexSonarEchos, SONAR_ECHOS );
+
 // flags
 #define SONAR_ENABLED       0x01    ///< flag to indicate sonar is enabled
 #define SONAR_INSTALLED     0x02    ///< flag to indicate sonar is installed
@@ -106,8 +121,7 @@ _vs_gpt_cb(GPTDriver *gptp)
     else
     if( nextState == kSonarStateWait )
         {
-        vexSonars[nextSonar].time_r = 0;
-        vexSonars[nextSonar].time_f = SONAR_TIMEOUT;
+        // no falling edge will be queued, the task sees the timeout
         nextState = kSonarStateError;
         }
 
@@ -136,6 +150,8 @@ static msg_t
 VexSonarTask( void *arg )
 {
     tVexSonarChannel    c;
+    vexSonarEcho        echo;
+    bool_t              fell;
 
     (void)arg;
 
@@ -155,6 +171,28 @@ VexSonarTask( void *arg )
             // pings can be sent
             chThdSleepUntil(chTimeNow() + 50);
 
+            // collect the echo edges, without a falling edge it timed out
+            fell = FALSE;
+            while( vexRingGet( &vexSonarEchoRing, &echo ) )
+                {
+                if( echo.channel != nextSonar )
+                    continue;
+                if( echo.level )
+                    vexSonars[nextSonar].time_r = echo.time;
+                else
+                    {
+                    vexSonars[nextSonar].time_f = echo.time;
+                    vexSonars[nextSonar].stamp  = echo.stamp;
+                    fell = TRUE;
+                    }
+                }
+            if( !fell )
+                {
+                vexSonars[nextSonar].time_r = 0;
+                vexSonars[nextSonar].time_f = SONAR_TIMEOUT;
+                vexSonars[nextSonar].stamp  = vexTimeUs();
+                }
+
             // calculate echo time
             vexSonars[nextSonar].time = vexSonars[nextSonar].time_f - vexSonars[nextSonar].time_r;
 
@@ -200,20 +238,18 @@ VexSonarTask( void *arg )
 static void
 _vs_echo_cb(EXTDriver *extp, expchannel_t channel)
 {
+    vexSonarEcho    echo;
+
     (void)extp;
     (void)channel;
 
-    chSysLockFromIsr();
+    // queued without a lock, the task works out the time
+    echo.stamp   = vexTimeUs();
+    echo.time    = sonarGpt->tim->CNT;
+    echo.channel = nextSonar;
+    echo.level   = palReadPad( vexSonars[nextSonar].pb_port,  vexSonars[nextSonar].pb_pad );
 
-    if( palReadPad( vexSonars[nextSonar].pb_port,  vexSonars[nextSonar].pb_pad ) )
-        vexSonars[nextSonar].time_r = sonarGpt->tim->CNT;
-    else
-        {
-        vexSonars[nextSonar].time_f = sonarGpt->tim->CNT;
-        nextState = kSonarStateDone;
-        }
-
-    chSysUnlockFromIsr();
+    vexRingPut( &vexSonarEchoRing, &echo );
 }
 
 /*-----------------------------------------------------------------------------*/
@@ -366,6 +402,29 @@ vexSonarGetInch( tVexSonarChannel channel )
         return(-1);
 }
 
+/*-----------------------------------------------------------------------------*/
+/** @brief      Get the time of the last sonar measurement                     */
+/** @param[in]  channel The sonar channel                                      */
+/** @returns    vexTimeUs of the falling echo edge, or of the timeout          */
+/*-----------------------------------------------------------------------------*/
+/** @details
+ *  The ping went out the echo time before this, the target was at the
+ *  measured distance half way between the two.
+ */
+
+uint32_t
+vexSonarGetTime( tVexSonarChannel channel )
+{
+    if( channel >= kVexSonar_Num )
+        return(0);
+
+    if( vexSonars[channel].flags & SONAR_INSTALLED ) {
+        return( vexSonars[channel].stamp );
+        }
+    else
+        return(0);
+}
+
 /*-----------------------------------------------------------------------------*/
 /** @brief      Send useful information to debug console                       */
 /** @param[in]  chp     A pointer to a vexStream object                      */
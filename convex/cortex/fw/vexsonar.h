@@ -77,6 +77,7 @@ typedef enum {
     uint16_t        time_r;         ///< time of rising edge on receive pulse
     uint16_t        time_f;         ///< time of falling edge on receive pulse
     int32_t         time;           ///< receive pulse time
+    uint32_t        stamp;          ///< vexTimeUs of the falling edge or timeout
     int16_t         distance_cm;    ///< distance calculated as cm
     int16_t         distance_inch;  ///< distance calculated as inches
     int16_t         flags;          ///< flags, SONAR_INSTALLED & SONAR_ENABLED
@@ -101,6 +102,7 @@ void                vexSonarDebug(vexStream *chp, int argc, char *argv[]);
 void                vexSonarRun(void);
 int16_t             vexSonarGetCm( tVexSonarChannel channel );
 int16_t             vexSonarGetInch( tVexSonarChannel channel );
+uint32_t            vexSonarGetTime( tVexSonarChannel channel );
 
 #ifdef __cplusplus
 }
@@ -64,6 +64,12 @@ static  GPTDriver          *spiGpt    = &GPTD2;
 static  Thread             *spiThread = NULL;
 
 static  char                spiTeamName[16] = CONVEX_TEAM_NAME;
+static  vexSpiRxCallback volatile spiRxCallback = NULL;
+static  jsdata             *spiJoystickReplay = NULL;
+static  EVENTSOURCE_DECL(spiFrameEvent);
+static  EVENTSOURCE_DECL(spiStateEvent);
+static  uint16_t            spiCompState = 0xFFFF;
+static  uint32_t            spiStateTime = 0;
 
 /*-----------------------------------------------------------------------------*/
 /* SPI configuration structure.                                                */
@@ -200,12 +206,98 @@ vexSpiGetOnlineStatus()
 jsdata *
 vexSpiGetJoystickDataPtr( int16_t index )
 {
+    jsdata  *replay = spiJoystickReplay;
+
+    // replayed data takes the place of the real joysticks
+    if( replay != NULL )
+        return( (index > 1) ? &replay[1] : &replay[0] );
+
     if(index > 1)
         return( &vexSpiData.rxdata.pak.js_2 );
     else
         return( &vexSpiData.rxdata.pak.js_1 );
 }
 
+/*-----------------------------------------------------------------------------*/
+/** @brief      Replace the joystick data with replayed data                   */
+/** @param[in]  js Two jsdata structures, main then partner, NULL for live    */
+/*-----------------------------------------------------------------------------*/
+/** @details
+ *  vexControllerGet and everything else reading the joysticks through
+ *  vexSpiGetJoystickDataPtr see the replayed data until this is called
+ *  again with NULL.
+ */
+void
+vexSpiJoystickReplaySet( jsdata *js )
+{
+    spiJoystickReplay = js;
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Set a function called with each valid received packet         */
+/** @param[in]  callback The function or NULL for none                        */
+/*-----------------------------------------------------------------------------*/
+/** @details
+ *  The callback runs in the system task as part of vexSpiSend, straight
+ *  after the packet has been checked, so it must be short and must not
+ *  block.
+ */
+void
+vexSpiRxCallbackSet( vexSpiRxCallback callback )
+{
+    spiRxCallback = callback;
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Get the event source broadcast after each exchange             */
+/** @returns    The event source                                               */
+/*-----------------------------------------------------------------------------*/
+/** @details
+ *  Broadcast by the system task straight after vexSpiSend has the new
+ *  packet, with VEX_SPI_FRAME_VALID or VEX_SPI_FRAME_ERROR as the flags.
+ *  Threads that register a listener run in step with the SPI frames rather
+ *  than at a phase of their own.
+ */
+EventSource *
+vexSpiFrameEventGet()
+{
+    return( &spiFrameEvent );
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Get the event source broadcast on a competition state change   */
+/** @returns    The event source                                               */
+/*-----------------------------------------------------------------------------*/
+/** @details
+ *  Broadcast from vexSpiSend on the first packet with new disabled or
+ *  autonomous bits, vexSpiStateTimeGet gives the time it arrived.
+ */
+EventSource *
+vexSpiStateEventGet()
+{
+    return( &spiStateEvent );
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Get the time of the last competition state change              */
+/** @returns    Cycle count, see halGetCounterValue, when the packet arrived   */
+/*-----------------------------------------------------------------------------*/
+uint32_t
+vexSpiStateTimeGet()
+{
+    return( spiStateTime );
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Get the number of exchanges with the master processor          */
+/** @returns    The frame count, good and bad                                  */
+/*-----------------------------------------------------------------------------*/
+uint32_t
+vexSpiFrameCountGet()
+{
+    return( vexSpiData.frames );
+}
+
 /*-----------------------------------------------------------------------------*/
 /** @brief      Get competition and status word                                */
 /** @returns    The status word from the spi data                              */
@@ -322,6 +414,8 @@ void
 vexSpiSend()
 {
     int16_t      i;
+    uint16_t     state;
+    vexSpiRxCallback callback;
 
     uint16_t    *txbuf = (uint16_t *)vexSpiData.txdata.data;
     uint16_t    *rxbuf = (uint16_t *)vexSpiData.rxdata_t.data;
@@ -399,9 +493,31 @@ vexSpiSend()
                 vexSpiData.txdata.pak.type  = 0;
                 }
             }
+
+        // read once, record and replay set it from other threads
+        callback = spiRxCallback;
+        if( callback != NULL )
+            callback( &vexSpiData.rxdata );
+
+        // the monitor waits for this rather than polling the state
+        state = vexControllerCompetitonState() & (kFlagDisabled | kFlagAutonomousMode);
+        if( state != spiCompState )
+            {
+            spiCompState = state;
+            spiStateTime = halGetCounterValue();
+            chEvtBroadcast( &spiStateEvent );
+            }
+
+        vexSpiData.frames++;
+        chEvtBroadcastFlags( &spiFrameEvent, VEX_SPI_FRAME_VALID );
         }
     else
+        {
         vexSpiData.errors++;
+
+        vexSpiData.frames++;
+        chEvtBroadcastFlags( &spiFrameEvent, VEX_SPI_FRAME_ERROR );
+        }
 }
 
 /*-----------------------------------------------------------------------------*/
@@ -444,6 +560,7 @@ vexSpiDebug(vexStream *chp, int argc, char *argv[])
     chprintf(chp,"\r\n");
 
     chprintf(chp,"errors %ld\r\n", vexSpiData.errors );
+    chprintf(chp,"frames %ld\r\n", vexSpiData.frames );
 
     chprintf(chp,"JS1 - ");
     chprintf(chp,"ch1 %3d ", vexSpiData.rxdata.pak.js_1.Ch1);
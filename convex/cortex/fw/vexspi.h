@@ -156,8 +156,21 @@ typedef struct _SpiData {
     spiRxPacket rxdata_t;           ///< receive data packet, may have errors
     uint16_t    online;             ///< online status
     uint32_t    errors;             ///< number of packets received with error
+    uint32_t    frames;             ///< number of exchanges with the master
 } SpiData;
 
+/*-----------------------------------------------------------------------------*/
+/** @brief      Event flags broadcast after each exchange, see                 */
+/**             vexSpiFrameEventGet                                            */
+/*-----------------------------------------------------------------------------*/
+#define     VEX_SPI_FRAME_VALID     0x0001  ///< packet passed the checks
+#define     VEX_SPI_FRAME_ERROR     0x0002  ///< packet was bad, data not updated
+
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Function called with each valid received packet                */
+/*-----------------------------------------------------------------------------*/
+typedef void (*vexSpiRxCallback)( spiRxPacket *rx );
 
 #ifdef __cplusplus
 extern "C" {
@@ -173,6 +186,12 @@ void        vexSpiSetMotor( int16_t index, int16_t data, bool_t reversed );
 void        vexSpiSend(void);
 void        vexSpiTickDelay( int16_t tick);
 jsdata     *vexSpiGetJoystickDataPtr( int16_t index );
+void        vexSpiJoystickReplaySet( jsdata *js );
+void        vexSpiRxCallbackSet( vexSpiRxCallback callback );
+EventSource *vexSpiFrameEventGet(void);
+EventSource *vexSpiStateEventGet(void);
+uint32_t    vexSpiStateTimeGet(void);
+uint32_t    vexSpiFrameCountGet(void);
 uint16_t    vexSpiGetControl(void);
 uint16_t    vexSpiGetMainBattery(void);
 uint16_t    vexSpiGetBackupBattery(void);
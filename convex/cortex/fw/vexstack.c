@@ -0,0 +1,380 @@
+/*-----------------------------------------------------------------------------*/
+/*                                                                             */
+/*    Module:     vexstack.c                                                   */
+/*    Created:    18 October 2026                                              */
+/*                                                                             */
+/*    Revisions:                                                               */
+/*                V1.00     18 Oct 2026 - Initial release                      */
+/*                                                                             */
+/*-----------------------------------------------------------------------------*/
+/*                                                                             */
+/*    This file is part of ConVEX.                                             */
+/*                                                                             */
+/*    ConVEX is free software; you can redistribute it                         */
+/*    and/or modify it under the terms of the GNU General Public License       */
+/*    as published by the Free Software Foundation; either version 3 of        */
+/*    the License, or (at your option) any later version.                      */
+/*                                                                             */
+/*    ConVEX is distributed in the hope that it will be useful,                */
+/*    but WITHOUT ANY WARRANTY; without even the implied warranty of           */
+/*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            */
+/*    GNU General Public License for more details.                             */
+/*                                                                             */
+/*    You should have received a copy of the GNU General Public License        */
+/*    along with this program.  If not, see <http://www.gnu.org/licenses/>.    */
+/*                                                                             */
+/*-----------------------------------------------------------------------------*/
+/*                                                                             */
+/*    Description:                                                             */
+/*                                                                             */
+/*    Stack high water marks, see vexstack.h. The idle thread can not block    */
+/*    so it can not hold a registry reference, instead once per tick it        */
+/*    checks a few words with the system locked and looks the thread up again  */
+/*    in the registry, a thread that exited in between is dropped.             */
+/*                                                                             */
+/*    Only the words below the last mark are checked, so once the marks have   */
+/*    settled a pass over all the threads is short.                            */
+/*                                                                             */
+/*    With CORTEX_ENABLE_STACK_GUARD the guard at the bottom of each stack is  */
+/*    never read, it is counted as used. The port calls vexStackGuardFault     */
+/*    through CORTEX_STACK_GUARD_HOOK when a thread runs into its guard.       */
+/*                                                                             */
+/*-----------------------------------------------------------------------------*/
+
+#include "ch.h"         // needs for all ChibiOS programs
+#include "hal.h"        // hardware abstraction layer header
+#include "vex.h"        // vex library header
+
+/*-----------------------------------------------------------------------------*/
+/** @file    vexstack.c
+  * @brief   Stack high water marks
+*//*---------------------------------------------------------------------------*/
+
+// process stack used by main and the exception stack, filled by crt0
+extern uint32_t __process_stack_base__;
+extern uint32_t __process_stack_end__;
+extern uint32_t __main_stack_base__;
+extern uint32_t __main_stack_end__;
+
+// working area bytes that are not stack, the WORKING_AREA size excludes them
+#define VEXSTACK_OVERHEAD       (THD_WA_SIZE(0) - sizeof(Thread))
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Fill the stack part of a working area                          */
+/** @param[in]  wsp the working area                                           */
+/** @param[in]  size its size                                                  */
+/*-----------------------------------------------------------------------------*/
+/** @details
+ *  chThdCreateStatic and chThdCreateFromHeap do this already, call it
+ *  before chThdCreateI so that the thread can be measured as well.
+ */
+void
+vexStackFill( void *wsp, size_t size )
+{
+#if CH_DBG_FILL_THREADS
+    uint32_t   *p   = (uint32_t *)((Thread *)wsp + 1);
+    uint32_t   *top = (uint32_t *)((uint8_t *)wsp + size);
+
+    while( p < top )
+        *p++ = VEXSTACK_FILL_WORD;
+#else
+    (void)wsp;
+    (void)size;
+#endif
+}
+
+#if CORTEX_ENABLE_STACK_GUARD
+/*-----------------------------------------------------------------------------*/
+/*  Write to the console USART without the serial driver                       */
+/*-----------------------------------------------------------------------------*/
+static void
+vexStackPuts( USART_TypeDef *u, const char *s )
+{
+    while( *s != '\0' )
+        {
+        while( (u->SR & USART_SR_TXE) == 0 )
+            ;
+        u->DR = *s++;
+        }
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Report a stack overflow, called from CORTEX_STACK_GUARD_HOOK   */
+/** @param[in]  tp the thread that ran into its stack guard                    */
+/*-----------------------------------------------------------------------------*/
+/** @details
+ *  Interrupts are off and the system halts when this returns, so the
+ *  console is written directly.
+ */
+void
+vexStackGuardFault( Thread *tp )
+{
+    USART_TypeDef  *u = (SD_CONSOLE)->usart;
+
+    vexStackPuts( u, "\r\nstack overflow in " );
+    vexStackPuts( u, (tp->p_name != NULL) ? tp->p_name : "unnamed thread" );
+    vexStackPuts( u, "\r\n" );
+}
+#endif
+
+#if defined(VEX_THREAD_STACK) && CH_DBG_FILL_THREADS
+
+typedef struct _vexStack {
+    Thread             *tp;             ///< thread being scanned
+    uint32_t           *base;           ///< its lowest stack word checked
+    uint32_t           *p;              ///< next word to check
+    uint32_t           *end;            ///< last mark, no need to go past it
+    systime_t           last;           ///< tick of the last check
+    uint32_t            passes;         ///< scans over all the threads
+    } vexStack;
+
+static vexStack     vstk;
+
+/*-----------------------------------------------------------------------------*/
+/*  Stack limits of a thread, main runs on the process stack                   */
+/*-----------------------------------------------------------------------------*/
+static void
+vexStackBounds( Thread *tp, uint32_t **base, uint32_t **top )
+{
+    if( tp->vex_stktop == NULL )
+        {
+        *base = &__process_stack_base__;
+        *top  = &__process_stack_end__;
+        }
+    else
+        {
+        *base = (uint32_t *)(tp + 1);
+        *top  = (uint32_t *)tp->vex_stktop;
+        }
+}
+
+/*-----------------------------------------------------------------------------*/
+/*  Lowest word that is checked, the stack guard is skipped                    */
+/*-----------------------------------------------------------------------------*/
+static uint32_t *
+vexStackScanBase( uint32_t *base )
+{
+#if CORTEX_ENABLE_STACK_GUARD
+    // not stack, with the MPU the running thread can not even read it
+    return( (uint32_t *)(PORT_GUARD_ALIGN( base ) + CORTEX_STACK_GUARD_SIZE) );
+#else
+    return( base );
+#endif
+}
+
+/*-----------------------------------------------------------------------------*/
+/*  Last mark as a word pointer, the top if there is no mark yet               */
+/*-----------------------------------------------------------------------------*/
+static uint32_t *
+vexStackEnd( Thread *tp, uint32_t *base, uint32_t *top )
+{
+    if( (uint32_t)(top - base) < (uint32_t)(tp->vex_stkfree / sizeof(uint32_t)) )
+        return( top );
+
+    return( base + (tp->vex_stkfree / sizeof(uint32_t)) );
+}
+
+/*-----------------------------------------------------------------------------*/
+/*  Is the thread still in the registry, call with the system locked           */
+/*-----------------------------------------------------------------------------*/
+static bool_t
+vexStackThreadValid( Thread *tp )
+{
+    Thread     *p;
+
+    for( p = rlist.r_newer; p != (Thread *)&rlist; p = p->p_newer )
+        {
+        if( p == tp )
+            return( TRUE );
+        }
+
+    return( FALSE );
+}
+
+/*-----------------------------------------------------------------------------*/
+/*  Start scanning a thread, call with the system locked                       */
+/*-----------------------------------------------------------------------------*/
+static void
+vexStackStart( Thread *tp )
+{
+    uint32_t   *bottom, *top;
+
+    // wrapped round the registry
+    if( tp == (Thread *)&rlist )
+        {
+        tp = rlist.r_newer;
+        vstk.passes++;
+        }
+
+    vexStackBounds( tp, &bottom, &top );
+    vstk.tp   = tp;
+    vstk.base = vexStackScanBase( bottom );
+    vstk.p    = vstk.base;
+    vstk.end = vexStackEnd( tp, vstk.base, top );
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Check a few stack words, called from IDLE_LOOP_HOOK            */
+/*-----------------------------------------------------------------------------*/
+/** @details
+ *  Runs once per tick, the other idle passes only read the time. The
+ *  system is then locked for at most VEXSTACK_SCAN_WORDS compares plus the
+ *  registry walk.
+ */
+void
+vexStackScan(void)
+{
+    uint32_t    n;
+    uint16_t    mark;
+
+    // a word read, no lock needed
+    if( chTimeNow() == vstk.last )
+        return;
+    vstk.last = chTimeNow();
+
+    chSysLock();
+
+    if( (vstk.tp == NULL) || !vexStackThreadValid( vstk.tp ) )
+        vexStackStart( rlist.r_newer );
+
+    for( n = 0; n < VEXSTACK_SCAN_WORDS; n++ )
+        {
+        // lowest used word found, or nothing new below the last mark
+        if( (vstk.p >= vstk.end) || (*vstk.p != VEXSTACK_FILL_WORD) )
+            {
+            mark = (uint16_t)((vstk.p - vstk.base) * sizeof(uint32_t));
+            if( mark < vstk.tp->vex_stkfree )
+                vstk.tp->vex_stkfree = mark;
+
+            vexStackStart( vstk.tp->p_newer );
+            break;
+            }
+        vstk.p++;
+        }
+
+    chSysUnlock();
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Get the size and peak use of a thread stack                    */
+/** @param[in]  tp the thread, the caller must hold a reference                */
+/** @param[out] size stack bytes                                               */
+/** @param[out] used most bytes ever used                                      */
+/** @returns    FALSE if this build does not measure stacks                    */
+/*-----------------------------------------------------------------------------*/
+/** @details
+ *  Scans below the last mark first so the answer is up to date.
+ */
+bool_t
+vexStackUsage( Thread *tp, uint32_t *size, uint32_t *used )
+{
+    uint32_t   *bottom, *base, *top, *end, *p;
+    uint16_t    mark;
+
+    vexStackBounds( tp, &bottom, &top );
+    base = vexStackScanBase( bottom );
+    end  = vexStackEnd( tp, base, top );
+
+    for( p = base; (p < end) && (*p == VEXSTACK_FILL_WORD); p++ )
+        ;
+
+    mark = (uint16_t)((p - base) * sizeof(uint32_t));
+
+    chSysLock();
+    if( mark < tp->vex_stkfree )
+        tp->vex_stkfree = mark;
+    mark = tp->vex_stkfree;
+    chSysUnlock();
+
+    *size = (top - bottom) * sizeof(uint32_t);
+    *used = *size - mark;
+
+    return( TRUE );
+}
+
+/*-----------------------------------------------------------------------------*/
+/*  Peak use of a stack that is not a thread                                   */
+/*-----------------------------------------------------------------------------*/
+static uint32_t
+vexStackUsed( uint32_t *base, uint32_t *top )
+{
+    uint32_t   *p;
+
+    for( p = base; (p < top) && (*p == VEXSTACK_FILL_WORD); p++ )
+        ;
+
+    return( (top - p) * sizeof(uint32_t) );
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Debug function, show peak stack use of every thread            */
+/** @param[in]  chp     A pointer to a vexStream object                        */
+/** @param[in]  argc    The number of command line arguments                   */
+/** @param[in]  argv    An array of pointers to the command line args          */
+/*-----------------------------------------------------------------------------*/
+/** @details
+ *  ovh is the part of a working area that WORKING_AREA adds to the size it
+ *  is given, so size - ovh is the value to compare with the source. The
+ *  listing is the input to "make stackreport". A stack guard and its
+ *  alignment are part of used.
+ */
+void
+vexStackDebug(vexStream *chp, int argc, char *argv[])
+{
+    Thread     *tp;
+    uint32_t    size, used;
+
+    (void)argc;
+    (void)argv;
+
+    vex_chprintf( chp, "            name     size     used     free  ovh\r\n" );
+
+    tp = chRegFirstThread();
+    do
+        {
+        vexStackUsage( tp, &size, &used );
+
+        vex_chprintf( chp, "%16s %8d %8d %8d %4d\r\n",
+            (tp->p_name != NULL) ? tp->p_name : "-", size, used, size - used,
+            (tp->vex_stktop == NULL) ? 0 : VEXSTACK_OVERHEAD );
+
+        tp = chRegNextThread( tp );
+        } while( tp != NULL );
+
+    size = (&__main_stack_end__ - &__main_stack_base__) * sizeof(uint32_t);
+    used = vexStackUsed( &__main_stack_base__, &__main_stack_end__ );
+    vex_chprintf( chp, "%16s %8d %8d %8d %4d\r\n", "exceptions", size, used, size - used, 0 );
+
+    vex_chprintf( chp, "idle scans %d\r\n", vstk.passes );
+}
+
+#else
+
+/*-----------------------------------------------------------------------------*/
+/*  chconf.h does not keep the stack in the thread or fill it, no marks        */
+/*-----------------------------------------------------------------------------*/
+void
+vexStackScan(void)
+{
+}
+
+bool_t
+vexStackUsage( Thread *tp, uint32_t *size, uint32_t *used )
+{
+    (void)tp;
+    *size = 0;
+    *used = 0;
+
+    return( FALSE );
+}
+
+void
+vexStackDebug(vexStream *chp, int argc, char *argv[])
+{
+    (void)argc;
+    (void)argv;
+
+    vex_chprintf( chp, "stack marks need VEX_STACK_SCAN or CH_DBG_FILL_THREADS\r\n" );
+}
+
+#endif  // VEX_THREAD_STACK && CH_DBG_FILL_THREADS
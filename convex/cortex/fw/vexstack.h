@@ -0,0 +1,76 @@
+/*-----------------------------------------------------------------------------*/
+/*                                                                             */
+/*    Module:     vexstack.h                                                   */
+/*    Created:    18 October 2026                                              */
+/*                                                                             */
+/*    Revisions:                                                               */
+/*                V1.00     18 Oct 2026 - Initial release                      */
+/*                                                                             */
+/*-----------------------------------------------------------------------------*/
+/*                                                                             */
+/*    This file is part of ConVEX.                                             */
+/*                                                                             */
+/*    ConVEX is free software; you can redistribute it                         */
+/*    and/or modify it under the terms of the GNU General Public License       */
+/*    as published by the Free Software Foundation; either version 3 of        */
+/*    the License, or (at your option) any later version.                      */
+/*                                                                             */
+/*    ConVEX is distributed in the hope that it will be useful,                */
+/*    but WITHOUT ANY WARRANTY; without even the implied warranty of           */
+/*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            */
+/*    GNU General Public License for more details.                             */
+/*                                                                             */
+/*    You should have received a copy of the GNU General Public License        */
+/*    along with this program.  If not, see <http://www.gnu.org/licenses/>.    */
+/*                                                                             */
+/*-----------------------------------------------------------------------------*/
+/*                                                                             */
+/*    Description:                                                             */
+/*                                                                             */
+/*    Stack high water marks. With CH_DBG_FILL_THREADS the kernel fills each   */
+/*    working area when a thread is created, with VEX_STACK_SCAN the idle      */
+/*    loop then looks for the lowest word that is no longer the fill pattern   */
+/*    and remembers it in the thread. The "stack" shell command shows size     */
+/*    and peak use for every thread plus the main and exception stacks.        */
+/*                                                                             */
+/*    chconf.h must define VEX_THREAD_STACK and add vex_stktop and             */
+/*    vex_stkfree to THREAD_EXT_FIELDS, without them nothing is measured.      */
+/*    opt/vexstack.mk turns a captured "stack" listing into suggested sizes.   */
+/*                                                                             */
+/*-----------------------------------------------------------------------------*/
+
+#ifndef __VEXSTACK__
+#define __VEXSTACK__
+
+/*-----------------------------------------------------------------------------*/
+/** @file    vexstack.h
+  * @brief   Stack high water mark macros and prototypes
+*//*---------------------------------------------------------------------------*/
+
+/** @brief words checked by the idle loop each tick with the system locked
+ */
+#define VEXSTACK_SCAN_WORDS     16
+
+/** @brief vex_stkfree before the first scan
+ */
+#define VEXSTACK_FREE_UNKNOWN   0xFFFF
+
+/** @brief the kernel fill byte as a word
+ */
+#define VEXSTACK_FILL_WORD      ((uint32_t)CH_STACK_FILL_VALUE * 0x01010101)
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void            vexStackFill( void *wsp, size_t size );
+void            vexStackScan(void);
+bool_t          vexStackUsage( Thread *tp, uint32_t *size, uint32_t *used );
+void            vexStackDebug(vexStream *chp, int argc, char *argv[]);
+void            vexStackGuardFault( Thread *tp );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // __VEXSTACK__
@@ -48,6 +48,7 @@
 /*-----------------------------------------------------------------------------*/
 
 #include <stdlib.h>
+#include <string.h>
 
 #include "ch.h"         // needs for all ChibiOS programs
 #include "hal.h"        // hardware abstraction layer header
@@ -90,6 +91,236 @@ vexTest()
     chThdCreateStatic(waVexTestThread, sizeof(waVexTestThread), NORMALPRIO-1, vexTestThread, NULL);
 }
 
+/*-----------------------------------------------------------------------------*/
+/*  Ring benchmark, TIM1 is free so a GPT interrupt is the producer            */
+/*-----------------------------------------------------------------------------*/
+
+#define TEST_RING_ENTRIES   64          ///< a power of two
+#define TEST_RING_PASSES    1000        ///< put and get pairs timed
+#define TEST_RING_EVENTS    1000        ///< interrupts timed
+#define TEST_RING_INTERVAL  100         ///< uS between interrupts
+
+typedef struct _vexTestRingEntry {
+    uint32_t        time;
+    uint32_t        seq;
+} vexTestRingEntry;
+
+static  vexTestRingEntry    testRingBuffer[TEST_RING_ENTRIES];
+static  VEXRING_DECL( testRing, testRingBuffer, TEST_RING_ENTRIES );
+static  volatile uint32_t   testRingSeq;
+
+static  msg_t               testMbBuffer[TEST_RING_ENTRIES];
+static  MAILBOX_DECL( testMb, testMbBuffer, TEST_RING_ENTRIES );
+
+static void
+_vt_gpt_cb(GPTDriver *gptp)
+{
+    vexTestRingEntry    e;
+
+    (void)gptp;
+
+    // no lock, this is the only producer
+    e.time = halGetCounterValue();
+    e.seq  = testRingSeq++;
+    vexRingPut( &testRing, &e );
+}
+
+static const GPTConfig vexTestGpt = {
+    1000000,    /* 1MHz timer clock.*/
+    _vt_gpt_cb  /* Timer callback.*/
+#if ( CH_KERNEL_VERSION_HEX >= 0x261 )
+    ,0          /* DIER = 0, version 2.6.1.and on */
+#endif
+    };
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Time the ring against a mailbox and from an interrupt          */
+/** @param[in]  chp     A pointer to a vexStream object                      */
+/*-----------------------------------------------------------------------------*/
+/** @details
+ *  Throughput is one put and one get from this thread, the mailbox needs
+ *  the system locked for the I class calls. Latency is from the interrupt
+ *  queuing an entry to this thread taking it while polling, so it includes
+ *  any higher priority thread that runs in between.
+ */
+
+static void
+vexTestRing(vexStream *chp)
+{
+    vexTestRingEntry    e;
+    msg_t               msg;
+    systime_t           timeout;
+    uint32_t            start, cycles;
+    uint32_t            i, n, expected, lost;
+    uint32_t            lat, latMin, latMax, latSum;
+    uint32_t            us = STM32_SYSCLK / 1000000;
+
+    vexRingFlush( &testRing );
+    start = halGetCounterValue();
+    for(i=0;i<TEST_RING_PASSES;i++)
+        {
+        e.seq = i;
+        vexRingPut( &testRing, &e );
+        vexRingGet( &testRing, &e );
+        }
+    cycles = halGetCounterValue() - start;
+    vex_chprintf( chp, "ring    put+get %d cycles\r\n", cycles / TEST_RING_PASSES );
+
+    start = halGetCounterValue();
+    for(i=0;i<TEST_RING_PASSES;i++)
+        {
+        chSysLock();
+        chMBPostI( &testMb, (msg_t)i );
+        chMBFetchI( &testMb, &msg );
+        chSysUnlock();
+        }
+    cycles = halGetCounterValue() - start;
+    vex_chprintf( chp, "mailbox post+fetch %d cycles\r\n", cycles / TEST_RING_PASSES );
+
+    // interrupt to thread
+    testRing.drops = 0;
+    testRingSeq    = 0;
+    expected = 0;
+    lost     = 0;
+    latMin   = 0xFFFFFFFF;
+    latMax   = 0;
+    latSum   = 0;
+
+    gptStart( &GPTD1, &vexTestGpt );
+    gptStartContinuous( &GPTD1, TEST_RING_INTERVAL );
+
+    timeout = chTimeNow() + MS2ST(1000);
+    for(n=0;(n < TEST_RING_EVENTS) && (chTimeNow() < timeout);)
+        {
+        if( !vexRingGet( &testRing, &e ) )
+            continue;
+
+        lat = halGetCounterValue() - e.time;
+        if( lat < latMin ) latMin = lat;
+        if( lat > latMax ) latMax = lat;
+        latSum += lat;
+
+        lost += e.seq - expected;
+        expected = e.seq + 1;
+        n++;
+        }
+
+    gptStopTimer( &GPTD1 );
+    gptStop( &GPTD1 );
+    vexRingFlush( &testRing );
+
+    if( n == 0 )
+        {
+        vex_chprintf( chp, "no interrupts\r\n" );
+        return;
+        }
+
+    vex_chprintf( chp, "latency %d events min %d avg %d max %d cycles, max %d uS\r\n",
+        n, latMin, latSum / n, latMax, latMax / us );
+    vex_chprintf( chp, "drops %d lost %d\r\n", testRing.drops, lost );
+}
+
+/*-----------------------------------------------------------------------------*/
+/*  Tick benchmark, counters are bumped by the kernel hooks in chconf.h        */
+/*-----------------------------------------------------------------------------*/
+
+#define TEST_TICK_PERIOD    10          ///< mS between wake ups
+#define TEST_TICK_WAKES     100         ///< wake ups timed, one second
+
+#if VEX_TEST_COUNTERS
+volatile uint32_t           vexTestTicks;
+volatile uint32_t           vexTestSwitches;
+#endif
+
+typedef struct _vexTestTickStats {
+    uint32_t        wakes;
+    uint32_t        min;
+    uint32_t        max;
+    uint32_t        sum;
+} vexTestTickStats;
+
+static WORKING_AREA(waVexTestTick, 256);
+
+static msg_t
+vexTestTickThread( void *arg )
+{
+    vexTestTickStats   *st = (vexTestTickStats *)arg;
+    systime_t           next;
+    uint32_t            last, now, period;
+
+    chRegSetThreadName("tick");
+
+    next = chTimeNow();
+    last = vexTimeUs();
+    while( st->wakes < TEST_TICK_WAKES )
+        {
+        next += MS2ST(TEST_TICK_PERIOD);
+        chThdSleepUntil( next );
+
+        now    = vexTimeUs();
+        period = now - last;
+        last   = now;
+
+        if( period < st->min ) st->min = period;
+        if( period > st->max ) st->max = period;
+        st->sum += period;
+        st->wakes++;
+        }
+
+    return (msg_t)0;
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Count tick interrupts and context switches for a second        */
+/** @param[in]  chp     A pointer to a vexStream object                        */
+/*-----------------------------------------------------------------------------*/
+/** @details
+ *  Meanwhile a thread wakes every 10mS with chThdSleepUntil, its period is
+ *  measured with the microsecond timebase so the jitter of the tick, or of
+ *  the tickless alarm, shows up. Run it on a build with and without
+ *  CH_USE_TICKLESS to compare, the numbers include the whole system.
+ *  The tick and switch counts need a build with VEX_TEST_COUNTERS.
+ */
+
+static void
+vexTestTick(vexStream *chp)
+{
+    vexTestTickStats    st;
+    Thread             *tp;
+    uint32_t            start, us;
+#if VEX_TEST_COUNTERS
+    uint32_t            ticks, switches;
+#endif
+
+    st.wakes = 0;
+    st.min   = 0xFFFFFFFF;
+    st.max   = 0;
+    st.sum   = 0;
+
+#if VEX_TEST_COUNTERS
+    ticks    = vexTestTicks;
+    switches = vexTestSwitches;
+#endif
+    start    = vexTimeUs();
+
+    tp = chThdCreateStatic(waVexTestTick, sizeof(waVexTestTick), NORMALPRIO+1, vexTestTickThread, &st);
+    chThdWait( tp );
+
+    us       = vexTimeUsSince( start );
+
+    vex_chprintf( chp, "mode     %s\r\n", CH_USE_TICKLESS ? "tickless" : "periodic" );
+#if VEX_TEST_COUNTERS
+    ticks    = vexTestTicks - ticks;
+    switches = vexTestSwitches - switches;
+    vex_chprintf( chp, "tick isr %d in %d uS\r\n", ticks, us );
+    vex_chprintf( chp, "switches %d in %d uS\r\n", switches, us );
+#else
+    vex_chprintf( chp, "ran %d uS, build with VEX_TEST_COUNTERS to count ticks\r\n", us );
+#endif
+    vex_chprintf( chp, "wake %d periods min %d avg %d max %d uS\r\n",
+        st.wakes, st.min, st.sum / st.wakes, st.max );
+}
+
 /*-----------------------------------------------------------------------------*/
 /** @brief      Dump test data for debug                                       */
 /** @param[in]  chp     A pointer to a vexStream object                      */
@@ -100,9 +331,18 @@ vexTest()
 void
 vexTestDebug(vexStream *chp, int argc, char *argv[])
 {
-    (void)argc;
-    (void)argv;
-    (void)chp;
+    if( (argc > 0) && (strcmp( argv[0], "ring" ) == 0) )
+        {
+        vexTestRing( chp );
+        return;
+        }
+    if( (argc > 0) && (strcmp( argv[0], "tick" ) == 0) )
+        {
+        vexTestTick( chp );
+        return;
+        }
+
+    vex_chprintf( chp, "test ring|tick\r\n" );
 }
 
 
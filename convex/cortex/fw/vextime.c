@@ -0,0 +1,202 @@
+/*-----------------------------------------------------------------------------*/
+/*                                                                             */
+/*    Module:     vextime.c                                                    */
+/*    Created:    18 October 2026                                              */
+/*                                                                             */
+/*    Revisions:                                                               */
+/*                V1.00     18 Oct 2026 - Initial release                      */
+/*                                                                             */
+/*-----------------------------------------------------------------------------*/
+/*                                                                             */
+/*    This file is part of ConVEX.                                             */
+/*                                                                             */
+/*    ConVEX is free software; you can redistribute it                         */
+/*    and/or modify it under the terms of the GNU General Public License       */
+/*    as published by the Free Software Foundation; either version 3 of        */
+/*    the License, or (at your option) any later version.                      */
+/*                                                                             */
+/*    ConVEX is distributed in the hope that it will be useful,                */
+/*    but WITHOUT ANY WARRANTY; without even the implied warranty of           */
+/*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            */
+/*    GNU General Public License for more details.                             */
+/*                                                                             */
+/*    You should have received a copy of the GNU General Public License        */
+/*    along with this program.  If not, see <http://www.gnu.org/licenses/>.    */
+/*                                                                             */
+/*-----------------------------------------------------------------------------*/
+/*                                                                             */
+/*    Description:                                                             */
+/*                                                                             */
+/*    Microsecond timebase, see vextime.h. The base is a microsecond count     */
+/*    and the cycle count it was taken at, kept twice like the blackboard.     */
+/*    The sequence is odd while the virtual timer writes the base that is not  */
+/*    published, a reader adds the cycles since its base and only goes again   */
+/*    if a second update started while it was reading. Whole microseconds are  */
+/*    moved into the base and the leftover cycles stay behind, so the time     */
+/*    never drifts from the cycle counter.                                     */
+/*                                                                             */
+/*-----------------------------------------------------------------------------*/
+
+#include "ch.h"         // needs for all ChibiOS programs
+#include "hal.h"        // hardware abstraction layer header
+#include "vex.h"        // vex library header
+
+/*-----------------------------------------------------------------------------*/
+/** @file    vextime.c
+  * @brief   Microsecond timebase from the cycle counter
+*//*---------------------------------------------------------------------------*/
+
+typedef struct _vexTimeBase {
+    uint64_t            us;             ///< time at cycles
+    uint32_t            cycles;         ///< cycle count the base was taken at
+    } vexTimeBase;
+
+typedef struct _vexTime {
+    // odd while a base is being written, newest complete base is
+    // base[VEXTIME_NEWEST(sequence)]
+    volatile uint32_t   sequence;
+    vexTimeBase         base[2];
+
+    uint32_t            cyclesPerUs;
+    VirtualTimer        vt;
+    } vexTime;
+
+static vexTime      vtm;
+
+// keep the compiler from moving base accesses across the sequence counter
+#define vexTimeBarrier()        __asm__ volatile("" ::: "memory")
+
+// two sequence steps per update, the base flips every second step
+#define VEXTIME_NEWEST(s)       (((s) >> 1) & 1)
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Fold the cycles since the last base into a new one             */
+/** @param[in]  arg Unused                                                     */
+/*-----------------------------------------------------------------------------*/
+/** @note       Runs from the system tick with the kernel locked               */
+/*-----------------------------------------------------------------------------*/
+static void
+vexTimeUpdate( void *arg )
+{
+    vexTimeBase    *old = &vtm.base[ VEXTIME_NEWEST(vtm.sequence) ];
+    vexTimeBase    *b   = &vtm.base[ VEXTIME_NEWEST(vtm.sequence) ^ 1 ];
+    uint32_t        us;
+
+    (void)arg;
+
+    // odd, a fast interrupt reading the other base can see the update
+    vtm.sequence++;
+    vexTimeBarrier();
+
+    us = (halGetCounterValue() - old->cycles) / vtm.cyclesPerUs;
+
+    b->us     = old->us + us;
+    b->cycles = old->cycles + (us * vtm.cyclesPerUs);
+
+    vexTimeBarrier();
+    vtm.sequence++;
+
+    chVTSetI( &vtm.vt, VEXTIME_UPDATE_TICKS, vexTimeUpdate, NULL );
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Start the timebase                                             */
+/*-----------------------------------------------------------------------------*/
+/** @details
+ *  Called from vexCortexInit before any sensor is started, time zero is
+ *  the cycle count at that moment.
+ */
+void
+vexTimeInit(void)
+{
+    vtm.cyclesPerUs    = halGetCounterFrequency() / 1000000;
+    vtm.sequence       = 0;
+    vtm.base[0].us     = 0;
+    vtm.base[0].cycles = halGetCounterValue();
+
+    chSysLock();
+    chVTSetI( &vtm.vt, VEXTIME_UPDATE_TICKS, vexTimeUpdate, NULL );
+    chSysUnlock();
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Get the time in uS as a 64 bit count                           */
+/** @returns    uS since vexTimeInit                                           */
+/*-----------------------------------------------------------------------------*/
+/** @details
+ *  Safe from any ISR or thread. The counter is read after the base, so
+ *  it can never be behind it.
+ */
+uint64_t
+vexTimeUs64(void)
+{
+    vexTimeBase    *b;
+    uint32_t        s;
+    uint64_t        us;
+
+    while( TRUE )
+        {
+        // the base being written, if any, is the other one
+        s = vtm.sequence & ~1;
+        vexTimeBarrier();
+        b  = &vtm.base[ VEXTIME_NEWEST(s) ];
+        us = b->us + ((halGetCounterValue() - b->cycles) / vtm.cyclesPerUs);
+        vexTimeBarrier();
+        if( (vtm.sequence - s) <= 2 )
+            break;
+        }
+
+    return( us );
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Get the time in uS                                             */
+/** @returns    uS since vexTimeInit, wraps after about 71 minutes             */
+/*-----------------------------------------------------------------------------*/
+uint32_t
+vexTimeUs(void)
+{
+    return( (uint32_t)vexTimeUs64() );
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Get the uS since a stamp                                       */
+/** @param[in]  stamp An earlier value from vexTimeUs                          */
+/** @returns    The elapsed time, correct across the wrap                      */
+/*-----------------------------------------------------------------------------*/
+uint32_t
+vexTimeUsSince( uint32_t stamp )
+{
+    return( vexTimeUs() - stamp );
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Debug function, show the timebase and the cost of reading it   */
+/** @param[in]  chp     A pointer to a vexStream object                        */
+/** @param[in]  argc    The number of command line arguments                   */
+/** @param[in]  argv    An array of pointers to the command line args          */
+/*-----------------------------------------------------------------------------*/
+void
+vexTimeDebug(vexStream *chp, int argc, char *argv[])
+{
+    uint32_t    start, cycles;
+    uint32_t    t0, t1;
+    uint64_t    now;
+
+    (void)argc;
+    (void)argv;
+
+    start = halGetCounterValue();
+    t0 = vexTimeUs();
+    cycles = halGetCounterValue() - start;
+
+    chThdSleepMilliseconds(10);
+    t1 = vexTimeUs();
+    now = vexTimeUs64();
+
+    vex_chprintf( chp, "time %u.%06u s systime %d\r\n",
+        (uint32_t)(now / 1000000), (uint32_t)(now % 1000000), chTimeNow() );
+    vex_chprintf( chp, "updates %d cycles/uS %d read %d cycles\r\n",
+        vtm.sequence >> 1, vtm.cyclesPerUs, cycles );
+    vex_chprintf( chp, "10mS sleep measured %d uS\r\n", t1 - t0 );
+}
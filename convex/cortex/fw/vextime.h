@@ -0,0 +1,71 @@
+/*-----------------------------------------------------------------------------*/
+/*                                                                             */
+/*    Module:     vextime.h                                                    */
+/*    Created:    18 October 2026                                              */
+/*                                                                             */
+/*    Revisions:                                                               */
+/*                V1.00     18 Oct 2026 - Initial release                      */
+/*                                                                             */
+/*-----------------------------------------------------------------------------*/
+/*                                                                             */
+/*    This file is part of ConVEX.                                             */
+/*                                                                             */
+/*    ConVEX is free software; you can redistribute it                         */
+/*    and/or modify it under the terms of the GNU General Public License       */
+/*    as published by the Free Software Foundation; either version 3 of        */
+/*    the License, or (at your option) any later version.                      */
+/*                                                                             */
+/*    ConVEX is distributed in the hope that it will be useful,                */
+/*    but WITHOUT ANY WARRANTY; without even the implied warranty of           */
+/*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            */
+/*    GNU General Public License for more details.                             */
+/*                                                                             */
+/*    You should have received a copy of the GNU General Public License        */
+/*    along with this program.  If not, see <http://www.gnu.org/licenses/>.    */
+/*                                                                             */
+/*-----------------------------------------------------------------------------*/
+/*                                                                             */
+/*    Description:                                                             */
+/*                                                                             */
+/*    Microsecond timebase. The system tick is 1mS, too coarse for rates       */
+/*    measured over 10 to 25mS, so sensor samples are stamped from the DWT     */
+/*    cycle counter instead. The counter wraps every minute at 72MHz, a        */
+/*    virtual timer folds it into a 64 bit microsecond count well before       */
+/*    that happens.                                                            */
+/*                                                                             */
+/*    Reading takes no lock and works from ISRs and threads, the 32 bit time   */
+/*    wraps after 71 minutes so take differences as uint32_t.                  */
+/*                                                                             */
+/*-----------------------------------------------------------------------------*/
+
+#ifndef __VEXTIME__
+#define __VEXTIME__
+
+/*-----------------------------------------------------------------------------*/
+/** @file    vextime.h
+  * @brief   Microsecond timebase macros and prototypes
+*//*---------------------------------------------------------------------------*/
+
+/** @brief system ticks between folding the cycle counter into the base
+ */
+#define VEXTIME_UPDATE_TICKS    MS2ST(100)
+
+/** @brief microseconds to mS as a float, for rate calculations
+ */
+#define VEXTIME_US2MS(us)       ((float)(us) / 1000.0)
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void            vexTimeInit(void);
+uint32_t        vexTimeUs(void);
+uint64_t        vexTimeUs64(void);
+uint32_t        vexTimeUsSince( uint32_t stamp );
+void            vexTimeDebug(vexStream *chp, int argc, char *argv[]);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // __VEXTIME__
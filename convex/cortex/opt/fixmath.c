@@ -0,0 +1,262 @@
+/*-----------------------------------------------------------------------------*/
+/*                                                                             */
+/*    Module:     fixmath.c                                                    */
+/*    Created:    18 October 2026                                              */
+/*                                                                             */
+/*    Revisions:                                                               */
+/*                V1.00     18 Oct 2026 - Initial release                      */
+/*                                                                             */
+/*-----------------------------------------------------------------------------*/
+/*                                                                             */
+/*    This file is part of ConVEX.                                             */
+/*                                                                             */
+/*    ConVEX is free software; you can redistribute it                         */
+/*    and/or modify it under the terms of the GNU General Public License       */
+/*    as published by the Free Software Foundation; either version 3 of        */
+/*    the License, or (at your option) any later version.                      */
+/*                                                                             */
+/*    ConVEX is distributed in the hope that it will be useful,                */
+/*    but WITHOUT ANY WARRANTY; without even the implied warranty of           */
+/*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            */
+/*    GNU General Public License for more details.                             */
+/*                                                                             */
+/*    You should have received a copy of the GNU General Public License        */
+/*    along with this program.  If not, see <http://www.gnu.org/licenses/>.    */
+/*                                                                             */
+/*-----------------------------------------------------------------------------*/
+
+#include "fixmath.h"
+#include "fixmathlut.h"
+
+/*-----------------------------------------------------------------------------*/
+/** @file    fixmath.c
+  * @brief   Fixed point trig, sqrt and angle conversion
+*//*---------------------------------------------------------------------------*/
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Sine of a binary angle                                         */
+/** @param[in]  a The angle                                                    */
+/** @returns    sin(a) in Q16.16                                               */
+/*-----------------------------------------------------------------------------*/
+/** @details
+ *  Quarter wave table with linear interpolation, worst case error is
+ *  about 2.5e-5 (under 2 lsb).
+ */
+fix16_t
+fixSin( fixangle_t a )
+{
+    uint32_t    x;
+    uint32_t    index;
+    int32_t     frac;
+    int32_t     v;
+
+    // fold into the first quadrant, x is 0 to 90 deg inclusive
+    x = a & (FIXANGLE_90 - 1);
+    if( a & FIXANGLE_90 )
+        x = FIXANGLE_90 - x;
+
+    // top bits index the table, next 16 bits interpolate
+    index = x >> (30 - FIXMATH_LUT_BITS);
+    if( index >= FIXMATH_LUT_SIZE )
+        v = FixSinLut[ FIXMATH_LUT_SIZE ];
+    else
+        {
+        frac = (x >> (14 - FIXMATH_LUT_BITS)) & 0xFFFF;
+        v = FixSinLut[ index ] + (((FixSinLut[ index + 1 ] - FixSinLut[ index ]) * frac) >> 16);
+        }
+
+    // second half of the revolution is negative
+    if( a & FIXANGLE_180 )
+        v = -v;
+
+    return( v );
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Cosine of a binary angle                                       */
+/** @param[in]  a The angle                                                    */
+/** @returns    cos(a) in Q16.16                                               */
+/*-----------------------------------------------------------------------------*/
+fix16_t
+fixCos( fixangle_t a )
+{
+    return( fixSin( a + FIXANGLE_90 ) );
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      atan for ratio 0 to 1 in Q16.16                                */
+/*-----------------------------------------------------------------------------*/
+static fixangle_t
+fixAtanUnit( uint32_t r )
+{
+    uint32_t    index;
+    uint32_t    frac;
+
+    index = r >> (16 - FIXMATH_LUT_BITS);
+    if( index >= FIXMATH_LUT_SIZE )
+        return( FixAtanLut[ FIXMATH_LUT_SIZE ] );
+
+    frac = r & ((1 << (16 - FIXMATH_LUT_BITS)) - 1);
+
+    return( FixAtanLut[ index ] +
+            (((FixAtanLut[ index + 1 ] - FixAtanLut[ index ]) * frac) >> (16 - FIXMATH_LUT_BITS)) );
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Four quadrant arc tangent                                      */
+/** @param[in]  y The y component, any units                                  */
+/** @param[in]  x The x component, same units as y                            */
+/** @returns    The binary angle of the vector, 0 for a zero vector           */
+/*-----------------------------------------------------------------------------*/
+fixangle_t
+fixAtan2( int32_t y, int32_t x )
+{
+    uint32_t    ax, ay;
+    fixangle_t  a;
+
+    if( x == 0 && y == 0 )
+        return( 0 );
+
+    ax = (x < 0) ? -(uint32_t)x : (uint32_t)x;
+    ay = (y < 0) ? -(uint32_t)y : (uint32_t)y;
+
+    // reduce to the first octant so the table ratio is 0 to 1
+    if( ax >= ay )
+        a = fixAtanUnit( (uint32_t)(((uint64_t)ay << 16) / ax) );
+    else
+        a = FIXANGLE_90 - fixAtanUnit( (uint32_t)(((uint64_t)ax << 16) / ay) );
+
+    if( x < 0 )
+        a = FIXANGLE_180 - a;
+    if( y < 0 )
+        a = -a;
+
+    return( a );
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Integer square root                                            */
+/** @param[in]  x The value                                                    */
+/** @returns    floor(sqrt(x))                                                 */
+/*-----------------------------------------------------------------------------*/
+uint32_t
+fixSqrt32( uint32_t x )
+{
+    uint32_t    res = 0;
+    uint32_t    bit = 1UL << 30;
+
+    while( bit > x )
+        bit >>= 2;
+
+    while( bit != 0 )
+        {
+        if( x >= res + bit )
+            {
+            x  -= res + bit;
+            res = (res >> 1) + bit;
+            }
+        else
+            res >>= 1;
+        bit >>= 2;
+        }
+
+    return( res );
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Integer square root of a 64 bit value                          */
+/** @param[in]  x The value                                                    */
+/** @returns    floor(sqrt(x))                                                 */
+/*-----------------------------------------------------------------------------*/
+uint32_t
+fixSqrt64( uint64_t x )
+{
+    uint64_t    res = 0;
+    uint64_t    bit = 1ULL << 62;
+
+    // most callers are small, use the faster version
+    if( x <= 0xFFFFFFFFUL )
+        return( fixSqrt32( (uint32_t)x ) );
+
+    while( bit > x )
+        bit >>= 2;
+
+    while( bit != 0 )
+        {
+        if( x >= res + bit )
+            {
+            x  -= res + bit;
+            res = (res >> 1) + bit;
+            }
+        else
+            res >>= 1;
+        bit >>= 2;
+        }
+
+    return( (uint32_t)res );
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Square root of a Q16.16 number                                 */
+/** @param[in]  x The value, negative values return 0                         */
+/** @returns    sqrt(x) in Q16.16                                              */
+/*-----------------------------------------------------------------------------*/
+fix16_t
+fixSqrt( fix16_t x )
+{
+    if( x <= 0 )
+        return( 0 );
+
+    return( (fix16_t)fixSqrt64( (uint64_t)x << 16 ) );
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Length of a vector                                             */
+/** @param[in]  x The x component                                             */
+/** @param[in]  y The y component                                             */
+/** @returns    sqrt(x*x + y*y) in the same units as x and y                   */
+/*-----------------------------------------------------------------------------*/
+int32_t
+fixHypot( int32_t x, int32_t y )
+{
+    return( (int32_t)fixSqrt64( (uint64_t)((int64_t)x * x) + (uint64_t)((int64_t)y * y) ) );
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Convert degrees * 10 (as used by vexGyroGet) to binary angle   */
+/*-----------------------------------------------------------------------------*/
+fixangle_t
+fixAngleFromDeg10( int32_t deg10 )
+{
+    // 2^32 / 3600 scaled by 2^11
+    return( (fixangle_t)(((int64_t)deg10 * 2443359173LL) >> 11) );
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Convert binary angle to degrees * 10, range +/- 1800           */
+/*-----------------------------------------------------------------------------*/
+int32_t
+fixAngleToDeg10( fixangle_t a )
+{
+    return( (int32_t)(((int64_t)(int32_t)a * 3600 + 0x80000000LL) >> 32) );
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Convert radians in Q16.16 to binary angle                      */
+/*-----------------------------------------------------------------------------*/
+fixangle_t
+fixAngleFromRad( fix16_t rad )
+{
+    // 2^32 / (2 * pi) scaled by 2^16
+    return( (fixangle_t)(((int64_t)rad * 683565276LL) >> 16) );
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Convert binary angle to radians in Q16.16, range +/- pi        */
+/*-----------------------------------------------------------------------------*/
+fix16_t
+fixAngleToRad( fixangle_t a )
+{
+    // 2 * pi * 2^16
+    return( (fix16_t)(((int64_t)(int32_t)a * 411775LL) >> 32) );
+}
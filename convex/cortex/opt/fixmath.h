@@ -0,0 +1,127 @@
+/*-----------------------------------------------------------------------------*/
+/*                                                                             */
+/*    Module:     fixmath.h                                                    */
+/*    Created:    18 October 2026                                              */
+/*                                                                             */
+/*    Revisions:                                                               */
+/*                V1.00     18 Oct 2026 - Initial release                      */
+/*                                                                             */
+/*-----------------------------------------------------------------------------*/
+/*                                                                             */
+/*    This file is part of ConVEX.                                             */
+/*                                                                             */
+/*    ConVEX is free software; you can redistribute it                         */
+/*    and/or modify it under the terms of the GNU General Public License       */
+/*    as published by the Free Software Foundation; either version 3 of        */
+/*    the License, or (at your option) any later version.                      */
+/*                                                                             */
+/*    ConVEX is distributed in the hope that it will be useful,                */
+/*    but WITHOUT ANY WARRANTY; without even the implied warranty of           */
+/*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            */
+/*    GNU General Public License for more details.                             */
+/*                                                                             */
+/*    You should have received a copy of the GNU General Public License        */
+/*    along with this program.  If not, see <http://www.gnu.org/licenses/>.    */
+/*                                                                             */
+/*-----------------------------------------------------------------------------*/
+/*                                                                             */
+/*    Description:                                                             */
+/*                                                                             */
+/*    Fixed point math for control loops, the cortex has no FPU so anything    */
+/*    running at high rate should avoid float.                                 */
+/*                                                                             */
+/*    fix16_t     signed Q16.16                                                */
+/*    fixangle_t  binary angle, the full 32 bits are one revolution so         */
+/*                angles wrap for free. Cast to int32_t for +/- 180 deg.       */
+/*                                                                             */
+/*    The sin and atan tables are generated by vexlutgen, see fixmathlut.h     */
+/*                                                                             */
+/*-----------------------------------------------------------------------------*/
+
+#ifndef __FIXMATH__
+#define __FIXMATH__
+
+#include <stdint.h>
+
+/*-----------------------------------------------------------------------------*/
+/** @file    fixmath.h
+  * @brief   Fixed point math macros and prototypes
+*//*---------------------------------------------------------------------------*/
+
+typedef int32_t     fix16_t;        ///< signed Q16.16
+typedef uint32_t    fixangle_t;     ///< binary angle, 2^32 is 360 deg
+
+/** @brief 1.0 in Q16.16
+ */
+#define FIX16_ONE               65536
+/** @brief Convert a constant to Q16.16, use for constants only
+ */
+#define FIX16(x)                ((fix16_t)((x) * 65536.0 + (((x) >= 0) ? 0.5 : -0.5)))
+/** @brief Convert Q16.16 to float, debug output only
+ */
+#define FIX16_TO_FLOAT(x)       ((float)(x) / 65536.0f)
+
+/** @brief 90, 180 and 270 deg as binary angles
+ */
+#define FIXANGLE_90             0x40000000UL
+#define FIXANGLE_180            0x80000000UL
+#define FIXANGLE_270            0xC0000000UL
+
+/** @brief Convert a constant in degrees to a binary angle, constants only
+ */
+#define FIXANGLE_DEG(x)         ((fixangle_t)(int32_t)((x) * (4294967296.0 / 360.0)))
+
+/** @brief size of the sin quarter wave and atan tables, must be power of 2
+ */
+#define FIXMATH_LUT_BITS        8
+#define FIXMATH_LUT_SIZE        (1 << FIXMATH_LUT_BITS)
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Multiply two Q16.16 numbers                                    */
+/*-----------------------------------------------------------------------------*/
+static inline fix16_t
+fixMul( fix16_t a, fix16_t b )
+{
+    return( (fix16_t)(((int64_t)a * b) >> 16) );
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Divide two Q16.16 numbers, no checking for divide by 0         */
+/*-----------------------------------------------------------------------------*/
+static inline fix16_t
+fixDiv( fix16_t a, fix16_t b )
+{
+    return( (fix16_t)(((int64_t)a << 16) / b) );
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Signed difference between two binary angles, +/- 180 deg       */
+/*-----------------------------------------------------------------------------*/
+static inline int32_t
+fixAngleDiff( fixangle_t a, fixangle_t b )
+{
+    return( (int32_t)(a - b) );
+}
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+fix16_t     fixSin( fixangle_t a );
+fix16_t     fixCos( fixangle_t a );
+fixangle_t  fixAtan2( int32_t y, int32_t x );
+uint32_t    fixSqrt32( uint32_t x );
+uint32_t    fixSqrt64( uint64_t x );
+fix16_t     fixSqrt( fix16_t x );
+int32_t     fixHypot( int32_t x, int32_t y );
+
+fixangle_t  fixAngleFromDeg10( int32_t deg10 );
+int32_t     fixAngleToDeg10( fixangle_t a );
+fixangle_t  fixAngleFromRad( fix16_t rad );
+fix16_t     fixAngleToRad( fixangle_t a );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // __FIXMATH__
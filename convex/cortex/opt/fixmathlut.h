@@ -0,0 +1,99 @@
+/*-----------------------------------------------------------------------------*/
+/*                                                                             */
+/*    fixmathlut.h                                                             */
+/*                                                                             */
+/*    Generated by vexlutgen, do not edit.                                     */
+/*    Regenerate with  make -C src vexlut                                      */
+/*                                                                             */
+/*-----------------------------------------------------------------------------*/
+
+#ifndef __FIXMATHLUT__
+#define __FIXMATHLUT__
+
+/** @brief  sin for 0 to 90 deg in Q16.16
+ */
+static const int32_t FixSinLut[ FIXMATH_LUT_SIZE + 1 ] = {
+         0,    402,    804,   1206,   1608,   2010,   2412,   2814,
+      3216,   3617,   4019,   4420,   4821,   5222,   5623,   6023,
+      6424,   6824,   7224,   7623,   8022,   8421,   8820,   9218,
+      9616,  10014,  10411,  10808,  11204,  11600,  11996,  12391,
+     12785,  13180,  13573,  13966,  14359,  14751,  15143,  15534,
+     15924,  16314,  16703,  17091,  17479,  17867,  18253,  18639,
+     19024,  19409,  19792,  20175,  20557,  20939,  21320,  21699,
+     22078,  22457,  22834,  23210,  23586,  23961,  24335,  24708,
+     25080,  25451,  25821,  26190,  26558,  26925,  27291,  27656,
+     28020,  28383,  28745,  29106,  29466,  29824,  30182,  30538,
+     30893,  31248,  31600,  31952,  32303,  32652,  33000,  33347,
+     33692,  34037,  34380,  34721,  35062,  35401,  35738,  36075,
+     36410,  36744,  37076,  37407,  37736,  38064,  38391,  38716,
+     39040,  39362,  39683,  40002,  40320,  40636,  40951,  41264,
+     41576,  41886,  42194,  42501,  42806,  43110,  43412,  43713,
+     44011,  44308,  44604,  44898,  45190,  45480,  45769,  46056,
+     46341,  46624,  46906,  47186,  47464,  47741,  48015,  48288,
+     48559,  48828,  49095,  49361,  49624,  49886,  50146,  50404,
+     50660,  50914,  51166,  51417,  51665,  51911,  52156,  52398,
+     52639,  52878,  53114,  53349,  53581,  53812,  54040,  54267,
+     54491,  54714,  54934,  55152,  55368,  55582,  55794,  56004,
+     56212,  56418,  56621,  56823,  57022,  57219,  57414,  57607,
+     57798,  57986,  58172,  58356,  58538,  58718,  58896,  59071,
+     59244,  59415,  59583,  59750,  59914,  60075,  60235,  60392,
+     60547,  60700,  60851,  60999,  61145,  61288,  61429,  61568,
+     61705,  61839,  61971,  62101,  62228,  62353,  62476,  62596,
+     62714,  62830,  62943,  63054,  63162,  63268,  63372,  63473,
+     63572,  63668,  63763,  63854,  63944,  64031,  64115,  64197,
+     64277,  64354,  64429,  64501,  64571,  64639,  64704,  64766,
+     64827,  64884,  64940,  64993,  65043,  65091,  65137,  65180,
+     65220,  65259,  65294,  65328,  65358,  65387,  65413,  65436,
+     65457,  65476,  65492,  65505,  65516,  65525,  65531,  65535,
+     65536
+    };
+
+/** @brief  atan for ratio 0 to 1 as binary angle
+ */
+static const uint32_t FixAtanLut[ FIXMATH_LUT_SIZE + 1 ] = {
+             0UL,    2670163UL,    5340245UL,    8010164UL,   10679838UL,   13349187UL,
+      16018129UL,   18686582UL,   21354465UL,   24021698UL,   26688200UL,   29353889UL,
+      32018685UL,   34682507UL,   37345276UL,   40006910UL,   42667331UL,   45326458UL,
+      47984212UL,   50640513UL,   53295284UL,   55948444UL,   58599915UL,   61249621UL,
+      63897482UL,   66543421UL,   69187361UL,   71829226UL,   74468939UL,   77106424UL,
+      79741605UL,   82374407UL,   85004756UL,   87632577UL,   90257796UL,   92880340UL,
+      95500135UL,   98117110UL,  100731191UL,  103342309UL,  105950391UL,  108555367UL,
+     111157167UL,  113755721UL,  116350962UL,  118942819UL,  121531227UL,  124116117UL,
+     126697423UL,  129275078UL,  131849018UL,  134419178UL,  136985493UL,  139547900UL,
+     142106335UL,  144660738UL,  147211045UL,  149757197UL,  152299132UL,  154836791UL,
+     157370116UL,  159899047UL,  162423527UL,  164943499UL,  167458907UL,  169969696UL,
+     172475810UL,  174977196UL,  177473799UL,  179965568UL,  182452450UL,  184934394UL,
+     187411349UL,  189883266UL,  192350096UL,  194811789UL,  197268300UL,  199719579UL,
+     202165583UL,  204606264UL,  207041579UL,  209471483UL,  211895933UL,  214314887UL,
+     216728303UL,  219136141UL,  221538359UL,  223934919UL,  226325781UL,  228710908UL,
+     231090262UL,  233463808UL,  235831508UL,  238193329UL,  240549235UL,  242899194UL,
+     245243172UL,  247581137UL,  249913059UL,  252238905UL,  254558647UL,  256872255UL,
+     259179700UL,  261480955UL,  263775993UL,  266064788UL,  268347313UL,  270623543UL,
+     272893455UL,  275157025UL,  277414230UL,  279665048UL,  281909457UL,  284147437UL,
+     286378966UL,  288604026UL,  290822599UL,  293034664UL,  295240206UL,  297439207UL,
+     299631651UL,  301817523UL,  303996806UL,  306169488UL,  308335554UL,  310494991UL,
+     312647786UL,  314793928UL,  316933406UL,  319066208UL,  321192324UL,  323311746UL,
+     325424463UL,  327530468UL,  329629752UL,  331722309UL,  333808132UL,  335887214UL,
+     337959550UL,  340025134UL,  342083962UL,  344136031UL,  346181336UL,  348219874UL,
+     350251643UL,  352276640UL,  354294865UL,  356306316UL,  358310992UL,  360308894UL,
+     362300021UL,  364284375UL,  366261957UL,  368232767UL,  370196809UL,  372154086UL,
+     374104599UL,  376048352UL,  377985350UL,  379915596UL,  381839095UL,  383755852UL,
+     385665872UL,  387569162UL,  389465727UL,  391355574UL,  393238710UL,  395115141UL,
+     396984877UL,  398847924UL,  400704291UL,  402553986UL,  404397019UL,  406233399UL,
+     408063135UL,  409886237UL,  411702716UL,  413512582UL,  415315845UL,  417112518UL,
+     418902610UL,  420686135UL,  422463104UL,  424233528UL,  425997422UL,  427754796UL,
+     429505665UL,  431250041UL,  432987938UL,  434719370UL,  436444350UL,  438162893UL,
+     439875013UL,  441580724UL,  443280042UL,  444972981UL,  446659557UL,  448339785UL,
+     450013680UL,  451681259UL,  453342536UL,  454997530UL,  456646255UL,  458288728UL,
+     459924966UL,  461554985UL,  463178803UL,  464796437UL,  466407904UL,  468013221UL,
+     469612406UL,  471205476UL,  472792449UL,  474373344UL,  475948178UL,  477516969UL,
+     479079736UL,  480636498UL,  482187271UL,  483732076UL,  485270931UL,  486803855UL,
+     488330866UL,  489851983UL,  491367227UL,  492876615UL,  494380167UL,  495877903UL,
+     497369841UL,  498856002UL,  500336404UL,  501811068UL,  503280012UL,  504743258UL,
+     506200824UL,  507652730UL,  509098996UL,  510539643UL,  511974689UL,  513404156UL,
+     514828063UL,  516246430UL,  517659277UL,  519066625UL,  520468494UL,  521864904UL,
+     523255875UL,  524641427UL,  526021581UL,  527396357UL,  528765775UL,  530129856UL,
+     531488619UL,  532842087UL,  534190278UL,  535533213UL,  536870912UL
+    };
+
+#endif  // __FIXMATHLUT__
@@ -0,0 +1,20 @@
+/*-----------------------------------------------------------------------------*/
+/*    Host build stand in for ch.h, used by vexlutgen and vexringstress        */
+/*-----------------------------------------------------------------------------*/
+
+#ifndef _CH_H_
+#define _CH_H_
+
+#include <stdint.h>
+
+typedef int32_t     bool_t;
+typedef int32_t     msg_t;
+
+#ifndef FALSE
+#define FALSE       0
+#endif
+#ifndef TRUE
+#define TRUE        (!FALSE)
+#endif
+
+#endif  // _CH_H_
@@ -0,0 +1,8 @@
+/*-----------------------------------------------------------------------------*/
+/*    Host build stand in for hal.h, used by vexlutgen only                    */
+/*-----------------------------------------------------------------------------*/
+
+#ifndef _HAL_H_
+#define _HAL_H_
+
+#endif  // _HAL_H_
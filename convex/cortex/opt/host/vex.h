@@ -0,0 +1,17 @@
+/*-----------------------------------------------------------------------------*/
+/*    Host build stand in for vex.h, used by vexlutgen only                    */
+/*    Just enough for pidlib.h and smartmotor.h                                */
+/*-----------------------------------------------------------------------------*/
+
+#ifndef __VEX__
+#define __VEX__
+
+#include "ch.h"
+
+typedef int     tVexSensors;
+typedef int     tVexMotor;
+typedef int     tVexMotorType;
+typedef int     tVexDigitalPin;
+typedef int     tVexAnalogPin;
+
+#endif  // __VEX__
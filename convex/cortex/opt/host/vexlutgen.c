@@ -0,0 +1,391 @@
+/*-----------------------------------------------------------------------------*/
+/*                                                                             */
+/*    Module:     vexlutgen.c                                                  */
+/*    Created:    18 October 2026                                              */
+/*                                                                             */
+/*    Revisions:                                                               */
+/*                V1.00     18 Oct 2026 - Initial release                      */
+/*                                                                             */
+/*-----------------------------------------------------------------------------*/
+/*                                                                             */
+/*    This file is part of ConVEX.                                             */
+/*                                                                             */
+/*    ConVEX is free software; you can redistribute it                         */
+/*    and/or modify it under the terms of the GNU General Public License       */
+/*    as published by the Free Software Foundation; either version 3 of        */
+/*    the License, or (at your option) any later version.                      */
+/*                                                                             */
+/*    ConVEX is distributed in the hope that it will be useful,                */
+/*    but WITHOUT ANY WARRANTY; without even the implied warranty of           */
+/*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            */
+/*    GNU General Public License for more details.                             */
+/*                                                                             */
+/*    You should have received a copy of the GNU General Public License        */
+/*    along with this program.  If not, see <http://www.gnu.org/licenses/>.    */
+/*                                                                             */
+/*-----------------------------------------------------------------------------*/
+/*                                                                             */
+/*    Host tool, NOT part of the cortex firmware.                              */
+/*                                                                             */
+/*    Generates the constant tables used by pidlib and smartmotor so they      */
+/*    live in flash rather than being calculated into RAM at startup.          */
+/*    The values are calculated using exactly the same expressions (and the    */
+/*    same fastmath approximations) that the cortex code used at runtime.      */
+/*                                                                             */
+/*    vexlutgen pid         - write pidlut.h to stdout                         */
+/*    vexlutgen smartmotor  - write smartmotorlut.h to stdout                  */
+/*    vexlutgen fixmath     - write fixmathlut.h to stdout                     */
+/*    vexlutgen check       - compare generated tables with libm reference     */
+/*                                                                             */
+/*    See vexlut.mk for the make targets that use this.                        */
+/*-----------------------------------------------------------------------------*/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+
+/*-----------------------------------------------------------------------------*/
+/** @file    vexlutgen.c
+  * @brief   Host generator for the pidlib and smartmotor constant tables
+*//*---------------------------------------------------------------------------*/
+
+// ch.h, hal.h and vex.h in this directory stand in for the real ones
+#include "vex.h"
+#include "pidlib.h"
+#include "smartmotor.h"
+#include "fixmath.h"
+#include "fastmath.c"
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Create the pidlib power based lut                              */
+/** @note       Must match the curve pidlib used to build at run time         */
+/*-----------------------------------------------------------------------------*/
+
+static void
+genPidLut( int16_t *lut )
+{
+    int16_t   i;
+    float     x;
+
+    for(i=0;i<PIDLIB_LUT_SIZE;i++)
+        {
+        // check for valid power base
+        if( PIDLIB_LUT_FACTOR > 1 )
+            {
+            x = fastpow( PIDLIB_LUT_FACTOR, (float)i / (float)(PIDLIB_LUT_SIZE-1) );
+
+            if(i >= (PIDLIB_LUT_OFFSET/2))
+               lut[i] = (((x - 1.0) / (PIDLIB_LUT_FACTOR - 1.0)) * (PIDLIB_LUT_SIZE-1-PIDLIB_LUT_OFFSET)) + PIDLIB_LUT_OFFSET;
+            else
+               lut[i] = i * 2;
+            }
+        else
+            {
+            // Linear
+            lut[i] = i;
+            }
+        }
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Motor type constants                                           */
+/** @note       Must match the original SmartMotorsInit switch statement       */
+/*-----------------------------------------------------------------------------*/
+
+typedef struct {
+    const char        *name;
+    smartMotorParams   p;
+    } motorType;
+
+static void
+genMotorParams( motorType *t )
+{
+    smartMotorParams *p;
+    int               i;
+
+    // 393 set for high torque
+    t[0].name = "kVexMotor393T";
+    p = &t[0].p;
+    p->i_free        = SMLIB_I_FREE_393;
+    p->i_stall       = SMLIB_I_STALL_393;
+    p->r_motor       = SMLIB_R_393;
+    p->l_motor       = SMLIB_L_393;
+    p->ke_motor      = SMLIB_Ke_393;
+    p->rpm_free      = SMLIB_RPM_FREE_393;
+    p->ticks_per_rev = SMLIB_TPR_393T;
+    p->safe_current  = SMLIB_I_SAFE393;
+    p->t_const_1     = SMLIB_C1_393;
+    p->t_const_2     = SMLIB_C2_393;
+
+    // 393 set for high speed
+    t[1].name = "kVexMotor393S";
+    p = &t[1].p;
+    p->i_free        = SMLIB_I_FREE_393;
+    p->i_stall       = SMLIB_I_STALL_393;
+    p->r_motor       = SMLIB_R_393;
+    p->l_motor       = SMLIB_L_393;
+    p->ke_motor      = SMLIB_Ke_393/1.6;
+    p->rpm_free      = SMLIB_RPM_FREE_393 * 1.6;
+    p->ticks_per_rev = SMLIB_TPR_393S;
+    p->safe_current  = SMLIB_I_SAFE393;
+    p->t_const_1     = SMLIB_C1_393;
+    p->t_const_2     = SMLIB_C2_393;
+
+    // 393 set for Turbo
+    t[2].name = "kVexMotor393R";
+    p = &t[2].p;
+    p->i_free        = SMLIB_I_FREE_393;
+    p->i_stall       = SMLIB_I_STALL_393;
+    p->r_motor       = SMLIB_R_393;
+    p->l_motor       = SMLIB_L_393;
+    p->ke_motor      = SMLIB_Ke_393/2.4;
+    p->rpm_free      = SMLIB_RPM_FREE_393 * 2.4;
+    p->ticks_per_rev = SMLIB_TPR_393R;
+    p->safe_current  = SMLIB_I_SAFE393;
+    p->t_const_1     = SMLIB_C1_393;
+    p->t_const_2     = SMLIB_C2_393;
+
+    // 269 and 3wire set the same
+    t[3].name = "kVexMotor269";
+    p = &t[3].p;
+    p->i_free        = SMLIB_I_FREE_269;
+    p->i_stall       = SMLIB_I_STALL_269;
+    p->r_motor       = SMLIB_R_269;
+    p->l_motor       = SMLIB_L_269;
+    p->ke_motor      = SMLIB_Ke_269;
+    p->rpm_free      = SMLIB_RPM_FREE_269;
+    p->ticks_per_rev = SMLIB_TPR_269;
+    p->safe_current  = SMLIB_I_SAFE269;
+    p->t_const_1     = SMLIB_C1_269;
+    p->t_const_2     = SMLIB_C2_269;
+
+    // per pwm cycle constant, was calculated in SmartMotorCurrent
+    for(i=0;i<4;i++)
+        {
+        p = &t[i].p;
+        p->lamda = p->r_motor/((float)SMLIB_PWM_FREQ * p->l_motor);
+        }
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Print a float so that it is reproduced exactly by the compiler */
+/*-----------------------------------------------------------------------------*/
+
+static void
+printFloat( const char *name, float f, const char *sep )
+{
+    char    buf[32];
+
+    // 9 significant digits round trips a float, 110f is not a valid constant
+    snprintf( buf, sizeof(buf), "%.9g", f );
+    if( strpbrk( buf, ".e" ) == NULL )
+        strcat( buf, ".0" );
+
+    printf("        .%-14s = %sf%s\n", name, buf, sep );
+}
+
+static void
+printHeader( const char *file, const char *guard )
+{
+    printf("/*-----------------------------------------------------------------------------*/\n");
+    printf("/*                                                                             */\n");
+    printf("/*    %-73s*/\n", file);
+    printf("/*                                                                             */\n");
+    printf("/*    Generated by vexlutgen, do not edit.                                     */\n");
+    printf("/*    Regenerate with  make -C src vexlut                                      */\n");
+    printf("/*                                                                             */\n");
+    printf("/*-----------------------------------------------------------------------------*/\n\n");
+    printf("#ifndef %s\n", guard);
+    printf("#define %s\n\n", guard);
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Output pidlut.h                                                */
+/*-----------------------------------------------------------------------------*/
+
+static void
+outputPidLut(void)
+{
+    int16_t lut[PIDLIB_LUT_SIZE];
+    int     i;
+
+    genPidLut( lut );
+
+    printHeader( "pidlut.h", "__PIDLUT__" );
+
+    printf("/** @brief  Linearizing table, factor %g, offset %d\n */\n", (double)PIDLIB_LUT_FACTOR, PIDLIB_LUT_OFFSET );
+    printf("static const int16_t PidDriveLut[ PIDLIB_LUT_SIZE ] = {\n");
+    for(i=0;i<PIDLIB_LUT_SIZE;i++)
+        {
+        if( (i % 8) == 0 )
+            printf("    ");
+        printf("%4d%s", lut[i], (i == PIDLIB_LUT_SIZE-1) ? "" : ",");
+        if( (i % 8) == 7 )
+            printf("\n");
+        else
+            printf(" ");
+        }
+    printf("    };\n\n");
+
+    printf("#endif  // __PIDLUT__\n");
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Output smartmotorlut.h                                         */
+/*-----------------------------------------------------------------------------*/
+
+static void
+outputSmartMotorLut(void)
+{
+    motorType   t[4];
+    int         i;
+
+    genMotorParams( t );
+
+    printHeader( "smartmotorlut.h", "__SMARTMOTORLUT__" );
+
+    printf("/** @brief  Constants for each motor type, indexed by tVexMotorType\n */\n");
+    printf("static const smartMotorParams SmartMotorParams[] = {\n");
+    for(i=0;i<4;i++)
+        {
+        printf("    [%s] = {\n", t[i].name);
+        printFloat( "i_free",        t[i].p.i_free,        "," );
+        printFloat( "i_stall",       t[i].p.i_stall,       "," );
+        printFloat( "r_motor",       t[i].p.r_motor,       "," );
+        printFloat( "l_motor",       t[i].p.l_motor,       "," );
+        printFloat( "ke_motor",      t[i].p.ke_motor,      "," );
+        printFloat( "rpm_free",      t[i].p.rpm_free,      "," );
+        printFloat( "ticks_per_rev", t[i].p.ticks_per_rev, "," );
+        printFloat( "safe_current",  t[i].p.safe_current,  "," );
+        printFloat( "t_const_1",     t[i].p.t_const_1,     "," );
+        printFloat( "t_const_2",     t[i].p.t_const_2,     "," );
+        printFloat( "lamda",         t[i].p.lamda,         ""  );
+        printf("        }%s\n", (i == 3) ? "" : ",");
+        }
+    printf("    };\n\n");
+
+    printf("#endif  // __SMARTMOTORLUT__\n");
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Output fixmathlut.h                                            */
+/*-----------------------------------------------------------------------------*/
+
+static void
+outputFixmathLut(void)
+{
+    int     i;
+    double  pi = 3.14159265358979323846;
+
+    printHeader( "fixmathlut.h", "__FIXMATHLUT__" );
+
+    printf("/** @brief  sin for 0 to 90 deg in Q16.16\n */\n");
+    printf("static const int32_t FixSinLut[ FIXMATH_LUT_SIZE + 1 ] = {\n");
+    for(i=0;i<=FIXMATH_LUT_SIZE;i++)
+        {
+        if( (i % 8) == 0 )
+            printf("    ");
+        printf("%6ld%s", lround( sin( (pi / 2) * i / FIXMATH_LUT_SIZE ) * 65536.0 ), (i == FIXMATH_LUT_SIZE) ? "" : ",");
+        printf( ((i % 8) == 7 || i == FIXMATH_LUT_SIZE) ? "\n" : " ");
+        }
+    printf("    };\n\n");
+
+    printf("/** @brief  atan for ratio 0 to 1 as binary angle\n */\n");
+    printf("static const uint32_t FixAtanLut[ FIXMATH_LUT_SIZE + 1 ] = {\n");
+    for(i=0;i<=FIXMATH_LUT_SIZE;i++)
+        {
+        if( (i % 6) == 0 )
+            printf("    ");
+        printf("%10lldUL%s", llround( atan( (double)i / FIXMATH_LUT_SIZE ) * (4294967296.0 / (2 * pi)) ), (i == FIXMATH_LUT_SIZE) ? "" : ",");
+        printf( ((i % 6) == 5 || i == FIXMATH_LUT_SIZE) ? "\n" : " ");
+        }
+    printf("    };\n\n");
+
+    printf("#endif  // __FIXMATHLUT__\n");
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Check the generated tables against libm                        */
+/** @note       fastpow is an approximation, allow one count of error          */
+/*-----------------------------------------------------------------------------*/
+
+static int
+checkTables(void)
+{
+    int16_t     lut[PIDLIB_LUT_SIZE];
+    motorType   t[4];
+    int         errors = 0;
+    int         i;
+    double      x, ref;
+
+    genPidLut( lut );
+
+    for(i=0;i<PIDLIB_LUT_SIZE;i++)
+        {
+        if( PIDLIB_LUT_FACTOR > 1 && i >= (PIDLIB_LUT_OFFSET/2) )
+            {
+            x   = pow( PIDLIB_LUT_FACTOR, (double)i / (double)(PIDLIB_LUT_SIZE-1) );
+            ref = (((x - 1.0) / (PIDLIB_LUT_FACTOR - 1.0)) * (PIDLIB_LUT_SIZE-1-PIDLIB_LUT_OFFSET)) + PIDLIB_LUT_OFFSET;
+            }
+        else
+        if( PIDLIB_LUT_FACTOR > 1 )
+            ref = i * 2;
+        else
+            ref = i;
+
+        if( fabs( lut[i] - ref ) > 1.0 || lut[i] < 0 || lut[i] > 127 )
+            {
+            fprintf(stderr, "pidlut: entry %d is %d, expected %.2f\n", i, lut[i], ref );
+            errors++;
+            }
+        // table must never decrease
+        if( i > 0 && lut[i] < lut[i-1] )
+            {
+            fprintf(stderr, "pidlut: entry %d is not monotonic\n", i );
+            errors++;
+            }
+        }
+
+    genMotorParams( t );
+
+    for(i=0;i<4;i++)
+        {
+        ref = t[i].p.r_motor / ((double)SMLIB_PWM_FREQ * t[i].p.l_motor);
+        if( fabs( t[i].p.lamda - ref ) > (ref * 1e-6) )
+            {
+            fprintf(stderr, "smartmotor: %s lamda is %g, expected %g\n", t[i].name, t[i].p.lamda, ref );
+            errors++;
+            }
+        if( t[i].p.t_const_1 <= 0 || t[i].p.t_const_2 <= 0 || t[i].p.safe_current <= 0 )
+            {
+            fprintf(stderr, "smartmotor: %s has bad PTC constants\n", t[i].name );
+            errors++;
+            }
+        }
+
+    return( errors );
+}
+
+int
+main( int argc, char *argv[] )
+{
+    if( argc == 2 && strcmp( argv[1], "pid" ) == 0 )
+        outputPidLut();
+    else
+    if( argc == 2 && strcmp( argv[1], "smartmotor" ) == 0 )
+        outputSmartMotorLut();
+    else
+    if( argc == 2 && strcmp( argv[1], "fixmath" ) == 0 )
+        outputFixmathLut();
+    else
+    if( argc == 2 && strcmp( argv[1], "check" ) == 0 )
+        return( checkTables() ? 1 : 0 );
+    else
+        {
+        fprintf(stderr, "usage: %s pid|smartmotor|fixmath|check\n", argv[0] );
+        return(2);
+        }
+
+    return(0);
+}
@@ -0,0 +1,249 @@
+/*-----------------------------------------------------------------------------*/
+/*                                                                             */
+/*    Module:     vexringstress.c                                              */
+/*    Created:    18 October 2026                                              */
+/*                                                                             */
+/*    Revisions:                                                               */
+/*                V1.00     18 Oct 2026 - Initial release                      */
+/*                                                                             */
+/*-----------------------------------------------------------------------------*/
+/*                                                                             */
+/*    This file is part of ConVEX.                                             */
+/*                                                                             */
+/*    ConVEX is free software; you can redistribute it                         */
+/*    and/or modify it under the terms of the GNU General Public License       */
+/*    as published by the Free Software Foundation; either version 3 of        */
+/*    the License, or (at your option) any later version.                      */
+/*                                                                             */
+/*    ConVEX is distributed in the hope that it will be useful,                */
+/*    but WITHOUT ANY WARRANTY; without even the implied warranty of           */
+/*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            */
+/*    GNU General Public License for more details.                             */
+/*                                                                             */
+/*    You should have received a copy of the GNU General Public License        */
+/*    along with this program.  If not, see <http://www.gnu.org/licenses/>.    */
+/*                                                                             */
+/*-----------------------------------------------------------------------------*/
+/*                                                                             */
+/*    Host tool, NOT part of the cortex firmware.                              */
+/*                                                                             */
+/*    Runs fw/vexring.c with the producer and consumer on two host threads,    */
+/*    which unlike the cortex really do run at the same time. Every entry      */
+/*    carries a sequence number and a pattern made from it, the consumer       */
+/*    checks nothing is lost, repeated, reordered or torn.                     */
+/*                                                                             */
+/*    Each ring size and entry size is run twice, once with the producer       */
+/*    waiting for room and once dropping like an ISR would, where the gaps     */
+/*    seen by the consumer must match the drop count. The indices start just   */
+/*    short of 2^32 so they wrap during the run.                               */
+/*                                                                             */
+/*    vexringstress [entries]  - entries per run, default 1000000              */
+/*                                                                             */
+/*    See vexring.mk for the make target that uses this.                       */
+/*-----------------------------------------------------------------------------*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <pthread.h>
+#include <sched.h>
+
+/*-----------------------------------------------------------------------------*/
+/** @file    vexringstress.c
+  * @brief   Host stress test for the lock free ring
+*//*---------------------------------------------------------------------------*/
+
+// ch.h in this directory stands in for the real one
+#include "ch.h"
+#include "vexring.h"
+#include "vexring.c"
+
+#define STRESS_MAX_SIZE     64          ///< largest entry in bytes
+#define STRESS_MAX_ENTRIES  1024
+
+typedef struct _stressRun {
+    vexRing         ring;
+    uint32_t        entries;
+    uint16_t        size;
+    uint32_t        count;
+    int             drop;               ///< producer drops when full
+
+    uint64_t        full;               ///< producer found it full
+    uint64_t        received;
+    uint64_t        gaps;
+    uint64_t        errors;
+} stressRun;
+
+static uint8_t      stressBuffer[STRESS_MAX_ENTRIES * STRESS_MAX_SIZE];
+
+/*-----------------------------------------------------------------------------*/
+/*  Entry contents, the sequence number then bytes made from it                */
+/*-----------------------------------------------------------------------------*/
+static void
+stressFill( uint8_t *e, uint16_t size, uint32_t seq )
+{
+    uint16_t    i;
+
+    memcpy( e, &seq, sizeof(seq) );
+    for( i = sizeof(seq); i < size; i++ )
+        e[i] = (uint8_t)(seq * 31 + i);
+}
+
+static int
+stressCheck( const uint8_t *e, uint16_t size, uint32_t *seq )
+{
+    uint16_t    i;
+
+    memcpy( seq, e, sizeof(*seq) );
+    for( i = sizeof(*seq); i < size; i++ )
+        {
+        if( e[i] != (uint8_t)(*seq * 31 + i) )
+            return( 0 );
+        }
+    return( 1 );
+}
+
+/*-----------------------------------------------------------------------------*/
+/*  Producer thread                                                            */
+/*-----------------------------------------------------------------------------*/
+static void *
+stressProducer( void *arg )
+{
+    stressRun  *r = (stressRun *)arg;
+    uint8_t     e[STRESS_MAX_SIZE];
+    uint32_t    seq;
+
+    for( seq = 0; seq < r->count; seq++ )
+        {
+        stressFill( e, r->size, seq );
+        while( !vexRingPut( &r->ring, e ) )
+            {
+            r->full++;
+            if( r->drop )
+                break;
+            sched_yield();
+            }
+
+        // bursts, so a single core host interleaves the two sides as well
+        if( (seq & 63) == 63 )
+            sched_yield();
+        }
+
+    return( NULL );
+}
+
+/*-----------------------------------------------------------------------------*/
+/*  Consumer, runs on the main thread                                          */
+/*-----------------------------------------------------------------------------*/
+static void
+stressConsumer( stressRun *r )
+{
+    uint8_t     e[STRESS_MAX_SIZE];
+    uint32_t    seq;
+    uint32_t    expected = 0;
+
+    while( expected < r->count )
+        {
+        if( !vexRingGet( &r->ring, e ) )
+            {
+            // the producer may have dropped the last ones
+            if( r->drop && (r->ring.head == r->ring.tail) && (r->received + r->ring.drops >= r->count) )
+                break;
+            // let the producer in on a single core host
+            sched_yield();
+            continue;
+            }
+
+        if( !stressCheck( e, r->size, &seq ) || (seq < expected) )
+            {
+            r->errors++;
+            continue;
+            }
+
+        r->gaps += seq - expected;
+        expected = seq + 1;
+        r->received++;
+        }
+
+    r->gaps += r->count - expected;
+}
+
+/*-----------------------------------------------------------------------------*/
+/*  One ring size and entry size, returns non zero on failure                  */
+/*-----------------------------------------------------------------------------*/
+static int
+stressOne( uint32_t entries, uint16_t size, uint32_t count, int drop )
+{
+    stressRun   r;
+    pthread_t   producer;
+    int         fail;
+
+    memset( &r, 0, sizeof(r) );
+    r.entries = entries;
+    r.size    = size;
+    r.count   = count;
+    r.drop    = drop;
+
+    if( !vexRingInit( &r.ring, stressBuffer, size, entries ) )
+        {
+        printf( "init failed for %u entries\n", entries );
+        return( 1 );
+        }
+
+    // wrap the free running indices part way through
+    r.ring.head = r.ring.tail = 0xFFFFFFFF - (count / 2);
+
+    pthread_create( &producer, NULL, stressProducer, &r );
+    stressConsumer( &r );
+    pthread_join( producer, NULL );
+
+    if( drop )
+        fail = (r.errors != 0) || (r.gaps != r.ring.drops) || (r.received + r.gaps != count);
+    else
+        fail = (r.errors != 0) || (r.gaps != 0) || (r.received != count) || (r.ring.drops != r.full);
+
+    printf( "%4u x %2u %s received %9llu full %9llu drops %9u gaps %9llu errors %llu %s\n",
+        entries, size, drop ? "drop" : "wait",
+        (unsigned long long)r.received, (unsigned long long)r.full, r.ring.drops,
+        (unsigned long long)r.gaps, (unsigned long long)r.errors, fail ? "FAIL" : "ok" );
+
+    return( fail );
+}
+
+/*-----------------------------------------------------------------------------*/
+/*  Main                                                                       */
+/*-----------------------------------------------------------------------------*/
+int
+main( int argc, char *argv[] )
+{
+    static const uint32_t   entries[] = { 1, 2, 8, 64, 1024 };
+    static const uint16_t   sizes[]   = { 4, 12, 64 };
+    uint32_t    count = 1000000;
+    uint8_t     b[4];
+    vexRing     r;
+    unsigned    i, j;
+    int         fail = 0;
+
+    if( argc > 1 )
+        count = (uint32_t)strtoul( argv[1], NULL, 0 );
+
+    // sizes that are not a power of two are refused
+    if( vexRingInit( &r, b, 1, 3 ) || vexRingInit( &r, b, 1, 0 ) )
+        {
+        printf( "init accepted a bad size\n" );
+        fail = 1;
+        }
+
+    for( i = 0; i < sizeof(entries) / sizeof(entries[0]); i++ )
+        {
+        for( j = 0; j < sizeof(sizes) / sizeof(sizes[0]); j++ )
+            {
+            fail |= stressOne( entries[i], sizes[j], count, 0 );
+            fail |= stressOne( entries[i], sizes[j], count, 1 );
+            }
+        }
+
+    printf( "%s\n", fail ? "FAILED" : "passed" );
+    return( fail ? 1 : 0 );
+}
@@ -0,0 +1,239 @@
+/*-----------------------------------------------------------------------------*/
+/*                                                                             */
+/*    Module:     vexstackreport.c                                             */
+/*    Created:    18 October 2026                                              */
+/*                                                                             */
+/*    Revisions:                                                               */
+/*                V1.00     18 Oct 2026 - Initial release                      */
+/*                                                                             */
+/*-----------------------------------------------------------------------------*/
+/*                                                                             */
+/*    This file is part of ConVEX.                                             */
+/*                                                                             */
+/*    ConVEX is free software; you can redistribute it                         */
+/*    and/or modify it under the terms of the GNU General Public License       */
+/*    as published by the Free Software Foundation; either version 3 of        */
+/*    the License, or (at your option) any later version.                      */
+/*                                                                             */
+/*    ConVEX is distributed in the hope that it will be useful,                */
+/*    but WITHOUT ANY WARRANTY; without even the implied warranty of           */
+/*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            */
+/*    GNU General Public License for more details.                             */
+/*                                                                             */
+/*    You should have received a copy of the GNU General Public License        */
+/*    along with this program.  If not, see <http://www.gnu.org/licenses/>.    */
+/*                                                                             */
+/*-----------------------------------------------------------------------------*/
+/*                                                                             */
+/*    Host tool, NOT part of the cortex firmware.                              */
+/*                                                                             */
+/*    Reads the output of the "stack" shell command captured from the robot    */
+/*    and suggests stack sizes with a safety margin. Several captures can be   */
+/*    put in the one file, say after autonomous and after driver control,      */
+/*    the largest use of each thread is kept.                                  */
+/*                                                                             */
+/*    Thread sizes are given the way WORKING_AREA and THD_WA_SIZE take them,   */
+/*    main and exceptions are the linker script stack sizes.                   */
+/*                                                                             */
+/*    The .su files written by -fstack-usage are read as well and the          */
+/*    largest frames listed, they show where the stack goes.                   */
+/*                                                                             */
+/*    vexstackreport [-l log] [-m percent] [-b bytes] [file.su ...]            */
+/*                                                                             */
+/*    See vexstack.mk for the make target that uses this.                      */
+/*-----------------------------------------------------------------------------*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*-----------------------------------------------------------------------------*/
+/** @file    vexstackreport.c
+  * @brief   Host report of suggested stack sizes
+*//*---------------------------------------------------------------------------*/
+
+#define REPORT_MAX_THREADS  32
+#define REPORT_MAX_FRAMES   10          ///< largest frames listed
+#define REPORT_ALIGN        8           ///< stack alignment on the cortex
+
+typedef struct _reportThread {
+    char            name[32];
+    unsigned        size;               ///< stack bytes
+    unsigned        used;               ///< largest use seen
+    unsigned        overhead;           ///< bytes WORKING_AREA adds
+} reportThread;
+
+typedef struct _reportFrame {
+    char            name[128];
+    unsigned        size;
+    int             dynamic;            ///< alloca or a variable length array
+} reportFrame;
+
+static reportThread threads[REPORT_MAX_THREADS];
+static int          threadCount;
+
+static reportFrame  frames[REPORT_MAX_FRAMES];
+static int          frameCount;
+
+/*-----------------------------------------------------------------------------*/
+/*  Read a captured listing, returns non zero if it can not be opened          */
+/*-----------------------------------------------------------------------------*/
+static int
+reportReadLog( const char *path )
+{
+    FILE           *f;
+    char            line[256];
+    reportThread    t;
+    unsigned        spare;
+    int             i;
+
+    if( (f = fopen( path, "r" )) == NULL )
+        {
+        perror( path );
+        return( 1 );
+        }
+
+    while( fgets( line, sizeof(line), f ) != NULL )
+        {
+        // anything else the terminal captured is skipped
+        if( sscanf( line, "%31s %u %u %u %u", t.name, &t.size, &t.used, &spare, &t.overhead ) != 5 )
+            continue;
+        if( (t.used + spare) != t.size )
+            continue;
+
+        for( i = 0; i < threadCount; i++ )
+            {
+            if( strcmp( threads[i].name, t.name ) == 0 )
+                break;
+            }
+
+        if( i == threadCount )
+            {
+            if( threadCount == REPORT_MAX_THREADS )
+                continue;
+            threads[ threadCount++ ] = t;
+            }
+        else
+        if( t.used > threads[i].used )
+            threads[i].used = t.used;
+        }
+
+    fclose( f );
+    return( 0 );
+}
+
+/*-----------------------------------------------------------------------------*/
+/*  Keep the largest frames from a .su file                                    */
+/*-----------------------------------------------------------------------------*/
+static void
+reportReadFrames( const char *path )
+{
+    FILE           *f;
+    char            line[256];
+    reportFrame     fr;
+    char            kind[32];
+    int             i;
+
+    if( (f = fopen( path, "r" )) == NULL )
+        return;
+
+    // file.c:line:column:function<tab>bytes<tab>static|dynamic|dynamic,bounded
+    while( fgets( line, sizeof(line), f ) != NULL )
+        {
+        if( sscanf( line, "%127[^\t]\t%u\t%31s", fr.name, &fr.size, kind ) != 3 )
+            continue;
+        fr.dynamic = (strncmp( kind, "dynamic", 7 ) == 0);
+
+        // insertion into the list, largest first
+        for( i = frameCount; i > 0 && frames[i-1].size < fr.size; i-- )
+            {
+            if( i < REPORT_MAX_FRAMES )
+                frames[i] = frames[i-1];
+            }
+        if( i < REPORT_MAX_FRAMES )
+            {
+            frames[i] = fr;
+            if( frameCount < REPORT_MAX_FRAMES )
+                frameCount++;
+            }
+        }
+
+    fclose( f );
+}
+
+/*-----------------------------------------------------------------------------*/
+/*  Main                                                                       */
+/*-----------------------------------------------------------------------------*/
+int
+main( int argc, char *argv[] )
+{
+    const char *log = NULL;
+    unsigned    margin  = 25;
+    unsigned    minimum = 64;
+    unsigned    need;
+    long        saved = 0;
+    int         i;
+
+    for( i = 1; i < argc; i++ )
+        {
+        if( (strcmp( argv[i], "-l" ) == 0) && (i + 1 < argc) )
+            log = argv[++i];
+        else
+        if( (strcmp( argv[i], "-m" ) == 0) && (i + 1 < argc) )
+            margin = (unsigned)strtoul( argv[++i], NULL, 0 );
+        else
+        if( (strcmp( argv[i], "-b" ) == 0) && (i + 1 < argc) )
+            minimum = (unsigned)strtoul( argv[++i], NULL, 0 );
+        else
+            reportReadFrames( argv[i] );
+        }
+
+    if( frameCount > 0 )
+        {
+        printf( "largest stack frames\n" );
+        for( i = 0; i < frameCount; i++ )
+            printf( "%6u %s%s\n", frames[i].size, frames[i].name, frames[i].dynamic ? " (dynamic)" : "" );
+        printf( "\n" );
+        }
+
+    if( log == NULL )
+        {
+        printf( "no stack log, capture the \"stack\" command and set STACKLOG\n" );
+        return( 0 );
+        }
+
+    if( reportReadLog( log ) )
+        return( 1 );
+
+    if( threadCount == 0 )
+        {
+        printf( "%s has no stack listing\n", log );
+        return( 1 );
+        }
+
+    printf( "suggested stack sizes, %u%% margin and at least %u bytes\n", margin, minimum );
+    printf( "            name  current     used  suggest   change\n" );
+
+    for( i = 0; i < threadCount; i++ )
+        {
+        reportThread *t = &threads[i];
+
+        need = t->used + (t->used * margin) / 100;
+        if( need < t->used + minimum )
+            need = t->used + minimum;
+        need = (need + REPORT_ALIGN - 1) & ~(REPORT_ALIGN - 1);
+
+        // the overhead is part of the use but not of the size in the source
+        if( need < t->overhead )
+            need = t->overhead;
+
+        printf( "%16s %8u %8u %8u %8ld%s\n", t->name,
+            t->size - t->overhead, t->used, need - t->overhead,
+            (long)need - (long)t->size, (need > t->size) ? " too small" : "" );
+
+        saved += (long)t->size - (long)need;
+        }
+
+    printf( "RAM %s %ld bytes\n", (saved >= 0) ? "to reclaim" : "short by", labs( saved ) );
+    return( 0 );
+}
@@ -51,7 +51,7 @@
 #include "vex.h"
 
 #include "pidlib.h"
-#include "fastmath.c"
+#include "pidlut.h"
 
 /*-----------------------------------------------------------------------------*/
 /** @file    pidlib.c
@@ -65,7 +65,7 @@ static  pidController   _pidControllers[ MAX_PID ];
 
 static  int16_t          nextPidControllerPtr = 0;
 
-static  int16_t          PidDriveLut[PIDLIB_LUT_SIZE];
+// PidDriveLut is generated on the host by vexlutgen, see pidlut.h
 
 // There is no sgn function in the standard library
 static inline float
@@ -131,8 +131,6 @@ PidControllerInit( float Kp, float Ki, float Kd, tVexSensors port, int16_t senso
     else
         p->enabled    = 0;
 
-    PidControllerMakeLut();
-
     return(p);
 }
 
@@ -233,35 +231,3 @@ PidControllerUpdate( pidController *p )
     return( p->drive_cmd );
 }
 
-
-/*-----------------------------------------------------------------------------*/
-/** @brief      Create a power based lut                                       */
-/*-----------------------------------------------------------------------------*/
-
-void
-PidControllerMakeLut()
-{
-    int16_t   i;
-    float     x;
-
-    for(i=0;i<PIDLIB_LUT_SIZE;i++)
-        {
-        // check for valid power base
-        if( PIDLIB_LUT_FACTOR > 1 )
-            {
-            x = fastpow( PIDLIB_LUT_FACTOR, (float)i / (float)(PIDLIB_LUT_SIZE-1) );
-
-            if(i >= (PIDLIB_LUT_OFFSET/2))
-               PidDriveLut[i] = (((x - 1.0) / (PIDLIB_LUT_FACTOR - 1.0)) * (PIDLIB_LUT_SIZE-1-PIDLIB_LUT_OFFSET)) + PIDLIB_LUT_OFFSET;
-            else
-               PidDriveLut[i] = i * 2;
-            }
-        else
-            {
-            // Linear
-            PidDriveLut[i] = i;
-            }
-        }
-}
-
-
@@ -126,7 +126,6 @@ extern "C" {
 pidController *PidControllerInit( float Kp, float Ki, float Kd, tVexSensors port, int16_t sensor_reverse );
 pidController *PidControllerInitWithBias( float Kp, float Ki, float Kd, float Kbias, tVexSensors port, int16_t sensor_reverse );
 int16_t        PidControllerUpdate( pidController *p );
-void           PidControllerMakeLut(void);
 
 #ifdef __cplusplus
 }
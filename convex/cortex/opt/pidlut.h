@@ -0,0 +1,34 @@
+/*-----------------------------------------------------------------------------*/
+/*                                                                             */
+/*    pidlut.h                                                                 */
+/*                                                                             */
+/*    Generated by vexlutgen, do not edit.                                     */
+/*    Regenerate with  make -C src vexlut                                      */
+/*                                                                             */
+/*-----------------------------------------------------------------------------*/
+
+#ifndef __PIDLUT__
+#define __PIDLUT__
+
+/** @brief  Linearizing table, factor 20, offset 10
+ */
+static const int16_t PidDriveLut[ PIDLIB_LUT_SIZE ] = {
+       0,    2,    4,    6,    8,   10,   10,   11,
+      11,   11,   11,   11,   12,   12,   12,   12,
+      12,   13,   13,   13,   13,   13,   14,   14,
+      14,   14,   15,   15,   15,   16,   16,   16,
+      16,   17,   17,   17,   18,   18,   18,   19,
+      19,   20,   20,   20,   21,   21,   22,   22,
+      22,   23,   23,   24,   24,   25,   25,   26,
+      26,   27,   28,   28,   29,   29,   30,   31,
+      31,   32,   33,   33,   34,   35,   35,   36,
+      37,   38,   39,   39,   40,   41,   42,   43,
+      44,   45,   46,   47,   48,   49,   50,   51,
+      52,   54,   55,   56,   57,   59,   60,   61,
+      63,   64,   65,   67,   68,   70,   72,   73,
+      75,   77,   78,   80,   82,   84,   86,   88,
+      90,   92,   94,   96,   98,  101,  103,  105,
+     108,  110,  113,  115,  118,  121,  124,  126
+    };
+
+#endif  // __PIDLUT__
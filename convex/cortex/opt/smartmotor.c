@@ -114,6 +114,7 @@
 #include "smartmotor.h"
 #include "robotc_glue.h"
 #include "fastmath.c"
+#include "smartmotorlut.h"
 
 /*-----------------------------------------------------------------------------*/
 /** @file    smartmotor.c
@@ -124,6 +125,16 @@
 static smartMotor      sMotors[ kVexMotorNum ];
 static smartController sPorts[SMLIB_TOTAL_NUM_CONTROL_BANKS];
 
+// command sources, the first few are always there
+static smartMotorSource sSources[ SMLIB_MAX_SOURCES ] = {
+    { "default", SMLIB_PRIORITY_DEFAULT    },
+    { "driver",  SMLIB_PRIORITY_DRIVER     },
+    { "auto",    SMLIB_PRIORITY_AUTONOMOUS },
+    { "lock",    SMLIB_PRIORITY_LOCK       },
+    { "safety",  SMLIB_PRIORITY_SAFETY     }
+};
+static short    sSourceNum = kSmartMotorSourceNum;
+
 /*-----------------------------------------------------------------------------*/
 /*  Flags to determine behavior of the current limiting                        */
 /*-----------------------------------------------------------------------------*/
@@ -503,6 +514,7 @@ SmartMotorDebugStatus()
                 vex_printf("Current:%5.2f ", m->current);
                 vex_printf("Temp:%6.2f ", m->temperature);
                 vex_printf("Status:%2d ", m->ptc_tripped + (m->limit_tripped<<1) );
+                vex_printf("Owner:%s ", (m->owner >= 0) ? sSources[ m->owner ].name : "none" );
                 vex_printf("\r\n");
                 }
             }
@@ -529,33 +541,161 @@ SmartMotorDebugStatus()
 void
 //SetMotor( int index, int value = 0, bool immediate = FALSE )
 _SetMotor( int index, int value, bool_t immediate, ...  )
+{
+    SmartMotorSourceSet( kSmartMotorSourceDefault, (tVexMotor)index, value, immediate );
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Add a motor command source                                     */
+/** @param[in]  name Shown by SmartMotorDebugStatus                            */
+/** @param[in]  priority Higher wins, see SMLIB_PRIORITY_DRIVER etc.           */
+/** @returns    The source or -1 if there are no free slots                    */
+/*-----------------------------------------------------------------------------*/
+/** @details
+ *  Only needed for sources other than the standard ones in tSmartMotorSource
+ */
+
+short
+SmartMotorSourceRegister( char *name, short priority )
+{
+    short   source = -1;
+
+    chSysLock();
+    if( sSourceNum < SMLIB_MAX_SOURCES )
+        {
+        source = sSourceNum++;
+        sSources[ source ].name     = name;
+        sSources[ source ].priority = priority;
+        }
+    chSysUnlock();
+
+    return( source );
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Pick the highest priority source holding a command             */
+/** @param[in]  m Pointer to the smartMotor                                    */
+/** @returns    The source that owns the motor or -1 for none                  */
+/*-----------------------------------------------------------------------------*/
+/** @details
+ *  The winning command becomes motor_cmd, with no source the motor stops
+ */
+
+static short
+SmartMotorResolve( smartMotor *m )
+{
+    short   s;
+    short   owner = -1;
+
+    chSysLock();
+    for( s=0;s<sSourceNum;s++ )
+        {
+        if( (m->src_active & (1 << s)) == 0 )
+            continue;
+        if( (owner < 0) || (sSources[ s ].priority > sSources[ owner ].priority) )
+            owner = s;
+        }
+
+    m->owner = owner;
+    m->motor_cmd = (owner >= 0) ? m->src_cmd[ owner ] : 0;
+    chSysUnlock();
+
+    return( owner );
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Set the command a source wants for a motor                     */
+/** @param[in]  source The source                                              */
+/** @param[in]  index The motor index                                          */
+/** @param[in]  value The motor control value (speed)                          */
+/** @param[in]  immediate If TRUE then bypass the slew rate control            */
+/*-----------------------------------------------------------------------------*/
+/** @details
+ *  The command is held until the source releases it or sets another.  It
+ *  only reaches the motor while no higher priority source holds one, an
+ *  immediate command from the owner is sent to the motor straight away.
+ */
+
+void
+SmartMotorSourceSet( short source, tVexMotor index, int value, bool_t immediate )
 {
     smartMotor  *m;
+    short       cmd;
 
-    // bounds check index
+    // bounds check index and source
     if((index < 0) || (index >= kVexMotorNum))
         return;
+    if((source < 0) || (source >= sSourceNum))
+        return;
 
     // get motor
     m = _SmartMotorGetPtr( index );
 
-    // limit value and set into motorReq
+    // limit value
     if( value > SMLIB_MOTOR_MAX_CMD )
-        m->motor_cmd = SMLIB_MOTOR_MAX_CMD;
+        cmd = SMLIB_MOTOR_MAX_CMD;
     else
     if( value < SMLIB_MOTOR_MIN_CMD )
-        m->motor_cmd = SMLIB_MOTOR_MIN_CMD;
+        cmd = SMLIB_MOTOR_MIN_CMD;
     else
     if( abs(value) >= SMLIB_MOTOR_DEADBAND )
-        m->motor_cmd = value;
+        cmd = value;
+    else
+        cmd = 0;
+
+    chSysLock();
+    m->src_cmd[ source ] = cmd;
+    m->src_active |= (1 << source);
+    if( immediate )
+        m->src_immediate |= (1 << source);
     else
-        m->motor_cmd = 0;
+        m->src_immediate &= ~(1 << source);
+    chSysUnlock();
 
     // new - for hard stop
-    if(immediate)
+    if( immediate && (SmartMotorResolve( m ) == source) )
         vexMotorSet( index,  value);
 }
 
+/*-----------------------------------------------------------------------------*/
+/** @brief      Give up the command a source holds for a motor                 */
+/** @param[in]  source The source                                              */
+/** @param[in]  index The motor index                                          */
+/*-----------------------------------------------------------------------------*/
+
+void
+SmartMotorSourceRelease( short source, tVexMotor index )
+{
+    smartMotor  *m;
+
+    if((index < 0) || (index >= kVexMotorNum))
+        return;
+    if((source < 0) || (source >= sSourceNum))
+        return;
+
+    m = _SmartMotorGetPtr( index );
+
+    chSysLock();
+    m->src_active    &= ~(1 << source);
+    m->src_immediate &= ~(1 << source);
+    chSysUnlock();
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Get the source that owned a motor on the last resolve          */
+/** @param[in]  index The motor index                                          */
+/** @returns    The source or -1 for none                                      */
+/*-----------------------------------------------------------------------------*/
+
+short
+SmartMotorOwnerGet( tVexMotor index )
+{
+    if((index < 0) || (index >= kVexMotorNum))
+        return( -1 );
+
+    return( _SmartMotorGetPtr( index )->owner );
+}
+
 /*-----------------------------------------------------------------------------*/
 /** @brief      Initialize the smartMotor library                              */
 /*-----------------------------------------------------------------------------*/
@@ -573,6 +713,7 @@ SmartMotorsInit()
 {
     int         i, j;
     smartMotor  *m;
+    const smartMotorParams *p;
 
     // clear controllers
     for(j=0;j<SMLIB_TOTAL_NUM_CONTROL_BANKS;j++)
@@ -614,72 +755,27 @@ SmartMotorsInit()
 
         switch( m->type )
             {
-            // 393 set for high torque
+            // constants are generated by vexlutgen and live in flash
             case    kVexMotor393T:
-                m->i_free   = SMLIB_I_FREE_393;
-                m->i_stall  = SMLIB_I_STALL_393;
-                m->r_motor  = SMLIB_R_393;
-                m->l_motor  = SMLIB_L_393;
-                m->ke_motor = SMLIB_Ke_393;
-                m->rpm_free = SMLIB_RPM_FREE_393;
-
-                m->ticks_per_rev = SMLIB_TPR_393T;
-
-                m->safe_current = SMLIB_I_SAFE393;
-
-                m->t_const_1 = SMLIB_C1_393;
-                m->t_const_2 = SMLIB_C2_393;
-                break;
-
-            // 393 set for high speed
             case    kVexMotor393S:
-                m->i_free   = SMLIB_I_FREE_393;
-                m->i_stall  = SMLIB_I_STALL_393;
-                m->r_motor  = SMLIB_R_393;
-                m->l_motor  = SMLIB_L_393;
-                m->ke_motor = SMLIB_Ke_393/1.6;
-                m->rpm_free = SMLIB_RPM_FREE_393 * 1.6;
-
-                m->ticks_per_rev = SMLIB_TPR_393S;
-
-                m->safe_current = SMLIB_I_SAFE393;
-
-                m->t_const_1 = SMLIB_C1_393;
-                m->t_const_2 = SMLIB_C2_393;
-                break;
-
-            // 393 set for Turbo
             case    kVexMotor393R:
-                m->i_free   = SMLIB_I_FREE_393;
-                m->i_stall  = SMLIB_I_STALL_393;
-                m->r_motor  = SMLIB_R_393;
-                m->l_motor  = SMLIB_L_393;
-                m->ke_motor = SMLIB_Ke_393/2.4;
-                m->rpm_free = SMLIB_RPM_FREE_393 * 2.4;
-
-                m->ticks_per_rev = SMLIB_TPR_393R;
-
-                m->safe_current = SMLIB_I_SAFE393;
-
-                m->t_const_1 = SMLIB_C1_393;
-                m->t_const_2 = SMLIB_C2_393;
-                break;
-
-            // 269 and 3wire set the same
             case    kVexMotor269:
-                m->i_free   = SMLIB_I_FREE_269;
-                m->i_stall  = SMLIB_I_STALL_269;
-                m->r_motor  = SMLIB_R_269;
-                m->l_motor  = SMLIB_L_269;
-                m->ke_motor = SMLIB_Ke_269;
-                m->rpm_free = SMLIB_RPM_FREE_269;
+                p = &SmartMotorParams[ m->type ];
+
+                m->i_free   = p->i_free;
+                m->i_stall  = p->i_stall;
+                m->r_motor  = p->r_motor;
+                m->l_motor  = p->l_motor;
+                m->ke_motor = p->ke_motor;
+                m->rpm_free = p->rpm_free;
+                m->lamda    = p->lamda;
 
-                m->ticks_per_rev = SMLIB_TPR_269;
+                m->ticks_per_rev = p->ticks_per_rev;
 
-                m->safe_current = SMLIB_I_SAFE269;
+                m->safe_current = p->safe_current;
 
-                m->t_const_1 = SMLIB_C1_269;
-                m->t_const_2 = SMLIB_C2_269;
+                m->t_const_1 = p->t_const_1;
+                m->t_const_2 = p->t_const_2;
                 break;
 
             default:
@@ -696,18 +792,19 @@ SmartMotorsInit()
             m->ticks_per_rev = -1;
             m->enc    = 0;
             m->oldenc = 0;
+            m->enctime = 0;
             }
         else
         if( m->encoder_id < 20 ) {
             // quad encoder
             m->ticks_per_rev = SMLIB_TPR_QUAD;
-            m->enc    = vexMotorPositionGet( m->eport );
-            m->oldenc = vexMotorPositionGet( m->eport );
+            m->enc    = vexMotorPositionGetWithTime( m->eport, &m->enctime );
+            m->oldenc = m->enc;
             }
         else
             {
-            m->enc    = vexMotorPositionGet( m->eport );
-            m->oldenc = vexMotorPositionGet( m->eport );
+            m->enc    = vexMotorPositionGetWithTime( m->eport, &m->enctime );
+            m->oldenc = m->enc;
             }
 
         // use until overidden by user
@@ -747,6 +844,11 @@ SmartMotorsInit()
 
         // we have never run
         m->lastPgmTime = -1;
+
+        // nobody is commanding it yet
+        m->src_active    = 0;
+        m->src_immediate = 0;
+        m->owner         = -1;
         }
 }
 
@@ -786,6 +888,7 @@ SmartMotorLinkMotors( tVexMotor master, tVexMotor slave )
     s->encoder_id    = m->encoder_id;
     s->enc           = m->enc;
     s->oldenc        = m->oldenc;
+    s->enctime       = m->enctime;
 }
 
 /*-----------------------------------------------------------------------------*/
@@ -916,6 +1019,7 @@ _SmartMotorSetRpmSensor( tVexMotor index, tVexAnalogPin port, float ticks_per_re
         {
         m->encoder_id    = ENCODER_ID_SENSOR + (short)port;
         m->ticks_per_rev = ticks_per_rev;
+        m->enctime       = 0;
         // use negative ticks per rev if reversed sensor
         if( reversed )
             m->ticks_per_rev = -m->ticks_per_rev;
@@ -937,14 +1041,23 @@ _SmartMotorSetRpmSensor( tVexMotor index, tVexAnalogPin port, float ticks_per_re
 /** @param[in]  deltaTime The time in mS from the last call to this function   */
 /** @warning    Internal smartMotorLibrary function, do not call, ref only     */
 /*-----------------------------------------------------------------------------*/
+/** @details
+ *  The rpm is the count change over the time between the two sensor
+ *  samples, the encoder edges or IME reads, not over deltaTime. A quad
+ *  encoder with no new edge has moved less than one tick and reads as
+ *  stopped. deltaTime is only used if the count changed without a new
+ *  sample, for example after the position was set.
+ */
 
 #ifdef _Target_Emulator_
     float   motordrag = 1.0;
 #endif
 
 void
-SmartMotorSpeed( smartMotor *m, int deltaTime )
+SmartMotorSpeed( smartMotor *m, float deltaTime )
 {
+    uint32_t    time;
+
 #ifdef _Target_Emulator_
     // dummy increment based on speed
     int increment = m->ticks_per_rev * 0.2 * motordrag;
@@ -953,9 +1066,10 @@ SmartMotorSpeed( smartMotor *m, int deltaTime )
         increment = sgn(increment) * 100;
     // increase(or decrease) for testing in emulator
     m->enc = m->enc += increment; // debug
+    time   = vexTimeUs();
 #else
-    // Get encoder value
-    m->enc = vexMotorPositionGet(m->eport);
+    // Get encoder value and when it was measured
+    m->enc = vexMotorPositionGetWithTime(m->eport, &time);
 #endif
 
     // calculate encoder delta
@@ -963,6 +1077,18 @@ SmartMotorSpeed( smartMotor *m, int deltaTime )
     m->oldenc = m->enc;
 
     // calculate the rpm for the motor
+    if( time != m->enctime )
+        {
+        deltaTime  = VEXTIME_US2MS( time - m->enctime );
+        m->enctime = time;
+        }
+    else
+    if( m->delta == 0 )
+        {
+        m->rpm = 0;
+        return;
+        }
+
     m->rpm = (1000.0/deltaTime) * m->delta * 60.0 / m->ticks_per_rev;
 }
 
@@ -1007,11 +1133,16 @@ SmartMotorSimulateSpeed( smartMotor *m )
 /** @param[in]  deltaTime The time in mS from the last call to this function   */
 /** @warning    Internal smartMotorLibrary function, do not call, ref only     */
 /*-----------------------------------------------------------------------------*/
+/** @details
+ *  The ADC converts continuously, so the sample is stamped when it is read
+ *  and the rpm uses the time between samples rather than deltaTime.
+ */
 
 static void
-SmartMotorSensorSpeed( smartMotor *m, int deltaTime )
+SmartMotorSensorSpeed( smartMotor *m, float deltaTime )
 {
     tVexAnalogPin    port;
+    uint32_t         time;
 
     // get port from special encoder_id
     port = (tVexAnalogPin)(m->encoder_id - ENCODER_ID_SENSOR);
@@ -1020,11 +1151,17 @@ SmartMotorSensorSpeed( smartMotor *m, int deltaTime )
 
     // Get sensor value
     m->enc = vexAdcGet(port);
+    time   = vexTimeUs();
 
     // calculate encoder delta
     m->delta  = m->enc - m->oldenc;
     m->oldenc = m->enc;
 
+    // first sample, nothing to measure against yet
+    if( m->enctime != 0 )
+        deltaTime = VEXTIME_US2MS( time - m->enctime );
+    m->enctime = time;
+
     // calculate the rpm for the motor
     m->rpm = (1000.0/deltaTime) * m->delta * 60.0 / m->ticks_per_rev;
 }
@@ -1084,7 +1221,7 @@ SmartMotorCurrent( smartMotor *m, float v_battery  )
     duty_on = abs(cmd)/127.0;
 
     // constants for this pwm cycle
-    lamda = m->r_motor/((float)SMLIB_PWM_FREQ * m->l_motor);
+    lamda = m->lamda;
     c1    = fastexp( -lamda *    duty_on  );
     c2    = fastexp( -lamda * (1-duty_on) );
 
@@ -1247,7 +1384,7 @@ SmartMotorSafeCommand( smartMotor *m, float v_battery  )
 /*-----------------------------------------------------------------------------*/
 
 float
-SmartMotorTemperature( smartMotor *m, int deltaTime )
+SmartMotorTemperature( smartMotor *m, float deltaTime )
 {
     float   rate;
 
@@ -1268,7 +1405,7 @@ SmartMotorTemperature( smartMotor *m, int deltaTime )
 /*-----------------------------------------------------------------------------*/
 
 float
-SmartMotorControllerTemperature( smartController *s, int deltaTime  )
+SmartMotorControllerTemperature( smartController *s, float deltaTime  )
 {
     float   rate;
 
@@ -1469,6 +1606,10 @@ SmartMotorControllerSetLed( smartController *s )
         vexDigitalPinSet(s->statusLed,  SMLIB_LEDON);
 }
 
+// loop timing for the smart motor and slew rate tasks
+static  vexPeriodic smartMotorPeriodic;
+static  vexPeriodic slewRatePeriodic;
+
 /*-----------------------------------------------------------------------------*/
 /** @brief      The smart motor task                                           */
 /** @param[in]  arg pointer to user data (not used)                            */
@@ -1482,16 +1623,18 @@ msg_t
 SmartMotorTask( void *arg )
 {
     static  int loopDelay = 10;
-    static  int delayTimeMs = kVexMotorNum * 10;
+    static  float delayTimeMs = kVexMotorNum * 10;
             int i;
             int nextMotor = 0;
             float   v_battery;
+            uint32_t now;
 
     (void)arg;
 
     // Must call this - but we are not terminated
     vexTaskRegisterPersistant("smartMotor", TRUE);
 
+    vexPeriodicInit( &smartMotorPeriodic, loopDelay );
     while(!chThdShouldTerminate())
         {
 #ifdef  _smTestPoint_1
@@ -1503,10 +1646,12 @@ SmartMotorTask( void *arg )
 
         smartMotor *m = _SmartMotorGetPtr( nextMotor );
 
-        // may be overkill, could just use default from above
-        delayTimeMs = chTimeNow()  - m->lastPgmTime;
-        m->lastPgmTime = chTimeNow() ;
-        m->delayTimeMs = delayTimeMs; // debug
+        // real time since this motor was last done, the system tick is
+        // too coarse for rpm over a 10mS loop
+        now = vexTimeUs();
+        delayTimeMs = VEXTIME_US2MS( now - m->lastPgmTime );
+        m->lastPgmTime = now;
+        m->delayTimeMs = (short)delayTimeMs; // debug
 
         // Set current etc. for one motor if it exists and has an encoder
         if( m->type != kVexMotorUndefined )
@@ -1588,7 +1733,7 @@ SmartMotorTask( void *arg )
         vexDigitalPinSet( _smTestPoint_1, 0);
 #endif
         // wait
-        vexSleep(loopDelay);
+        vexPeriodicWait( &smartMotorPeriodic );
         }
 
     return (msg_t)0;
@@ -1610,6 +1755,7 @@ msg_t SmartMotorSlewRateTask( void *arg )
     static  int delayTimeMs = 15;
     int motorIndex;
     int motorTmp;
+    int slew;
     smartMotor  *m;
 
     (void)arg;
@@ -1627,6 +1773,7 @@ msg_t SmartMotorSlewRateTask( void *arg )
         }
 
     // run task until stopped
+    vexPeriodicInit( &slewRatePeriodic, delayTimeMs );
     while( !chThdShouldTerminate() )
         {
 #ifdef  _smTestPoint_2
@@ -1638,6 +1785,15 @@ msg_t SmartMotorSlewRateTask( void *arg )
             {
             m = _SmartMotorGetPtr( motorIndex );
 
+            // settle which source owns the motor, sets motor_cmd
+            // an owner that asked for immediate is not slewed
+            slew = m->motor_slew;
+            if( SmartMotorResolve( m ) >= 0 )
+                {
+                if( m->src_immediate & (1 << m->owner) )
+                    slew = SMLIB_MOTOR_FAST_SLEW_RATE;
+                }
+
             // So we don't keep accessing the internal storage
             motorTmp = vexMotorGet( m->port );
 
@@ -1663,7 +1819,7 @@ msg_t SmartMotorSlewRateTask( void *arg )
                 // increasing motor value
                 if( m->motor_req > motorTmp )
                     {
-                    motorTmp += m->motor_slew;
+                    motorTmp += slew;
                     // limit
                     if( motorTmp > m->motor_req )
                         motorTmp = m->motor_req;
@@ -1672,7 +1828,7 @@ msg_t SmartMotorSlewRateTask( void *arg )
                 // increasing motor value
                 if( m->motor_req < motorTmp )
                     {
-                    motorTmp -= m->motor_slew;
+                    motorTmp -= slew;
                     // limit
                     if( motorTmp < m->motor_req )
                         motorTmp = m->motor_req;
@@ -1688,7 +1844,7 @@ msg_t SmartMotorSlewRateTask( void *arg )
         vexDigitalPinSet( _smTestPoint_2, 0);
 #endif
         // Wait approx the speed of motor update over the spi
-        vexSleep( delayTimeMs );
+        vexPeriodicWait( &slewRatePeriodic );
         }
 
     return (msg_t)0;
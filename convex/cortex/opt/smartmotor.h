@@ -140,6 +140,39 @@
 #define SMLIB_LEDON             0
 #define SMLIB_LEDOFF            1
 
+/*-----------------------------------------------------------------------------*/
+/*  Motor command arbitration                                                  */
+/*                                                                             */
+/*  Each source writes into its own slot for a motor, the slew rate task picks */
+/*  the highest priority source holding a command every loop. A source holds   */
+/*  its command until it releases it. SetMotor is the default source so code   */
+/*  that knows nothing about this works as before.                             */
+/*-----------------------------------------------------------------------------*/
+
+#define SMLIB_MAX_SOURCES       8
+
+#define SMLIB_PRIORITY_DEFAULT      0
+#define SMLIB_PRIORITY_DRIVER       10
+#define SMLIB_PRIORITY_AUTONOMOUS   20
+#define SMLIB_PRIORITY_LOCK         30
+#define SMLIB_PRIORITY_SAFETY       40
+
+// sources that are always registered
+typedef enum {
+    kSmartMotorSourceDefault = 0,
+    kSmartMotorSourceDriver,
+    kSmartMotorSourceAutonomous,
+    kSmartMotorSourceLock,
+    kSmartMotorSourceSafety,
+
+    kSmartMotorSourceNum
+} tSmartMotorSource;
+
+typedef struct {
+    char   *name;
+    short   priority;
+    } smartMotorSource;
+
 
 /*-----------------------------------------------------------------------------*/
 /*                                                                             */
@@ -150,8 +183,8 @@
 /*  speed, current and temperature.  some of these are stored for debug        */
 /*  purposes                                                                   */
 /*                                                                             */
-/*  V1.02 code uses 124 bytes (a couple are wasted due to word alignment)      */
-/*  so 1240 bytes in all for the 10 motors.                                    */
+/*  This code uses 160 bytes (a few are wasted due to word alignment)          */
+/*  so 1600 bytes in all for the 10 motors.                                    */
 /*-----------------------------------------------------------------------------*/
 
 typedef struct {
@@ -191,6 +224,8 @@ typedef struct {
     // variables used by rpm calculation
     long    enc;
     long    oldenc;
+    // vexTimeUs of the sensor sample oldenc came from
+    uint32_t enctime;
     float   delta;
     float   rpm;
 
@@ -202,6 +237,7 @@ typedef struct {
     float   ke_motor;
     float   rpm_free;
     float   v_bemf_max;
+    float   lamda;
 
     // instantaneous current
     float   current;
@@ -222,10 +258,40 @@ typedef struct {
     float   t_ambient;
     short   ptc_tripped;
 
-    // Last program time we ran - may not keep this, bit overkill
-    long    lastPgmTime;
+    // Last program time we ran in uS, from vexTimeUs
+    uint32_t lastPgmTime;
+
+    // arbitration, each command source has its own slot
+    short   src_cmd[SMLIB_MAX_SOURCES];
+    // bit per source holding a command, and wanting it without slew
+    unsigned char src_active;
+    unsigned char src_immediate;
+    // source that won the last resolve, -1 for none
+    short   owner;
     } smartMotor;
 
+/*-----------------------------------------------------------------------------*/
+/*                                                                             */
+/*  Constants for each type of motor.  These are calculated on the host by     */
+/*  vexlutgen and stored in flash, see smartmotorlut.h                         */
+/*                                                                             */
+/*-----------------------------------------------------------------------------*/
+
+typedef struct {
+    float   i_free;
+    float   i_stall;
+    float   r_motor;
+    float   l_motor;
+    float   ke_motor;
+    float   rpm_free;
+    float   ticks_per_rev;
+    float   safe_current;
+    float   t_const_1;
+    float   t_const_2;
+    // r/(L * pwm freq) used every current calculation
+    float   lamda;
+    } smartMotorParams;
+
 /*-----------------------------------------------------------------------------*/
 /*  Motor control related definitions                                          */
 /*-----------------------------------------------------------------------------*/
@@ -333,18 +399,24 @@ void             _SmartMotorSetRpmSensor( tVexMotor index, tVexAnalogPin port, f
                  _SetMotor( index, value, ##__VA_ARGS__, FALSE )
 void             _SetMotor( int index, int value,  bool_t immediate, ... );
 
+// Arbitration
+short            SmartMotorSourceRegister( char *name, short priority );
+void             SmartMotorSourceSet( short source, tVexMotor index, int value, bool_t immediate );
+void             SmartMotorSourceRelease( short source, tVexMotor index );
+short            SmartMotorOwnerGet( tVexMotor index );
+
 // Access raw data
 smartMotor      *SmartMotorGetPtr( tVexMotor index );
 smartController *SmartMotorControllerGetPtr( short index );
 
 // Private functions for reference
-void             SmartMotorSpeed( smartMotor *m, int deltaTime );
+void             SmartMotorSpeed( smartMotor *m, float deltaTime );
 void             SmartMotorSimulateSpeed( smartMotor *m );
 float            SmartMotorCurrent( smartMotor *m, float v_battery  );
 float            SmartMotorControllerCurrent( smartController *s );
 int              SmartMotorSafeCommand( smartMotor *m, float v_battery  );
-float            SmartMotorTemperature( smartMotor *m, int deltaTime );
-float            SmartMotorControllerTemperature( smartController *s, int deltaTime  );
+float            SmartMotorTemperature( smartMotor *m, float deltaTime );
+float            SmartMotorControllerTemperature( smartController *s, float deltaTime  );
 void             SmartMotorMonitorPtc( smartMotor *m, float v_battery );
 void             SmartMotorControllerMonitorPtc( smartController *s, float v_battery );
 void             SmartMotorMonitorCurrent( smartMotor *m, float v_battery );
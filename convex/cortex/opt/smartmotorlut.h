@@ -0,0 +1,70 @@
+/*-----------------------------------------------------------------------------*/
+/*                                                                             */
+/*    smartmotorlut.h                                                          */
+/*                                                                             */
+/*    Generated by vexlutgen, do not edit.                                     */
+/*    Regenerate with  make -C src vexlut                                      */
+/*                                                                             */
+/*-----------------------------------------------------------------------------*/
+
+#ifndef __SMARTMOTORLUT__
+#define __SMARTMOTORLUT__
+
+/** @brief  Constants for each motor type, indexed by tVexMotorType
+ */
+static const smartMotorParams SmartMotorParams[] = {
+    [kVexMotor393T] = {
+        .i_free         = 0.200000003f,
+        .i_stall        = 4.80000019f,
+        .r_motor        = 1.5f,
+        .l_motor        = 0.000650000002f,
+        .ke_motor       = 0.0627272725f,
+        .rpm_free       = 110.0f,
+        .ticks_per_rev  = 627.200012f,
+        .safe_current   = 0.899999976f,
+        .t_const_1      = 75.0f,
+        .t_const_2      = 1.12676053e-05f,
+        .lamda          = 2.00668907f
+        },
+    [kVexMotor393S] = {
+        .i_free         = 0.200000003f,
+        .i_stall        = 4.80000019f,
+        .r_motor        = 1.5f,
+        .l_motor        = 0.000650000002f,
+        .ke_motor       = 0.0392045453f,
+        .rpm_free       = 176.0f,
+        .ticks_per_rev  = 392.0f,
+        .safe_current   = 0.899999976f,
+        .t_const_1      = 75.0f,
+        .t_const_2      = 1.12676053e-05f,
+        .lamda          = 2.00668907f
+        },
+    [kVexMotor393R] = {
+        .i_free         = 0.200000003f,
+        .i_stall        = 4.80000019f,
+        .r_motor        = 1.5f,
+        .l_motor        = 0.000650000002f,
+        .ke_motor       = 0.0261363629f,
+        .rpm_free       = 264.0f,
+        .ticks_per_rev  = 261.333008f,
+        .safe_current   = 0.899999976f,
+        .t_const_1      = 75.0f,
+        .t_const_2      = 1.12676053e-05f,
+        .lamda          = 2.00668907f
+        },
+    [kVexMotor269] = {
+        .i_free         = 0.180000007f,
+        .i_stall        = 2.88000011f,
+        .r_motor        = 2.5f,
+        .l_motor        = 0.000650000002f,
+        .ke_motor       = 0.0562499985f,
+        .rpm_free       = 120.0f,
+        .ticks_per_rev  = 240.447998f,
+        .safe_current   = 0.75f,
+        .t_const_1      = 133.333328f,
+        .t_const_2      = 3.9999999e-05f,
+        .lamda          = 3.34448171f
+        }
+    };
+
+#endif  // __SMARTMOTORLUT__
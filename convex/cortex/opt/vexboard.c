@@ -0,0 +1,255 @@
+/*-----------------------------------------------------------------------------*/
+/*                                                                             */
+/*    Module:     vexboard.c                                                   */
+/*    Created:    18 October 2026                                              */
+/*                                                                             */
+/*    Revisions:                                                               */
+/*                V1.00     18 Oct 2026 - Initial release                      */
+/*                                                                             */
+/*-----------------------------------------------------------------------------*/
+/*                                                                             */
+/*    This file is part of ConVEX.                                             */
+/*                                                                             */
+/*    ConVEX is free software; you can redistribute it                         */
+/*    and/or modify it under the terms of the GNU General Public License       */
+/*    as published by the Free Software Foundation; either version 3 of        */
+/*    the License, or (at your option) any later version.                      */
+/*                                                                             */
+/*    ConVEX is distributed in the hope that it will be useful,                */
+/*    but WITHOUT ANY WARRANTY; without even the implied warranty of           */
+/*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            */
+/*    GNU General Public License for more details.                             */
+/*                                                                             */
+/*    You should have received a copy of the GNU General Public License        */
+/*    along with this program.  If not, see <http://www.gnu.org/licenses/>.    */
+/*                                                                             */
+/*-----------------------------------------------------------------------------*/
+/*                                                                             */
+/*    Description:                                                             */
+/*                                                                             */
+/*    Sensor blackboard, see vexboard.h. The capture is a persistent loop on   */
+/*    the scheduler with the highest priority of the one frame loops, so it    */
+/*    runs at the start of every pass and the loops after it see the frame     */
+/*    that was taken for them.                                                 */
+/*                                                                             */
+/*-----------------------------------------------------------------------------*/
+
+#include <string.h>
+
+#include "ch.h"         // needs for all ChibiOS programs
+#include "hal.h"        // hardware abstraction layer header
+#include "vex.h"        // vex library header
+#include "vexgyro.h"
+#include "vexsched.h"
+#include "vexboard.h"
+
+/*-----------------------------------------------------------------------------*/
+/** @file    vexboard.c
+  * @brief   Frame coherent sensor blackboard
+*//*---------------------------------------------------------------------------*/
+
+typedef struct _vexBoard {
+    // odd while a capture is being written, newest complete frame is
+    // buffer[VEXBOARD_NEWEST(sequence)]
+    volatile uint32_t   sequence;
+    vexBoardFrame       buffer[2];
+
+    uint32_t            retries;        ///< copies that had to go again
+    vexSchedTask        sched;
+    } vexBoard;
+
+static vexBoard     vb;
+
+// keep the compiler from moving frame accesses across the sequence counter
+#define vexBoardBarrier()       __asm__ volatile("" ::: "memory")
+
+// two sequence steps per capture, the buffer flips every second step
+#define VEXBOARD_NEWEST(s)      (((s) >> 1) & 1)
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Take a snapshot into the frame that is not published           */
+/** @param[in]  arg Unused                                                     */
+/*-----------------------------------------------------------------------------*/
+static void
+vexBoardCapture( void *arg )
+{
+    vexBoardFrame  *f;
+    int16_t         i;
+
+    (void)arg;
+
+    // odd, readers of the other frame can see a capture has started
+    vb.sequence++;
+    vexBoardBarrier();
+
+    f = &vb.buffer[ VEXBOARD_NEWEST(vb.sequence) ^ 1 ];
+
+    f->seq    = (vb.sequence >> 1) + 1;
+    f->frame  = vexSchedFrameGet();
+    f->time   = chTimeNow();
+    f->cycles = halGetCounterValue();
+    f->us     = vexTimeUs();
+
+    for( i = 0; i < kVexAnalog_Num; i++ )
+        f->analog[i] = vexAdcGet( i );
+
+    f->digital = 0;
+    for( i = 0; i < kVexDigital_Num; i++ )
+        {
+        if( vexDigitalPinGet( (tVexDigitalPin)i ) )
+            f->digital |= (1 << i);
+        }
+
+    for( i = 0; i < kVexQuadEncoder_Num; i++ )
+        f->encoder[i] = vexEncoderGet( i );
+    for( i = 0; i < kVexSonar_Num; i++ )
+        f->sonar[i] = vexSonarGetCm( (tVexSonarChannel)i );
+    for( i = 0; i < kImeTotal; i++ )
+        f->ime[i] = vexImeGetCount( i );
+    f->gyro = vexGyroGet();
+
+    // joystick data was replaced by the SPI exchange that woke the scheduler
+    for( i = 0; i < VEXBOARD_CTL_NUM; i++ )
+        {
+        f->ctl[0][i] = vexControllerGet( (tCtlIndex)i );
+        f->ctl[1][i] = vexControllerGet( (tCtlIndex)(i + Ch1Xmtr2) );
+        }
+
+    f->mainBattery   = vexSpiGetMainBattery();
+    f->backupBattery = vexSpiGetBackupBattery();
+    f->mode          = vexModeGet();
+
+    vexBoardBarrier();
+    vb.sequence++;
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Start capturing                                                */
+/*-----------------------------------------------------------------------------*/
+/** @details
+ *  Call before the loops that read the board are started. The capture is
+ *  persistent so the board keeps going across competition modes, calling
+ *  this again does no harm.
+ */
+void
+vexBoardInit( void )
+{
+    if( vb.sched.update != NULL )
+        return;
+
+    // something to read before the first frame arrives
+    vexBoardCapture( NULL );
+
+    vexSchedAdd( &vb.sched, "board", vexBoardCapture, NULL, 1, VEXBOARD_PRIORITY );
+    vexSchedPersistentSet( &vb.sched, TRUE );
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Copy the newest frame                                          */
+/** @param[in]  f where to put it                                              */
+/*-----------------------------------------------------------------------------*/
+/** @details
+ *  Safe from any thread. A capture while copying writes the other frame,
+ *  the copy is only repeated if a second capture started, which makes the
+ *  sequence odd again and needs the caller to have been held off for a
+ *  whole frame.
+ */
+void
+vexBoardGet( vexBoardFrame *f )
+{
+    uint32_t    s;
+
+    while( TRUE )
+        {
+        // the frame being written, if any, is the other one
+        s = vb.sequence & ~1;
+        vexBoardBarrier();
+        memcpy( f, &vb.buffer[ VEXBOARD_NEWEST(s) ], sizeof( vexBoardFrame ) );
+        vexBoardBarrier();
+        if( (vb.sequence - s) <= 2 )
+            break;
+        vb.retries++;
+        }
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Get the newest frame without copying it                        */
+/** @return     A pointer to the frame                                         */
+/*-----------------------------------------------------------------------------*/
+/** @details
+ *  For loops on the scheduler thread, the frame does not change until the
+ *  next pass. Other threads should use vexBoardGet.
+ */
+const vexBoardFrame *
+vexBoardGetPtr( void )
+{
+    return( &vb.buffer[ VEXBOARD_NEWEST(vb.sequence) ] );
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Get one analog input from the newest frame                     */
+/** @param[in]  index The analog channel                                       */
+/** @return     The ADC value                                                  */
+/*-----------------------------------------------------------------------------*/
+int16_t
+vexBoardAnalogGet( int16_t index )
+{
+    if( (index < 0) || (index >= kVexAnalog_Num) )
+        return( 0 );
+
+    // one halfword, always from a single capture
+    return( vb.buffer[ VEXBOARD_NEWEST(vb.sequence) ].analog[index] );
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Get a joystick control from a frame                            */
+/** @param[in]  f The frame                                                    */
+/** @param[in]  index Same as vexControllerGet                                 */
+/** @return     The control value                                              */
+/*-----------------------------------------------------------------------------*/
+int16_t
+vexBoardControllerGet( const vexBoardFrame *f, tCtlIndex index )
+{
+    if( (index & 0x7F) >= VEXBOARD_CTL_NUM )
+        return( 0 );
+
+    return( f->ctl[ (index < Ch1Xmtr2) ? 0 : 1 ][ index & 0x7F ] );
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Debug function, show the newest frame                          */
+/** @param[in]  chp     A pointer to a vexStream object                        */
+/** @param[in]  argc    The number of command line arguments                   */
+/** @param[in]  argv    An array of pointers to the command line args          */
+/*-----------------------------------------------------------------------------*/
+void
+vexBoardDebug(vexStream *chp, int argc, char *argv[])
+{
+    vexBoardFrame   f;
+    int16_t         i;
+
+    (void)argc;
+    (void)argv;
+
+    vexBoardGet( &f );
+
+    vex_chprintf( chp, "seq %d frame %d time %d us %u retries %d\r\n", f.seq, f.frame, f.time, f.us, vb.retries );
+    vex_chprintf( chp, "analog " );
+    for( i = 0; i < kVexAnalog_Num; i++ )
+        vex_chprintf( chp, " %4d", f.analog[i] );
+    vex_chprintf( chp, "\r\ndigital 0x%03X\r\n", f.digital );
+    vex_chprintf( chp, "encoder" );
+    for( i = 0; i < kVexQuadEncoder_Num; i++ )
+        vex_chprintf( chp, " %d", f.encoder[i] );
+    vex_chprintf( chp, "\r\nsonar  " );
+    for( i = 0; i < kVexSonar_Num; i++ )
+        vex_chprintf( chp, " %d", f.sonar[i] );
+    vex_chprintf( chp, "\r\nime    " );
+    for( i = 0; i < kImeTotal; i++ )
+        vex_chprintf( chp, " %d", f.ime[i] );
+    vex_chprintf( chp, "\r\ngyro %d\r\n", f.gyro );
+    vex_chprintf( chp, "js1 %4d %4d %4d %4d js2 %4d %4d %4d %4d\r\n",
+        f.ctl[0][Ch1], f.ctl[0][Ch2], f.ctl[0][Ch3], f.ctl[0][Ch4],
+        f.ctl[1][Ch1], f.ctl[1][Ch2], f.ctl[1][Ch3], f.ctl[1][Ch4] );
+    vex_chprintf( chp, "battery %d mV backup %d mV mode %d\r\n", f.mainBattery, f.backupBattery, f.mode );
+}
@@ -0,0 +1,103 @@
+/*-----------------------------------------------------------------------------*/
+/*                                                                             */
+/*    Module:     vexboard.h                                                   */
+/*    Created:    18 October 2026                                              */
+/*                                                                             */
+/*    Revisions:                                                               */
+/*                V1.00     18 Oct 2026 - Initial release                      */
+/*                                                                             */
+/*-----------------------------------------------------------------------------*/
+/*                                                                             */
+/*    This file is part of ConVEX.                                             */
+/*                                                                             */
+/*    ConVEX is free software; you can redistribute it                         */
+/*    and/or modify it under the terms of the GNU General Public License       */
+/*    as published by the Free Software Foundation; either version 3 of        */
+/*    the License, or (at your option) any later version.                      */
+/*                                                                             */
+/*    ConVEX is distributed in the hope that it will be useful,                */
+/*    but WITHOUT ANY WARRANTY; without even the implied warranty of           */
+/*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            */
+/*    GNU General Public License for more details.                             */
+/*                                                                             */
+/*    You should have received a copy of the GNU General Public License        */
+/*    along with this program.  If not, see <http://www.gnu.org/licenses/>.    */
+/*                                                                             */
+/*-----------------------------------------------------------------------------*/
+/*                                                                             */
+/*    Description:                                                             */
+/*                                                                             */
+/*    Sensor blackboard. Once each control tick, before any loop runs, one     */
+/*    snapshot of every analog input, digital pin, encoder, sonar, IME, the    */
+/*    gyro, both joysticks and the batteries is taken and stamped with the     */
+/*    frame and time. Loops read that one frame instead of going back to each  */
+/*    driver, so everything they see was sampled together and a sensor used    */
+/*    several times in a tick is only read once.                               */
+/*                                                                             */
+/*    There are two frames. The newest is never written, the next capture      */
+/*    goes into the other one. A sequence number is odd while a capture is     */
+/*    written and even once it is published. Readers copy the newest and only  */
+/*    go round again if a second capture started while they were copying,      */
+/*    nothing is locked and a reader above the scheduler thread never waits.   */
+/*                                                                             */
+/*-----------------------------------------------------------------------------*/
+
+#ifndef __VEXBOARD__
+#define __VEXBOARD__
+
+/*-----------------------------------------------------------------------------*/
+/** @file    vexboard.h
+  * @brief   Sensor blackboard macros and prototypes
+*//*---------------------------------------------------------------------------*/
+
+/** @brief above every control loop so it runs first in the pass
+ */
+#define VEXBOARD_PRIORITY           255
+
+/** @brief decoded controls per joystick, Ch1 to BtnAny
+ */
+#define VEXBOARD_CTL_NUM            (BtnAny + 1)
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      One coherent snapshot of the robot inputs                      */
+/*-----------------------------------------------------------------------------*/
+/** @details
+ *  Unused ports read as the drivers return them, encoders and IMEs as 0 and
+ *  sonars as -1. Joystick values are decoded as vexControllerGet does.
+ */
+typedef struct _vexBoardFrame {
+    uint32_t            seq;            ///< capture number
+    uint32_t            frame;          ///< scheduler frame it was taken in
+    systime_t           time;
+    uint32_t            cycles;         ///< cycle count at the start
+    uint32_t            us;             ///< vexTimeUs at the start
+
+    int16_t             analog[kVexAnalog_Num];
+    uint16_t            digital;        ///< bit per pin
+    int32_t             encoder[kVexQuadEncoder_Num];
+    int16_t             sonar[kVexSonar_Num];           ///< cm
+    int32_t             ime[kImeTotal];
+    int32_t             gyro;
+
+    int16_t             ctl[2][VEXBOARD_CTL_NUM];
+    uint16_t            mainBattery;    ///< mV
+    uint16_t            backupBattery;  ///< mV
+    tVexMode            mode;
+    } vexBoardFrame;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void                 vexBoardInit( void );
+void                 vexBoardGet( vexBoardFrame *f );
+const vexBoardFrame *vexBoardGetPtr( void );
+int16_t              vexBoardAnalogGet( int16_t index );
+int16_t              vexBoardControllerGet( const vexBoardFrame *f, tCtlIndex index );
+void                 vexBoardDebug( vexStream *chp, int argc, char *argv[] );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // __VEXBOARD__
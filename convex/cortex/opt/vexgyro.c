@@ -78,14 +78,12 @@ vexGyroTask(void *arg)
 {
     int16_t     i;
     int32_t     GyroBiasAcc = 0;
-    int32_t     GyroBias;
-    int32_t     GyroSmallBias;
     int32_t     GyroRaw;
-    int32_t     GyroRawFiltered = 0;
+    int64_t     GyroRawFiltered = 0;
 
-    int16_t     GyroDelta;
+    int32_t     GyroDelta;
     int32_t     GyroSensorScale = 130;
-    int32_t     GyroJitterCycles = 0;
+    uint32_t    GyroTime, now;
 
     (void)arg;
     chRegSetThreadName("gyro");
@@ -97,30 +95,29 @@ vexGyroTask(void *arg)
         chThdSleepMilliseconds(1);
         }
 
-    GyroBias      = GyroBiasAcc / 1024;
-    GyroSmallBias = GyroBiasAcc - (GyroBias * 1024);
-    // Ok bias done
+    // Ok bias done, the sum of 1024 samples is the bias * 1024 so the
+    // fractional part is kept without a separate correction
+    GyroTime = vexTimeUs();
 
     while(!chThdShouldTerminate())
         {
-        // Get raw analog value
+        // Get raw analog value and when it was taken
         GyroRaw   = vexAdcGet( gyroAnalogPin );
-        // remove bias
-        GyroDelta = GyroRaw - GyroBias;
+        now       = vexTimeUs();
+        // remove bias, * 1024
+        GyroDelta = (GyroRaw * 1024) - GyroBiasAcc;
 
         // ignore small changes
-        if ((GyroDelta < -GyroJitterRange) || (GyroDelta > +GyroJitterRange))
+        if ((GyroDelta < -GyroJitterRange * 1024) || (GyroDelta > +GyroJitterRange * 1024))
             {
-            // integrate angle
-            GyroRawFiltered += GyroDelta;
-
-            // compensate for error in bias
-            if ((++GyroJitterCycles % 1024) == 0)
-                GyroRawFiltered -= GyroSmallBias;
+            // integrate angle over the real time since the last sample, a
+            // 1mS sleep is anything from just under 1mS to 2mS
+            GyroRawFiltered += (int64_t)GyroDelta * (uint32_t)(now - GyroTime);
             }
+        GyroTime = now;
 
-        // calculate angle in deg * 10
-        GyroValue = GyroRawFiltered / GyroSensorScale;
+        // calculate angle in deg * 10, scale is counts over 1mS
+        GyroValue = GyroRawFiltered / ((int64_t)GyroSensorScale * 1024 * 1000);
 
         // sleep
         chThdSleepMilliseconds(1);
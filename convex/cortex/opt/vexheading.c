@@ -0,0 +1,508 @@
+/*-----------------------------------------------------------------------------*/
+/*                                                                             */
+/*    Module:     vexheading.c                                                 */
+/*    Created:    18 October 2026                                              */
+/*                                                                             */
+/*    Revisions:                                                               */
+/*                V1.00     18 Oct 2026 - Initial release                      */
+/*                                                                             */
+/*-----------------------------------------------------------------------------*/
+/*                                                                             */
+/*    This file is part of ConVEX.                                             */
+/*                                                                             */
+/*    ConVEX is free software; you can redistribute it                         */
+/*    and/or modify it under the terms of the GNU General Public License       */
+/*    as published by the Free Software Foundation; either version 3 of        */
+/*    the License, or (at your option) any later version.                      */
+/*                                                                             */
+/*    ConVEX is distributed in the hope that it will be useful,                */
+/*    but WITHOUT ANY WARRANTY; without even the implied warranty of           */
+/*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            */
+/*    GNU General Public License for more details.                             */
+/*                                                                             */
+/*    You should have received a copy of the GNU General Public License        */
+/*    along with this program.  If not, see <http://www.gnu.org/licenses/>.    */
+/*                                                                             */
+/*-----------------------------------------------------------------------------*/
+
+#include <stdlib.h>
+
+#include "ch.h"         // needs for all ChibiOS programs
+#include "hal.h"        // hardware abstraction layer header
+#include "vex.h"        // vex library header
+#include "vexheading.h"
+
+/*-----------------------------------------------------------------------------*/
+/** @file    vexheading.c
+  * @brief   Gyro heading filter with encoder correction and bias tracking
+*//*---------------------------------------------------------------------------*/
+
+// gyro raw counts integrated over 1mS for 0.1 deg, same as vexgyro
+#define VEXHEADING_SCALE        130
+
+// binary angle per Q16.16 count sample over 1mS, Q24, so angle = (d * K) >> 24
+#define VEXHEADING_K            ((int64_t)(1099511627776.0 / (3600.0 * VEXHEADING_SCALE) + 0.5))
+
+// encoder changes larger than this in one window are a reset of the count
+#define VEXHEADING_MAX_DELTA    100
+
+// floor for the noise estimate, ADC quantization is 1/12 count^2 (Q8)
+#define VEXHEADING_MIN_NOISE    21
+
+// going to run the filter as a user task
+static WORKING_AREA(waVexHeadingTask, USER_TASK_STACK_SIZE);
+
+typedef struct _vexHeading {
+    tVexAnalogPin   pin;
+    tVexMotor       left;
+    bool_t          leftReversed;
+    tVexMotor       right;
+    bool_t          rightReversed;
+    int32_t         anglePerTick;
+
+    // gyro bias in raw counts Q16.16 and its noise in counts^2 Q24.8
+    int32_t         bias;
+    uint32_t        noise;
+    uint32_t        biasSamples;
+    uint32_t        biasUpdates;
+
+    // integrated heading in binary angle units, not wrapped
+    int64_t         total;
+    uint32_t        frac;
+    uint32_t        sampleTime;     ///< vexTimeUs of the last gyro sample
+
+    // variance model state, mS moving since the last bias estimate
+    uint32_t        movingMs;
+    uint32_t        variance;
+
+    // still detection and bias accumulators, held is the angle integrated
+    // while still since the last bias update
+    int16_t         stillWindows;
+    int32_t         held;
+    uint32_t        stillSum;
+    uint64_t        stillSumSq;
+    uint32_t        stillCount;
+
+    uint32_t        slips;
+    uint32_t        slowTurns;
+    vexPeriodic     periodic;       ///< sample timing, counts the overruns
+
+    // published estimate, guarded by sequence
+    volatile uint32_t   sequence;
+    vexHeadingData      data;
+
+    Thread         *thread;
+    } vexHeading;
+
+static vexHeading   vh = { .pin = kVexAnalog_None, .left = kVexMotor_None, .right = kVexMotor_None };
+
+// keep the compiler from moving data accesses across the sequence counter
+#define vexHeadingBarrier()     __asm__ volatile("" ::: "memory")
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Update bias and noise from accumulated still samples           */
+/*-----------------------------------------------------------------------------*/
+/** @details
+ *  Variance of the samples is (n * sum(x^2) - sum(x)^2) / n^2, the 64 bit
+ *  math happens at most once per second.
+ */
+static void
+vexHeadingBiasUpdate( uint32_t sum, uint64_t sumsq, uint32_t n )
+{
+    uint64_t    v;
+
+    if( n == 0 )
+        return;
+
+    v = ((sumsq * n) - ((uint64_t)sum * sum)) << 8;
+    v = v / ((uint64_t)n * n);
+    if( v < VEXHEADING_MIN_NOISE )
+        v = VEXHEADING_MIN_NOISE;
+    if( v > 0xFFFFFFFF )
+        v = 0xFFFFFFFF;
+
+    vh.bias        = (int32_t)(((uint64_t)sum << 16) / n);
+    vh.noise       = (uint32_t)v;
+    vh.biasSamples = n;
+    vh.movingMs    = 0;
+    vh.biasUpdates++;
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Grow the variance for one window of movement                   */
+/** @param[in]  encoderOk The encoder correction was applied                   */
+/*-----------------------------------------------------------------------------*/
+/** @details
+ *  Two terms in (deg * 10)^2 before scaling, white noise random walk
+ *  w * noise / scale^2 and residual bias error ((t+w)^2 - t^2) * noise / n
+ *  / scale^2 where t is time moving since the last bias estimate. The
+ *  encoder correction removes 1/8 of the gyro error each window.
+ */
+static void
+vexHeadingVarianceUpdate( bool_t encoderOk )
+{
+    uint64_t    x;
+    uint64_t    inc;
+    uint32_t    t = vh.movingMs;
+    uint32_t    w = VEXHEADING_WINDOW * VEXHEADING_SAMPLE_MS;
+
+    // x is the time term Q8
+    x = (uint64_t)w << 8;
+    x = x + ((((uint64_t)2 * t * w + (uint64_t)w * w) << 8) / vh.biasSamples);
+
+    // noise Q8 * x Q8 / (scale * 10)^2 gives deg^2 Q16
+    inc = (vh.noise * x) / ((uint64_t)VEXHEADING_SCALE * VEXHEADING_SCALE * 100);
+
+    if( encoderOk )
+        inc = (inc * 49) >> 6;
+
+    inc += vh.variance;
+    vh.variance = (inc > 0x7FFFFFFF) ? 0x7FFFFFFF : (uint32_t)inc;
+
+    if( t < 0x7FFFFFFF )
+        vh.movingMs = t + w;
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Publish the estimate                                           */
+/** @param[in]  d The change in heading since the last publish               */
+/** @param[in]  rate The turn rate in deg * 10 per second                     */
+/** @param[in]  still The robot is stationary                                  */
+/*-----------------------------------------------------------------------------*/
+
+static void
+vexHeadingPublish( int32_t d, int32_t rate, bool_t still )
+{
+    chSysLock();
+    vh.total += d;
+
+    vh.sequence++;
+    vexHeadingBarrier();
+    vh.data.heading  = (fixangle_t)vh.total;
+    vh.data.deg10    = (int32_t)((vh.total * 3600) >> 32);
+    vh.data.rate     = rate;
+    vh.data.variance = (fix16_t)vh.variance;
+    vh.data.still    = still;
+    vh.data.time     = chTimeNow();
+    vh.data.us       = vh.sampleTime;
+    vexHeadingBarrier();
+    vh.sequence++;
+    chSysUnlock();
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Read an encoder count, reversed if necessary                   */
+/*-----------------------------------------------------------------------------*/
+
+static int32_t
+vexHeadingCount( tVexMotor motor, bool_t reversed )
+{
+    int32_t count = vexMotorPositionGet( motor );
+    return( reversed ? -count : count );
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Heading filter task                                            */
+/*-----------------------------------------------------------------------------*/
+/** @details
+ *  Samples the gyro every mS, each VEXHEADING_WINDOW samples the gyro
+ *  change is compared with the encoder differential. If they agree within
+ *  VEXHEADING_SLIP a fraction of the difference is applied, larger
+ *  differences are wheel slip and only the gyro is used.
+ *
+ *  While still the gyro is still integrated but the heading is held. The
+ *  held angle is applied if the window turns out to be moving, or once it
+ *  passes VEXHEADING_STILL_ANGLE, a turn too slow for the rate test.
+ */
+static msg_t
+vexHeadingTask( void *arg )
+{
+    int32_t     raw;
+    int32_t     d;
+    int64_t     a;
+    int16_t     i;
+    uint32_t    sum = 0;
+    uint64_t    sumsq = 0;
+
+    int32_t     winSum, winAngle, winStep;
+    int32_t     leftCount = 0, rightCount = 0;
+    int32_t     dl, dr;
+    int32_t     err, corr, rate;
+    uint32_t    now, dt;
+    bool_t      useEncoders;
+    bool_t      encoderOk;
+    bool_t      still = FALSE;
+    bool_t      slowTurn;
+
+    (void)arg;
+    chRegSetThreadName("heading");
+
+    useEncoders = (vh.left != kVexMotor_None && vh.right != kVexMotor_None && vh.anglePerTick != 0);
+
+    // initial bias, robot must be still
+    for(i=0;i<VEXHEADING_CAL_SAMPLES;i++)
+        {
+        raw = vexAdcGet( vh.pin );
+        sum += raw;
+        sumsq += (uint32_t)(raw * raw);
+        chThdSleepMilliseconds(VEXHEADING_SAMPLE_MS);
+        }
+    vexHeadingBiasUpdate( sum, sumsq, VEXHEADING_CAL_SAMPLES );
+    vexHeadingPublish( 0, 0, FALSE );
+
+    if( useEncoders )
+        {
+        leftCount  = vexHeadingCount( vh.left,  vh.leftReversed );
+        rightCount = vexHeadingCount( vh.right, vh.rightReversed );
+        }
+
+    vexPeriodicInit( &vh.periodic, VEXHEADING_SAMPLE_MS );
+    vh.sampleTime = vexTimeUs();
+
+    while(!chThdShouldTerminate())
+        {
+        winSum   = 0;
+        winAngle = 0;
+        sum      = 0;
+        sumsq    = 0;
+
+        for(i=0;i<VEXHEADING_WINDOW;i++)
+            {
+            raw = vexAdcGet( vh.pin );
+            now = vexTimeUs();
+            dt  = now - vh.sampleTime;
+            vh.sampleTime = now;
+            sum += raw;
+            sumsq += (uint32_t)(raw * raw);
+
+            // |raw - bias| is under 2300 counts so 10 of these fit Q16.16
+            d = (raw << 16) - vh.bias;
+            winSum += d;
+
+            // K is for 1mS, scale by the real time since the last
+            // sample so a late wakeup or skipped sample is not lost
+            a = (((int64_t)d * VEXHEADING_K) / 1000) * dt + vh.frac;
+            winStep = (int32_t)(a >> 24);
+            vh.frac = (uint32_t)(a & 0xFFFFFF);
+            winAngle += winStep;
+
+            // heading is held while still, the window is kept until the
+            // end shows whether the gyro was only measuring bias
+            if( !still )
+                vexHeadingPublish( winStep, vh.data.rate, still );
+
+            // missed samples are skipped, dt above covers the gap
+            vexPeriodicWait( &vh.periodic );
+            }
+
+        // deg * 10 per second
+        rate = (int32_t)(((int64_t)winSum * (1000 / (VEXHEADING_WINDOW * VEXHEADING_SAMPLE_MS))) /
+                         ((int64_t)VEXHEADING_SCALE << 16));
+
+        // encoder differential for the window
+        dl = dr = 0;
+        encoderOk = FALSE;
+        corr = 0;
+        if( useEncoders )
+            {
+            dl = vexHeadingCount( vh.left,  vh.leftReversed );
+            dr = vexHeadingCount( vh.right, vh.rightReversed );
+            dl -= leftCount;  leftCount  += dl;
+            dr -= rightCount; rightCount += dr;
+
+            if( abs(dl) > VEXHEADING_MAX_DELTA || abs(dr) > VEXHEADING_MAX_DELTA )
+                dl = dr = 0;
+            else
+            if( !still )
+                {
+                err = fixAngleDiff( (fixangle_t)((dr - dl) * vh.anglePerTick), (fixangle_t)winAngle );
+                if( abs(err) < (int32_t)VEXHEADING_SLIP )
+                    {
+                    corr = err >> VEXHEADING_ENC_SHIFT;
+                    encoderOk = TRUE;
+                    }
+                else
+                    vh.slips++;
+                }
+            }
+
+        // zero velocity, encoders not moving and gyro rate close to bias
+        if( dl == 0 && dr == 0 &&
+            abs(winSum) < ((VEXHEADING_STILL_RATE * VEXHEADING_WINDOW) << 16) )
+            {
+            if( vh.stillWindows < VEXHEADING_STILL_WINDOWS )
+                vh.stillWindows++;
+            }
+        else
+            vh.stillWindows = 0;
+
+        // a turn slower than the rate test still adds up while held
+        slowTurn = FALSE;
+        if( still )
+            {
+            vh.held += winAngle;
+            if( abs(vh.held) >= (int32_t)VEXHEADING_STILL_ANGLE )
+                {
+                vh.slowTurns++;
+                vh.stillWindows = 0;
+                slowTurn = TRUE;
+                }
+            }
+
+        if( vh.stillWindows >= VEXHEADING_STILL_WINDOWS )
+            {
+            // still, collect samples for a new bias
+            if( still )
+                {
+                vh.stillSum   += sum;
+                vh.stillSumSq += sumsq;
+                vh.stillCount += VEXHEADING_WINDOW;
+
+                // the held angle was bias, the new estimate takes it out
+                if( vh.stillCount >= VEXHEADING_BIAS_MAX )
+                    {
+                    vexHeadingBiasUpdate( vh.stillSum, vh.stillSumSq, vh.stillCount );
+                    vh.stillSum = vh.stillSumSq = vh.stillCount = 0;
+                    vh.held = 0;
+                    }
+                }
+            still = TRUE;
+            }
+        else
+            {
+            // moving again, use what we have if there is enough of it, a
+            // slow turn means the samples were not bias at all
+            if( still && !slowTurn && vh.stillCount >= VEXHEADING_BIAS_MIN )
+                vexHeadingBiasUpdate( vh.stillSum, vh.stillSumSq, vh.stillCount );
+            vh.stillSum = vh.stillSumSq = vh.stillCount = 0;
+
+            // the held angle, including the window where motion started
+            corr += vh.held;
+            vh.held = 0;
+
+            vexHeadingVarianceUpdate( encoderOk );
+            still = FALSE;
+            }
+
+        vexHeadingPublish( corr, rate, still );
+        }
+
+    vh.thread = NULL;
+    return( (msg_t) 0);
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Use drive encoders to correct the gyro                         */
+/** @param[in]  left The left drive motor with an IME                          */
+/** @param[in]  leftReversed Flag indicating the left count should be reversed */
+/** @param[in]  right The right drive motor with an IME                        */
+/** @param[in]  rightReversed Flag indicating the right count should be reversed */
+/** @param[in]  anglePerTick Binary angle turned per tick of (right - left)   */
+/*-----------------------------------------------------------------------------*/
+/** @details
+ *  Call before vexHeadingInit, the encoders are also used to decide when the
+ *  robot is still. Without encoders only the gyro rate is used for that.
+ */
+void
+vexHeadingEncoderSet( tVexMotor left, bool_t leftReversed,
+                      tVexMotor right, bool_t rightReversed, int32_t anglePerTick )
+{
+    vh.left          = left;
+    vh.leftReversed  = leftReversed;
+    vh.right         = right;
+    vh.rightReversed = rightReversed;
+    vh.anglePerTick  = anglePerTick;
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Init the heading filter task                                   */
+/** @param[in]  pin The analog port the gyro is on                             */
+/*-----------------------------------------------------------------------------*/
+/** @details
+ *  The first second is bias calibration, the robot must not move.
+ */
+void
+vexHeadingInit( tVexAnalogPin pin )
+{
+    if( (pin < kVexAnalog_1) || (pin > kVexAnalog_8))
+        return;
+    if( vh.thread != NULL )
+        return;
+
+    vh.pin = pin;
+
+    // above the control loops so samples are not delayed
+    vh.thread = chThdCreateStatic(waVexHeadingTask, sizeof(waVexHeadingTask), USER_THREAD_PRIORITY + 3, vexHeadingTask, NULL);
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Get the latest heading estimate, safe from any thread          */
+/** @param[out] h Where to copy the estimate                                   */
+/*-----------------------------------------------------------------------------*/
+
+void
+vexHeadingGet( vexHeadingData *h )
+{
+    uint32_t    sequence;
+
+    do  {
+        sequence = vh.sequence;
+        vexHeadingBarrier();
+        *h = vh.data;
+        vexHeadingBarrier();
+        } while( (sequence & 1) || sequence != vh.sequence );
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Set the heading, clears the variance and the still state       */
+/** @param[in]  heading The new heading                                        */
+/*-----------------------------------------------------------------------------*/
+
+void
+vexHeadingReset( fixangle_t heading )
+{
+    chSysLock();
+    vh.total    = (int32_t)heading;
+    vh.variance = 0;
+    vh.frac     = 0;
+
+    // an angle held from before the reset must not be applied after it
+    vh.held         = 0;
+    vh.stillWindows = 0;
+    vh.stillSum     = 0;
+    vh.stillSumSq   = 0;
+    vh.stillCount   = 0;
+    chSysUnlock();
+
+    vexHeadingPublish( 0, vh.data.rate, vh.data.still );
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Dump heading filter state                                      */
+/** @param[in]  chp     A pointer to a vexStream object                        */
+/** @param[in]  argc    The number of command line arguments                   */
+/** @param[in]  argv    An array of pointers to the command line args          */
+/*-----------------------------------------------------------------------------*/
+
+void
+vexHeadingDebug(vexStream *chp, int argc, char *argv[])
+{
+    vexHeadingData  h;
+
+    (void)argc;
+    (void)argv;
+
+    vexHeadingGet( &h );
+
+    vex_chprintf( chp, "heading  %d (deg * 10)\r\n", h.deg10 );
+    vex_chprintf( chp, "rate     %d\r\n", h.rate );
+    vex_chprintf( chp, "variance %f\r\n", FIX16_TO_FLOAT(h.variance) );
+    vex_chprintf( chp, "still    %d\r\n", h.still );
+    vex_chprintf( chp, "time     %d\r\n", h.time );
+    vex_chprintf( chp, "bias     %f\r\n", FIX16_TO_FLOAT(vh.bias) );
+    vex_chprintf( chp, "noise    %f\r\n", (float)vh.noise / 256.0f );
+    vex_chprintf( chp, "updates  %d\r\n", vh.biasUpdates );
+    vex_chprintf( chp, "slips    %d\r\n", vh.slips );
+    vex_chprintf( chp, "slow     %d\r\n", vh.slowTurns );
+    vex_chprintf( chp, "overruns %d\r\n", vh.periodic.overruns );
+}
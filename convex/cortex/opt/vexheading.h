@@ -0,0 +1,113 @@
+/*-----------------------------------------------------------------------------*/
+/*                                                                             */
+/*    Module:     vexheading.h                                                 */
+/*    Created:    18 October 2026                                              */
+/*                                                                             */
+/*    Revisions:                                                               */
+/*                V1.00     18 Oct 2026 - Initial release                      */
+/*                                                                             */
+/*-----------------------------------------------------------------------------*/
+/*                                                                             */
+/*    This file is part of ConVEX.                                             */
+/*                                                                             */
+/*    ConVEX is free software; you can redistribute it                         */
+/*    and/or modify it under the terms of the GNU General Public License       */
+/*    as published by the Free Software Foundation; either version 3 of        */
+/*    the License, or (at your option) any later version.                      */
+/*                                                                             */
+/*    ConVEX is distributed in the hope that it will be useful,                */
+/*    but WITHOUT ANY WARRANTY; without even the implied warranty of           */
+/*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            */
+/*    GNU General Public License for more details.                             */
+/*                                                                             */
+/*    You should have received a copy of the GNU General Public License        */
+/*    along with this program.  If not, see <http://www.gnu.org/licenses/>.    */
+/*                                                                             */
+/*-----------------------------------------------------------------------------*/
+/*                                                                             */
+/*    Description:                                                             */
+/*                                                                             */
+/*    Heading filter, integrates the gyro at 1kHz and corrects it with the     */
+/*    drive encoders. When the encoders and gyro both say the robot is not     */
+/*    moving the heading is held and the gyro bias is measured again, this     */
+/*    removes most of the drift the simple vexGyro task suffers from.          */
+/*                                                                             */
+/*    Use either this or vexGyroInit on a given port, not both.                */
+/*                                                                             */
+/*-----------------------------------------------------------------------------*/
+
+#ifndef __VEXHEADING__
+#define __VEXHEADING__
+
+#include "fixmath.h"
+
+/*-----------------------------------------------------------------------------*/
+/** @file    vexheading.h
+  * @brief   Gyro and encoder heading filter macros and prototypes
+*//*---------------------------------------------------------------------------*/
+
+/** @brief gyro sample period in mS
+ */
+#define VEXHEADING_SAMPLE_MS        1
+/** @brief number of gyro samples in each encoder fusion window
+ */
+#define VEXHEADING_WINDOW           10
+/** @brief number of samples used for the initial bias calibration
+ */
+#define VEXHEADING_CAL_SAMPLES      1024
+/** @brief minimum and maximum number of still samples for a bias update
+ */
+#define VEXHEADING_BIAS_MIN         256
+#define VEXHEADING_BIAS_MAX         1024
+/** @brief consecutive still windows before the robot is considered stopped
+ */
+#define VEXHEADING_STILL_WINDOWS    20
+/** @brief mean gyro rate in raw counts below which a window may be still
+ */
+#define VEXHEADING_STILL_RATE       3
+/** @brief angle held while still that is taken as a slow turn instead of bias
+ */
+#define VEXHEADING_STILL_ANGLE      FIXANGLE_DEG(0.5)
+/** @brief encoder correction gain is 1/(2^shift)
+ */
+#define VEXHEADING_ENC_SHIFT        3
+/** @brief gyro and encoder disagreement above this per window is wheel slip
+ */
+#define VEXHEADING_SLIP             FIXANGLE_DEG(1.0)
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Heading estimate                                               */
+/*-----------------------------------------------------------------------------*/
+/** @details
+ *  heading is the wrapped binary angle, deg10 is the same estimate in
+ *  degrees * 10 without wrapping so it can replace vexGyroGet.
+ *  variance is the estimated error variance in deg^2 Q16.16, it grows while
+ *  the robot moves and does not shrink until vexHeadingReset.
+ */
+typedef struct _vexHeadingData {
+    fixangle_t      heading;        ///< heading, CCW positive
+    int32_t         deg10;          ///< heading in deg * 10, not wrapped
+    int32_t         rate;           ///< turn rate in deg * 10 per second
+    fix16_t         variance;       ///< error variance in deg^2, Q16.16
+    bool_t          still;          ///< robot is stationary, bias being updated
+    systime_t       time;           ///< time of the last gyro sample
+    uint32_t        us;             ///< vexTimeUs of the last gyro sample
+    } vexHeadingData;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void        vexHeadingInit( tVexAnalogPin pin );
+void        vexHeadingEncoderSet( tVexMotor left, bool_t leftReversed,
+                                  tVexMotor right, bool_t rightReversed,
+                                  int32_t anglePerTick );
+void        vexHeadingGet( vexHeadingData *h );
+void        vexHeadingReset( fixangle_t heading );
+void        vexHeadingDebug( vexStream *chp, int argc, char *argv[] );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // __VEXHEADING__
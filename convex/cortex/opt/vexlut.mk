@@ -0,0 +1,42 @@
+# Host generated constant tables for pidlib, smartmotor and fixmath.
+# Include after rules.mk so the build check runs as part of "all".
+#
+#   make vexlut       regenerate pidlut.h, smartmotorlut.h and fixmathlut.h
+#   make vexlutcheck  check the tables in the tree match the formulas
+#
+HOSTCC     ?= cc
+VEXLUTDIR   = $(BUILDDIR)/lut
+VEXLUTGEN   = $(VEXLUTDIR)/vexlutgen
+VEXLUTDEPS  = ${CONVEX}/opt/host/vexlutgen.c \
+              ${CONVEX}/opt/host/vex.h \
+              ${CONVEX}/opt/pidlib.h \
+              ${CONVEX}/opt/smartmotor.h \
+              ${CONVEX}/opt/fixmath.h \
+              ${CONVEX}/opt/fastmath.c
+
+# Same IEEE single precision results as the cortex, no fused multiply-add
+$(VEXLUTGEN): $(VEXLUTDEPS)
+	@mkdir -p $(VEXLUTDIR)
+	$(HOSTCC) -O1 -ffp-contract=off -Wall -I${CONVEX}/opt/host -I${CONVEX}/opt -o $@ $< -lm
+
+vexlut: $(VEXLUTGEN)
+	$(VEXLUTGEN) check
+	$(VEXLUTGEN) pid > ${CONVEX}/opt/pidlut.h
+	$(VEXLUTGEN) smartmotor > ${CONVEX}/opt/smartmotorlut.h
+	$(VEXLUTGEN) fixmath > ${CONVEX}/opt/fixmathlut.h
+
+vexlutcheck: $(VEXLUTGEN)
+	@$(VEXLUTGEN) check
+	@$(VEXLUTGEN) pid | cmp -s - ${CONVEX}/opt/pidlut.h || \
+	    (echo "pidlut.h is out of date, run make vexlut"; exit 1)
+	@$(VEXLUTGEN) smartmotor | cmp -s - ${CONVEX}/opt/smartmotorlut.h || \
+	    (echo "smartmotorlut.h is out of date, run make vexlut"; exit 1)
+	@$(VEXLUTGEN) fixmath | cmp -s - ${CONVEX}/opt/fixmathlut.h || \
+	    (echo "fixmathlut.h is out of date, run make vexlut"; exit 1)
+
+.PHONY: vexlut vexlutcheck
+
+# Only check when a host compiler is available
+ifneq ($(shell command -v $(HOSTCC) 2>/dev/null),)
+MAKE_ALL_RULE_HOOK: vexlutcheck
+endif
@@ -4,7 +4,13 @@ VEXOPTSRC = ${CONVEX}/opt/robotc_glue.c \
             ${CONVEX}/opt/apollo.c \
             ${CONVEX}/opt/pidlib.c \
             ${CONVEX}/opt/vexgyro.c \
+            ${CONVEX}/opt/vexheading.c \
             ${CONVEX}/opt/vexflash.c \
+            ${CONVEX}/opt/vexrecord.c \
+            ${CONVEX}/opt/vexpt.c \
+            ${CONVEX}/opt/vexsched.c \
+            ${CONVEX}/opt/vexboard.c \
+            ${CONVEX}/opt/fixmath.c \
             ${CONVEX}/opt/stm32_flash.c
             
 # Required include directories
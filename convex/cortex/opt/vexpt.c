@@ -0,0 +1,361 @@
+/*-----------------------------------------------------------------------------*/
+/*                                                                             */
+/*    Module:     vexpt.c                                                      */
+/*    Created:    18 October 2026                                              */
+/*                                                                             */
+/*    Revisions:                                                               */
+/*                V1.00     18 Oct 2026 - Initial release                      */
+/*                                                                             */
+/*-----------------------------------------------------------------------------*/
+/*                                                                             */
+/*    This file is part of ConVEX.                                             */
+/*                                                                             */
+/*    ConVEX is free software; you can redistribute it                         */
+/*    and/or modify it under the terms of the GNU General Public License       */
+/*    as published by the Free Software Foundation; either version 3 of        */
+/*    the License, or (at your option) any later version.                      */
+/*                                                                             */
+/*    ConVEX is distributed in the hope that it will be useful,                */
+/*    but WITHOUT ANY WARRANTY; without even the implied warranty of           */
+/*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            */
+/*    GNU General Public License for more details.                             */
+/*                                                                             */
+/*    You should have received a copy of the GNU General Public License        */
+/*    along with this program.  If not, see <http://www.gnu.org/licenses/>.    */
+/*                                                                             */
+/*-----------------------------------------------------------------------------*/
+/*                                                                             */
+/*    Description:                                                             */
+/*                                                                             */
+/*    Runner for the stackless coroutines in vexpt.h. One user task calls each */
+/*    behavior in turn then sleeps until the earliest wake time, an event from */
+/*    vexPtSignal or the next poll for behaviors waiting on a condition.       */
+/*                                                                             */
+/*    The runner registers as a normal user task, when the competition mode    */
+/*    changes it ends with the other tasks and all behaviors stop with it. The */
+/*    next vexPtAdd starts a fresh runner.                                     */
+/*                                                                             */
+/*-----------------------------------------------------------------------------*/
+
+#include "ch.h"         // needs for all ChibiOS programs
+#include "hal.h"        // hardware abstraction layer header
+#include "vex.h"        // vex library header
+#include "vexpt.h"
+
+/*-----------------------------------------------------------------------------*/
+/** @file    vexpt.c
+  * @brief   Stackless coroutine runner
+*//*---------------------------------------------------------------------------*/
+
+// event used to wake the runner, bit 0 is the task_terminate event
+#define VEXPT_WAKE_EVENT        EVENT_MASK(1)
+
+// all behaviors run on this one thread
+static WORKING_AREA(waVexPtTask, VEXPT_STACK_SIZE);
+
+typedef struct _vexPtRunner {
+    vexPt              *list;
+    Thread             *thread;
+    eventmask_t         pending;    ///< events signalled since the last pass
+    uint32_t            passes;
+    uint32_t            cycles;     ///< longest pass in cpu cycles
+    uint32_t            starts;
+    } vexPtRunner;
+
+static vexPtRunner  vp;
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Is the runner thread alive, call with the system locked        */
+/*-----------------------------------------------------------------------------*/
+static bool_t
+vexPtRunnerAlive( void )
+{
+    return( (vp.thread != NULL) && (vp.thread->p_state != THD_STATE_FINAL) );
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Remove a finished behavior, call with the system locked        */
+/*-----------------------------------------------------------------------------*/
+/** @details
+ *  The link to it is found again, vexPtAdd may have put new behaviors at
+ *  the head of the list while the behavior was running.
+ */
+static void
+vexPtUnlinkI( vexPt *pt )
+{
+    vexPt     **link;
+
+    for( link = &vp.list; *link != NULL; link = &(*link)->next )
+        {
+        if( *link == pt )
+            {
+            *link = pt->next;
+            break;
+            }
+        }
+    pt->wait = kVexPtWaitDone;
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Call each behavior that can continue                           */
+/** @return     mS until a behavior next needs to be called                    */
+/*-----------------------------------------------------------------------------*/
+static int32_t
+vexPtPass( eventmask_t pending )
+{
+    vexPt     **link;
+    vexPt      *pt;
+    int32_t     wait = VEXPT_IDLE;
+    int32_t     t;
+    bool_t      run;
+
+    link = &vp.list;
+    while( (pt = *link) != NULL )
+        {
+        if( !pt->killed )
+            {
+            pt->events |= pending;
+
+            // skip behaviors that can not continue yet
+            run = TRUE;
+            if( pt->wait == kVexPtWaitTime && (int32_t)(pt->wake - chTimeNow()) > 0 )
+                run = FALSE;
+            if( pt->wait == kVexPtWaitEvent && pt->events == 0 )
+                run = FALSE;
+
+            if( run )
+                pt->func( pt, pt->arg );
+            }
+
+        // only this thread unlinks, link is still in the list afterwards
+        if( pt->killed || pt->wait == kVexPtWaitDone )
+            {
+            chSysLock();
+            vexPtUnlinkI( pt );
+            chSysUnlock();
+            continue;
+            }
+
+        t = wait;
+        if( pt->wait == kVexPtWaitTime )
+            t = ((int32_t)(pt->wake - chTimeNow()) * 1000) / CH_FREQUENCY;
+        else
+        if( pt->wait == kVexPtWaitCondition )
+            t = VEXPT_POLL;
+        else
+        if( pt->wait == kVexPtWaitYield )
+            t = 1;
+
+        if( t < 1 )
+            t = 1;
+        if( t < wait )
+            wait = t;
+
+        link = &pt->next;
+        }
+
+    return( wait );
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      The runner thread                                              */
+/*-----------------------------------------------------------------------------*/
+static msg_t
+vexPtTask( void *arg )
+{
+    eventmask_t pending;
+    int32_t     wait;
+    uint32_t    start, cycles;
+
+    (void)arg;
+    chRegSetThreadName("pt");
+
+    vexTaskRegister("pt");
+
+    while( !chThdShouldTerminate() )
+        {
+        chSysLock();
+        pending = vp.pending;
+        vp.pending = 0;
+        chSysUnlock();
+
+        start = halGetCounterValue();
+        wait = vexPtPass( pending );
+
+        cycles = halGetCounterValue() - start;
+        if( cycles > vp.cycles )
+            vp.cycles = cycles;
+        vp.passes++;
+
+        // returns early for vexPtSignal, exits on terminate
+        vexSleepEvents( VEXPT_WAKE_EVENT, wait );
+        }
+
+    return (msg_t)0;
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Start a behavior                                               */
+/** @param[in]  pt storage for the behavior state, not on the caller's stack   */
+/** @param[in]  func the behavior                                              */
+/** @param[in]  arg passed to func each time it is called                     */
+/*-----------------------------------------------------------------------------*/
+/** @details
+ *  Starts the runner if it is not running, behaviors left from a runner that
+ *  has ended are dropped. Adding a behavior that is already running starts
+ *  it again from the beginning.
+ */
+void
+vexPtAdd( vexPt *pt, vexPtFunc func, void *arg )
+{
+    vexPt   *p;
+    bool_t  linked = FALSE;
+
+    chSysLock();
+
+    if( !vexPtRunnerAlive() )
+        {
+        for( p = vp.list; p != NULL; p = p->next )
+            p->wait = kVexPtWaitDone;
+        vp.list    = NULL;
+        vp.pending = 0;
+        vp.thread  = NULL;
+        }
+
+    pt->lc     = 0;
+    pt->wait   = kVexPtWaitYield;
+    pt->killed = FALSE;
+    pt->events = 0;
+    pt->func   = func;
+    pt->arg    = arg;
+
+    for( p = vp.list; p != NULL; p = p->next )
+        {
+        if( p == pt )
+            linked = TRUE;
+        }
+    if( !linked )
+        {
+        pt->next = vp.list;
+        vp.list  = pt;
+        }
+
+    if( vp.thread == NULL )
+        {
+        // same as chThdCreateStatic but under the same lock as the list
+        vexStackFill( waVexPtTask, sizeof(waVexPtTask) );
+        vp.thread = chThdCreateI(waVexPtTask, sizeof(waVexPtTask), USER_THREAD_PRIORITY, vexPtTask, NULL);
+        vp.starts++;
+        chSchWakeupS( vp.thread, RDY_OK );
+        }
+    else
+        {
+        chEvtSignalI( vp.thread, VEXPT_WAKE_EVENT );
+        chSchRescheduleS();
+        }
+
+    chSysUnlock();
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Stop a behavior                                                */
+/** @param[in]  pt the behavior                                                */
+/*-----------------------------------------------------------------------------*/
+/** @details
+ *  A behavior may kill itself, it is not called again after it returns.
+ */
+void
+vexPtKill( vexPt *pt )
+{
+    chSysLock();
+    pt->killed = TRUE;
+    if( vexPtRunnerAlive() )
+        {
+        chEvtSignalI( vp.thread, VEXPT_WAKE_EVENT );
+        chSchRescheduleS();
+        }
+    chSysUnlock();
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Is a behavior still running                                    */
+/** @param[in]  pt the behavior                                                */
+/** @return     TRUE until it ends, exits or is killed                         */
+/*-----------------------------------------------------------------------------*/
+bool_t
+vexPtRunning( vexPt *pt )
+{
+    bool_t  running;
+
+    chSysLock();
+    running = vexPtRunnerAlive() && !pt->killed &&
+              (pt->wait != kVexPtWaitNone) && (pt->wait != kVexPtWaitDone);
+    chSysUnlock();
+
+    return( running );
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Send events to behaviors in VEXPT_WAIT_EVENT, ISR version      */
+/** @param[in]  events the event flags, all 32 are free for user code         */
+/*-----------------------------------------------------------------------------*/
+/** @details
+ *  Call with the system locked or from an ISR inside
+ *  chSysLockFromIsr / chSysUnlockFromIsr.
+ */
+void
+vexPtSignalI( eventmask_t events )
+{
+    vp.pending |= events;
+    if( vexPtRunnerAlive() )
+        chEvtSignalI( vp.thread, VEXPT_WAKE_EVENT );
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Send events to behaviors in VEXPT_WAIT_EVENT                   */
+/** @param[in]  events the event flags                                        */
+/*-----------------------------------------------------------------------------*/
+void
+vexPtSignal( eventmask_t events )
+{
+    chSysLock();
+    vexPtSignalI( events );
+    chSchRescheduleS();
+    chSysUnlock();
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Debug function, list the behaviors                             */
+/** @param[in]  chp     A pointer to a vexStream object                        */
+/** @param[in]  argc    The number of command line arguments                   */
+/** @param[in]  argv    An array of pointers to the command line args          */
+/*-----------------------------------------------------------------------------*/
+void
+vexPtDebug(vexStream *chp, int argc, char *argv[])
+{
+    static const char *waits[] = { "none", "yield", "sleep", "cond", "event", "done" };
+    vexPt      *pt;
+    systime_t   now = chTimeNow();
+
+    (void)argc;
+    (void)argv;
+
+    if( !vexPtRunnerAlive() )
+        {
+        vex_chprintf( chp, "runner stopped, started %d times\r\n", vp.starts );
+        return;
+        }
+
+    vex_chprintf( chp, "passes %d longest %d uS started %d times\r\n", vp.passes, vp.cycles / (STM32_SYSCLK / 1000000), vp.starts );
+
+    // a behavior that is unlinked keeps its next pointer so the walk is safe
+    for( pt = vp.list; pt != NULL; pt = pt->next )
+        {
+        vex_chprintf( chp, "%08X line %4d %-5s", (uint32_t)pt->func, pt->lc, (pt->wait <= kVexPtWaitDone) ? waits[ pt->wait ] : "?" );
+        if( pt->wait == kVexPtWaitTime )
+            vex_chprintf( chp, " %d mS", (int32_t)(pt->wake - now) );
+        if( pt->killed )
+            vex_chprintf( chp, " killed" );
+        vex_chprintf( chp, "\r\n" );
+        }
+}
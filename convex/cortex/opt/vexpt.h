@@ -0,0 +1,210 @@
+/*-----------------------------------------------------------------------------*/
+/*                                                                             */
+/*    Module:     vexpt.h                                                      */
+/*    Created:    18 October 2026                                              */
+/*                                                                             */
+/*    Revisions:                                                               */
+/*                V1.00     18 Oct 2026 - Initial release                      */
+/*                                                                             */
+/*-----------------------------------------------------------------------------*/
+/*                                                                             */
+/*    This file is part of ConVEX.                                             */
+/*                                                                             */
+/*    ConVEX is free software; you can redistribute it                         */
+/*    and/or modify it under the terms of the GNU General Public License       */
+/*    as published by the Free Software Foundation; either version 3 of        */
+/*    the License, or (at your option) any later version.                      */
+/*                                                                             */
+/*    ConVEX is distributed in the hope that it will be useful,                */
+/*    but WITHOUT ANY WARRANTY; without even the implied warranty of           */
+/*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            */
+/*    GNU General Public License for more details.                             */
+/*                                                                             */
+/*    You should have received a copy of the GNU General Public License        */
+/*    along with this program.  If not, see <http://www.gnu.org/licenses/>.    */
+/*                                                                             */
+/*-----------------------------------------------------------------------------*/
+/*                                                                             */
+/*    Description:                                                             */
+/*                                                                             */
+/*    Stackless coroutines, protothreads, for small concurrent behaviors. Each */
+/*    behavior is a function that is called again and again by one runner      */
+/*    thread, a switch on the line number it last stopped at lets it continue  */
+/*    where it left off. A behavior costs a vexPt of a few words rather than a */
+/*    thread with its own stack, so a dozen of them fit where one task did.    */
+/*                                                                             */
+/*    Local variables are not kept between calls, keep state in static storage */
+/*    or in a structure passed as the argument. A switch statement can not be  */
+/*    used across a VEXPT_ macro, use if instead.                              */
+/*                                                                             */
+/*-----------------------------------------------------------------------------*/
+
+#ifndef __VEXPT__
+#define __VEXPT__
+
+/*-----------------------------------------------------------------------------*/
+/** @file    vexpt.h
+  * @brief   Stackless coroutine macros and prototypes
+*//*---------------------------------------------------------------------------*/
+
+/** @brief longest the runner leaves a behavior waiting on a condition
+ */
+#define VEXPT_POLL                  5
+/** @brief runner wakes this often with nothing to do to check for terminate
+ */
+#define VEXPT_IDLE                  100
+
+/** @brief runner thread stack, behaviors run on it so must not go deep
+ */
+#define VEXPT_STACK_SIZE            USER_TASK_STACK_SIZE
+
+/** @brief values returned by a behavior function
+ */
+#define VEXPT_WAITING               0
+#define VEXPT_YIELDED               1
+#define VEXPT_EXITED                2
+#define VEXPT_ENDED                 3
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      What a behavior is waiting for                                 */
+/*-----------------------------------------------------------------------------*/
+typedef enum {
+    kVexPtWaitNone = 0,
+    kVexPtWaitYield,
+    kVexPtWaitTime,
+    kVexPtWaitCondition,
+    kVexPtWaitEvent,
+    kVexPtWaitDone
+    } tVexPtWait;
+
+struct _vexPt;
+
+/** @brief a behavior, returns one of VEXPT_WAITING etc.
+ */
+typedef int8_t (*vexPtFunc)( struct _vexPt *pt, void *arg );
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      State of one behavior                                          */
+/*-----------------------------------------------------------------------------*/
+/** @details
+ *  Must not be on the stack of the thread that calls vexPtAdd, a static
+ *  is usual.
+ */
+typedef struct _vexPt {
+    uint16_t        lc;             ///< line to continue from, 0 to start
+    uint8_t         wait;           ///< a tVexPtWait
+    uint8_t         killed;         ///< vexPtKill was called
+    systime_t       wake;           ///< end of VEXPT_SLEEP
+    eventmask_t     events;         ///< events received since VEXPT_WAIT_EVENT
+    vexPtFunc       func;
+    void           *arg;
+    struct _vexPt  *next;
+    } vexPt;
+
+/*-----------------------------------------------------------------------------*/
+/*  Macros used inside a behavior function                                     */
+/*-----------------------------------------------------------------------------*/
+
+/** @brief start of a behavior, before any other VEXPT_ macro
+ */
+#define VEXPT_BEGIN(pt)             switch( (pt)->lc ) { case 0:
+
+/** @brief end of a behavior, it is removed from the runner
+ */
+#define VEXPT_END(pt)                                                   \
+    }                                                                   \
+    (pt)->lc = 0; (pt)->wait = kVexPtWaitDone;                          \
+    return( VEXPT_ENDED )
+
+/** @brief leave the behavior early
+ */
+#define VEXPT_EXIT(pt)                                                  \
+    do {                                                                \
+        (pt)->lc = 0; (pt)->wait = kVexPtWaitDone;                      \
+        return( VEXPT_EXITED );                                         \
+    } while(0)
+
+/** @brief let the other behaviors run, continue on the next pass
+ */
+#define VEXPT_YIELD(pt)                                                 \
+    do {                                                                \
+        (pt)->lc = __LINE__; (pt)->wait = kVexPtWaitYield;              \
+        return( VEXPT_YIELDED );                                        \
+        case __LINE__:;                                                 \
+    } while(0)
+
+/** @brief wait until condition is true, it is checked at least every
+ *         VEXPT_POLL mS
+ */
+#define VEXPT_WAIT_UNTIL(pt, condition)                                 \
+    do {                                                                \
+        (pt)->lc = __LINE__;                                            \
+        case __LINE__:                                                  \
+        if( !(condition) ) {                                            \
+            (pt)->wait = kVexPtWaitCondition;                           \
+            return( VEXPT_WAITING );                                    \
+            }                                                           \
+    } while(0)
+
+#define VEXPT_WAIT_WHILE(pt, condition) VEXPT_WAIT_UNTIL( pt, !(condition) )
+
+/** @brief sleep for msec mS, other behaviors run meanwhile
+ */
+#define VEXPT_SLEEP(pt, msec)                                           \
+    do {                                                                \
+        (pt)->wake = chTimeNow() + MS2ST(msec);                         \
+        (pt)->lc = __LINE__;                                            \
+        case __LINE__:                                                  \
+        if( (int32_t)((pt)->wake - chTimeNow()) > 0 ) {                 \
+            (pt)->wait = kVexPtWaitTime;                                \
+            return( VEXPT_WAITING );                                    \
+            }                                                           \
+    } while(0)
+
+/** @brief wait for any of the events in mask from vexPtSignal, only events
+ *         signalled after the wait starts count
+ */
+#define VEXPT_WAIT_EVENT(pt, mask)                                      \
+    do {                                                                \
+        (pt)->events = 0;                                               \
+        (pt)->lc = __LINE__;                                            \
+        case __LINE__:                                                  \
+        if( ((pt)->events & (mask)) == 0 ) {                            \
+            (pt)->wait = kVexPtWaitEvent;                               \
+            return( VEXPT_WAITING );                                    \
+            }                                                           \
+    } while(0)
+
+/** @brief events that ended the last VEXPT_WAIT_EVENT
+ */
+#define VEXPT_EVENTS(pt)            ((pt)->events)
+
+/** @brief run a child behavior to completion inside this one, the child
+ *         vexPt is not added to the runner so events the parent receives
+ *         are handed on to it before each call
+ */
+#define VEXPT_SPAWN(pt, child, f, a)                                    \
+    do {                                                                \
+        (child)->lc = 0;                                                \
+        (child)->events = 0;                                            \
+        VEXPT_WAIT_UNTIL( pt, ((child)->events |= (pt)->events,         \
+                               (pt)->events = 0,                        \
+                               (f)( child, a ) >= VEXPT_EXITED) );      \
+    } while(0)
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void            vexPtAdd( vexPt *pt, vexPtFunc func, void *arg );
+void            vexPtKill( vexPt *pt );
+bool_t          vexPtRunning( vexPt *pt );
+void            vexPtSignal( eventmask_t events );
+void            vexPtSignalI( eventmask_t events );
+void            vexPtDebug( vexStream *chp, int argc, char *argv[] );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // __VEXPT__
@@ -0,0 +1,644 @@
+/*-----------------------------------------------------------------------------*/
+/*                                                                             */
+/*    Module:     vexrecord.c                                                  */
+/*    Created:    18 October 2026                                              */
+/*                                                                             */
+/*    Revisions:                                                               */
+/*                V1.00     18 Oct 2026 - Initial release                      */
+/*                                                                             */
+/*-----------------------------------------------------------------------------*/
+/*                                                                             */
+/*    This file is part of ConVEX.                                             */
+/*                                                                             */
+/*    ConVEX is free software; you can redistribute it                         */
+/*    and/or modify it under the terms of the GNU General Public License       */
+/*    as published by the Free Software Foundation; either version 3 of        */
+/*    the License, or (at your option) any later version.                      */
+/*                                                                             */
+/*    ConVEX is distributed in the hope that it will be useful,                */
+/*    but WITHOUT ANY WARRANTY; without even the implied warranty of           */
+/*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            */
+/*    GNU General Public License for more details.                             */
+/*                                                                             */
+/*    You should have received a copy of the GNU General Public License        */
+/*    along with this program.  If not, see <http://www.gnu.org/licenses/>.    */
+/*                                                                             */
+/*-----------------------------------------------------------------------------*/
+/*                                                                             */
+/*    Description:                                                             */
+/*                                                                             */
+/*    Driver input recording and replay, see vexrecord.h.                      */
+/*                                                                             */
+/*    Frame encoding, channels are 8 bit values                                */
+/*      varint  mask of channels that changed since the last frame             */
+/*      varint  zigzag of the 8 bit wrapped delta, for each bit set in mask    */
+/*    The packet time jitters by a mS so it changes in most frames, it is      */
+/*    channel 0 so an idle frame still has a one byte mask.                    */
+/*    A frame is at most VEXREC_FRAME_MAX bytes so the work done in the SPI    */
+/*    path is bounded, nothing is written to flash while recording.            */
+/*                                                                             */
+/*-----------------------------------------------------------------------------*/
+
+#include <string.h>
+
+#include "ch.h"         // needs for all ChibiOS programs
+#include "hal.h"        // hardware abstraction layer header
+#include "vex.h"        // vex library header
+#include "vexflash.h"
+#include "vexrecord.h"
+
+/*-----------------------------------------------------------------------------*/
+/** @file    vexrecord.c
+  * @brief   Driver input recording and replay
+*//*---------------------------------------------------------------------------*/
+
+#define VEXREC_MAGIC            0x52454332  // "REC2"
+
+// channel index of the packet time, the joystick bytes follow it
+#define VEXREC_CH_TIME          0
+#define VEXREC_CH_JOY           1
+
+// joystick axis value with the stick centered
+#define VEXREC_CENTER           0x7F
+
+// end of the program image, from the linker script
+extern uint32_t _textdata, _data, _edata;
+
+typedef struct _vexRecord {
+    tVexRecordState state;
+
+    // channel values of the last frame encoded or decoded
+    uint8_t         last[VEXREC_CHANNELS];
+
+    // recording
+    uint8_t         buffer[VEXREC_BUFFER_SIZE];
+    uint16_t        bytes;
+    uint16_t        frames;
+    uint32_t        duration;
+    systime_t       lastTime;
+    bool_t          full;
+    bool_t          savePending;    ///< save once stopped and disabled
+    uint32_t        maxCycles;      ///< longest time spent in the SPI path
+
+    // replay, data is read straight from flash
+    const vexRecordHeader *header;
+    const uint8_t  *data;
+    uint16_t        offset;
+    uint16_t        frame;
+    bool_t          pending;        ///< next frame decoded, not yet due
+    systime_t       startTime;
+    uint32_t        time;           ///< recorded time of the decoded frame
+    int32_t         maxSkew;        ///< largest difference to the recorded time
+    jsdata          js[2];
+    } vexRecord;
+
+static vexRecord    vr;
+
+static void     vexRecordCallback( spiRxPacket *rx );
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Flash slot address                                             */
+/*-----------------------------------------------------------------------------*/
+static inline const vexRecordHeader *
+vexRecordSlot( int16_t slot )
+{
+    return( (const vexRecordHeader *)(VEXREC_FLASH_ADDR + (slot * VEXREC_SLOT_SIZE)) );
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Checksum of the encoded data                                   */
+/*-----------------------------------------------------------------------------*/
+static uint32_t
+vexRecordChecksum( const uint8_t *data, uint16_t bytes )
+{
+    uint32_t    sum = 0;
+
+    while( bytes-- )
+        sum = ((sum << 1) | (sum >> 31)) + *data++;
+
+    return( sum );
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Set the channels to sticks centered, no buttons                */
+/*-----------------------------------------------------------------------------*/
+static void
+vexRecordReset( void )
+{
+    int16_t     i;
+
+    vr.last[VEXREC_CH_TIME] = 0;
+    for( i = 0; i < (VEXREC_CHANNELS - VEXREC_CH_JOY); i++ )
+        vr.last[VEXREC_CH_JOY + i] = ((i % 6) < 4) ? VEXREC_CENTER : 0;
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Pack a value as a varint, 7 bits per byte, low bits first      */
+/*-----------------------------------------------------------------------------*/
+static inline uint8_t *
+vexRecordVarint( uint8_t *p, uint16_t value )
+{
+    while( value >= 0x80 )
+        {
+        *p++ = (value & 0x7F) | 0x80;
+        value >>= 7;
+        }
+    *p++ = value;
+    return( p );
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Unpack a varint                                                */
+/*-----------------------------------------------------------------------------*/
+static inline uint16_t
+vexRecordVarintGet( const uint8_t **pp )
+{
+    const uint8_t  *p = *pp;
+    uint16_t        value = 0;
+    int16_t         shift = 0;
+
+    do  {
+        value |= (uint16_t)(*p & 0x7F) << shift;
+        shift += 7;
+        } while( *p++ & 0x80 );
+
+    *pp = p;
+    return( value );
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Encode one packet                                              */
+/*-----------------------------------------------------------------------------*/
+static void
+vexRecordEncode( spiRxPacket *rx )
+{
+    uint8_t     ch[VEXREC_CHANNELS];
+    uint8_t    *js = &ch[VEXREC_CH_JOY];
+    uint8_t    *p;
+    uint16_t    mask = 0;
+    int8_t      d;
+    systime_t   now = chTimeNow();
+    uint32_t    dt;
+    int16_t     i;
+
+    js[0]  = rx->pak.js_1.Ch1;
+    js[1]  = rx->pak.js_1.Ch2;
+    js[2]  = rx->pak.js_1.Ch3;
+    js[3]  = rx->pak.js_1.Ch4;
+    js[4]  = rx->pak.js_1.btns[0];
+    js[5]  = rx->pak.js_1.btns[1];
+    js[6]  = rx->pak.js_2.Ch1;
+    js[7]  = rx->pak.js_2.Ch2;
+    js[8]  = rx->pak.js_2.Ch3;
+    js[9]  = rx->pak.js_2.Ch4;
+    js[10] = rx->pak.js_2.btns[0];
+    js[11] = rx->pak.js_2.btns[1];
+
+    // time since the last packet, the first frame is time 0
+    dt = (vr.frames == 0) ? 0 : (uint32_t)(now - vr.lastTime);
+    ch[VEXREC_CH_TIME] = (dt > 255) ? 255 : dt;
+    vr.lastTime = now;
+
+    for( i = 0; i < VEXREC_CHANNELS; i++ )
+        if( ch[i] != vr.last[i] )
+            mask |= (1 << i);
+
+    p = vexRecordVarint( &vr.buffer[vr.bytes], mask );
+    for( i = 0; i < VEXREC_CHANNELS; i++ )
+        {
+        if( mask & (1 << i) )
+            {
+            d = (int8_t)(ch[i] - vr.last[i]);
+            p = vexRecordVarint( p, (uint8_t)((d << 1) ^ (d >> 7)) );
+            vr.last[i] = ch[i];
+            }
+        }
+
+    vr.bytes = p - vr.buffer;
+    vr.frames++;
+    vr.duration += ch[VEXREC_CH_TIME];
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Decode the next frame into the replay joystick data            */
+/*-----------------------------------------------------------------------------*/
+static void
+vexRecordDecode( void )
+{
+    const uint8_t  *p = &vr.data[vr.offset];
+    uint16_t        mask, zz;
+    int16_t         i;
+
+    mask = vexRecordVarintGet( &p );
+    for( i = 0; i < VEXREC_CHANNELS; i++ )
+        {
+        if( mask & (1 << i) )
+            {
+            zz = vexRecordVarintGet( &p );
+            vr.last[i] += (uint8_t)((zz >> 1) ^ -(zz & 1));
+            }
+        }
+    vr.offset = p - vr.data;
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Copy the channels to the replay joystick data                  */
+/*-----------------------------------------------------------------------------*/
+/** @details
+ *  The accelerometers are not recorded, they replay as level.
+ */
+static void
+vexRecordJoysticks( void )
+{
+    int16_t     j;
+    uint8_t    *ch;
+
+    for( j = 0; j < 2; j++ )
+        {
+        ch = &vr.last[VEXREC_CH_JOY + (j * 6)];
+        vr.js[j].Ch1     = ch[0];
+        vr.js[j].Ch2     = ch[1];
+        vr.js[j].Ch3     = ch[2];
+        vr.js[j].Ch4     = ch[3];
+        vr.js[j].acc_x   = VEXREC_CENTER;
+        vr.js[j].acc_y   = VEXREC_CENTER;
+        vr.js[j].acc_z   = VEXREC_CENTER;
+        vr.js[j].btns[0] = ch[4];
+        vr.js[j].btns[1] = ch[5];
+        vr.js[j].res[0]  = 0;
+        vr.js[j].res[1]  = 0;
+        }
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Called by vexSpiSend with each valid packet                    */
+/*-----------------------------------------------------------------------------*/
+static void
+vexRecordCallback( spiRxPacket *rx )
+{
+    uint32_t    start = halGetCounterValue();
+    uint32_t    cycles;
+    uint32_t    elapsed;
+    int32_t     skew;
+
+    if( vr.state == kVexRecordRecording )
+        {
+        if( (vr.bytes + VEXREC_FRAME_MAX) > VEXREC_BUFFER_SIZE )
+            vr.full = TRUE;
+        else
+            vexRecordEncode( rx );
+
+        if( vr.full || vr.duration >= VEXREC_MAX_TIME )
+            {
+            vr.state = kVexRecordIdle;
+            vexSpiRxCallbackSet( NULL );
+            }
+
+        cycles = halGetCounterValue() - start;
+        if( cycles > vr.maxCycles )
+            vr.maxCycles = cycles;
+        }
+    else
+    if( vr.state == kVexRecordReplaying )
+        {
+        if( vr.frame < vr.header->frames )
+            {
+            if( vr.frame == 0 && !vr.pending )
+                vr.startTime = chTimeNow();
+            elapsed = chTimeNow() - vr.startTime;
+
+            // frames follow the recorded time, not the packets, a frame is held
+            // while packets come faster and frames are skipped if they are slower
+            while( vr.frame < vr.header->frames )
+                {
+                if( !vr.pending )
+                    {
+                    vexRecordDecode();
+                    vr.time += vr.last[VEXREC_CH_TIME];
+                    vr.pending = TRUE;
+                    }
+                if( vr.time > elapsed )
+                    break;
+
+                vexRecordJoysticks();
+                vr.frame++;
+                vr.pending = FALSE;
+
+                skew = (int32_t)(elapsed - vr.time);
+                if( skew > vr.maxSkew )
+                    vr.maxSkew = skew;
+                }
+            }
+        else
+            {
+            // hold everything still until the replay is stopped
+            vexRecordReset();
+            vexRecordJoysticks();
+            vr.state = kVexRecordReplayDone;
+            vexSpiRxCallbackSet( NULL );
+            }
+        }
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Start recording, any recording in RAM is discarded             */
+/*-----------------------------------------------------------------------------*/
+void
+vexRecordStart()
+{
+    if( vr.state == kVexRecordReplaying || vr.state == kVexRecordReplayDone )
+        vexReplayStop();
+
+    chSysLock();
+    vexRecordReset();
+    vr.bytes     = 0;
+    vr.frames    = 0;
+    vr.duration  = 0;
+    vr.full      = FALSE;
+    vr.maxCycles = 0;
+    vr.savePending = FALSE;
+    vr.state     = kVexRecordRecording;
+    chSysUnlock();
+
+    vexSpiRxCallbackSet( vexRecordCallback );
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Stop recording, the recording stays in RAM until saved         */
+/*-----------------------------------------------------------------------------*/
+void
+vexRecordStop()
+{
+    chSysLock();
+    if( vr.state == kVexRecordRecording )
+        {
+        vr.state = kVexRecordIdle;
+        vexSpiRxCallbackSet( NULL );
+        }
+    chSysUnlock();
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Find the newest valid recording in flash                       */
+/** @returns    The slot or -1 if there is none                                */
+/*-----------------------------------------------------------------------------*/
+static int16_t
+vexRecordNewest( void )
+{
+    const vexRecordHeader *h;
+    int16_t     slot, newest = -1;
+
+    for( slot = 0; slot < VEXREC_SLOTS; slot++ )
+        {
+        h = vexRecordSlot( slot );
+        if( h->magic != VEXREC_MAGIC || h->frames == 0 ||
+            h->bytes > (VEXREC_SLOT_SIZE - sizeof(vexRecordHeader)) )
+            continue;
+        if( vexRecordChecksum( (const uint8_t *)(h + 1), h->bytes ) != h->checksum )
+            continue;
+        if( newest < 0 || (int32_t)(h->sequence - vexRecordSlot( newest )->sequence) > 0 )
+            newest = slot;
+        }
+
+    return( newest );
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Program a block of flash a half word at a time                 */
+/*-----------------------------------------------------------------------------*/
+static int16_t
+vexRecordProgram( uint32_t addr, const uint8_t *data, uint16_t bytes )
+{
+    uint16_t    i;
+    uint16_t    w;
+
+    for( i = 0; i < bytes; i += 2 )
+        {
+        w = data[i];
+        if( (i + 1) < bytes )
+            w |= (uint16_t)data[i + 1] << 8;
+        else
+            w |= 0xFF00;
+        if( FLASH_ProgramHalfWord( addr + i, w ) != FLASH_COMPLETE )
+            return( FLASH_ERROR_WRITE );
+        }
+
+    return( FLASH_SUCCESS );
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Save the recording in RAM to the next flash slot               */
+/** @returns    status or error code, see vexflash.h                           */
+/*-----------------------------------------------------------------------------*/
+/** @details
+ *  Slots are used in turn and only the pages the recording needs are
+ *  erased, so each page is erased at most once every VEXREC_SLOTS saves.
+ *  The CPU stalls while flash is erased and programmed, save when the
+ *  robot is not moving.
+ */
+int16_t
+vexRecordSave()
+{
+    const vexRecordHeader *old;
+    vexRecordHeader h;
+    uint32_t    addr, end;
+    int16_t     newest, slot, ret;
+
+    if( vr.state == kVexRecordRecording || vr.frames == 0 )
+        return( FLASH_ERROR );
+
+    // never erase the program
+    end = (uint32_t)&_textdata + ((uint32_t)&_edata - (uint32_t)&_data);
+    if( end > VEXREC_FLASH_ADDR )
+        return( FLASH_ERROR );
+
+    newest = vexRecordNewest();
+    slot   = (newest < 0) ? 0 : (newest + 1) % VEXREC_SLOTS;
+    old    = vexRecordSlot( slot );
+    addr   = (uint32_t)old;
+
+    h.magic     = VEXREC_MAGIC;
+    h.sequence  = (newest < 0) ? 1 : vexRecordSlot( newest )->sequence + 1;
+    h.erases    = (old->erases == 0xFFFFFFFF) ? 1 : old->erases + 1;
+    h.checksum  = vexRecordChecksum( vr.buffer, vr.bytes );
+    h.duration  = vr.duration;
+    h.frames    = vr.frames;
+    h.bytes     = vr.bytes;
+
+    FLASH_UnlockBank1();
+    FLASH_ClearFlag(FLASH_FLAG_EOP | FLASH_FLAG_PGERR | FLASH_FLAG_WRPRTERR);
+
+    for( end = addr + sizeof(vexRecordHeader) + vr.bytes; addr < end; addr += VEXREC_FLASH_PAGE_SIZE )
+        if( FLASH_ErasePage( addr ) != FLASH_COMPLETE )
+            return( FLASH_ERROR_ERASE );
+
+    // data, then the header with the magic number last
+    addr = (uint32_t)old;
+    ret = vexRecordProgram( addr + sizeof(vexRecordHeader), vr.buffer, vr.bytes );
+    if( ret == FLASH_SUCCESS )
+        ret = vexRecordProgram( addr + sizeof(uint32_t), (uint8_t *)&h + sizeof(uint32_t),
+                                sizeof(vexRecordHeader) - sizeof(uint32_t) );
+    if( ret == FLASH_SUCCESS )
+        ret = vexRecordProgram( addr, (uint8_t *)&h.magic, sizeof(uint32_t) );
+
+    return( ret );
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Ask for the recording to be saved when it is safe to           */
+/*-----------------------------------------------------------------------------*/
+/** @details
+ *  Call from driver control, the save is done by vexRecordSavePoll once
+ *  recording has stopped and the robot is disabled.
+ */
+void
+vexRecordSaveRequest()
+{
+    vr.savePending = TRUE;
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Save a requested recording if the robot is disabled            */
+/*-----------------------------------------------------------------------------*/
+/** @details
+ *  Call regularly from a thread that keeps running while disabled, the
+ *  flash stall then never happens while the robot is being driven.
+ */
+void
+vexRecordSavePoll()
+{
+    if( !vr.savePending || vr.state == kVexRecordRecording )
+        return;
+    if( vexModeGet() != kVexModeDisabled )
+        return;
+
+    vr.savePending = FALSE;
+    vexRecordSave();
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Select the newest recording in flash for replay                */
+/** @returns    TRUE if there is one                                           */
+/*-----------------------------------------------------------------------------*/
+bool_t
+vexRecordLoad()
+{
+    int16_t     slot = vexRecordNewest();
+
+    if( slot < 0 )
+        {
+        vr.header = NULL;
+        return( FALSE );
+        }
+
+    vr.header = vexRecordSlot( slot );
+    vr.data   = (const uint8_t *)(vr.header + 1);
+    return( TRUE );
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Replay the newest recording through the joystick data          */
+/** @returns    TRUE if replay started                                         */
+/*-----------------------------------------------------------------------------*/
+/** @details
+ *  The first frame is used on the next SPI packet, use vexRecordStateGet
+ *  to wait for kVexRecordReplayDone and then call vexReplayStop.
+ */
+bool_t
+vexReplayStart()
+{
+    vexRecordStop();
+
+    if( !vexRecordLoad() )
+        return( FALSE );
+
+    chSysLock();
+    vexRecordReset();
+    vexRecordJoysticks();
+    vr.offset  = 0;
+    vr.frame   = 0;
+    vr.pending = FALSE;
+    vr.time    = 0;
+    vr.maxSkew = 0;
+    vr.state   = kVexRecordReplaying;
+    chSysUnlock();
+
+    vexSpiJoystickReplaySet( vr.js );
+    vexSpiRxCallbackSet( vexRecordCallback );
+    return( TRUE );
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Stop replay and go back to the real joysticks                  */
+/*-----------------------------------------------------------------------------*/
+void
+vexReplayStop()
+{
+    chSysLock();
+    if( vr.state == kVexRecordReplaying || vr.state == kVexRecordReplayDone )
+        {
+        vr.state = kVexRecordIdle;
+        vexSpiRxCallbackSet( NULL );
+        vexSpiJoystickReplaySet( NULL );
+        }
+    chSysUnlock();
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Get the recorder state                                         */
+/*-----------------------------------------------------------------------------*/
+tVexRecordState
+vexRecordStateGet()
+{
+    return( vr.state );
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Debug function, rec [start|stop|save|play]                     */
+/** @param[in]  chp     A pointer to a vexStream object                        */
+/** @param[in]  argc    The number of command line arguments                   */
+/** @param[in]  argv    An array of pointers to the command line args          */
+/*-----------------------------------------------------------------------------*/
+void
+vexRecordDebug(vexStream *chp, int argc, char *argv[])
+{
+    const vexRecordHeader *h;
+    int16_t     slot;
+
+    if( argc > 0 )
+        {
+        if( strcmp( argv[0], "start" ) == 0 )
+            vexRecordStart();
+        else
+        if( strcmp( argv[0], "stop" ) == 0 )
+            {
+            vexRecordStop();
+            vexReplayStop();
+            }
+        else
+        if( strcmp( argv[0], "save" ) == 0 )
+            vex_chprintf( chp, "save %d\r\n", vexRecordSave() );
+        else
+        if( strcmp( argv[0], "play" ) == 0 )
+            vex_chprintf( chp, "play %d\r\n", vexReplayStart() );
+        }
+
+    vex_chprintf( chp, "state    %d\r\n", vr.state );
+    vex_chprintf( chp, "frames   %d\r\n", vr.frames );
+    vex_chprintf( chp, "bytes    %d of %d%s\r\n", vr.bytes, VEXREC_BUFFER_SIZE, vr.full ? " full" : "" );
+    vex_chprintf( chp, "duration %d mS\r\n", vr.duration );
+    vex_chprintf( chp, "cycles   %d max\r\n", vr.maxCycles );
+    if( vr.header != NULL )
+        vex_chprintf( chp, "replay   %d of %d skew %d mS\r\n", vr.frame, vr.header->frames, vr.maxSkew );
+
+    for( slot = 0; slot < VEXREC_SLOTS; slot++ )
+        {
+        h = vexRecordSlot( slot );
+        vex_chprintf( chp, "slot %d ", slot );
+        if( h->magic == VEXREC_MAGIC )
+            vex_chprintf( chp, "seq %d frames %d bytes %d mS %d", h->sequence, h->frames, h->bytes, h->duration );
+        else
+            vex_chprintf( chp, "empty" );
+        vex_chprintf( chp, " erases %d\r\n", (h->erases == 0xFFFFFFFF) ? 0 : h->erases );
+        }
+}
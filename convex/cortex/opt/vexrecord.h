@@ -0,0 +1,118 @@
+/*-----------------------------------------------------------------------------*/
+/*                                                                             */
+/*    Module:     vexrecord.h                                                  */
+/*    Created:    18 October 2026                                              */
+/*                                                                             */
+/*    Revisions:                                                               */
+/*                V1.00     18 Oct 2026 - Initial release                      */
+/*                                                                             */
+/*-----------------------------------------------------------------------------*/
+/*                                                                             */
+/*    This file is part of ConVEX.                                             */
+/*                                                                             */
+/*    ConVEX is free software; you can redistribute it                         */
+/*    and/or modify it under the terms of the GNU General Public License       */
+/*    as published by the Free Software Foundation; either version 3 of        */
+/*    the License, or (at your option) any later version.                      */
+/*                                                                             */
+/*    ConVEX is distributed in the hope that it will be useful,                */
+/*    but WITHOUT ANY WARRANTY; without even the implied warranty of           */
+/*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            */
+/*    GNU General Public License for more details.                             */
+/*                                                                             */
+/*    You should have received a copy of the GNU General Public License        */
+/*    along with this program.  If not, see <http://www.gnu.org/licenses/>.    */
+/*                                                                             */
+/*-----------------------------------------------------------------------------*/
+/*                                                                             */
+/*    Description:                                                             */
+/*                                                                             */
+/*    Driver input recorder. Each valid SPI packet from the master processor   */
+/*    has its joystick data delta encoded and varint packed into a RAM buffer, */
+/*    a frame where only the packet time changed costs two bytes so a 15       */
+/*    second run is a few KB. Saved recordings rotate through VEXREC_SLOTS flash slots so the  */
+/*    pages wear evenly, the newest valid slot is the one that is played.      */
+/*                                                                             */
+/*    Replay feeds the recorded frames back through vexSpiGetJoystickDataPtr   */
+/*    at the times they were recorded, each frame keeps the mS since the one   */
+/*    before. A different SPI period then holds or skips frames rather than    */
+/*    stretching or shrinking the run.                                         */
+/*                                                                             */
+/*-----------------------------------------------------------------------------*/
+
+#ifndef __VEXRECORD__
+#define __VEXRECORD__
+
+/*-----------------------------------------------------------------------------*/
+/** @file    vexrecord.h
+  * @brief   Driver input recording and replay macros and prototypes
+*//*---------------------------------------------------------------------------*/
+
+/** @brief size of the RAM buffer a recording is made in
+ */
+#define VEXREC_BUFFER_SIZE          6144
+/** @brief flash used for recordings, pages below the user parameter page
+ */
+#define VEXREC_FLASH_ADDR           0x08057000
+#define VEXREC_FLASH_PAGE_SIZE      0x0800
+#define VEXREC_SLOT_SIZE            0x2000
+#define VEXREC_SLOTS                4
+/** @brief recording stops by itself after this many mS
+ */
+#define VEXREC_MAX_TIME             15000
+
+/** @brief encoded channels, the time since the last packet, then 2 joysticks
+ *         of 4 axes and 2 button bytes
+ */
+#define VEXREC_CHANNELS             13
+/** @brief most bytes one frame can encode to, change mask and all channels
+ */
+#define VEXREC_FRAME_MAX            (2 + (VEXREC_CHANNELS * 2))
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Recording header, at the start of each flash slot              */
+/*-----------------------------------------------------------------------------*/
+/** @details
+ *  magic is programmed last so a slot that was not completely written is
+ *  never played.
+ */
+typedef struct _vexRecordHeader {
+    uint32_t        magic;          ///< VEXREC_MAGIC when the slot is valid
+    uint32_t        sequence;       ///< increases with each save
+    uint32_t        erases;         ///< times this slot has been erased
+    uint32_t        checksum;       ///< of the encoded data
+    uint32_t        duration;       ///< mS from the first to the last frame
+    uint16_t        frames;         ///< number of SPI packets recorded
+    uint16_t        bytes;          ///< size of the encoded data
+    } vexRecordHeader;
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Recorder state                                                 */
+/*-----------------------------------------------------------------------------*/
+typedef enum {
+    kVexRecordIdle = 0,
+    kVexRecordRecording,
+    kVexRecordReplaying,
+    kVexRecordReplayDone
+    } tVexRecordState;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void            vexRecordStart( void );
+void            vexRecordStop( void );
+int16_t         vexRecordSave( void );
+void            vexRecordSaveRequest( void );
+void            vexRecordSavePoll( void );
+bool_t          vexRecordLoad( void );
+bool_t          vexReplayStart( void );
+void            vexReplayStop( void );
+tVexRecordState vexRecordStateGet( void );
+void            vexRecordDebug( vexStream *chp, int argc, char *argv[] );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // __VEXRECORD__
@@ -0,0 +1,32 @@
+# Host stress test for the lock free ring in fw/vexring.c.
+# Include after rules.mk so the check runs as part of "all".
+#
+#   make vexringstress  full run, a million entries per ring and entry size
+#   make vexringcheck   short run used by the build
+#
+HOSTCC          ?= cc
+VEXRINGDIR       = $(BUILDDIR)/ring
+VEXRINGSTRESS    = $(VEXRINGDIR)/vexringstress
+VEXRINGDEPS      = ${CONVEX}/opt/host/vexringstress.c \
+                   ${CONVEX}/opt/host/ch.h \
+                   ${CONVEX}/fw/vexring.h \
+                   ${CONVEX}/fw/vexring.c
+
+# Optimized so the compiler is free to reorder anything the barriers allow
+$(VEXRINGSTRESS): $(VEXRINGDEPS)
+	@mkdir -p $(VEXRINGDIR)
+	$(HOSTCC) -O2 -Wall -pthread -I${CONVEX}/opt/host -I${CONVEX}/fw -o $@ $<
+
+vexringstress: $(VEXRINGSTRESS)
+	$(VEXRINGSTRESS)
+
+vexringcheck: $(VEXRINGSTRESS)
+	@$(VEXRINGSTRESS) 20000 > /dev/null || \
+	    (echo "vexring stress test failed, run make vexringstress"; exit 1)
+
+.PHONY: vexringstress vexringcheck
+
+# Only check when a host compiler is available
+ifneq ($(shell command -v $(HOSTCC) 2>/dev/null),)
+MAKE_ALL_RULE_HOOK: vexringcheck
+endif
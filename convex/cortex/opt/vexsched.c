@@ -0,0 +1,463 @@
+/*-----------------------------------------------------------------------------*/
+/*                                                                             */
+/*    Module:     vexsched.c                                                   */
+/*    Created:    18 October 2026                                              */
+/*                                                                             */
+/*    Revisions:                                                               */
+/*                V1.00     18 Oct 2026 - Initial release                      */
+/*                                                                             */
+/*-----------------------------------------------------------------------------*/
+/*                                                                             */
+/*    This file is part of ConVEX.                                             */
+/*                                                                             */
+/*    ConVEX is free software; you can redistribute it                         */
+/*    and/or modify it under the terms of the GNU General Public License       */
+/*    as published by the Free Software Foundation; either version 3 of        */
+/*    the License, or (at your option) any later version.                      */
+/*                                                                             */
+/*    ConVEX is distributed in the hope that it will be useful,                */
+/*    but WITHOUT ANY WARRANTY; without even the implied warranty of           */
+/*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            */
+/*    GNU General Public License for more details.                             */
+/*                                                                             */
+/*    You should have received a copy of the GNU General Public License        */
+/*    along with this program.  If not, see <http://www.gnu.org/licenses/>.    */
+/*                                                                             */
+/*-----------------------------------------------------------------------------*/
+/*                                                                             */
+/*    Description:                                                             */
+/*                                                                             */
+/*    Control loop scheduler, see vexsched.h. The scheduler thread listens     */
+/*    to the SPI frame event and to the event that ends the user tasks. Loops  */
+/*    that are not persistent are dropped when the competition mode ends, in   */
+/*    the same way as the tasks that registered them.                          */
+/*                                                                             */
+/*    Persistent loops stay registered across modes and are told of each       */
+/*    change through their mode callback instead.                              */
+/*                                                                             */
+/*-----------------------------------------------------------------------------*/
+
+#include <string.h>
+
+#include "ch.h"         // needs for all ChibiOS programs
+#include "hal.h"        // hardware abstraction layer header
+#include "vex.h"        // vex library header
+#include "vexsched.h"
+
+/*-----------------------------------------------------------------------------*/
+/** @file    vexsched.c
+  * @brief   Rate monotonic control loop scheduler
+*//*---------------------------------------------------------------------------*/
+
+// events the scheduler thread waits for
+#define VEXSCHED_FRAME_EVENT        EVENT_MASK(0)
+#define VEXSCHED_TERMINATE_EVENT    EVENT_MASK(1)
+#define VEXSCHED_MODE_EVENT         EVENT_MASK(2)
+#define VEXSCHED_COMMAND_EVENT      EVENT_MASK(3)
+
+// cpu cycles in one nominal frame
+#define VEXSCHED_FRAME_CYCLES       (VEXSCHED_FRAME_MS * (STM32_SYSCLK / 1000))
+
+// all loops run on this one thread
+static WORKING_AREA(waVexSchedTask, VEXSCHED_STACK_SIZE);
+
+typedef struct _vexSched {
+    vexSchedTask       *list;
+    Thread             *thread;
+
+    uint32_t            frame;          ///< frames seen, counts timeouts too
+    uint32_t            spiFrame;       ///< last SPI frame count
+    uint32_t            frameStart;     ///< cycle count when the frame arrived
+    uint32_t            frameCycles;    ///< last time between frames
+    uint32_t            maxFrameCycles;
+    uint32_t            skipped;        ///< frames that arrived during a pass
+    uint32_t            timeouts;       ///< frames run without the master
+    uint32_t            passCycles;     ///< last time to run all loops
+    uint32_t            maxPassCycles;
+    } vexSched;
+
+static vexSched     vs;
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Unlink removed loops, call with the system locked              */
+/*-----------------------------------------------------------------------------*/
+/** @details
+ *  Done in one go after the pass rather than through a link kept while the
+ *  callbacks ran, vexSchedAdd may have moved loops about meanwhile.
+ */
+static void
+vexSchedSweepI( void )
+{
+    vexSchedTask  **link;
+    vexSchedTask   *t;
+
+    link = &vs.list;
+    while( (t = *link) != NULL )
+        {
+        if( t->removed )
+            *link = t->next;
+        else
+            link = &t->next;
+        }
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Run the loops that are due this frame                          */
+/*-----------------------------------------------------------------------------*/
+static void
+vexSchedPass( void )
+{
+    vexSchedTask   *t;
+    uint32_t        elapsed;
+    uint32_t        start, end;
+
+    for( t = vs.list; t != NULL; t = t->next )
+        {
+        if( t->removed || ((vs.frame - t->release) < t->frames) )
+            continue;
+
+        // released a frame or more after it was due
+        elapsed = vs.frame - t->release;
+        if( (t->runs != 0) && (elapsed > t->frames) )
+            t->misses++;
+        t->release = vs.frame;
+
+        start = halGetCounterValue();
+        t->update( t->arg );
+        end = halGetCounterValue();
+
+        t->cycles = end - start;
+        if( t->cycles > t->maxCycles )
+            t->maxCycles = t->cycles;
+        t->runs++;
+
+        // deadline is the end of its period from when the frame arrived
+        if( (end - vs.frameStart) > (t->frames * VEXSCHED_FRAME_CYCLES) )
+            t->misses++;
+        }
+
+    chSysLock();
+    vexSchedSweepI();
+    chSysUnlock();
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Tell the loops the competition mode has changed                */
+/*-----------------------------------------------------------------------------*/
+static void
+vexSchedModeChange( void )
+{
+    vexSchedTask   *t;
+    tVexMode        mode = vexModeGet();
+
+    for( t = vs.list; t != NULL; t = t->next )
+        {
+        if( !t->removed && (t->modeChange != NULL) )
+            t->modeChange( t->arg, mode );
+        }
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Run the command callbacks of loops that have been woken        */
+/*-----------------------------------------------------------------------------*/
+static void
+vexSchedCommand( void )
+{
+    vexSchedTask   *t;
+
+    for( t = vs.list; t != NULL; t = t->next )
+        {
+        if( !t->woken )
+            continue;
+
+        // cleared first, a wake while it runs is not lost
+        t->woken = FALSE;
+        if( !t->removed && (t->command != NULL) )
+            t->command( t->arg );
+        }
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Drop the loops that end with the user tasks                    */
+/*-----------------------------------------------------------------------------*/
+static void
+vexSchedTerminate( void )
+{
+    vexSchedTask   *t;
+
+    for( t = vs.list; t != NULL; t = t->next )
+        {
+        if( !t->persistent )
+            t->removed = TRUE;
+        }
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      The scheduler thread                                           */
+/*-----------------------------------------------------------------------------*/
+static msg_t
+vexSchedThread( void *arg )
+{
+    static EventListener    frameListener;
+    static EventListener    terminateListener;
+    static EventListener    modeListener;
+    eventmask_t events;
+    uint32_t    now, spiFrame;
+
+    (void)arg;
+    chRegSetThreadName("sched");
+
+    chEvtRegisterMask( vexSpiFrameEventGet(), &frameListener, VEXSCHED_FRAME_EVENT );
+    vexTaskTerminateListen( &terminateListener, VEXSCHED_TERMINATE_EVENT );
+    vexModeListen( &modeListener, VEXSCHED_MODE_EVENT );
+
+    vs.spiFrame   = vexSpiFrameCountGet();
+    vs.frameStart = halGetCounterValue();
+
+    while( TRUE )
+        {
+        events = chEvtWaitAnyTimeout( ALL_EVENTS, MS2ST(VEXSCHED_FRAME_TIMEOUT) );
+        now = halGetCounterValue();
+
+        // the mode changes after the old mode tasks have ended
+        if( events & VEXSCHED_MODE_EVENT )
+            vexSchedModeChange();
+        if( events & VEXSCHED_TERMINATE_EVENT )
+            vexSchedTerminate();
+        if( events & VEXSCHED_COMMAND_EVENT )
+            vexSchedCommand();
+
+        // not a frame, the loops run on the next one
+        if( (events != 0) && !(events & VEXSCHED_FRAME_EVENT) )
+            continue;
+
+        if( events & VEXSCHED_FRAME_EVENT )
+            {
+            // more than one if a pass overran
+            spiFrame = vexSpiFrameCountGet();
+            if( (spiFrame - vs.spiFrame) > 1 )
+                vs.skipped += (spiFrame - vs.spiFrame) - 1;
+            vs.frame += spiFrame - vs.spiFrame;
+            vs.spiFrame = spiFrame;
+            }
+        else
+            {
+            // no master processor, keep the loops running
+            vs.frame++;
+            vs.timeouts++;
+            }
+
+        vs.frameCycles = now - vs.frameStart;
+        if( vs.frameCycles > vs.maxFrameCycles )
+            vs.maxFrameCycles = vs.frameCycles;
+        vs.frameStart = now;
+
+        vexSchedPass();
+
+        vs.passCycles = halGetCounterValue() - now;
+        if( vs.passCycles > vs.maxPassCycles )
+            vs.maxPassCycles = vs.passCycles;
+        }
+
+    return (msg_t)0;
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Add a control loop                                             */
+/** @param[in]  t storage for the loop, not on the caller's stack              */
+/** @param[in]  name shown by the sched command                               */
+/** @param[in]  update called once each period                                */
+/** @param[in]  arg passed to update                                           */
+/** @param[in]  frames period in SPI frames                                    */
+/** @param[in]  priority higher runs first among loops of the same period     */
+/*-----------------------------------------------------------------------------*/
+/** @details
+ *  Starts the scheduler the first time. The loop first runs on the next
+ *  frame, it is dropped when the competition mode ends unless made
+ *  persistent. Adding a loop that is already running changes its period.
+ */
+void
+vexSchedAdd( vexSchedTask *t, char *name, vexSchedFunc update, void *arg, uint16_t frames, uint8_t priority )
+{
+    vexSchedTask  **link;
+    vexSchedTask   *p;
+
+    if( frames == 0 )
+        frames = 1;
+
+    chSysLock();
+
+    // take it out first so it is sorted again
+    for( link = &vs.list; (p = *link) != NULL; link = &p->next )
+        {
+        if( p == t )
+            {
+            *link = t->next;
+            break;
+            }
+        }
+
+    t->name       = name;
+    t->update     = update;
+    t->modeChange = NULL;
+    t->command    = NULL;
+    t->arg        = arg;
+    t->frames     = frames;
+    t->priority   = priority;
+    t->persistent = FALSE;
+    t->removed    = FALSE;
+    t->woken      = FALSE;
+    t->release    = vs.frame - frames;
+
+    // rate monotonic, shortest period first
+    for( link = &vs.list; (p = *link) != NULL; link = &p->next )
+        {
+        if( (p->frames > frames) || ((p->frames == frames) && (p->priority < priority)) )
+            break;
+        }
+    t->next = p;
+    *link   = t;
+
+    if( vs.thread == NULL )
+        {
+        // same as chThdCreateStatic but under the same lock as the list
+        vexStackFill( waVexSchedTask, sizeof(waVexSchedTask) );
+        vs.thread = chThdCreateI(waVexSchedTask, sizeof(waVexSchedTask), VEXSCHED_THREAD_PRIORITY, vexSchedThread, NULL);
+        chSchWakeupS( vs.thread, RDY_OK );
+        }
+
+    chSysUnlock();
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Remove a control loop                                          */
+/** @param[in]  t the loop                                                     */
+/*-----------------------------------------------------------------------------*/
+/** @details
+ *  The loop is not called after the current pass.
+ */
+void
+vexSchedRemove( vexSchedTask *t )
+{
+    t->removed = TRUE;
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Keep a loop when the competition mode ends                     */
+/** @param[in]  t the loop                                                     */
+/** @param[in]  p TRUE to keep it                                              */
+/*-----------------------------------------------------------------------------*/
+void
+vexSchedPersistentSet( vexSchedTask *t, bool_t p )
+{
+    t->persistent = p;
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Set a function called when the competition mode changes        */
+/** @param[in]  t the loop                                                     */
+/** @param[in]  modeChange the function, NULL for none                         */
+/*-----------------------------------------------------------------------------*/
+/** @details
+ *  Called on the scheduler thread between frames so it never runs at the
+ *  same time as the update. Persistent loops use it to change behavior
+ *  for the new mode rather than being restarted.
+ */
+void
+vexSchedModeCallbackSet( vexSchedTask *t, vexSchedModeFunc modeChange )
+{
+    t->modeChange = modeChange;
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Set a function called when the loop is woken                   */
+/** @param[in]  t the loop                                                     */
+/** @param[in]  command the function, NULL for none                            */
+/*-----------------------------------------------------------------------------*/
+/** @details
+ *  Like the mode callback it runs on the scheduler thread and never at the
+ *  same time as the update.
+ */
+void
+vexSchedCommandCallbackSet( vexSchedTask *t, vexSchedCommandFunc command )
+{
+    t->command = command;
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Run the command callback of a loop now                         */
+/** @param[in]  t the loop                                                     */
+/** @note       Call from an ISR or with the system locked                     */
+/*-----------------------------------------------------------------------------*/
+void
+vexSchedWakeI( vexSchedTask *t )
+{
+    t->woken = TRUE;
+    if( vs.thread != NULL )
+        chEvtSignalI( vs.thread, VEXSCHED_COMMAND_EVENT );
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Run the command callback of a loop now                         */
+/** @param[in]  t the loop                                                     */
+/*-----------------------------------------------------------------------------*/
+/** @details
+ *  The scheduler thread is above the user tasks so the callback has run
+ *  by the time this returns, unless it is called from a callback.
+ */
+void
+vexSchedWake( vexSchedTask *t )
+{
+    chSysLock();
+    vexSchedWakeI( t );
+    chSchRescheduleS();
+    chSysUnlock();
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Get the current frame number                                   */
+/** @return     Frames since the scheduler started                             */
+/*-----------------------------------------------------------------------------*/
+uint32_t
+vexSchedFrameGet( void )
+{
+    return( vs.frame );
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Debug function, list the loops, sched [reset]                  */
+/** @param[in]  chp     A pointer to a vexStream object                        */
+/** @param[in]  argc    The number of command line arguments                   */
+/** @param[in]  argv    An array of pointers to the command line args          */
+/*-----------------------------------------------------------------------------*/
+void
+vexSchedDebug(vexStream *chp, int argc, char *argv[])
+{
+    vexSchedTask   *t;
+    uint32_t        us = STM32_SYSCLK / 1000000;
+
+    if( (argc > 0) && (strcmp( argv[0], "reset" ) == 0) )
+        {
+        vs.maxFrameCycles = 0;
+        vs.maxPassCycles  = 0;
+        vs.skipped        = 0;
+        vs.timeouts       = 0;
+        for( t = vs.list; t != NULL; t = t->next )
+            {
+            t->maxCycles = 0;
+            t->misses    = 0;
+            }
+        }
+
+    vex_chprintf( chp, "frame %d skipped %d timeouts %d\r\n", vs.frame, vs.skipped, vs.timeouts );
+    vex_chprintf( chp, "frame %d uS max %d uS, pass %d uS max %d uS\r\n",
+        vs.frameCycles / us, vs.maxFrameCycles / us, vs.passCycles / us, vs.maxPassCycles / us );
+
+    vex_chprintf( chp, "name     frames pri     runs  exec   max misses\r\n" );
+    // a removed loop keeps its next pointer so the walk is safe
+    for( t = vs.list; t != NULL; t = t->next )
+        {
+        vex_chprintf( chp, "%-8s %6d %3d %8d %5d %5d %6d%s\r\n", t->name, t->frames, t->priority,
+            t->runs, t->cycles / us, t->maxCycles / us, t->misses, t->persistent ? " persistent" : "" );
+        }
+}
@@ -0,0 +1,126 @@
+/*-----------------------------------------------------------------------------*/
+/*                                                                             */
+/*    Module:     vexsched.h                                                   */
+/*    Created:    18 October 2026                                              */
+/*                                                                             */
+/*    Revisions:                                                               */
+/*                V1.00     18 Oct 2026 - Initial release                      */
+/*                                                                             */
+/*-----------------------------------------------------------------------------*/
+/*                                                                             */
+/*    This file is part of ConVEX.                                             */
+/*                                                                             */
+/*    ConVEX is free software; you can redistribute it                         */
+/*    and/or modify it under the terms of the GNU General Public License       */
+/*    as published by the Free Software Foundation; either version 3 of        */
+/*    the License, or (at your option) any later version.                      */
+/*                                                                             */
+/*    ConVEX is distributed in the hope that it will be useful,                */
+/*    but WITHOUT ANY WARRANTY; without even the implied warranty of           */
+/*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            */
+/*    GNU General Public License for more details.                             */
+/*                                                                             */
+/*    You should have received a copy of the GNU General Public License        */
+/*    along with this program.  If not, see <http://www.gnu.org/licenses/>.    */
+/*                                                                             */
+/*-----------------------------------------------------------------------------*/
+/*                                                                             */
+/*    Description:                                                             */
+/*                                                                             */
+/*    Rate monotonic scheduler for control loops. Mechanisms register an       */
+/*    update callback with a period in SPI frames and a priority, one thread   */
+/*    runs all of them straight after the system task has exchanged a packet   */
+/*    with the master processor. Joystick data is fresh and motor commands go  */
+/*    out on the next exchange, each loop costs a function call rather than a  */
+/*    thread.                                                                  */
+/*                                                                             */
+/*    Callbacks run shortest period first, priority orders those with the same */
+/*    period. They must not block. The time each takes is measured and a miss  */
+/*    is counted when one starts a frame late or finishes after its period.    */
+/*                                                                             */
+/*    Persistent loops can set a mode callback, called between frames when the */
+/*    competition mode changes, and keep running across modes.                 */
+/*                                                                             */
+/*    A loop can also set a command callback. vexSchedWake runs it on the      */
+/*    scheduler thread straight away rather than on the next frame, so other   */
+/*    tasks hand the loop work without touching its state themselves.          */
+/*                                                                             */
+/*-----------------------------------------------------------------------------*/
+
+#ifndef __VEXSCHED__
+#define __VEXSCHED__
+
+/*-----------------------------------------------------------------------------*/
+/** @file    vexsched.h
+  * @brief   Control loop scheduler macros and prototypes
+*//*---------------------------------------------------------------------------*/
+
+/** @brief nominal frame, the system task sleeps 16 mS between exchanges
+ */
+#define VEXSCHED_FRAME_MS           17
+/** @brief run without the master processor if no frame arrives for this long
+ */
+#define VEXSCHED_FRAME_TIMEOUT      (VEXSCHED_FRAME_MS * 2)
+
+/** @brief above the user tasks, below the sensor filters
+ */
+#define VEXSCHED_THREAD_PRIORITY    (USER_THREAD_PRIORITY + 1)
+#define VEXSCHED_STACK_SIZE         USER_TASK_STACK_SIZE
+
+/** @brief a control loop update function
+ */
+typedef void (*vexSchedFunc)( void *arg );
+/** @brief called on the scheduler thread when the competition mode changes
+ */
+typedef void (*vexSchedModeFunc)( void *arg, tVexMode mode );
+/** @brief called on the scheduler thread after vexSchedWake, same as update
+ */
+typedef vexSchedFunc vexSchedCommandFunc;
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      One control loop                                               */
+/*-----------------------------------------------------------------------------*/
+/** @details
+ *  Must not be on the stack of the thread that calls vexSchedAdd, a static
+ *  is usual.
+ */
+typedef struct _vexSchedTask {
+    char               *name;
+    vexSchedFunc        update;
+    vexSchedModeFunc    modeChange;     ///< optional
+    vexSchedCommandFunc command;        ///< optional
+    void               *arg;
+    uint16_t            frames;         ///< period in SPI frames
+    uint8_t             priority;       ///< higher runs first
+    uint8_t             persistent;     ///< keep when the user tasks end
+    uint8_t             removed;
+    uint8_t             woken;          ///< command callback due
+
+    uint32_t            release;        ///< frame it last ran in
+    uint32_t            runs;
+    uint32_t            misses;
+    uint32_t            cycles;         ///< last execution time
+    uint32_t            maxCycles;
+
+    struct _vexSchedTask *next;
+    } vexSchedTask;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void            vexSchedAdd( vexSchedTask *t, char *name, vexSchedFunc update, void *arg, uint16_t frames, uint8_t priority );
+void            vexSchedRemove( vexSchedTask *t );
+void            vexSchedPersistentSet( vexSchedTask *t, bool_t p );
+void            vexSchedModeCallbackSet( vexSchedTask *t, vexSchedModeFunc modeChange );
+void            vexSchedCommandCallbackSet( vexSchedTask *t, vexSchedCommandFunc command );
+void            vexSchedWake( vexSchedTask *t );
+void            vexSchedWakeI( vexSchedTask *t );
+uint32_t        vexSchedFrameGet( void );
+void            vexSchedDebug( vexStream *chp, int argc, char *argv[] );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // __VEXSCHED__
@@ -0,0 +1,27 @@
+# Stack size report from the stack high water marks in fw/vexstack.c.
+# Include after rules.mk, every object also gets a .su file of frame sizes.
+#
+#   make stackreport STACKLOG=stack.log
+#
+# stack.log is the "stack" shell command captured from the robot after a
+# run, more than one capture can go in the file. Without it only the
+# largest frames are listed.
+#
+HOSTCC           ?= cc
+STACKLOG         ?=
+STACK_MARGIN     ?= 25
+STACK_MINIMUM    ?= 64
+VEXSTACKDIR       = $(BUILDDIR)/stack
+VEXSTACKREPORT    = $(VEXSTACKDIR)/vexstackreport
+
+USE_COPT += -fstack-usage
+
+$(VEXSTACKREPORT): ${CONVEX}/opt/host/vexstackreport.c
+	@mkdir -p $(VEXSTACKDIR)
+	$(HOSTCC) -O1 -Wall -o $@ $<
+
+stackreport: $(VEXSTACKREPORT) $(OBJS)
+	@$(VEXSTACKREPORT) -m $(STACK_MARGIN) -b $(STACK_MINIMUM) \
+	    $(if $(STACKLOG),-l $(STACKLOG)) $(wildcard $(OBJDIR)/*.su)
+
+.PHONY: stackreport
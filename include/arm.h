@@ -12,6 +12,9 @@
 
 #include "pidlib.h"
 #include "smartmotor.h"
+#include "fixmath.h"
+#include "vexsched.h"
+#include "vexboard.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -24,6 +27,43 @@ typedef enum {
 	armPositionUp
 } armPosition_t;
 
+// arm loop period in SPI frames and mS, and order among loops with the same period
+#define ARM_FRAMES				1
+#define ARM_PERIOD				(ARM_FRAMES * VEXSCHED_FRAME_MS)
+#define ARM_PRIORITY			2
+
+// loop period the lock gains were tuned at, Ki and Kd are scaled from it
+#define ARM_TUNED_PERIOD		25
+
+// commands that can wait for the arm loop, more are dropped
+#define ARM_COMMANDS			8
+
+// potentiometer counts per revolution, same estimate smartmotor uses
+#define ARM_POT_PER_REV			SMLIB_TPR_POT
+
+// estimator noise, pot counts and pot counts per period
+#define ARM_EST_POT_NOISE		4.0f	// pot reading standard deviation
+#define ARM_EST_IME_NOISE		1.5f	// IME rate standard deviation, quantization and backlash
+#define ARM_EST_ACCEL_NOISE		3.0f	// change in rate between periods
+#define ARM_EST_DRIFT_NOISE		0.5f	// pot and IME disagreement, gear slop
+
+// IME changes larger than this in one period are a reset of the count
+#define ARM_EST_MAX_DELTA		200
+
+/*-----------------------------------------------------------------------------*/
+/** @brief   Arm angle and rate estimate, pot counts and pot counts per period  */
+/*-----------------------------------------------------------------------------*/
+typedef struct armEstimator_s {
+	bool_t			valid;
+	fix16_t			angle;
+	fix16_t			rate;
+	fix16_t			potPerTick;
+	fix16_t			gain[2][2];		// steady state gains for pot and IME
+	fix16_t			potGain[2];		// steady state gains for pot only
+	int32_t			imeCount;
+	uint32_t		imeRejects;
+} armEstimator_t;
+
 typedef struct arm_s {
 	tVexMotor		motor0;
 	tVexMotor		motor1;
@@ -37,6 +77,9 @@ typedef struct arm_s {
 	armPosition_t	position;
 	bool_t			locked;
 	pidController	*lock;
+	armEstimator_t	estimator;
+	uint32_t		commands;			// applied by the arm loop
+	uint32_t		commandsDropped;	// mailbox was full
 } arm_t;
 
 extern arm_t	*armGetPtr(void);
@@ -51,7 +94,9 @@ extern void		armUnlock(void);
 extern void		armLockDown(void);
 extern void		armLockBump(void);
 extern void		armLockUp(void);
+extern void		armLockPosition(int16_t value);
 extern void		armLockCurrent(void);
+extern int32_t	armGetPosition(void);
 #ifdef __cplusplus
 }
 #endif
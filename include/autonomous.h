@@ -15,21 +15,19 @@
 #include "drive.h"
 #include "arm.h"
 #include "claw.h"
+#include "lcd.h"
+#include "autoseq.h"
+#include "traj.h"
+#include "vexrecord.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
-extern void autonomousMode0(void);
-extern void autonomousMode1(void);
-extern void autonomousMode2(void);
-extern void autonomousMode3(void);
-extern void autonomousMode4(void);
-extern void autonomousMode5(void);
-extern void autonomousMode6(void);
-extern void autonomousMode7(void);
-extern void autonomousMode8(void);
-extern void autonomousMode9(void);
+// driver control in this mode is recorded, autonomous in this mode replays it
+#define AUTONOMOUS_REPLAY_MODE	kLcdMode3
+
+extern void autonomousRun(kLcdModeType mode);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,143 @@
+/*
+ * autoseq.h
+ */
+
+#ifndef AUTOSEQ_H_
+
+#define AUTOSEQ_H_
+
+#include "ch.h"  		// needs for all ChibiOS programs
+#include "hal.h" 		// hardware abstraction layer header
+#include "vex.h"		// vex library header
+
+#include "drive.h"
+#include "arm.h"
+#include "claw.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// how often sensor conditions are checked in mS
+#define AUTOSEQ_POLL			2
+
+// length of the autonomous period in mS
+#define AUTOSEQ_MATCH_TIME		15000
+
+// the routine is stopped and the arm and claw locked this long before the period ends
+#define AUTOSEQ_SAFE_MARGIN		250
+
+/*-----------------------------------------------------------------------------*/
+/** @brief   What a track does at the start of a step                           */
+/*-----------------------------------------------------------------------------*/
+typedef enum {
+	autoCmdNone = 0,		// leave the track as it is
+	autoCmdMove,			// drive the motors, non zero unlocks arm and claw
+	autoCmdUnlock,
+	autoCmdLockCurrent,
+	autoCmdLockDown,		// arm only
+	autoCmdLockBump,		// arm only
+	autoCmdLockUp,			// arm only
+	autoCmdLockGrab,		// claw only
+	autoCmdLockOpen,		// claw only
+	autoCmdSegment			// drive only, marks the start of a segment
+} autoCmd_t;
+
+/*-----------------------------------------------------------------------------*/
+/** @brief   How much a segment matters when the routine is running late        */
+/*-----------------------------------------------------------------------------*/
+typedef enum {
+	autoPriorityLow = 0,		// skipped if it does not fit
+	autoPriorityNormal,			// skipped if it does not fit
+	autoPriorityHigh,			// shortened to the time left
+	autoPriorityRequired		// always run, shortened to the end of the period
+} autoPriority_t;
+
+/*-----------------------------------------------------------------------------*/
+/** @brief   When a track is finished, arm and claw use their pot               */
+/*-----------------------------------------------------------------------------*/
+typedef enum {
+	autoUntilNone = 0,		// runs until the step ends
+	autoUntilAbove,			// pot at or above target
+	autoUntilBelow,			// pot at or below target
+	autoUntilDistance		// drive encoders travelled target ticks
+} autoUntil_t;
+
+typedef struct autoAction_s {
+	uint8_t			cmd;
+	uint8_t			until;
+	int16_t			x;
+	int16_t			y;
+	int16_t			target;
+	uint8_t			priority;		// autoCmdSegment only, an autoPriority_t
+} autoAction_t;
+
+/*-----------------------------------------------------------------------------*/
+/** @brief   One step, the three tracks run in parallel                         */
+/*-----------------------------------------------------------------------------*/
+/** @details
+ *  A step with no conditions lasts timeout mS. A step with conditions ends
+ *  as soon as every track with a condition is done, or at timeout. Tracks
+ *  are stopped as they finish, the arm and claw hold where they are.
+ *
+ *  AUTO_SEGMENT steps split a routine into segments with an expected time
+ *  and a priority. At the start of each segment the time left in the
+ *  period is compared with what the segment needs plus what later, more
+ *  important, segments need. A segment that does not fit is skipped or
+ *  shortened depending on its priority.
+ */
+typedef struct autoStep_s {
+	autoAction_t	drive;
+	autoAction_t	arm;
+	autoAction_t	claw;
+	uint16_t		timeout;
+} autoStep_t;
+
+#define AUTO_NONE					{ autoCmdNone, autoUntilNone, 0, 0, 0, 0 }
+#define AUTO_MOVE(speed)			{ autoCmdMove, autoUntilNone, (speed), 0, 0, 0 }
+#define AUTO_DRIVE(x, y)			{ autoCmdMove, autoUntilNone, (x), (y), 0, 0 }
+#define AUTO_STOP					{ autoCmdMove, autoUntilNone, 0, 0, 0, 0 }
+#define AUTO_CMD(cmd)				{ (cmd), autoUntilNone, 0, 0, 0, 0 }
+#define AUTO_MOVE_UNTIL(speed, until, target)	{ autoCmdMove, (until), (speed), 0, (target), 0 }
+#define AUTO_DRIVE_UNTIL(x, y, ticks)	{ autoCmdMove, autoUntilDistance, (x), (y), (ticks), 0 }
+
+// starts a segment, the steps up to the next segment take about ms
+#define AUTO_SEGMENT(ms, priority)	{ { autoCmdSegment, autoUntilNone, 0, 0, 0, (priority) }, AUTO_NONE, AUTO_NONE, (ms) }
+
+// common steps
+#define AUTO_WAIT(ms)				{ AUTO_NONE, AUTO_NONE, AUTO_NONE, (ms) }
+#define AUTO_STOP_ALL(ms)			{ AUTO_STOP, AUTO_STOP, AUTO_STOP, (ms) }
+#define AUTO_STOP_DRIVE(ms)			{ AUTO_STOP, AUTO_NONE, AUTO_NONE, (ms) }
+
+typedef struct autoRoutine_s {
+	const autoStep_t	*steps;
+	int16_t				count;
+} autoRoutine_t;
+
+#define AUTO_ROUTINE(steps)			{ (steps), sizeof(steps) / sizeof(autoStep_t) }
+
+typedef struct autoseq_s {
+	const autoRoutine_t	*routine;
+	int16_t			step;
+	systime_t		started;
+	systime_t		stepStarted;
+	uint32_t		timeouts;
+	int16_t			lastTimeout;
+	bool_t			matchValid;
+	systime_t		matchStarted;	// start of the autonomous period
+	int16_t			segment;		// step index of the current segment
+	int16_t			skipped;		// segments skipped for time
+	int16_t			shortened;		// segments cut short for time
+	bool_t			windowClosed;	// stopped at the end of the period
+} autoseq_t;
+
+extern autoseq_t	*autoSeqGetPtr(void);
+extern void		autoSeqMatchStart(void);
+extern systime_t	autoSeqMatchEnd(void);
+extern void		autoSeqRun(const autoRoutine_t *routine);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
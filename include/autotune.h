@@ -24,10 +24,10 @@ typedef struct autotuner_s {
 	float			noiseBand;
 	int				controlType;
 	bool_t			running;
-	unsigned long	peak1;
-	unsigned long	peak2;
-	unsigned long	lastTime;
-	int				sampleTime;
+	uint32_t		peak1;		// uS, vexTimeUs
+	uint32_t		peak2;
+	uint32_t		lastTime;
+	int				sampleTime;	// mS
 	int				nLookBack;
 	int				peakType;
 	float			lastInputs[101];
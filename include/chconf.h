@@ -59,6 +59,19 @@
 #define CH_TIME_QUANTUM                 20
 #endif
 
+/**
+ * @brief   Tickless mode.
+ * @details If enabled the system tick interrupt only happens when a virtual
+ *          timer is due or the round robin needs it, the system time keeps
+ *          the @p CH_FREQUENCY unit. Define it TRUE in UDEFS to try it, the
+ *          "test tick" shell command shows the difference.
+ *
+ * @note    Only the ARMv7-M port supports it.
+ */
+#if !defined(CH_USE_TICKLESS) || defined(__DOXYGEN__)
+#define CH_USE_TICKLESS                 FALSE
+#endif
+
 /**
  * @brief   Managed RAM size.
  * @details Size of the RAM area to be managed by the OS. If set to zero
@@ -408,6 +421,20 @@
 #define CH_DBG_ENABLE_STACK_CHECK       FALSE
 #endif
 
+/**
+ * @brief   Stack high water marks in the idle thread.
+ * @details If enabled the working areas are filled and the idle thread
+ *          checks a few stack words once per tick, see vexstack.c. Define
+ *          it TRUE in UDEFS when sizing stacks. Setting only
+ *          @p CH_DBG_FILL_THREADS gives the "stack" command without the
+ *          idle scan.
+ *
+ * @note    The default is @p FALSE.
+ */
+#if !defined(VEX_STACK_SCAN) || defined(__DOXYGEN__)
+#define VEX_STACK_SCAN                  FALSE
+#endif
+
 /**
  * @brief   Debug option, stacks initialization.
  * @details If enabled then the threads working area is filled with a byte
@@ -415,9 +442,10 @@
  *          runtime measurement of the used stack.
  *
  * @note    The default is @p FALSE.
+ * @note    ConVEX turns it on with @p VEX_STACK_SCAN.
  */
 #if !defined(CH_DBG_FILL_THREADS) || defined(__DOXYGEN__)
-#define CH_DBG_FILL_THREADS             FALSE
+#define CH_DBG_FILL_THREADS             VEX_STACK_SCAN
 #endif
 
 /**
@@ -448,9 +476,25 @@
  */
 #if !defined(THREAD_EXT_FIELDS) || defined(__DOXYGEN__)
 #define THREAD_EXT_FIELDS                                                   \
-  /* Add threads custom fields here.*/
+  /* Add threads custom fields here.*/                                      \
+  /* ConVEX task registry slot, -1 if not registered.*/                     \
+  int16_t vex_slot;                                                         \
+  /* Lowest free stack bytes seen by vexstack.c.*/                          \
+  uint16_t vex_stkfree;                                                     \
+  /* End of the working area, NULL for main on the process stack.*/         \
+  uint8_t *vex_stktop;
 #endif
 
+/**
+ * @brief   ConVEX uses vex_slot to find a registered thread directly.
+ */
+#define VEX_THREAD_SLOT
+
+/**
+ * @brief   ConVEX measures stacks with vex_stktop and vex_stkfree.
+ */
+#define VEX_THREAD_STACK
+
 /**
  * @brief   Threads initialization hook.
  * @details User initialization code added to the @p chThdInit() API.
@@ -461,6 +505,11 @@
 #if !defined(THREAD_EXT_INIT_HOOK) || defined(__DOXYGEN__)
 #define THREAD_EXT_INIT_HOOK(tp) {                                          \
   /* Add threads initialization code here.*/                                \
+  (tp)->vex_slot = -1;                                                      \
+  /* The context is already set up, main has none.*/                        \
+  (tp)->vex_stkfree = 0xFFFF;                                               \
+  (tp)->vex_stktop = ((tp)->p_ctx.r13 == NULL) ? NULL :                     \
+                     (uint8_t *)(tp)->p_ctx.r13 + sizeof(struct intctx);    \
 }
 #endif
 
@@ -478,13 +527,35 @@
 }
 #endif
 
+/**
+ * @brief   Tick and context switch counters.
+ * @details If enabled the context switch and system tick hooks count for
+ *          the "test tick" command in vextest.c. Define it TRUE in UDEFS
+ *          when measuring, it adds a store to both hot paths.
+ *
+ * @note    The default is @p FALSE.
+ */
+#if !defined(VEX_TEST_COUNTERS) || defined(__DOXYGEN__)
+#define VEX_TEST_COUNTERS               FALSE
+#endif
+
+#if VEX_TEST_COUNTERS || defined(__DOXYGEN__)
+#define VEX_TEST_COUNT(n) {                                                 \
+  extern volatile uint32_t n;                                               \
+  n++;                                                                      \
+}
+#else
+#define VEX_TEST_COUNT(n)
+#endif
+
 /**
  * @brief   Context switch hook.
  * @details This hook is invoked just before switching between threads.
  */
 #if !defined(THREAD_CONTEXT_SWITCH_HOOK) || defined(__DOXYGEN__)
 #define THREAD_CONTEXT_SWITCH_HOOK(ntp, otp) {                              \
-  /* System halt code here.*/                                               \
+  /* Counted for the "test tick" command in vextest.c.*/                    \
+  VEX_TEST_COUNT(vexTestSwitches);                                          \
 }
 #endif
 
@@ -493,10 +564,27 @@
  * @details This hook is continuously invoked by the idle thread loop.
  */
 #if !defined(IDLE_LOOP_HOOK) || defined(__DOXYGEN__)
+#if VEX_STACK_SCAN
+#define IDLE_LOOP_HOOK() {                                                  \
+  /* Stack high water marks, see vexstack.c.*/                              \
+  extern void vexStackScan(void);                                           \
+  vexStackScan();                                                           \
+}
+#else
 #define IDLE_LOOP_HOOK() {                                                  \
   /* Idle loop code here.*/                                                 \
 }
 #endif
+#endif
+
+/**
+ * @brief   Idle thread stack, room for the stack scan in the idle hook.
+ */
+#if VEX_STACK_SCAN
+#if !defined(PORT_IDLE_THREAD_STACK_SIZE) || defined(__DOXYGEN__)
+#define PORT_IDLE_THREAD_STACK_SIZE     128
+#endif
+#endif
 
 /**
  * @brief   System tick event hook.
@@ -505,7 +593,8 @@
  */
 #if !defined(SYSTEM_TICK_EVENT_HOOK) || defined(__DOXYGEN__)
 #define SYSTEM_TICK_EVENT_HOOK() {                                          \
-  /* System tick event code here.*/                                         \
+  /* Counted for the "test tick" command in vextest.c.*/                    \
+  VEX_TEST_COUNT(vexTestTicks);                                             \
 }
 #endif
 
@@ -526,6 +615,26 @@
 /* Port-specific settings (override port settings defaulted in chcore.h).    */
 /*===========================================================================*/
 
+/**
+ * @brief   MPU stack guard under every thread stack.
+ * @details Off by default, the guard costs twice its size in each working
+ *          area. See CORTEX_ENABLE_STACK_GUARD in chcore_v7m.h.
+ */
+#if !defined(CORTEX_ENABLE_STACK_GUARD) || defined(__DOXYGEN__)
+#define CORTEX_ENABLE_STACK_GUARD       FALSE
+#endif
+
+/**
+ * @brief   Stack guard hit hook.
+ * @details Names the thread on the console before the system halts.
+ */
+#if !defined(CORTEX_STACK_GUARD_HOOK) || defined(__DOXYGEN__)
+#define CORTEX_STACK_GUARD_HOOK(tp) {                                       \
+  extern void vexStackGuardFault(Thread *);                                 \
+  vexStackGuardFault(tp);                                                   \
+}
+#endif
+
 #endif  /* _CHCONF_H_ */
 
 /** @} */
\ No newline at end of file
@@ -12,11 +12,24 @@
 
 #include "pidlib.h"
 #include "smartmotor.h"
+#include "vexsched.h"
+#include "vexboard.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+// claw loop period in SPI frames and mS, and order among loops with the same period
+#define CLAW_FRAMES				1
+#define CLAW_PERIOD				(CLAW_FRAMES * VEXSCHED_FRAME_MS)
+#define CLAW_PRIORITY			1
+
+// loop period the lock gains were tuned at, Ki and Kd are scaled from it
+#define CLAW_TUNED_PERIOD		25
+
+// commands that can wait for the claw loop, more are dropped
+#define CLAW_COMMANDS			8
+
 typedef struct claw_s {
 	tVexMotor		leftMotor;
 	tVexMotor		rightMotor;
@@ -29,6 +42,8 @@ typedef struct claw_s {
 	pidController	*leftLock;
 	pidController	*rightLock;
 	bool_t			isGrabbing;
+	uint32_t		commands;			// applied by the claw loop
+	uint32_t		commandsDropped;	// mailbox was full
 } claw_t;
 
 extern claw_t	*clawGetPtr(void);
@@ -41,6 +56,7 @@ extern void		clawLock(void);
 extern void		clawUnlock(void);
 extern void		clawLockGrab(void);
 extern void		clawLockOpen(void);
+extern void		clawLockPosition(int16_t value);
 extern void		clawLockCurrent(void);
 #ifdef __cplusplus
 }
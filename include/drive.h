@@ -11,11 +11,38 @@
 #include "vex.h"		// vex library header
 
 #include "smartmotor.h"
+#include "fixmath.h"
+#include "odometry.h"
+#include "vexsched.h"
+#include "vexboard.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+// joystick drive loop period in SPI frames, and order among loops with the same period
+#define DRIVE_FRAMES			1
+#define DRIVE_PRIORITY			3
+
+// motion primitive profile limits, encoder ticks per odometry period
+#define DRIVE_MAX_VELOCITY		FIX16(6.0)
+#define DRIVE_ACCELERATION		FIX16(0.4)
+
+// motion primitive turn limits, deg * 10 per odometry period
+#define DRIVE_MAX_TURN_RATE		FIX16(25.0)
+#define DRIVE_TURN_ACCELERATION	FIX16(2.0)
+
+// motion primitive gains, motor command per unit of velocity and error
+#define DRIVE_KV				FIX16(16.0)		// per tick per period
+#define DRIVE_KP				FIX16(2.0)		// per tick
+#define DRIVE_TURN_KV			FIX16(4.0)		// per deg * 10 per period
+#define DRIVE_TURN_KP			FIX16(0.8)		// per deg * 10
+#define DRIVE_HEADING_KP		FIX16(0.5)		// per deg * 10 of heading error
+
+// done when the profile has finished and the error is inside these
+#define DRIVE_TOLERANCE			10		// encoder ticks
+#define DRIVE_TURN_TOLERANCE	10		// deg * 10
+
 typedef struct drive_s {
 	tVexMotor	northeast;
 	tVexMotor	northwest;
@@ -31,6 +58,8 @@ extern void		driveStart(void);
 extern void		driveMove(int16_t x, int16_t y, bool_t immediate);
 extern void		driveLock(void);
 extern void		driveUnlock(void);
+extern bool_t	driveStraight(float inches, int32_t timeout);
+extern bool_t	driveTurn(float degrees, int32_t timeout);
 
 #ifdef __cplusplus
 }
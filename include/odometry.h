@@ -0,0 +1,73 @@
+/*
+ * odometry.h
+ */
+
+#ifndef ODOMETRY_H_
+
+#define ODOMETRY_H_
+
+#include "ch.h"  		// needs for all ChibiOS programs
+#include "hal.h" 		// hardware abstraction layer header
+#include "vex.h"		// vex library header
+
+#include "fixmath.h"
+#include "smartmotor.h"
+#include "vexheading.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// odometry update period in mS (100Hz)
+#define ODOMETRY_PERIOD			10
+
+// encoder changes larger than this in one period are treated as a reset of the count
+#define ODOMETRY_MAX_DELTA		200
+
+/*-----------------------------------------------------------------------------*/
+/** @brief   Robot pose, x and y in inches Q16.16, heading CCW from +x          */
+/*-----------------------------------------------------------------------------*/
+typedef struct odometryPose_s {
+	fix16_t			x;
+	fix16_t			y;
+	fixangle_t		heading;
+	int32_t			count;		// average of the left and right encoder counts
+	systime_t		time;
+} odometryPose_t;
+
+typedef struct odometry_s {
+	tVexMotor		left;
+	bool_t			leftReversed;
+	tVexMotor		right;
+	bool_t			rightReversed;
+	tVexAnalogPin	gyro;
+	float			wheelDiameter;
+	float			trackWidth;
+	fix16_t			inchesPerTick;
+	int32_t			anglePerTick;
+	int32_t			leftCount;
+	int32_t			rightCount;
+	fixangle_t		headingOffset;
+	fixangle_t		heading;
+	volatile uint32_t	sequence;
+	odometryPose_t	pose;
+	uint32_t		updates;
+	vexPeriodic		periodic;
+	bool_t			valid;		// left and right are separate encoders
+	Thread			*thread;
+} odometry_t;
+
+extern odometry_t	*odometryGetPtr(void);
+extern void		odometrySetup(tVexMotor left, bool_t leftReversed,
+							  tVexMotor right, bool_t rightReversed,
+							  tVexAnalogPin gyro, float wheelDiameter, float trackWidth);
+extern void		odometryInit(void);
+extern void		odometryStart(void);
+extern void		odometryGet(odometryPose_t *pose);
+extern void		odometryReset(fix16_t x, fix16_t y, fixangle_t heading);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
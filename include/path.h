@@ -0,0 +1,81 @@
+/*
+ * path.h
+ */
+
+#ifndef PATH_H_
+
+#define PATH_H_
+
+#include "ch.h"  		// needs for all ChibiOS programs
+#include "hal.h" 		// hardware abstraction layer header
+#include "vex.h"		// vex library header
+
+#include "fixmath.h"
+#include "drive.h"
+#include "odometry.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// path follower update period in mS, runs with odometry which is faster than the SPI frame
+#define PATH_PERIOD				ODOMETRY_PERIOD
+
+// most segments the follower moves forward in one update, bounds the cost per update
+#define PATH_SEARCH_MAX			4
+
+// distance from the end in inches Q16.16 where the speed starts to ramp down
+#define PATH_SLOWDOWN			FIX16(12.0)
+
+// slowest command used while ramping down so the robot does not stall
+#define PATH_MIN_SPEED			25
+
+// done when this close to the last point, inches Q16.16
+#define PATH_TOLERANCE			FIX16(1.0)
+
+/*-----------------------------------------------------------------------------*/
+/** @brief   A waypoint, inches Q16.16 in the odometry frame                    */
+/*-----------------------------------------------------------------------------*/
+/** @details
+ *  s is the distance along the path from the first point to this one, it is
+ *  part of the table so the follower never needs a square root per segment.
+ */
+typedef struct pathPoint_s {
+	fix16_t			x;
+	fix16_t			y;
+	fix16_t			s;
+} pathPoint_t;
+
+#define PATH_POINT(x, y, s)		{ FIX16(x), FIX16(y), FIX16(s) }
+
+typedef struct path_s {
+	const pathPoint_t	*points;
+	int16_t			count;
+	fix16_t			lookahead;	// inches Q16.16
+	int16_t			speed;		// motor command at full speed
+} path_t;
+
+#define PATH(points, lookahead, speed)	{ (points), sizeof(points) / sizeof(pathPoint_t), FIX16(lookahead), (speed) }
+
+/*-----------------------------------------------------------------------------*/
+/** @brief   Follower state, for debugging                                      */
+/*-----------------------------------------------------------------------------*/
+typedef struct pathState_s {
+	const path_t	*path;
+	int16_t			segment;	// segment the robot is closest to
+	int16_t			lookSegment;	// segment the lookahead point is on
+	fix16_t			s;			// distance along the path
+	fix16_t			goalX;
+	fix16_t			goalY;
+	fix16_t			curvature;	// 1/inches Q16.16, +ve turns CCW
+	uint32_t		updates;
+} pathState_t;
+
+extern pathState_t	*pathGetPtr(void);
+extern bool_t		pathFollow(const path_t *path, int32_t timeout);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,73 @@
+/*
+ * traj.h
+ */
+
+#ifndef TRAJ_H_
+
+#define TRAJ_H_
+
+#include "ch.h"  		// needs for all ChibiOS programs
+#include "hal.h" 		// hardware abstraction layer header
+#include "vex.h"		// vex library header
+
+#include "fixmath.h"
+#include "drive.h"
+#include "arm.h"
+#include "claw.h"
+#include "odometry.h"
+#include "autoseq.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// arm or claw target that leaves the mechanism alone
+#define TRAJ_KEEP				(-1)
+
+// motor command per encoder tick per second, DRIVE_KV is per tick per odometry period
+#define TRAJ_KV					(DRIVE_KV / (1000 / ODOMETRY_PERIOD))
+
+/*-----------------------------------------------------------------------------*/
+/** @brief   One row of a trajectory table, generated by host/trajgen.c         */
+/*-----------------------------------------------------------------------------*/
+/** @details
+ *  Wheel speeds are encoder ticks per second, heading is the top 16 bits of
+ *  a fixangle_t relative to the table start heading. The layout is fixed,
+ *  trajgen checks the size when it writes the tables.
+ */
+typedef struct trajSetpoint_s {
+	int16_t			left;
+	int16_t			right;
+	uint16_t		heading;
+	int16_t			arm;		// arm pot target or TRAJ_KEEP
+	int16_t			claw;		// claw pot target or TRAJ_KEEP
+} trajSetpoint_t;
+
+typedef struct trajectory_s {
+	const trajSetpoint_t	*points;
+	uint16_t		count;
+	uint16_t		period;		// mS per row
+	uint16_t		heading;	// heading the table starts at
+} trajectory_t;
+
+/*-----------------------------------------------------------------------------*/
+/** @brief   Player state, for debugging                                        */
+/*-----------------------------------------------------------------------------*/
+typedef struct trajState_s {
+	const trajectory_t	*traj;
+	uint16_t		index;
+	int16_t			arm;		// last arm target sent
+	int16_t			claw;		// last claw target sent
+	int32_t			headingError;	// deg * 10
+	uint32_t		overruns;
+	bool_t			windowClosed;	// stopped at the end of the period
+} trajState_t;
+
+extern trajState_t	*trajGetPtr(void);
+extern void		trajPlay(const trajectory_t *traj);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
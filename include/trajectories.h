@@ -0,0 +1,331 @@
+/*
+ * trajectories.h
+ *
+ * Generated by host/trajgen.c from trajectories.traj, do not edit.
+ * Run make traj after changing the description.
+ */
+
+#ifndef TRAJECTORIES_H_
+
+#define TRAJECTORIES_H_
+
+#include "traj.h"
+
+// 1 trajectories, 308 setpoints, 3092 bytes of flash
+typedef char trajSetpointSizeCheck[(sizeof(trajSetpoint_t) == 10) ? 1 : -1];
+
+// Fence, 6160 mS
+static const trajSetpoint_t trajFencePoints[308] = {
+	{    25,    25,     0, 2880,   -1 },
+	{    50,    50,     0, 2880,   -1 },
+	{    75,    75,     0, 2880,   -1 },
+	{   100,   100,     0, 2880,   -1 },
+	{   125,   125,     0, 2880,   -1 },
+	{   150,   150,     0, 2880,   -1 },
+	{   175,   175,     0, 2880,   -1 },
+	{   200,   200,     0, 2880,   -1 },
+	{   225,   225,     0, 2880,   -1 },
+	{   250,   250,     0, 2880,   -1 },
+	{   275,   275,     0, 2880,   -1 },
+	{   299,   299,     0, 2880,   -1 },
+	{   324,   324,     0, 2880,   -1 },
+	{   349,   349,     0, 2880,   -1 },
+	{   374,   374,     0, 2880,   -1 },
+	{   399,   399,     0, 2880,   -1 },
+	{   424,   424,     0, 2880,   -1 },
+	{   449,   449,     0, 2880,   -1 },
+	{   474,   474,     0, 2880,   -1 },
+	{   499,   499,     0, 2880,   -1 },
+	{   524,   524,     0, 2880,   -1 },
+	{   549,   549,     0, 2880,   -1 },
+	{   574,   574,     0, 2880,   -1 },
+	{   599,   599,     0, 2880,   -1 },
+	{   624,   624,     0, 2880,   -1 },
+	{   624,   624,     0, 2880,   -1 },
+	{   624,   624,     0, 2880,   -1 },
+	{   624,   624,     0, 2880,   -1 },
+	{   624,   624,     0, 2880,   -1 },
+	{   624,   624,     0, 2880,   -1 },
+	{   624,   624,     0, 2880,   -1 },
+	{   624,   624,     0, 2880,   -1 },
+	{   624,   624,     0, 2880,   -1 },
+	{   624,   624,     0, 2880,   -1 },
+	{   624,   624,     0, 2880,   -1 },
+	{   624,   624,     0, 2880,   -1 },
+	{   624,   624,     0, 2880,   -1 },
+	{   624,   624,     0, 2880,   -1 },
+	{   624,   624,     0, 2880,   -1 },
+	{   624,   624,     0, 2880,   -1 },
+	{   624,   624,     0, 2880,   -1 },
+	{   624,   624,     0, 2880,   -1 },
+	{   624,   624,     0, 2880,   -1 },
+	{   624,   624,     0, 2880,   -1 },
+	{   624,   624,     0, 2880,   -1 },
+	{   624,   624,     0, 2880,   -1 },
+	{   624,   624,     0, 2880,   -1 },
+	{   624,   624,     0, 2880,   -1 },
+	{   624,   624,     0, 2880,   -1 },
+	{   624,   624,     0, 2880,   -1 },
+	{   624,   624,     0, 2880,   -1 },
+	{   624,   624,     0, 2880,   -1 },
+	{   624,   624,     0, 2880,   -1 },
+	{   624,   624,     0, 2880,   -1 },
+	{   624,   624,     0, 2880,   -1 },
+	{   624,   624,     0, 2880,   -1 },
+	{   624,   624,     0, 2880,   -1 },
+	{   624,   624,     0, 2880,   -1 },
+	{   624,   624,     0, 2880,   -1 },
+	{   624,   624,     0, 2880,   -1 },
+	{   599,   599,     0, 2880,   -1 },
+	{   574,   574,     0, 2880,   -1 },
+	{   549,   549,     0, 2880,   -1 },
+	{   524,   524,     0, 2880,   -1 },
+	{   499,   499,     0, 2880,   -1 },
+	{   474,   474,     0, 2880,   -1 },
+	{   449,   449,     0, 2880,   -1 },
+	{   424,   424,     0, 2880,   -1 },
+	{   399,   399,     0, 2880,   -1 },
+	{   374,   374,     0, 2880,   -1 },
+	{   349,   349,     0, 2880,   -1 },
+	{   324,   324,     0, 2880,   -1 },
+	{   299,   299,     0, 2880,   -1 },
+	{   275,   275,     0, 2880,   -1 },
+	{   250,   250,     0, 2880,   -1 },
+	{   225,   225,     0, 2880,   -1 },
+	{   200,   200,     0, 2880,   -1 },
+	{   175,   175,     0, 2880,   -1 },
+	{   150,   150,     0, 2880,   -1 },
+	{   125,   125,     0, 2880,   -1 },
+	{   100,   100,     0, 2880,   -1 },
+	{    75,    75,     0, 2880,   -1 },
+	{    50,    50,     0, 2880,   -1 },
+	{    25,    25,     0, 2880,   -1 },
+	{     0,     0,     0, 2880,   -1 },
+	{     0,     0,     0, 2880, 2880 },
+	{     0,     0,     0, 2880, 2880 },
+	{     0,     0,     0, 2880, 2880 },
+	{     0,     0,     0, 2880, 2880 },
+	{     0,     0,     0, 2880, 2880 },
+	{     0,     0,     0, 2880, 2880 },
+	{     0,     0,     0, 2880, 2880 },
+	{     0,     0,     0, 2880, 2880 },
+	{     0,     0,     0, 2880, 2880 },
+	{     0,     0,     0, 2880, 2880 },
+	{     0,     0,     0, 2880, 2880 },
+	{     0,     0,     0, 2880, 2880 },
+	{     0,     0,     0, 2880, 2880 },
+	{     0,     0,     0, 2880, 2880 },
+	{     0,     0,     0, 2880, 2880 },
+	{     0,     0,     0, 2880, 2880 },
+	{     0,     0,     0, 2880, 2880 },
+	{     0,     0,     0, 2880, 2880 },
+	{     0,     0,     0, 2880, 2880 },
+	{     0,     0,     0, 2880, 2880 },
+	{   -25,   -25,     0, 2880, 2880 },
+	{   -50,   -50,     0, 2880, 2880 },
+	{   -75,   -75,     0, 2880, 2880 },
+	{  -100,  -100,     0, 2880, 2880 },
+	{  -125,  -125,     0, 2880, 2880 },
+	{  -150,  -150,     0, 2880, 2880 },
+	{  -175,  -175,     0, 2880, 2880 },
+	{  -200,  -200,     0, 2880, 2880 },
+	{  -225,  -225,     0, 2880, 2880 },
+	{  -250,  -250,     0, 2880, 2880 },
+	{  -275,  -275,     0, 2880, 2880 },
+	{  -299,  -299,     0, 2880, 2880 },
+	{  -324,  -324,     0, 2880, 2880 },
+	{  -349,  -349,     0, 2880, 2880 },
+	{  -374,  -374,     0, 2880, 2880 },
+	{  -399,  -399,     0, 2880, 2880 },
+	{  -424,  -424,     0, 2880, 2880 },
+	{  -449,  -449,     0, 2880, 2880 },
+	{  -474,  -474,     0, 2880, 2880 },
+	{  -499,  -499,     0, 2880, 2880 },
+	{  -524,  -524,     0, 2880, 2880 },
+	{  -549,  -549,     0, 2880, 2880 },
+	{  -542,  -542,     0, 2880, 2880 },
+	{  -517,  -517,     0, 2880, 2880 },
+	{  -492,  -492,     0, 2880, 2880 },
+	{  -467,  -467,     0, 2880, 2880 },
+	{  -442,  -442,     0, 2880, 2880 },
+	{  -417,  -417,     0, 2880, 2880 },
+	{  -392,  -392,     0, 2880, 2880 },
+	{  -367,  -367,     0, 2880, 2880 },
+	{  -342,  -342,     0, 2880, 2880 },
+	{  -317,  -317,     0, 2880, 2880 },
+	{  -293,  -293,     0, 2880, 2880 },
+	{  -268,  -268,     0, 2880, 2880 },
+	{  -243,  -243,     0, 2880, 2880 },
+	{  -218,  -218,     0, 2880, 2880 },
+	{  -193,  -193,     0, 2880, 2880 },
+	{  -168,  -168,     0, 2880, 2880 },
+	{  -143,  -143,     0, 2880, 2880 },
+	{  -118,  -118,     0, 2880, 2880 },
+	{   -93,   -93,     0, 2880, 2880 },
+	{   -68,   -68,     0, 2880, 2880 },
+	{   -43,   -43,     0, 2880, 2880 },
+	{   -18,   -18,     0, 2880, 2880 },
+	{     0,     0,     0, 2880, 2880 },
+	{   -20,    20,    13, 3750, 1725 },
+	{   -39,    39,    52, 3750, 1725 },
+	{   -59,    59,   118, 3750, 1725 },
+	{   -78,    78,   210, 3750, 1725 },
+	{   -98,    98,   328, 3750, 1725 },
+	{  -118,   118,   472, 3750, 1725 },
+	{  -137,   137,   642, 3750, 1725 },
+	{  -157,   157,   839, 3750, 1725 },
+	{  -176,   176,  1062, 3750, 1725 },
+	{  -196,   196,  1311, 3750, 1725 },
+	{  -216,   216,  1586, 3750, 1725 },
+	{  -235,   235,  1887, 3750, 1725 },
+	{  -255,   255,  2215, 3750, 1725 },
+	{  -274,   274,  2569, 3750, 1725 },
+	{  -294,   294,  2949, 3750, 1725 },
+	{  -314,   314,  3355, 3750, 1725 },
+	{  -333,   333,  3788, 3750, 1725 },
+	{  -353,   353,  4247, 3750, 1725 },
+	{  -372,   372,  4732, 3750, 1725 },
+	{  -392,   392,  5243, 3750, 1725 },
+	{  -412,   412,  5780, 3750, 1725 },
+	{  -431,   431,  6344, 3750, 1725 },
+	{  -451,   451,  6934, 3750, 1725 },
+	{  -470,   470,  7550, 3750, 1725 },
+	{  -490,   490,  8192, 3750, 1725 },
+	{  -470,   470,  8834, 3750, 1725 },
+	{  -451,   451,  9450, 3750, 1725 },
+	{  -431,   431, 10040, 3750, 1725 },
+	{  -412,   412, 10604, 3750, 1725 },
+	{  -392,   392, 11141, 3750, 1725 },
+	{  -372,   372, 11652, 3750, 1725 },
+	{  -353,   353, 12137, 3750, 1725 },
+	{  -333,   333, 12596, 3750, 1725 },
+	{  -314,   314, 13029, 3750, 1725 },
+	{  -294,   294, 13435, 3750, 1725 },
+	{  -274,   274, 13815, 3750, 1725 },
+	{  -255,   255, 14169, 3750, 1725 },
+	{  -235,   235, 14497, 3750, 1725 },
+	{  -216,   216, 14798, 3750, 1725 },
+	{  -196,   196, 15073, 3750, 1725 },
+	{  -176,   176, 15322, 3750, 1725 },
+	{  -157,   157, 15545, 3750, 1725 },
+	{  -137,   137, 15742, 3750, 1725 },
+	{  -118,   118, 15912, 3750, 1725 },
+	{   -98,    98, 16056, 3750, 1725 },
+	{   -78,    78, 16174, 3750, 1725 },
+	{   -59,    59, 16266, 3750, 1725 },
+	{   -39,    39, 16332, 3750, 1725 },
+	{   -20,    20, 16371, 3750, 1725 },
+	{     0,     0, 16384, 3750, 1725 },
+	{    25,    13, 16380, 3750, 1725 },
+	{    50,    26, 16368, 3750, 1725 },
+	{    75,    39, 16348, 3750, 1725 },
+	{   100,    52, 16320, 3750, 1725 },
+	{   125,    65, 16285, 3750, 1725 },
+	{   150,    78, 16241, 3750, 1725 },
+	{   175,    92, 16189, 3750, 1725 },
+	{   200,   105, 16130, 3750, 1725 },
+	{   225,   118, 16062, 3750, 1725 },
+	{   250,   131, 15987, 3750, 1725 },
+	{   275,   144, 15903, 3750, 1725 },
+	{   299,   157, 15812, 3750, 1725 },
+	{   324,   170, 15712, 3750, 1725 },
+	{   349,   183, 15605, 3750, 1725 },
+	{   374,   196, 15490, 3750, 1725 },
+	{   399,   209, 15367, 3750, 1725 },
+	{   424,   222, 15236, 3750, 1725 },
+	{   449,   235, 15097, 3750, 1725 },
+	{   474,   248, 14950, 3750, 1725 },
+	{   499,   261, 14795, 3750, 1725 },
+	{   524,   275, 14632, 3750, 1725 },
+	{   549,   288, 14461, 3750, 1725 },
+	{   574,   301, 14282, 3750, 1725 },
+	{   599,   314, 14095, 3750, 1725 },
+	{   624,   327, 13901, 3750, 1725 },
+	{   624,   327, 13702, 3750, 1725 },
+	{   624,   327, 13503, 3750, 1725 },
+	{   624,   327, 13305, 3750, 1725 },
+	{   624,   327, 13106, 3750, 1725 },
+	{   624,   327, 12907, 3750, 1725 },
+	{   624,   327, 12709, 3750, 1725 },
+	{   624,   327, 12510, 3750, 1725 },
+	{   624,   327, 12311, 3750, 1725 },
+	{   624,   327, 12113, 3750, 1725 },
+	{   624,   327, 11914, 3750, 1725 },
+	{   624,   327, 11715, 3750, 1725 },
+	{   624,   327, 11516, 3750, 1725 },
+	{   624,   327, 11318, 3750, 1725 },
+	{   624,   327, 11119, 3750, 1725 },
+	{   624,   327, 10920, 3750, 1725 },
+	{   624,   327, 10722, 3750, 1725 },
+	{   624,   327, 10523, 3750, 1725 },
+	{   624,   327, 10324, 3750, 1725 },
+	{   624,   327, 10126, 3750, 1725 },
+	{   624,   327,  9927, 3750, 1725 },
+	{   624,   327,  9728, 3750, 1725 },
+	{   624,   327,  9530, 3750, 1725 },
+	{   624,   327,  9331, 3750, 1725 },
+	{   624,   327,  9132, 3750, 1725 },
+	{   624,   327,  8934, 3750, 1725 },
+	{   624,   327,  8735, 3750, 1725 },
+	{   624,   327,  8536, 3750, 1725 },
+	{   624,   327,  8338, 3750, 1725 },
+	{   624,   327,  8139, 3750, 1725 },
+	{   624,   327,  7940, 3750, 1725 },
+	{   624,   327,  7742, 3750, 1725 },
+	{   624,   327,  7543, 3750, 1725 },
+	{   624,   327,  7344, 3750, 1725 },
+	{   624,   327,  7146, 3750, 1725 },
+	{   624,   327,  6947, 3750, 1725 },
+	{   624,   327,  6748, 3750, 1725 },
+	{   624,   327,  6550, 3750, 1725 },
+	{   624,   327,  6351, 3750, 1725 },
+	{   624,   327,  6152, 3750, 1725 },
+	{   624,   327,  5954, 3750, 1725 },
+	{   624,   327,  5755, 3750, 1725 },
+	{   624,   327,  5556, 3750, 1725 },
+	{   624,   327,  5358, 3750, 1725 },
+	{   624,   327,  5159, 3750, 1725 },
+	{   624,   327,  4960, 3750, 1725 },
+	{   624,   327,  4762, 3750, 1725 },
+	{   624,   327,  4563, 3750, 1725 },
+	{   624,   327,  4364, 3750, 1725 },
+	{   624,   327,  4166, 3750, 1725 },
+	{   624,   327,  3967, 3750, 1725 },
+	{   624,   327,  3768, 3750, 1725 },
+	{   624,   327,  3570, 3750, 1725 },
+	{   624,   327,  3371, 3750, 1725 },
+	{   624,   327,  3172, 3750, 1725 },
+	{   624,   327,  2974, 3750, 1725 },
+	{   624,   327,  2775, 3750, 1725 },
+	{   624,   327,  2576, 3750, 1725 },
+	{   611,   320,  2379, 3750, 1725 },
+	{   586,   307,  2188, 3750, 1725 },
+	{   561,   294,  2006, 3750, 1725 },
+	{   536,   281,  1831, 3750, 1725 },
+	{   511,   268,  1664, 3750, 1725 },
+	{   486,   254,  1506, 3750, 1725 },
+	{   461,   241,  1355, 3750, 1725 },
+	{   436,   228,  1212, 3750, 1725 },
+	{   411,   215,  1077, 3750, 1725 },
+	{   386,   202,   951, 3750, 1725 },
+	{   361,   189,   832, 3750, 1725 },
+	{   336,   176,   721, 3750, 1725 },
+	{   311,   163,   618, 3750, 1725 },
+	{   286,   150,   522, 3750, 1725 },
+	{   261,   137,   435, 3750, 1725 },
+	{   236,   124,   356, 3750, 1725 },
+	{   211,   111,   285, 3750, 1725 },
+	{   186,    98,   222, 3750, 1725 },
+	{   161,    85,   166, 3750, 1725 },
+	{   136,    71,   119, 3750, 1725 },
+	{   111,    58,    79, 3750, 1725 },
+	{    87,    45,    48, 3750, 1725 },
+	{    62,    32,    24, 3750, 1725 },
+	{    37,    19,     9, 3750, 1725 },
+	{    12,     6,     1, 3750, 1725 },
+	{     0,     0,     0, 3750, 1725 },
+};
+
+static const trajectory_t trajFence = { trajFencePoints, 308, 20, 0 };
+
+#endif
@@ -11,12 +11,35 @@
 // storage for arm
 static arm_t arm;
 
-// working area for arm task
-static WORKING_AREA(waArm, 512);
+// arm control loop, run by the scheduler
+static vexSchedTask armSched;
+
+// commands from other tasks, only the scheduler thread touches the lock
+typedef enum {
+	armCommandLock = 0,
+	armCommandUnlock,
+	armCommandLockDown,
+	armCommandLockBump,
+	armCommandLockUp,
+	armCommandLockPosition,
+	armCommandLockCurrent
+} armCommand_t;
+
+#define ARM_COMMAND(cmd, value)	((msg_t)(((uint32_t)(cmd) << 16) | (uint16_t)(value)))
+
+static msg_t	armCommandBuffer[ARM_COMMANDS];
+static MAILBOX_DECL(armCommands, armCommandBuffer, ARM_COMMANDS);
 
 // private functions
-static msg_t	armThread(void *arg);
+static void		armUpdate(void *arg);
+static void		armModeChange(void *arg, tVexMode mode);
+static void		armCommandPost(armCommand_t cmd, int16_t value);
+static void		armCommandApply(void *arg);
+static void		armMoveSource(short source, int16_t cmd, bool_t immediate);
+static void		armRelease(short source);
 static void		armPIDUpdate(int16_t *cmd);
+static void		armEstimatorInit(void);
+static void		armEstimatorUpdate(void);
 
 // arm speed adjustment
 #define USE_ARM_SPEED_TABLE 1
@@ -116,18 +139,187 @@ armInit(void)
 	// SmartMotorSetRpmSensor(arm.bottomMotorPair, arm.potentiometer, 6000 * arm.gearRatio, arm.reversed);
 	SmartMotorLinkMotors(arm.motor2, arm.motor1);
 	SmartMotorLinkMotors(arm.motor2, arm.motor0);
-	arm.lock = PidControllerInit(0.004, 0.0001, 0.01, kVexSensorUndefined, 0);
+	// Ki and Kd act per loop, keep the tuned response at the loop period
+	arm.lock = PidControllerInit(0.004,
+		0.0001 * ARM_PERIOD / ARM_TUNED_PERIOD,
+		0.01 * ARM_TUNED_PERIOD / ARM_PERIOD,
+		kVexSensorUndefined, 0);
 	arm.lock->enabled = 0;
+	armEstimatorInit();
+	return;
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Calculate the arm estimator gains                              */
+/*-----------------------------------------------------------------------------*/
+/** @details
+ *  Two state (angle, rate) Kalman filter, the pot measures angle and the
+ *  bottom motor IME measures rate. The noise is fixed so the gains settle
+ *  to constants, iterate the covariance here once in float and run the
+ *  filter in fixed point with the result. A second set of gains covers
+ *  periods where the IME count is rejected.
+ */
+static void
+armEstimatorInit(void)
+{
+	armEstimator_t	*e = &arm.estimator;
+	float	ticksPerRev;
+	float	potPerTick;
+	float	r1 = ARM_EST_POT_NOISE * ARM_EST_POT_NOISE;
+	float	r2 = ARM_EST_IME_NOISE * ARM_EST_IME_NOISE;
+	float	qa = ARM_EST_ACCEL_NOISE * ARM_EST_ACCEL_NOISE;
+	float	qd = ARM_EST_DRIFT_NOISE * ARM_EST_DRIFT_NOISE;
+	float	p11, p12, p22;		// covariance, symmetric
+	float	a11, a12, a22;		// predicted covariance
+	float	s11, s12, s22, det;
+	float	k11 = 0, k12 = 0, k21 = 0, k22 = 0;
+	int		pass, i;
+
+	ticksPerRev = SmartMotorGetPtr(arm.motor2)->ticks_per_rev;
+	if (ticksPerRev <= 0)
+		ticksPerRev = SMLIB_TPR_393S;
+
+	// IME counts positive with positive motor drive, the pot may count the other way
+	potPerTick = (ARM_POT_PER_REV * arm.gearRatio) / ticksPerRev;
+	if (arm.reversed)
+		potPerTick = -potPerTick;
+	e->potPerTick = (fix16_t)(potPerTick * 65536.0f);
+
+	// pass 0 uses pot and IME, pass 1 the pot alone
+	for (pass = 0; pass < 2; pass++) {
+		p11 = r1;
+		p12 = 0;
+		p22 = r2;
+		for (i = 0; i < 200; i++) {
+			// predict, constant rate model with one period as the time step
+			a11 = p11 + 2 * p12 + p22 + (qa / 4) + qd;
+			a12 = p12 + p22 + (qa / 2);
+			a22 = p22 + qa;
+
+			if (pass == 0) {
+				// K = P S^-1 with S = P + R
+				s11 = a11 + r1;
+				s12 = a12;
+				s22 = a22 + r2;
+				det = (s11 * s22) - (s12 * s12);
+				k11 = ((a11 * s22) - (a12 * s12)) / det;
+				k12 = ((a12 * s11) - (a11 * s12)) / det;
+				k21 = ((a12 * s22) - (a22 * s12)) / det;
+				k22 = ((a22 * s11) - (a12 * s12)) / det;
+				p11 = ((1 - k11) * a11) - (k12 * a12);
+				p12 = ((1 - k11) * a12) - (k12 * a22);
+				p22 = ((1 - k22) * a22) - (k21 * a12);
+			} else {
+				k11 = a11 / (a11 + r1);
+				k21 = a12 / (a11 + r1);
+				p11 = (1 - k11) * a11;
+				p12 = (1 - k11) * a12;
+				p22 = a22 - (k21 * a12);
+			}
+		}
+
+		if (pass == 0) {
+			e->gain[0][0] = (fix16_t)(k11 * 65536.0f);
+			e->gain[0][1] = (fix16_t)(k12 * 65536.0f);
+			e->gain[1][0] = (fix16_t)(k21 * 65536.0f);
+			e->gain[1][1] = (fix16_t)(k22 * 65536.0f);
+		} else {
+			e->potGain[0] = (fix16_t)(k11 * 65536.0f);
+			e->potGain[1] = (fix16_t)(k21 * 65536.0f);
+		}
+	}
+
+	e->valid = FALSE;
+	e->imeRejects = 0;
 	return;
 }
 
 /*-----------------------------------------------------------------------------*/
-/** @brief      Start the arm system thread                                    */
+/** @brief      Run one period of the arm estimator                            */
+/*-----------------------------------------------------------------------------*/
+static void
+armEstimatorUpdate(void)
+{
+	armEstimator_t	*e = &arm.estimator;
+	int32_t		pot;
+	int32_t		count, delta;
+	fix16_t		angle, rate;
+	fix16_t		y1, y2;
+
+	pot = vexBoardGetPtr()->analog[arm.potentiometer];
+	count = vexMotorPositionGet(arm.motor2);
+
+	if (!e->valid) {
+		e->angle = pot << 16;
+		e->rate = 0;
+		e->imeCount = count;
+		e->valid = TRUE;
+		return;
+	}
+
+	delta = count - e->imeCount;
+	e->imeCount = count;
+
+	// predict
+	angle = e->angle + e->rate;
+	rate = e->rate;
+
+	// correct
+	y1 = (pot << 16) - angle;
+	if (abs(delta) > ARM_EST_MAX_DELTA) {
+		// count was reset or the IME renegotiated, pot only this period
+		e->imeRejects++;
+		angle += fixMul(e->potGain[0], y1);
+		rate += fixMul(e->potGain[1], y1);
+	} else {
+		y2 = (delta * e->potPerTick) - rate;
+		angle += fixMul(e->gain[0][0], y1) + fixMul(e->gain[0][1], y2);
+		rate += fixMul(e->gain[1][0], y1) + fixMul(e->gain[1][1], y2);
+	}
+
+	e->angle = angle;
+	e->rate = rate;
+	return;
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Best arm position in pot counts                                */
+/** @return     The estimated pot value, raw pot before the estimator runs     */
+/*-----------------------------------------------------------------------------*/
+int32_t
+armGetPosition(void)
+{
+	if (!arm.estimator.valid)
+		return (vexBoardAnalogGet(arm.potentiometer));
+	return ((arm.estimator.angle + (FIX16_ONE / 2)) >> 16);
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Start the arm control loop, it runs in every mode              */
 /*-----------------------------------------------------------------------------*/
 void
 armStart(void)
 {
-	chThdCreateStatic(waArm, sizeof(waArm), NORMALPRIO - 1, armThread, NULL);
+	vexSchedAdd(&armSched, "arm", armUpdate, NULL, ARM_FRAMES, ARM_PRIORITY);
+	vexSchedModeCallbackSet(&armSched, armModeChange);
+	vexSchedCommandCallbackSet(&armSched, armCommandApply);
+	vexSchedPersistentSet(&armSched, TRUE);
+	return;
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Competition mode change, the joysticks take over for driver    */
+/** @param[in]  arg Unused                                                     */
+/** @param[in]  mode The new mode                                              */
+/*-----------------------------------------------------------------------------*/
+static void
+armModeChange(void *arg, tVexMode mode)
+{
+	// Unused
+	(void) arg;
+
+	if (mode == kVexModeOperator)
+		armLockCurrent();
 	return;
 }
 
@@ -143,58 +335,61 @@ limitSpeed(int speed, int limit)
 }
 
 /*-----------------------------------------------------------------------------*/
-/** @brief      The arm system thread                                          */
+/** @brief      The arm control loop, called each ARM_FRAMES SPI frames        */
 /** @param[in]  arg Unused                                                     */
-/** @return     (msg_t) 0                                                      */
 /*-----------------------------------------------------------------------------*/
-static msg_t
-armThread(void *arg)
+static void
+armUpdate(void *arg)
 {
+	const vexBoardFrame *board = vexBoardGetPtr();
 	int16_t armCmd = 0;
 	bool_t immediate = FALSE;
+	short source;
 
 	// Unused
 	(void) arg;
 
-	// Register the task
-	vexTaskRegister("arm");
-
-	while (!chThdShouldTerminate()) {
-		if (arm.locked) {
-			armCmd = armSpeed( limitSpeed( vexControllerGet( Ch2Xmtr2 ), 20 ) );
-
-			if (armCmd == 0) {
-				immediate = FALSE;
-				if (vexControllerGet( Btn7D ) || vexControllerGet( Btn7DXmtr2 )) {
-					arm.position = armPositionDown;
-					arm.lock->enabled = 1;
-					arm.lock->target_value = arm.downValue;
-				} else if (vexControllerGet( Btn7L ) || vexControllerGet( Btn7LXmtr2 )) {
-					arm.position = armPositionBump;
-					arm.lock->enabled = 1;
-					arm.lock->target_value = arm.bumpValue;
-				} else if (vexControllerGet( Btn7U ) || vexControllerGet( Btn7UXmtr2 )) {
-					arm.position = armPositionUp;
-					arm.lock->enabled = 1;
-					arm.lock->target_value = arm.upValue;
-				}
-				armPIDUpdate(&armCmd);
-			} else {
-				arm.position = armPositionUnknown;
-				immediate = TRUE;
-				// disable PID if joystick driving
-				arm.lock->enabled = 0;
-				PidControllerUpdate( arm.lock ); // zero out PID
+	// anything posted before the loop was started
+	armCommandApply(NULL);
+
+	armEstimatorUpdate();
+
+	// keep the estimate going but leave the motors alone while disabled
+	if (arm.locked && board->mode != kVexModeDisabled) {
+		armCmd = armSpeed( limitSpeed( vexBoardControllerGet( board, Ch2Xmtr2 ), 20 ) );
+
+		if (armCmd == 0) {
+			immediate = FALSE;
+			if (vexBoardControllerGet( board, Btn7D ) || vexBoardControllerGet( board, Btn7DXmtr2 )) {
+				arm.position = armPositionDown;
+				arm.lock->enabled = 1;
+				arm.lock->target_value = arm.downValue;
+			} else if (vexBoardControllerGet( board, Btn7L ) || vexBoardControllerGet( board, Btn7LXmtr2 )) {
+				arm.position = armPositionBump;
+				arm.lock->enabled = 1;
+				arm.lock->target_value = arm.bumpValue;
+			} else if (vexBoardControllerGet( board, Btn7U ) || vexBoardControllerGet( board, Btn7UXmtr2 )) {
+				arm.position = armPositionUp;
+				arm.lock->enabled = 1;
+				arm.lock->target_value = arm.upValue;
 			}
-
-			armMove( armCmd, immediate );
+			armPIDUpdate(&armCmd);
+			source = kSmartMotorSourceLock;
+			armRelease(kSmartMotorSourceDriver);
+		} else {
+			arm.position = armPositionUnknown;
+			immediate = TRUE;
+			// disable PID if joystick driving
+			arm.lock->enabled = 0;
+			PidControllerUpdate( arm.lock ); // zero out PID
+			source = kSmartMotorSourceDriver;
+			armRelease(kSmartMotorSourceLock);
 		}
 
-		// Don't hog cpu
-		vexSleep(25);
+		armMoveSource( source, armCmd, immediate );
 	}
 
-	return ((msg_t) 0);
+	return;
 }
 
 static void
@@ -203,7 +398,7 @@ armPIDUpdate(int16_t *cmd)
 	// enable PID if not driving and already disabled
 	if (arm.lock->enabled == 0) {
 		arm.lock->enabled = 1;
-		arm.lock->target_value = vexAdcGet( arm.potentiometer );
+		arm.lock->target_value = armGetPosition();
 	}
 	// prevent PID from trying to lock outside bounds
 	if (arm.reversed) {
@@ -217,8 +412,8 @@ armPIDUpdate(int16_t *cmd)
 		else if (arm.lock->target_value > arm.upValue)
 			arm.lock->target_value = arm.upValue;
 	}
-	// update PID
-	arm.lock->sensor_value = vexAdcGet( arm.potentiometer );
+	// update PID, the estimate is smooth so the derivative term is not pot noise
+	arm.lock->sensor_value = armGetPosition();
 	arm.lock->error =
 		(arm.reversed)
 		? (arm.lock->sensor_value - arm.lock->target_value)
@@ -234,58 +429,151 @@ armPIDUpdate(int16_t *cmd)
 	return;
 }
 
+static void
+armMoveSource(short source, int16_t cmd, bool_t immediate)
+{
+	SmartMotorSourceSet( source, arm.motor0, cmd, immediate );
+	SmartMotorSourceSet( source, arm.motor1, cmd, immediate );
+	SmartMotorSourceSet( source, arm.motor2, cmd, immediate );
+}
+
+static void
+armRelease(short source)
+{
+	SmartMotorSourceRelease( source, arm.motor0 );
+	SmartMotorSourceRelease( source, arm.motor1 );
+	SmartMotorSourceRelease( source, arm.motor2 );
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Drive the arm from autonomous, the arm loop wins while locked  */
+/** @param[in]  cmd The motor command                                          */
+/** @param[in]  immediate Bypass the slew rate                                 */
+/*-----------------------------------------------------------------------------*/
 void
 armMove(int16_t cmd, bool_t immediate)
 {
-	SetMotor( arm.motor0, cmd, immediate );
-	SetMotor( arm.motor1, cmd, immediate );
-	SetMotor( arm.motor2, cmd, immediate );
+	armMoveSource( kSmartMotorSourceAutonomous, cmd, immediate );
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Queue a command for the arm loop and wake it                   */
+/** @param[in]  cmd The command                                                */
+/** @param[in]  value Pot target for armCommandLockPosition                    */
+/*-----------------------------------------------------------------------------*/
+static void
+armCommandPost(armCommand_t cmd, int16_t value)
+{
+	if (chMBPost(&armCommands, ARM_COMMAND(cmd, value), TIME_IMMEDIATE) != RDY_OK)
+		arm.commandsDropped++;
+	vexSchedWake(&armSched);
+	return;
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Apply queued commands, runs on the scheduler thread            */
+/** @param[in]  arg Unused                                                     */
+/*-----------------------------------------------------------------------------*/
+static void
+armCommandApply(void *arg)
+{
+	msg_t	msg;
+	int16_t	value;
+
+	// Unused
+	(void) arg;
+
+	while (chMBFetch(&armCommands, &msg, TIME_IMMEDIATE) == RDY_OK) {
+		value = (int16_t)(msg & 0xFFFF);
+		// a lock hands the motors back to the loop, unlock hands them to autonomous
+		if ((armCommand_t)((uint32_t)msg >> 16) == armCommandUnlock) {
+			armRelease(kSmartMotorSourceDriver);
+			armRelease(kSmartMotorSourceLock);
+		} else {
+			armRelease(kSmartMotorSourceAutonomous);
+		}
+
+		switch ((armCommand_t)((uint32_t)msg >> 16)) {
+			case armCommandLock:
+				arm.locked = TRUE;
+				break;
+			case armCommandUnlock:
+				arm.locked = FALSE;
+				break;
+			case armCommandLockDown:
+				arm.locked = TRUE;
+				arm.position = armPositionDown;
+				arm.lock->enabled = 1;
+				arm.lock->target_value = arm.downValue;
+				break;
+			case armCommandLockBump:
+				arm.locked = TRUE;
+				arm.position = armPositionBump;
+				arm.lock->enabled = 1;
+				arm.lock->target_value = arm.bumpValue;
+				break;
+			case armCommandLockUp:
+				arm.locked = TRUE;
+				arm.position = armPositionUp;
+				arm.lock->enabled = 1;
+				arm.lock->target_value = arm.upValue;
+				break;
+			case armCommandLockPosition:
+				arm.locked = TRUE;
+				arm.position = armPositionUnknown;
+				arm.lock->enabled = 1;
+				arm.lock->target_value = value;
+				break;
+			case armCommandLockCurrent:
+				arm.locked = TRUE;
+				arm.position = armPositionUnknown;
+				arm.lock->enabled = 1;
+				arm.lock->target_value = armGetPosition();
+				break;
+		}
+		arm.commands++;
+	}
+	return;
 }
 
 void
 armLock(void)
 {
-	arm.locked = TRUE;
+	armCommandPost(armCommandLock, 0);
 }
 
 void
 armUnlock(void)
 {
-	arm.locked = FALSE;
+	armCommandPost(armCommandUnlock, 0);
 }
 
 void
 armLockDown(void)
 {
-	armLock();
-	arm.position = armPositionDown;
-	arm.lock->enabled = 1;
-	arm.lock->target_value = arm.downValue;
+	armCommandPost(armCommandLockDown, 0);
 }
 
 void
 armLockBump(void)
 {
-	armLock();
-	arm.position = armPositionBump;
-	arm.lock->enabled = 1;
-	arm.lock->target_value = arm.bumpValue;
+	armCommandPost(armCommandLockBump, 0);
 }
 
 void
 armLockUp(void)
 {
-	armLock();
-	arm.position = armPositionUp;
-	arm.lock->enabled = 1;
-	arm.lock->target_value = arm.upValue;
+	armCommandPost(armCommandLockUp, 0);
+}
+
+void
+armLockPosition(int16_t value)
+{
+	armCommandPost(armCommandLockPosition, value);
 }
 
 void
 armLockCurrent(void)
 {
-	armLock();
-	arm.position = armPositionUnknown;
-	arm.lock->enabled = 1;
-	arm.lock->target_value = vexAdcGet( arm.potentiometer );
+	armCommandPost(armCommandLockCurrent, 0);
 }
@@ -5,1176 +5,486 @@
 
 #include "autonomous.h"
 
-#include <math.h>
-#include <stdlib.h>
-
-/* Timer Helpers */
-typedef struct autotimer_s autotimer_t;
-
-struct autotimer_s {
-	unsigned long actual;
-	unsigned long target;
+/*
+ * Each routine is a table of steps run by autoseq, one entry per step
+ *	{ drive, arm, claw, timeout in mS }
+ * Positive arm speed raises the arm, positive claw speed grabs. Drive is
+ * AUTO_DRIVE(x, y), positive y is forward and positive x is right.
+ *
+ * AUTO_SEGMENT(ms, priority) starts a group of steps that take about ms.
+ * When the routine runs late, low and normal segments that no longer fit
+ * are skipped and high ones are cut short, see autoseq.h.
+ */
+
+// Grab the cube & three stars
+static const autoStep_t autonomousSteps0[] = {
+	{ AUTO_DRIVE(0, 0), AUTO_NONE, AUTO_NONE, 0 },
+
+	// unfold
+	AUTO_SEGMENT(1650, autoPriorityRequired),
+	AUTO_STOP_DRIVE(50),
+	{ AUTO_NONE, AUTO_MOVE(-127), AUTO_NONE, 200 },
+	AUTO_STOP_ALL(50),
+	{ AUTO_NONE, AUTO_MOVE(127), AUTO_NONE, 300 },
+	AUTO_STOP_ALL(50),
+	{ AUTO_NONE, AUTO_MOVE(-127), AUTO_NONE, 650 },
+	AUTO_STOP_ALL(50),
+	{ AUTO_NONE, AUTO_CMD(autoCmdLockDown), AUTO_NONE, 250 },
+	AUTO_STOP_DRIVE(50),
+
+	// open claw, drive forward & close claw
+	AUTO_SEGMENT(3075, autoPriorityHigh),
+	{ AUTO_NONE, AUTO_NONE, AUTO_MOVE(-127), 500 },
+	AUTO_STOP_ALL(50),
+	{ AUTO_DRIVE(0, 127), AUTO_NONE, AUTO_NONE, 1500 },
+	AUTO_STOP_DRIVE(25),
+	{ AUTO_NONE, AUTO_NONE, AUTO_MOVE(127), 1000 },
+	{ AUTO_NONE, AUTO_NONE, AUTO_CMD(autoCmdLockGrab), 0 },
+
+	// raise arm & turn
+	AUTO_SEGMENT(1075, autoPriorityHigh),
+	{ AUTO_NONE, AUTO_CMD(autoCmdUnlock), AUTO_NONE, 0 },
+	{ AUTO_NONE, AUTO_MOVE(60), AUTO_NONE, 500 },
+	AUTO_STOP_ALL(50),
+	{ AUTO_DRIVE(127, 0), AUTO_NONE, AUTO_NONE, 500 },
+	AUTO_STOP_DRIVE(25),
+
+	// backup and dump
+	AUTO_SEGMENT(2625, autoPriorityHigh),
+	{ AUTO_DRIVE(0, -127), AUTO_NONE, AUTO_NONE, 1300 },
+	AUTO_STOP_DRIVE(50),
+	{ AUTO_NONE, AUTO_MOVE(127), AUTO_NONE, 1000 },
+	{ AUTO_NONE, AUTO_NONE, AUTO_MOVE(-127), 250 },
+	{ AUTO_NONE, AUTO_NONE, AUTO_CMD(autoCmdUnlock), 0 },
+	AUTO_STOP_ALL(25),
+
+	// lower arm, drive forward, turn to the right, drive forward
+	AUTO_SEGMENT(4400, autoPriorityNormal),
+	{ AUTO_NONE, AUTO_MOVE(-127), AUTO_NONE, 1000 },
+	{ AUTO_NONE, AUTO_CMD(autoCmdLockDown), AUTO_NONE, 0 },
+	AUTO_STOP_ALL(50),
+	{ AUTO_DRIVE(0, 127), AUTO_NONE, AUTO_NONE, 400 },
+	AUTO_STOP_DRIVE(50),
+	{ AUTO_DRIVE(127, 0), AUTO_NONE, AUTO_NONE, 300 },
+	AUTO_STOP_DRIVE(50),
+	{ AUTO_DRIVE(0, 127), AUTO_NONE, AUTO_NONE, 2000 },
+	AUTO_STOP_DRIVE(50),
+	{ AUTO_NONE, AUTO_NONE, AUTO_MOVE(127), 500 },
+
+	// Drive backward, turn left, backup & dump
+	AUTO_SEGMENT(3125, autoPriorityNormal),
+	{ AUTO_DRIVE(0, -127), AUTO_NONE, AUTO_NONE, 500 },
+	AUTO_STOP_DRIVE(25),
+	{ AUTO_DRIVE(-127, 0), AUTO_NONE, AUTO_NONE, 400 },
+	AUTO_STOP_DRIVE(25),
+	{ AUTO_DRIVE(0, -127), AUTO_NONE, AUTO_NONE, 1000 },
+	AUTO_STOP_DRIVE(25),
+	{ AUTO_NONE, AUTO_MOVE(127), AUTO_NONE, 800 },
+	{ AUTO_NONE, AUTO_MOVE(127), AUTO_MOVE(-127), 300 },
+	AUTO_STOP_ALL(50),
+
+	// lower arm, drive forward & grab cube
+	AUTO_SEGMENT(4950, autoPriorityLow),
+	{ AUTO_NONE, AUTO_CMD(autoCmdLockDown), AUTO_NONE, 1000 },
+	{ AUTO_DRIVE(0, 127), AUTO_NONE, AUTO_NONE, 1100 },
+	AUTO_STOP_DRIVE(25),
+	{ AUTO_NONE, AUTO_NONE, AUTO_MOVE(127), 500 },
+	AUTO_STOP_ALL(50),
+	{ AUTO_DRIVE(0, -127), AUTO_NONE, AUTO_NONE, 1100 },
+	AUTO_STOP_DRIVE(50),
+	{ AUTO_NONE, AUTO_MOVE(127), AUTO_NONE, 800 },
+	{ AUTO_NONE, AUTO_MOVE(127), AUTO_MOVE(-127), 300 },
+	AUTO_STOP_ALL(25),
+
+	// lower arm, drive forward & grab cube
+	AUTO_SEGMENT(4950, autoPriorityLow),
+	{ AUTO_NONE, AUTO_CMD(autoCmdLockDown), AUTO_NONE, 1000 },
+	{ AUTO_DRIVE(0, 127), AUTO_NONE, AUTO_NONE, 1100 },
+	AUTO_STOP_DRIVE(25),
+	{ AUTO_NONE, AUTO_NONE, AUTO_MOVE(127), 500 },
+	AUTO_STOP_ALL(50),
+	{ AUTO_DRIVE(0, -127), AUTO_NONE, AUTO_NONE, 1100 },
+	AUTO_STOP_DRIVE(50),
+	{ AUTO_NONE, AUTO_MOVE(127), AUTO_NONE, 800 },
+	{ AUTO_NONE, AUTO_MOVE(127), AUTO_MOVE(-127), 300 },
+	AUTO_STOP_ALL(25),
 };
 
-static autotimer_t autotimer = {
-	.actual = 0,
-	.target = 0
+static const autoStep_t autonomousSteps1[] = {
+	AUTO_STOP_ALL(25),
+	AUTO_STOP_DRIVE(25),
+	{ AUTO_NONE, AUTO_NONE, AUTO_MOVE(0), 0 },
+	AUTO_STOP_ALL(75),
+
+	// unfold
+	AUTO_SEGMENT(1400, autoPriorityRequired),
+	{ AUTO_NONE, AUTO_MOVE(-127), AUTO_MOVE(0), 200 },
+	AUTO_STOP_ALL(50),
+	{ AUTO_NONE, AUTO_MOVE(127), AUTO_MOVE(0), 200 },
+	AUTO_STOP_ALL(50),
+	{ AUTO_NONE, AUTO_MOVE(-127), AUTO_MOVE(0), 600 },
+	{ AUTO_NONE, AUTO_CMD(autoCmdLockDown), AUTO_NONE, 250 },
+	AUTO_STOP_ALL(50),
+
+	// drive forward and grab cube
+	AUTO_SEGMENT(1900, autoPriorityHigh),
+	{ AUTO_NONE, AUTO_CMD(autoCmdUnlock), AUTO_NONE, 0 },
+	{ AUTO_NONE, AUTO_MOVE(-127), AUTO_MOVE(-127), 1000 },
+	{ AUTO_DRIVE(0, 127), AUTO_NONE, AUTO_CMD(autoCmdLockOpen), 700 },
+	{ AUTO_NONE, AUTO_NONE, AUTO_CMD(autoCmdLockGrab), 100 },
+	AUTO_STOP_DRIVE(100),
+
+	// lift halfway, drive forward, and turn right
+	AUTO_SEGMENT(1200, autoPriorityHigh),
+	{ AUTO_NONE, AUTO_MOVE(60), AUTO_NONE, 300 },
+	AUTO_STOP_ALL(50),
+	{ AUTO_DRIVE(0, 127), AUTO_MOVE(10), AUTO_NONE, 300 },
+	AUTO_STOP_DRIVE(50),
+	{ AUTO_DRIVE(127, 0), AUTO_NONE, AUTO_NONE, 400 },
+	AUTO_STOP_DRIVE(50),
+	AUTO_STOP_ALL(50),
+
+	// backup and dump
+	AUTO_SEGMENT(2200, autoPriorityHigh),
+	{ AUTO_DRIVE(0, -127), AUTO_NONE, AUTO_NONE, 1200 },
+	AUTO_STOP_DRIVE(50),
+	{ AUTO_NONE, AUTO_MOVE(127), AUTO_CMD(autoCmdLockOpen), 900 },
+	AUTO_STOP_ALL(50),
+
+	// lower arm, drive forward, turn to the right, drive forward
+	AUTO_SEGMENT(4800, autoPriorityNormal),
+	{ AUTO_NONE, AUTO_MOVE(-127), AUTO_NONE, 1000 },
+	{ AUTO_NONE, AUTO_CMD(autoCmdLockDown), AUTO_NONE, 0 },
+	AUTO_STOP_ALL(50),
+	{ AUTO_DRIVE(0, 127), AUTO_NONE, AUTO_NONE, 400 },
+	AUTO_STOP_DRIVE(50),
+	{ AUTO_DRIVE(127, 0), AUTO_NONE, AUTO_NONE, 300 },
+	AUTO_STOP_DRIVE(50),
+	{ AUTO_DRIVE(0, 127), AUTO_NONE, AUTO_NONE, 2000 },
+	AUTO_STOP_DRIVE(50),
+	{ AUTO_NONE, AUTO_NONE, AUTO_CMD(autoCmdLockGrab), 500 },
+	{ AUTO_NONE, AUTO_MOVE(127), AUTO_NONE, 400 },
+
+	// Drive backward, turn left, backup & dump
+	AUTO_SEGMENT(3625, autoPriorityNormal),
+	{ AUTO_DRIVE(0, -127), AUTO_NONE, AUTO_NONE, 500 },
+	AUTO_STOP_DRIVE(25),
+	{ AUTO_DRIVE(-127, 0), AUTO_NONE, AUTO_NONE, 600 },
+	AUTO_STOP_DRIVE(25),
+	{ AUTO_DRIVE(0, -127), AUTO_NONE, AUTO_NONE, 1300 },
+	AUTO_STOP_DRIVE(25),
+	{ AUTO_NONE, AUTO_MOVE(127), AUTO_NONE, 800 },
+	{ AUTO_NONE, AUTO_MOVE(127), AUTO_MOVE(-127), 300 },
+	AUTO_STOP_ALL(50),
 };
 
-static void
-timerStart(unsigned long target)
-{
-	autotimer.actual = chTimeNow();
-	autotimer.target = autotimer.actual + target;
-}
-
-static bool
-timerActive(void)
-{
-	return (autotimer.actual < autotimer.target);
-}
-
-static void
-timerUpdate(void)
-{
-	vexSleep(25);
-	autotimer.actual = chTimeNow();
-}
-
-#define timerRun(TARGET, CODE)	\
-	do {	\
-		timerStart(TARGET);	\
-		while (timerActive()) {	\
-			CODE	\
-			timerUpdate();	\
-		}	\
-	} while (0)
-
-/* Reusable Routines */
-static void
-stopMovement(unsigned long target)
-{
-	timerRun(target, {
-		armMove(0, TRUE);
-		clawMove(0, TRUE);
-		driveMove(0, 0, TRUE);
-	});
-}
-
-static void
-stopDriveMovement(unsigned long target)
-{
-	timerRun(target, {
-		driveMove(0, 0, TRUE);
-	});
-}
-
-static void
-raiseArm(int speed)
-{
-	armMove(speed, TRUE);
-}
+static const autoStep_t autonomousSteps5[] = {
+	{ AUTO_DRIVE(0, -127), AUTO_NONE, AUTO_NONE, 500 },
+	AUTO_STOP_DRIVE(25),
+	{ AUTO_DRIVE(127, 0), AUTO_NONE, AUTO_NONE, 100 },
+	AUTO_STOP_DRIVE(25),
+
+	// unfold
+	{ AUTO_NONE, AUTO_MOVE(-127), AUTO_MOVE(0), 200 },
+	AUTO_STOP_ALL(50),
+	{ AUTO_NONE, AUTO_MOVE(127), AUTO_MOVE(0), 200 },
+	AUTO_STOP_ALL(50),
+	{ AUTO_NONE, AUTO_MOVE(-127), AUTO_MOVE(-127), 600 },
+	{ AUTO_NONE, AUTO_CMD(autoCmdLockDown), AUTO_MOVE(-127), 300 },
+	AUTO_STOP_ALL(50),
+	{ AUTO_DRIVE(0, 127), AUTO_NONE, AUTO_NONE, 800 },
+	AUTO_STOP_DRIVE(25),
+	{ AUTO_NONE, AUTO_NONE, AUTO_MOVE(127), 500 },
+	AUTO_STOP_ALL(50),
+	{ AUTO_DRIVE(0, -127), AUTO_NONE, AUTO_NONE, 2000 },
+	AUTO_STOP_DRIVE(25),
+	{ AUTO_NONE, AUTO_MOVE(127), AUTO_NONE, 700 },
+	{ AUTO_NONE, AUTO_MOVE(127), AUTO_MOVE(-127), 300 },
+	AUTO_STOP_ALL(25),
+};
 
-static void
-lowerArm(int speed)
-{
-	armMove(-speed, TRUE);
-}
+static const autoStep_t autonomousSteps6[] = {
+	// drive backwards
+	{ AUTO_DRIVE(0, 127), AUTO_NONE, AUTO_NONE, 1000 },
+	AUTO_STOP_DRIVE(50),
+
+	// unfold
+	{ AUTO_NONE, AUTO_MOVE(-127), AUTO_MOVE(0), 200 },
+	AUTO_STOP_ALL(50),
+	{ AUTO_NONE, AUTO_MOVE(127), AUTO_MOVE(0), 200 },
+	AUTO_STOP_ALL(50),
+	{ AUTO_NONE, AUTO_MOVE(-127), AUTO_MOVE(-127), 600 },
+	{ AUTO_NONE, AUTO_CMD(autoCmdLockDown), AUTO_MOVE(-127), 250 },
+	AUTO_STOP_ALL(50),
+};
 
-static void
-driveForward(int speed)
-{
-	driveMove(0, speed, TRUE);
-}
+// Grab the cube & three stars
+static const autoStep_t autonomousSteps7[] = {
+	// unfold
+	AUTO_STOP_DRIVE(50),
+	AUTO_STOP_ALL(50),
+	{ AUTO_NONE, AUTO_MOVE(-127), AUTO_NONE, 200 },
+	AUTO_STOP_ALL(50),
+	{ AUTO_NONE, AUTO_MOVE(127), AUTO_NONE, 300 },
+	AUTO_STOP_ALL(50),
+	{ AUTO_NONE, AUTO_MOVE(-127), AUTO_NONE, 650 },
+	AUTO_STOP_ALL(50),
+	{ AUTO_NONE, AUTO_CMD(autoCmdLockDown), AUTO_NONE, 250 },
+	AUTO_STOP_DRIVE(50),
+
+	// open claw, drive forward & close claw
+	{ AUTO_NONE, AUTO_NONE, AUTO_MOVE(-127), 500 },
+	AUTO_STOP_ALL(50),
+	{ AUTO_DRIVE(0, 127), AUTO_NONE, AUTO_NONE, 1100 },
+	AUTO_STOP_DRIVE(25),
+	{ AUTO_NONE, AUTO_NONE, AUTO_MOVE(127), 1000 },
+	{ AUTO_NONE, AUTO_NONE, AUTO_CMD(autoCmdLockGrab), 0 },
+
+	// raise arm & turn
+	{ AUTO_NONE, AUTO_CMD(autoCmdUnlock), AUTO_NONE, 0 },
+	{ AUTO_NONE, AUTO_MOVE(60), AUTO_NONE, 500 },
+	AUTO_STOP_ALL(50),
+	{ AUTO_DRIVE(127, 0), AUTO_NONE, AUTO_NONE, 500 },
+	AUTO_STOP_DRIVE(25),
+
+	// backup and dump
+	{ AUTO_DRIVE(0, -127), AUTO_NONE, AUTO_NONE, 1300 },
+	AUTO_STOP_DRIVE(50),
+	{ AUTO_NONE, AUTO_MOVE(127), AUTO_NONE, 1000 },
+	{ AUTO_NONE, AUTO_NONE, AUTO_MOVE(-127), 250 },
+	{ AUTO_NONE, AUTO_NONE, AUTO_CMD(autoCmdUnlock), 0 },
+	AUTO_STOP_ALL(25),
+
+	// lower arm, drive forward, turn to the right, drive forward
+	{ AUTO_NONE, AUTO_MOVE(-127), AUTO_NONE, 1000 },
+	{ AUTO_NONE, AUTO_CMD(autoCmdLockDown), AUTO_NONE, 0 },
+	AUTO_STOP_ALL(50),
+	{ AUTO_DRIVE(0, 127), AUTO_NONE, AUTO_NONE, 400 },
+	AUTO_STOP_DRIVE(50),
+	{ AUTO_DRIVE(127, 0), AUTO_NONE, AUTO_NONE, 300 },
+	AUTO_STOP_DRIVE(50),
+	{ AUTO_DRIVE(0, 127), AUTO_NONE, AUTO_NONE, 1800 },
+	AUTO_STOP_DRIVE(50),
+	{ AUTO_NONE, AUTO_NONE, AUTO_MOVE(127), 500 },
+
+	// Drive backward, turn left, backup & dump
+	{ AUTO_DRIVE(0, -127), AUTO_NONE, AUTO_NONE, 500 },
+	AUTO_STOP_DRIVE(25),
+	{ AUTO_DRIVE(-127, 0), AUTO_NONE, AUTO_NONE, 400 },
+	AUTO_STOP_DRIVE(25),
+	{ AUTO_DRIVE(0, -127), AUTO_NONE, AUTO_NONE, 1300 },
+	AUTO_STOP_DRIVE(25),
+	{ AUTO_NONE, AUTO_MOVE(127), AUTO_NONE, 800 },
+	{ AUTO_NONE, AUTO_MOVE(127), AUTO_MOVE(-127), 300 },
+	AUTO_STOP_ALL(50),
+};
 
-static void
-driveBackward(int speed)
-{
-	driveMove(0, -speed, TRUE);
-}
+static const autoStep_t autonomousSteps8[] = {
+	AUTO_STOP_ALL(50),
+	AUTO_STOP_DRIVE(50),
+	{ AUTO_NONE, AUTO_NONE, AUTO_MOVE(0), 0 },
+
+	// unfold
+	{ AUTO_NONE, AUTO_MOVE(-127), AUTO_MOVE(0), 200 },
+	AUTO_STOP_ALL(50),
+	{ AUTO_NONE, AUTO_MOVE(127), AUTO_MOVE(0), 200 },
+	AUTO_STOP_ALL(50),
+	{ AUTO_NONE, AUTO_MOVE(-127), AUTO_MOVE(0), 600 },
+	{ AUTO_NONE, AUTO_CMD(autoCmdLockDown), AUTO_NONE, 250 },
+	AUTO_STOP_ALL(50),
+
+	// drive forward and grab cube
+	{ AUTO_NONE, AUTO_CMD(autoCmdUnlock), AUTO_NONE, 0 },
+	{ AUTO_NONE, AUTO_MOVE(-127), AUTO_MOVE(-127), 1000 },
+	{ AUTO_DRIVE(0, 127), AUTO_NONE, AUTO_CMD(autoCmdLockOpen), 700 },
+	{ AUTO_NONE, AUTO_NONE, AUTO_CMD(autoCmdLockGrab), 100 },
+	AUTO_STOP_DRIVE(100),
+
+	// lift halfway, drive forward, and turn left
+	{ AUTO_NONE, AUTO_MOVE(60), AUTO_NONE, 300 },
+	AUTO_STOP_ALL(50),
+	{ AUTO_DRIVE(0, 127), AUTO_MOVE(10), AUTO_NONE, 200 },
+	AUTO_STOP_DRIVE(50),
+	{ AUTO_DRIVE(-127, 0), AUTO_NONE, AUTO_NONE, 400 },
+	AUTO_STOP_DRIVE(50),
+	AUTO_STOP_ALL(50),
+
+	// backup and dump
+	{ AUTO_DRIVE(0, -127), AUTO_NONE, AUTO_NONE, 1000 },
+	AUTO_STOP_DRIVE(50),
+	{ AUTO_NONE, AUTO_MOVE(127), AUTO_CMD(autoCmdLockOpen), 900 },
+	AUTO_STOP_ALL(50),
+
+	// lower arm & drive foreward & grab
+	{ AUTO_NONE, AUTO_MOVE(-127), AUTO_NONE, 1000 },
+	{ AUTO_NONE, AUTO_CMD(autoCmdLockDown), AUTO_NONE, 250 },
+	AUTO_STOP_ALL(50),
+	{ AUTO_DRIVE(0, 127), AUTO_NONE, AUTO_NONE, 800 },
+	AUTO_STOP_DRIVE(50),
+	AUTO_STOP_ALL(50),
+	{ AUTO_NONE, AUTO_NONE, AUTO_MOVE(-127), 400 },
+	{ AUTO_NONE, AUTO_NONE, AUTO_CMD(autoCmdLockGrab), 1200 },
+	{ AUTO_NONE, AUTO_CMD(autoCmdUnlock), AUTO_NONE, 0 },
+
+	// bump up Backup & dump
+	{ AUTO_NONE, AUTO_MOVE(127), AUTO_NONE, 200 },
+	{ AUTO_DRIVE(0, -127), AUTO_NONE, AUTO_NONE, 1100 },
+	{ AUTO_NONE, AUTO_MOVE(127), AUTO_NONE, 800 },
+	{ AUTO_NONE, AUTO_NONE, AUTO_CMD(autoCmdLockOpen), 100 },
+	{ AUTO_NONE, AUTO_MOVE(127), AUTO_NONE, 800 },
+};
 
-static void
-driveRight(int speed)
-{
-	driveMove(speed, 0, TRUE);
-}
+static const autoStep_t autonomousSteps9[] = {
+	AUTO_STOP_ALL(25),
+	AUTO_STOP_DRIVE(25),
+	{ AUTO_NONE, AUTO_NONE, AUTO_MOVE(0), 0 },
+	AUTO_STOP_ALL(75),
+
+	// unfold
+	{ AUTO_NONE, AUTO_MOVE(-127), AUTO_MOVE(0), 200 },
+	AUTO_STOP_ALL(50),
+	{ AUTO_NONE, AUTO_MOVE(127), AUTO_MOVE(0), 200 },
+	AUTO_STOP_ALL(50),
+	{ AUTO_NONE, AUTO_MOVE(-127), AUTO_MOVE(0), 600 },
+	{ AUTO_NONE, AUTO_CMD(autoCmdLockDown), AUTO_NONE, 250 },
+	AUTO_STOP_ALL(50),
+
+	// drive forward and grab cube
+	{ AUTO_NONE, AUTO_CMD(autoCmdUnlock), AUTO_NONE, 0 },
+	{ AUTO_NONE, AUTO_MOVE(-127), AUTO_MOVE(-127), 1000 },
+	{ AUTO_DRIVE(0, 127), AUTO_NONE, AUTO_CMD(autoCmdLockOpen), 900 },
+	AUTO_STOP_DRIVE(50),
+	{ AUTO_NONE, AUTO_NONE, AUTO_CMD(autoCmdLockGrab), 100 },
+	AUTO_STOP_DRIVE(100),
+
+	// lift halfway, drive forward, and turn
+	{ AUTO_NONE, AUTO_MOVE(60), AUTO_NONE, 300 },
+	AUTO_STOP_ALL(50),
+	{ AUTO_DRIVE(0, 127), AUTO_MOVE(10), AUTO_NONE, 300 },
+	AUTO_STOP_DRIVE(50),
+	{ AUTO_DRIVE(127, 0), AUTO_NONE, AUTO_NONE, 400 },
+	AUTO_STOP_DRIVE(50),
+	AUTO_STOP_ALL(50),
+
+	// backup and dump
+	{ AUTO_DRIVE(0, -127), AUTO_NONE, AUTO_NONE, 1200 },
+	AUTO_STOP_DRIVE(50),
+	{ AUTO_NONE, AUTO_MOVE(127), AUTO_CMD(autoCmdLockOpen), 900 },
+	AUTO_STOP_ALL(50),
+
+	// lower arm & drive foreward & grab
+	{ AUTO_NONE, AUTO_MOVE(-127), AUTO_NONE, 1000 },
+	{ AUTO_NONE, AUTO_CMD(autoCmdLockDown), AUTO_NONE, 250 },
+	AUTO_STOP_ALL(50),
+	{ AUTO_DRIVE(0, 127), AUTO_NONE, AUTO_NONE, 1000 },
+	AUTO_STOP_DRIVE(50),
+	AUTO_STOP_ALL(50),
+	{ AUTO_NONE, AUTO_NONE, AUTO_MOVE(-127), 400 },
+	{ AUTO_NONE, AUTO_NONE, AUTO_CMD(autoCmdLockGrab), 1000 },
+	{ AUTO_NONE, AUTO_CMD(autoCmdUnlock), AUTO_NONE, 0 },
+
+	// bump up Backup & dump
+	{ AUTO_NONE, AUTO_MOVE(127), AUTO_NONE, 200 },
+	{ AUTO_DRIVE(0, -127), AUTO_NONE, AUTO_NONE, 1200 },
+	{ AUTO_NONE, AUTO_MOVE(127), AUTO_MOVE(-100), 800 },
+
+	// timerRun(800, {
+
+	// raiseArm(127);
+
+	// openClaw(100);
+
+	// });
+};
 
-static void
-driveLeft(int speed)
-{
-	driveMove(-speed, 0, TRUE);
-}
+// indexed by the lcd mode
+static const autoRoutine_t autonomousRoutines[kLcdModeNumber] = {
+	AUTO_ROUTINE(autonomousSteps0),
+	AUTO_ROUTINE(autonomousSteps1),
+	{ NULL, 0 },
+	{ NULL, 0 },
+	{ NULL, 0 },
+	AUTO_ROUTINE(autonomousSteps5),
+	AUTO_ROUTINE(autonomousSteps6),
+	AUTO_ROUTINE(autonomousSteps7),
+	AUTO_ROUTINE(autonomousSteps8),
+	AUTO_ROUTINE(autonomousSteps9),
+};
 
-static void
-grabClaw(int speed)
-{
-	clawMove(speed, TRUE);
-}
+// modes with a compiled trajectory play it instead of a step routine, none
+// yet, include trajectories.h and put the table here to bind a mode to one
+static const trajectory_t *autonomousTrajectories[kLcdModeNumber] = {
+	NULL,
+	NULL,
+	NULL,
+	NULL,
+	NULL,
+	NULL,
+	NULL,
+	NULL,
+	NULL,
+	NULL,
+};
 
+/*-----------------------------------------------------------------------------*/
+/** @brief      Replay the last recorded driver control run                    */
+/*-----------------------------------------------------------------------------*/
+/** @details
+ *  The drive, arm and claw tasks follow the joysticks when locked, the
+ *  recorder feeds them the recorded joystick data one SPI packet at a time.
+ *  Like autoSeqRun the replay is cut off AUTOSEQ_SAFE_MARGIN before the end
+ *  of the period with the drive stopped and the arm and claw locked.
+ */
 static void
-openClaw(int speed)
-{
-	clawMove(-speed, TRUE);
-}
-
-
-void
-autonomousMode0(void)
-
-// Grab the cube & three stars,
-
-{
-	armUnlock();
-	clawUnlock();
-	driveUnlock();
-
-	driveForward(0);
-
-		// unfold
-	{
-		stopDriveMovement(50);
-
-		timerRun(200, {
-			lowerArm(127);
-		});
-
-		stopMovement(50);
-
-		timerRun(300, {
-			raiseArm(127);
-		});
-
-		stopMovement(50);
-
-		timerRun(650, {
-			lowerArm(127);
-		});
-
-		stopMovement(50);
-
-		timerRun(250, {
-			lowerArm(127);
-			armLockDown();
-		});
-
-		stopDriveMovement(50);
-	}
-		// open claw, drive forward & close claw
-	{
-		timerRun(500, {
-			openClaw(127);
-		});
-
-		stopMovement(50);
-
-		timerRun(1500,{
-			driveForward(127);
-		});
-
-		stopDriveMovement(25);
-
-		timerRun(1000, {
-			grabClaw(127);
-		});
-
-		clawLockGrab();
-	}
-		// raise arm & turn
-	{
-		armUnlock();
-
-		timerRun(500, {
-			raiseArm(60);
-		});
-
-		stopMovement(50);
-
-		timerRun(500, {
-			driveRight(127);
-		});
-
-		stopDriveMovement(25);
-	}
-		// backup and dump
-	{
-		timerRun(1300, {
-			driveBackward(127);
-		});
-
-		stopDriveMovement(50);
-
-		timerRun(1000, {
-			raiseArm(127);
-		});
-
-		timerRun(250, {
-			openClaw(127);
-		});
-
-		clawUnlock();
-
-		stopMovement(25);
-
-	}
-		// lower arm, drive forward, turn to the right, drive forward
-	{
-		timerRun(1000, {
-			lowerArm(127);
-		});
-
-		armLockDown();
-
-		stopMovement(50);
-
-		timerRun(400, {
-			driveForward(127);
-		});
-
-		stopDriveMovement(50);
-
-		timerRun(300, {
-			driveRight(127);
-		});
-
-		stopDriveMovement(50);
-
-		timerRun(2000, {
-			driveForward(127);
-		});
-
-		stopDriveMovement(50);
-
-		timerRun(500, {
-			grabClaw(127);
-		});
-
-	}
-		// Drive backward, turn left, backup & dump
-	{
-		timerRun(500, {
-			driveBackward(127);
-		});
-
-		stopDriveMovement(25);
-
-		timerRun(400, {
-			driveLeft(127);
-		});
-
-		stopDriveMovement(25);
-
-		timerRun(1000, {
-			driveBackward(127);
-		});
-
-		stopDriveMovement(25);
-
-		timerRun(800, {
-			raiseArm(127);
-		});
-
-		timerRun(300, {
-			raiseArm(127);
-			openClaw(127);
-		});
-
-		stopMovement(50);
-	}
-		// lower arm, drive forward & grab cube
-	{
-		timerRun(1000, {
-			lowerArm(127);
-			armLockDown();
-		});
-
-		timerRun(1100, {
-			driveForward(127);
-		});
-
-		stopDriveMovement(25);
-
-		timerRun(500, {
-			grabClaw(127);
-		});
-
-		stopMovement(50);
-
-		timerRun(1100, {
-			driveBackward(127);
-		});
-
-		stopDriveMovement(50);
-
-		timerRun(800, {
-			raiseArm(127);
-		});
-
-		timerRun(300, {
-			raiseArm(127);
-			openClaw(127);
-		});
-
-		stopMovement(25);
-	}
-		// lower arm, drive forward & grab cube
-	{
-		timerRun(1000, {
-			lowerArm(127);
-			armLockDown();
-		});
-
-		timerRun(1100, {
-			driveForward(127);
-		});
-
-		stopDriveMovement(25);
-
-		timerRun(500, {
-			grabClaw(127);
-		});
-
-		stopMovement(50);
-
-		timerRun(1100, {
-			driveBackward(127);
-		});
-
-		stopDriveMovement(50);
-
-		timerRun(800, {
-			raiseArm(127);
-		});
-
-		timerRun(300, {
-			raiseArm(127);
-			openClaw(127);
-		});
-
-		stopMovement(25);
-	}
-
-	return;
-}
-
-void
-autonomousMode1(void)
-{
-
-	armUnlock();
-	clawUnlock();
-	driveUnlock();
-
-	clawUnlock();
-	stopMovement(25);
-	stopDriveMovement(25);
-
-	grabClaw(0);
-	openClaw(0);
-
-	stopMovement(75);
-
-		// unfold
-	{
-		timerRun(200, {
-			lowerArm(127);
-			openClaw(0);
-		});
-
-		stopMovement(50);
-
-		timerRun(200, {
-			raiseArm(127);
-			openClaw(0);
-		});
-
-		stopMovement(50);
-
-		timerRun(600, {
-			lowerArm(127);
-			openClaw(0);
-		});
-
-		timerRun(250, {
-			lowerArm(127);
-			armLockDown();
-		});
-
-		stopMovement(50);
-	}
-		// drive forward and grab cube
-	{
-		armUnlock();
-
-		timerRun(1000, {
-			lowerArm(127);
-			openClaw(127);
-		});
-
-		clawLockOpen();
-
-		timerRun(700, {
-			driveForward(127);
-		});
-
-		timerRun(100, {
-			clawLockGrab();
-		});
-
-		stopDriveMovement(100);
-	}
-		// lift halfway, drive forward, and turn right
-	{
-		timerRun(300, {
-			raiseArm(60);
-		});
-
-		stopMovement(50);
-		raiseArm(10);
-
-		timerRun(300, {
-			driveForward(127);
-		});
-
-		stopDriveMovement(50);
-
-		timerRun(400, {
-			driveRight(127);
-		});
-
-		stopDriveMovement(50);
-		stopMovement(50);
-	}
-		// backup and dump
-	{
-		timerRun(1200, {
-			driveBackward(127);
-		});
-
-		stopDriveMovement(50);
-
-		timerRun(900, {
-			raiseArm(127);
-			clawLockOpen();
-		});
-
-		stopMovement(50);
-	}
-		// lower arm, drive forward, turn to the right, drive forward
-	{
-		timerRun(1000, {
-			lowerArm(127);
-		});
-
-		armLockDown();
-
-		stopMovement(50);
-
-		timerRun(400, {
-			driveForward(127);
-		});
-
-		stopDriveMovement(50);
-
-		timerRun(300, {
-			driveRight(127);
-		});
-
-		stopDriveMovement(50);
-
-		timerRun(2000, {
-			driveForward(127);
-		});
-
-		stopDriveMovement(50);
-
-		timerRun(500, {
-			grabClaw(127);
-			clawLockGrab();
-		});
-
-		timerRun(400, {
-			raiseArm(127);
-		});
-
-	}
-		// Drive backward, turn left, backup & dump
-	{
-		timerRun(500, {
-			driveBackward(127);
-		});
-
-		stopDriveMovement(25);
-
-		timerRun(600, {
-			driveLeft(127);
-		});
-
-		stopDriveMovement(25);
-
-		timerRun(1300, {
-			driveBackward(127);
-		});
-
-		stopDriveMovement(25);
-
-		timerRun(800, {
-			raiseArm(127);
-		});
-
-		timerRun(300, {
-			raiseArm(127);
-			openClaw(127);
-		});
-
-		stopMovement(50);
-	}
-
-
-	return;
-}
-
-void
-autonomousMode2(void)
-{
-	armUnlock();
-	clawUnlock();
-	driveUnlock();
-
-	return;
-}
-
-void
-autonomousMode3(void)
-{
-	armUnlock();
-	clawUnlock();
-	driveUnlock();
-
-	return;
-}
-
-void
-autonomousMode4(void)
-{
-	armUnlock();
-	clawUnlock();
-	driveUnlock();
-
-	return;
-}
-
-void
-autonomousMode5(void)
+autonomousReplay(void)
 {
-	armUnlock();
-	clawUnlock();
-	driveUnlock();
-
-	timerRun(500, {
-		driveBackward(127);
-	});
-
-	stopDriveMovement(25);
-
-	timerRun(100, {
-		driveRight(127);
-	});
-
-	stopDriveMovement(25);
-
-	//unfold
-	{
-		timerRun(200, {
-			lowerArm(127);
-			openClaw(0);
-		});
-
-		stopMovement(50);
+	systime_t	end;
+	bool_t		windowClosed = FALSE;
 
-		timerRun(200, {
-			raiseArm(127);
-			openClaw(0);
-		});
+	end = autoSeqMatchEnd();
+	if (!vexReplayStart())
+		return;
 
-		stopMovement(50);
+	armLockCurrent();
+	clawLockCurrent();
+	driveLock();
 
-		timerRun(600, {
-			lowerArm(127);
-			openClaw(127);
-		});
-
-		timerRun(300, {
-			lowerArm(127);
-			armLockDown();
-			openClaw(127);
-		});
-
-		stopMovement(50);
+	while (vexRecordStateGet() == kVexRecordReplaying) {
+		if ((int32_t)(end - chTimeNow()) <= 0) {
+			windowClosed = TRUE;
+			break;
+		}
+		vexSleep(25);
 	}
 
-	timerRun(800 , {
-		driveForward(127);
-	});
-
-	stopDriveMovement(25);
-
-	timerRun(500, {
-		grabClaw(127);
-	});
-
-	stopMovement(50);
-{
-	timerRun(2000, {
-		driveBackward(127);
-	});
-
-	stopDriveMovement(25);
-
-	timerRun(700, {
-		raiseArm(127);
-	});
-
-	timerRun(300, {
-		raiseArm(127);
-		openClaw(127);
-	});
-
-	stopMovement(25);
-}
-	return;
-}
-
-void
-autonomousMode6(void)
-{
-	armUnlock();
-	clawUnlock();
-	driveUnlock();
-
-	//drive backwards
-
-	timerRun(1000, {
-		driveForward(127);
-	});
-
-	stopDriveMovement(50);
-
-	//unfold
-	{
-		timerRun(200, {
-			lowerArm(127);
-			openClaw(0);
-		});
-
-		stopMovement(50);
-
-		timerRun(200, {
-			raiseArm(127);
-			openClaw(0);
-		});
-
-		stopMovement(50);
-
-		timerRun(600, {
-			lowerArm(127);
-			openClaw(127);
-		});
-
-		timerRun(250, {
-			lowerArm(127);
-			armLockDown();
-			openClaw(127);
-		});
-
-		stopMovement(50);
-	}
-
-
-	return;
-}
-
-void
-autonomousMode7(void)
-
-// Grab the cube & three stars,
-
-{
-	armUnlock();
-	clawUnlock();
+	vexReplayStop();
 	driveUnlock();
-
-		// unfold
-	{
-		stopDriveMovement(50);
-
-		stopMovement(50);
-
-		timerRun(200, {
-			lowerArm(127);
-		});
-
-		stopMovement(50);
-
-		timerRun(300, {
-			raiseArm(127);
-		});
-
-		stopMovement(50);
-
-		timerRun(650, {
-			lowerArm(127);
-		});
-
-		stopMovement(50);
-
-		timerRun(250, {
-			lowerArm(127);
-			armLockDown();
-		});
-
-		stopDriveMovement(50);
-	}
-		// open claw, drive forward & close claw
-	{
-		timerRun(500, {
-			openClaw(127);
-		});
-
-		stopMovement(50);
-
-		timerRun(1100,{
-			driveForward(127);
-		});
-
-		stopDriveMovement(25);
-
-		timerRun(1000, {
-			grabClaw(127);
-		});
-
-		clawLockGrab();
-	}
-		// raise arm & turn
-	{
+	driveMove(0, 0, TRUE);
+	if (windowClosed) {
+		armLockCurrent();
+		clawLockCurrent();
+	} else {
 		armUnlock();
-
-		timerRun(500, {
-			raiseArm(60);
-		});
-
-		stopMovement(50);
-
-		timerRun(500, {
-			driveRight(127);
-		});
-
-		stopDriveMovement(25);
-	}
-		// backup and dump
-	{
-		timerRun(1300, {
-			driveBackward(127);
-		});
-
-		stopDriveMovement(50);
-
-		timerRun(1000, {
-			raiseArm(127);
-		});
-
-		timerRun(250, {
-			openClaw(127);
-		});
-
 		clawUnlock();
-
-		stopMovement(25);
-
 	}
-		// lower arm, drive forward, turn to the right, drive forward
-	{
-		timerRun(1000, {
-			lowerArm(127);
-		});
-
-		armLockDown();
-
-		stopMovement(50);
-
-		timerRun(400, {
-			driveForward(127);
-		});
-
-		stopDriveMovement(50);
-
-		timerRun(300, {
-			driveRight(127);
-		});
-
-		stopDriveMovement(50);
-
-		timerRun(1800, {
-			driveForward(127);
-		});
-
-		stopDriveMovement(50);
-
-		timerRun(500, {
-			grabClaw(127);
-		});
-
-	}
-		// Drive backward, turn left, backup & dump
-	{
-		timerRun(500, {
-			driveBackward(127);
-		});
-
-		stopDriveMovement(25);
-
-		timerRun(400, {
-			driveLeft(127);
-		});
-
-		stopDriveMovement(25);
-
-		timerRun(1300, {
-			driveBackward(127);
-		});
-
-		stopDriveMovement(25);
-
-		timerRun(800, {
-			raiseArm(127);
-		});
-
-		timerRun(300, {
-			raiseArm(127);
-			openClaw(127);
-		});
-
-		stopMovement(50);
-	}
-
 	return;
 }
 
+/*-----------------------------------------------------------------------------*/
+/** @brief      Run the autonomous routine for a mode                          */
+/** @param[in]  mode The lcd mode selected before the match                    */
+/*-----------------------------------------------------------------------------*/
 void
-autonomousMode8(void)
+autonomousRun(kLcdModeType mode)
 {
-
-	armUnlock();
-	clawUnlock();
-	driveUnlock();
-
-	clawUnlock();
-	stopMovement(50);
-	stopDriveMovement(50);
-
-	grabClaw(0);
-	openClaw(0);
-
-		// unfold
-	{
-		timerRun(200, {
-			lowerArm(127);
-			openClaw(0);
-		});
-
-		stopMovement(50);
-
-		timerRun(200, {
-			raiseArm(127);
-			openClaw(0);
-		});
-
-		stopMovement(50);
-
-		timerRun(600, {
-			lowerArm(127);
-			openClaw(0);
-		});
-
-		timerRun(250, {
-			lowerArm(127);
-			armLockDown();
-		});
-
-		stopMovement(50);
-	}
-		// drive forward and grab cube
-	{
-		armUnlock();
-
-		timerRun(1000, {
-			lowerArm(127);
-			openClaw(127);
-		});
-
-		clawLockOpen();
-
-		timerRun(700, {
-			driveForward(127);
-		});
-
-		timerRun(100, {
-			clawLockGrab();
-		});
-
-		stopDriveMovement(100);
-	}
-		// lift halfway, drive forward, and turn left
-	{
-		timerRun(300, {
-			raiseArm(60);
-		});
-
-		stopMovement(50);
-		raiseArm(10);
-
-		timerRun(200, {
-			driveForward(127);
-		});
-
-		stopDriveMovement(50);
-
-		timerRun(400, {
-			driveLeft(127);
-		});
-
-		stopDriveMovement(50);
-		stopMovement(50);
-	}
-		// backup and dump
-	{
-		timerRun(1000, {
-			driveBackward(127);
-		});
-
-		stopDriveMovement(50);
-
-		timerRun(900, {
-			raiseArm(127);
-			clawLockOpen();
-		});
-
-		stopMovement(50);
-	}
-		// lower arm & drive foreward & grab
-	{
-		timerRun(1000, {
-			lowerArm(127);
-		});
-
-		timerRun(250, {
-			lowerArm(127);
-			armLockDown();
-		});
-
-		stopMovement(50);
-
-		timerRun(800, {
-			driveForward(127);
-		});
-
-		stopDriveMovement(50);
-		stopMovement(50);
-
-		timerRun(400, {
-			openClaw(127);
-		});
-
-		timerRun(1200, {
-			grabClaw(127);
-			clawLockGrab();
-		});
-
-		armUnlock();
-	}
-		// bump up Backup & dump
-	{
-
-		timerRun(200, {
-			raiseArm(127);
-		});
-
-		timerRun(1100, {
-			driveBackward(127);
-		});
-
-		timerRun(800, {
-			raiseArm(127);
-		});
-
-		timerRun(100,{
-			clawLockOpen();
-		});
-
-		timerRun(800, {
-			raiseArm(127);
-		});
-
-	}
+	if (mode < kLcdMode0 || mode >= kLcdModeNumber)
+		return;
+
+	if (mode == AUTONOMOUS_REPLAY_MODE)
+		autonomousReplay();
+	else if (autonomousTrajectories[mode] != NULL)
+		trajPlay(autonomousTrajectories[mode]);
+	else
+		autoSeqRun(&autonomousRoutines[mode]);
 	return;
 }
-
-void
-autonomousMode9(void)
-{
-
-	armUnlock();
-	clawUnlock();
-	driveUnlock();
-
-	clawUnlock();
-	stopMovement(25);
-	stopDriveMovement(25);
-
-	grabClaw(0);
-	openClaw(0);
-
-	stopMovement(75);
-
-		// unfold
-	{
-		timerRun(200, {
-			lowerArm(127);
-			openClaw(0);
-		});
-
-		stopMovement(50);
-
-		timerRun(200, {
-			raiseArm(127);
-			openClaw(0);
-		});
-
-		stopMovement(50);
-
-		timerRun(600, {
-			lowerArm(127);
-			openClaw(0);
-		});
-
-		timerRun(250, {
-			lowerArm(127);
-			armLockDown();
-		});
-
-		stopMovement(50);
-	}
-		// drive forward and grab cube
-	{
-		armUnlock();
-
-		timerRun(1000, {
-			lowerArm(127);
-			openClaw(127);
-		});
-
-		clawLockOpen();
-
-		timerRun(900, {
-			driveForward(127);
-		});
-
-		stopDriveMovement(50);
-
-		timerRun(100, {
-			clawLockGrab();
-		});
-
-		stopDriveMovement(100);
-	}
-		// lift halfway, drive forward, and turn
-	{right
-		timerRun(300, {
-			raiseArm(60);
-		});
-
-		stopMovement(50);
-		raiseArm(10);
-
-		timerRun(300, {
-			driveForward(127);
-		});
-
-		stopDriveMovement(50);
-
-		timerRun(400, {
-			driveRight(127);
-		});
-
-		stopDriveMovement(50);
-		stopMovement(50);
-	}
-		// backup and dump
-	{
-		timerRun(1200, {
-			driveBackward(127);
-		});
-
-		stopDriveMovement(50);
-
-		timerRun(900, {
-			raiseArm(127);
-			clawLockOpen();
-		});
-
-		stopMovement(50);
-	}
-		// lower arm & drive foreward & grab
-	{
-		timerRun(1000, {
-			lowerArm(127);
-		});
-
-		timerRun(250, {
-			lowerArm(127);
-			armLockDown();
-		});
-
-		stopMovement(50);
-
-		timerRun(1000, {
-			driveForward(127);
-		});
-
-		stopDriveMovement(50);
-		stopMovement(50);
-
-		timerRun(400, {
-			openClaw(127);
-		});
-
-		timerRun(1000, {
-			grabClaw(127);
-			clawLockGrab();
-		});
-
-		armUnlock();
-	}
-		// bump up Backup & dump
-	{
-
-		timerRun(200, {
-			raiseArm(127);
-		});
-
-		timerRun(1200, {
-			driveBackward(127);
-		});
-
-		timerRun(800, {
-			raiseArm(127);
-			openClaw(100);
-		});
-
-		// timerRun(800, {
-		// 	raiseArm(127);
-		// 	openClaw(100);
-		// });
-
-	}
-	return;
-}
\ No newline at end of file
@@ -0,0 +1,368 @@
+/*-----------------------------------------------------------------------------*/
+/** @file    autoseq.c                                                         */
+/** @brief   Runs autonomous routines described as step tables                 */
+/*-----------------------------------------------------------------------------*/
+
+#include "autoseq.h"
+#include "odometry.h"
+
+#include <stdlib.h>
+
+// storage for the sequencer
+static autoseq_t autoseq;
+
+// track bits for the pending mask
+#define AUTOSEQ_DRIVE	0x01
+#define AUTOSEQ_ARM		0x02
+#define AUTOSEQ_CLAW	0x04
+
+#define AUTOSEQ_ALL		(AUTOSEQ_DRIVE | AUTOSEQ_ARM | AUTOSEQ_CLAW)
+
+// private functions
+static void		autoSeqStep(const autoStep_t *step, systime_t limit);
+static void		autoSeqFinish(uint8_t tracks);
+static int32_t	autoSeqDriveDistance(int32_t start);
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Get pointer to sequencer structure - not used locally          */
+/** @return     A autoseq_t pointer                                            */
+/*-----------------------------------------------------------------------------*/
+autoseq_t *
+autoSeqGetPtr(void)
+{
+	return (&autoseq);
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Mark the start of the autonomous period                        */
+/*-----------------------------------------------------------------------------*/
+/** @details
+ *  Call first thing in vexAutonomous so time spent before the routine
+ *  starts is counted against the period.
+ */
+void
+autoSeqMatchStart(void)
+{
+	autoseq.matchStarted = chTimeNow();
+	autoseq.matchValid = TRUE;
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      When an autonomous routine has to stop                         */
+/** @return     AUTOSEQ_SAFE_MARGIN before the end of the period               */
+/*-----------------------------------------------------------------------------*/
+/** @details
+ *  The period is timed from now if autoSeqMatchStart was not called.
+ */
+systime_t
+autoSeqMatchEnd(void)
+{
+	return ((autoseq.matchValid ? autoseq.matchStarted : chTimeNow()) +
+			MS2ST(AUTOSEQ_MATCH_TIME - AUTOSEQ_SAFE_MARGIN));
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Index of the next segment marker after step i                  */
+/*-----------------------------------------------------------------------------*/
+static int16_t
+autoSeqNextSegment(const autoRoutine_t *routine, int16_t i)
+{
+	for (i++; i < routine->count; i++) {
+		if (routine->steps[i].drive.cmd == autoCmdSegment)
+			break;
+	}
+	return (i);
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Decide how a segment runs                                      */
+/** @param[in]  routine The routine                                            */
+/** @param[in]  i Index of the segment marker                                  */
+/** @param[in]  end When the routine has to stop                               */
+/** @param[out] limit When the segment has to stop                             */
+/** @return     FALSE if the segment should be skipped                         */
+/*-----------------------------------------------------------------------------*/
+static bool_t
+autoSeqSegment(const autoRoutine_t *routine, int16_t i, systime_t end, systime_t *limit)
+{
+	const autoStep_t	*marker = &routine->steps[i];
+	int32_t		remaining, reserved = 0;
+	int16_t		j;
+
+	// time later segments that matter more than this one will need
+	for (j = autoSeqNextSegment(routine, i); j < routine->count; j = autoSeqNextSegment(routine, j)) {
+		if (routine->steps[j].drive.priority > marker->drive.priority)
+			reserved += routine->steps[j].timeout;
+	}
+
+	remaining = (int32_t)(end - chTimeNow()) - (int32_t)MS2ST(reserved);
+	if (remaining >= (int32_t)MS2ST(marker->timeout)) {
+		*limit = chTimeNow() + remaining;
+		return (TRUE);
+	}
+
+	if (marker->drive.priority >= autoPriorityHigh && remaining > 0) {
+		*limit = chTimeNow() + remaining;
+		autoseq.shortened++;
+		return (TRUE);
+	}
+
+	autoseq.skipped++;
+	return (FALSE);
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Run an autonomous routine to completion                        */
+/** @param[in]  routine The routine to run                                     */
+/*-----------------------------------------------------------------------------*/
+/** @details
+ *  Runs in the calling thread, the autonomous task is the scheduler. Uses
+ *  vexSleep so the routine is stopped when autonomous ends. The routine is
+ *  stopped AUTOSEQ_SAFE_MARGIN before the end of the period with the drive
+ *  stopped and the arm and claw locked where they are.
+ */
+void
+autoSeqRun(const autoRoutine_t *routine)
+{
+	systime_t	end, limit;
+	int16_t		i;
+
+	autoseq.routine = routine;
+	autoseq.started = chTimeNow();
+	autoseq.timeouts = 0;
+	autoseq.lastTimeout = -1;
+	autoseq.segment = -1;
+	autoseq.skipped = 0;
+	autoseq.shortened = 0;
+	autoseq.windowClosed = FALSE;
+
+	end = autoSeqMatchEnd();
+	limit = end;
+
+	armUnlock();
+	clawUnlock();
+	driveUnlock();
+
+	for (i = 0; i < routine->count; i++) {
+		if ((int32_t)(end - chTimeNow()) <= 0) {
+			autoseq.windowClosed = TRUE;
+			break;
+		}
+
+		if (routine->steps[i].drive.cmd == autoCmdSegment) {
+			autoseq.segment = i;
+			if (!autoSeqSegment(routine, i, end, &limit)) {
+				// nothing left running while the segment is skipped
+				autoSeqFinish(AUTOSEQ_ALL);
+				i = autoSeqNextSegment(routine, i) - 1;
+			}
+			continue;
+		}
+
+		autoseq.step = i;
+		autoseq.stepStarted = chTimeNow();
+		autoSeqStep(&routine->steps[i], limit);
+	}
+
+	if ((int32_t)(end - chTimeNow()) <= 0)
+		autoseq.windowClosed = TRUE;
+	if (autoseq.windowClosed)
+		autoSeqFinish(AUTOSEQ_ALL);
+
+	return;
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Distance travelled by the drive in encoder ticks               */
+/** @param[in]  start The odometry count at the start of the step            */
+/*-----------------------------------------------------------------------------*/
+static int32_t
+autoSeqDriveDistance(int32_t start)
+{
+	odometryPose_t	pose;
+
+	odometryGet(&pose);
+	return (abs(pose.count - start));
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Check a pot condition                                          */
+/*-----------------------------------------------------------------------------*/
+static bool_t
+autoSeqReached(const autoAction_t *a, int32_t value)
+{
+	if (a->until == autoUntilAbove)
+		return (value >= a->target);
+	if (a->until == autoUntilBelow)
+		return (value <= a->target);
+	return (FALSE);
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Start the drive track                                          */
+/*-----------------------------------------------------------------------------*/
+static void
+autoSeqDriveStart(const autoAction_t *a)
+{
+	switch (a->cmd) {
+		case autoCmdMove:
+			driveMove(a->x, a->y, TRUE);
+			break;
+		case autoCmdUnlock:
+			driveUnlock();
+			break;
+		case autoCmdLockCurrent:
+			driveLock();
+			break;
+		default:
+			break;
+	}
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Start the arm track                                            */
+/*-----------------------------------------------------------------------------*/
+static void
+autoSeqArmStart(const autoAction_t *a)
+{
+	switch (a->cmd) {
+		case autoCmdMove:
+			// a stop leaves a lock alone, anything else takes the arm off it
+			if (a->x != 0)
+				armUnlock();
+			armMove(a->x, TRUE);
+			break;
+		case autoCmdUnlock:
+			armUnlock();
+			break;
+		case autoCmdLockCurrent:
+			armLockCurrent();
+			break;
+		case autoCmdLockDown:
+			armLockDown();
+			break;
+		case autoCmdLockBump:
+			armLockBump();
+			break;
+		case autoCmdLockUp:
+			armLockUp();
+			break;
+		default:
+			break;
+	}
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Start the claw track                                           */
+/*-----------------------------------------------------------------------------*/
+static void
+autoSeqClawStart(const autoAction_t *a)
+{
+	switch (a->cmd) {
+		case autoCmdMove:
+			if (a->x != 0)
+				clawUnlock();
+			clawMove(a->x, TRUE);
+			break;
+		case autoCmdUnlock:
+			clawUnlock();
+			break;
+		case autoCmdLockCurrent:
+			clawLockCurrent();
+			break;
+		case autoCmdLockGrab:
+			clawLockGrab();
+			break;
+		case autoCmdLockOpen:
+			clawLockOpen();
+			break;
+		default:
+			break;
+	}
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Stop tracks that are done, drive stops, arm and claw hold      */
+/*-----------------------------------------------------------------------------*/
+static void
+autoSeqFinish(uint8_t tracks)
+{
+	if (tracks & AUTOSEQ_DRIVE)
+		driveMove(0, 0, TRUE);
+	if (tracks & AUTOSEQ_ARM)
+		armLockCurrent();
+	if (tracks & AUTOSEQ_CLAW)
+		clawLockCurrent();
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Run one step                                                   */
+/** @param[in]  step The step                                                  */
+/** @param[in]  limit The step ends here even if the timeout is later          */
+/*-----------------------------------------------------------------------------*/
+static void
+autoSeqStep(const autoStep_t *step, systime_t limit)
+{
+	systime_t	deadline;
+	int32_t		remaining;
+	odometryPose_t	pose;
+	uint8_t		pending = 0;
+	uint8_t		done;
+
+	deadline = chTimeNow() + MS2ST(step->timeout);
+	if ((int32_t)(deadline - limit) > 0)
+		deadline = limit;
+	odometryGet(&pose);
+
+	autoSeqDriveStart(&step->drive);
+	autoSeqArmStart(&step->arm);
+	autoSeqClawStart(&step->claw);
+
+	if (step->drive.until != autoUntilNone)
+		pending |= AUTOSEQ_DRIVE;
+	if (step->arm.until != autoUntilNone)
+		pending |= AUTOSEQ_ARM;
+	if (step->claw.until != autoUntilNone)
+		pending |= AUTOSEQ_CLAW;
+
+	// no conditions is a timed step, one sleep to the deadline
+	while (1) {
+		if (pending) {
+			done = 0;
+			if ((pending & AUTOSEQ_DRIVE) &&
+				autoSeqDriveDistance(pose.count) >= step->drive.target)
+				done |= AUTOSEQ_DRIVE;
+			if ((pending & AUTOSEQ_ARM) &&
+				autoSeqReached(&step->arm, armGetPosition()))
+				done |= AUTOSEQ_ARM;
+			if ((pending & AUTOSEQ_CLAW) &&
+				autoSeqReached(&step->claw, vexBoardAnalogGet(clawGetPtr()->potentiometer)))
+				done |= AUTOSEQ_CLAW;
+
+			if (done) {
+				autoSeqFinish(done);
+				pending &= ~done;
+				if (!pending)
+					return;
+			}
+		}
+
+		remaining = (int32_t)(deadline - chTimeNow());
+		if (remaining <= 0)
+			break;
+
+		if (pending && remaining > (int32_t)MS2ST(AUTOSEQ_POLL))
+			remaining = MS2ST(AUTOSEQ_POLL);
+		// vexSleep takes mS, round up so we never wake just short of the deadline
+		vexSleep((remaining * 1000 + CH_FREQUENCY - 1) / CH_FREQUENCY);
+	}
+
+	// timed out with tracks still running
+	if (pending) {
+		autoSeqFinish(pending);
+		autoseq.timeouts++;
+		autoseq.lastTimeout = autoseq.step;
+	}
+
+	return;
+}
@@ -21,7 +21,7 @@ autotuneInit(autotuner_t *t, float input, float output, bool_t reversed)
 	t->running = FALSE;
 	t->oStep = 30;
 	autotuneSetLookbackSec(t, 10);
-	t->lastTime = chTimeNow();
+	t->lastTime = vexTimeUs();
 }
 
 void
@@ -41,9 +41,10 @@ autotuneRuntime(autotuner_t *t)
 		autotuneFinishUp(t);
 		return 1;
 	}
-	unsigned long now = chTimeNow();
+	uint32_t now = vexTimeUs();
 
-	if (now >= (t->lastTime + t->sampleTime))
+	// peaks are timed in uS, the tick would add 1mS of error to each one
+	if ((uint32_t)(now - t->lastTime) < (uint32_t)t->sampleTime * 1000)
 		return 0;
 	t->lastTime = now;
 	float refVal = t->input;
@@ -138,7 +139,7 @@ autotuneFinishUp(autotuner_t *t)
 	t->output = t->outputStart;
 	// we can generate tuning parameters!
 	t->Ku = 4 * (2 * t->oStep) / ((t->absMax - t->absMin) * 3.14159);
-	t->Pu = (float)(t->peak1 - t->peak2) / 1000;
+	t->Pu = (float)(uint32_t)(t->peak1 - t->peak2) / 1000000;
 
 	return;
 }
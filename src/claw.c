@@ -11,11 +11,32 @@
 // storage for claw
 static claw_t claw;
 
-// working area for claw task
-static WORKING_AREA(waClaw, 512);
+// claw control loop, run by the scheduler
+static vexSchedTask clawSched;
+
+// commands from other tasks, only the scheduler thread touches the locks
+typedef enum {
+	clawCommandLock = 0,
+	clawCommandUnlock,
+	clawCommandLockGrab,
+	clawCommandLockOpen,
+	clawCommandLockPosition,
+	clawCommandLockCurrent
+} clawCommand_t;
+
+#define CLAW_COMMAND(cmd, value)	((msg_t)(((uint32_t)(cmd) << 16) | (uint16_t)(value)))
+
+static msg_t	clawCommandBuffer[CLAW_COMMANDS];
+static MAILBOX_DECL(clawCommands, clawCommandBuffer, CLAW_COMMANDS);
 
 // private functions
-static msg_t	clawThread(void *arg);
+static void		clawUpdate(void *arg);
+static void		clawModeChange(void *arg, tVexMode mode);
+static void		clawCommandPost(clawCommand_t cmd, int16_t value);
+static void		clawCommandApply(void *arg);
+static void		clawLockTarget(bool_t grabbing, int16_t value);
+static void		clawMoveSource(short source, int16_t leftCmd, int16_t rightCmd, bool_t immediate);
+static void		clawRelease(short source);
 static void		clawPIDUpdate(int16_t *leftCmd, int16_t *rightCmd);
 
 // claw speed adjustment
@@ -109,99 +130,126 @@ clawInit(void)
 {
 	// SmartMotorSetRpmSensor(claw.leftMotor, claw.leftPotentiometer, 6000 * claw.gearRatio, claw.leftSensorReversed);
 	// SmartMotorSetRpmSensor(claw.rightMotor, claw.rightPotentiometer, 6000 * claw.gearRatio, claw.rightSensorReversed);
-	claw.leftLock = PidControllerInit(0.004, 0.0001, 0.01, kVexSensorUndefined, 0);
+	// Ki and Kd act per loop, keep the tuned response at the loop period
+	claw.leftLock = PidControllerInit(0.004,
+		0.0001 * CLAW_PERIOD / CLAW_TUNED_PERIOD,
+		0.01 * CLAW_TUNED_PERIOD / CLAW_PERIOD,
+		kVexSensorUndefined, 0);
 	claw.leftLock->enabled = 0;
 	// claw.rightLock = PidControllerInit(0.004, 0.0001, 0.01, kVexSensorUndefined, 0);
-	claw.rightLock = PidControllerInit(0.004, 0.0001, 0.01, kVexSensorUndefined, 0);
+	claw.rightLock = PidControllerInit(0.004,
+		0.0001 * CLAW_PERIOD / CLAW_TUNED_PERIOD,
+		0.01 * CLAW_TUNED_PERIOD / CLAW_PERIOD,
+		kVexSensorUndefined, 0);
 	claw.rightLock->enabled = 0;
 	return;
 }
 
 /*-----------------------------------------------------------------------------*/
-/** @brief      Start the claw system thread                                  */
+/** @brief      Start the claw control loop, it runs in every mode             */
 /*-----------------------------------------------------------------------------*/
 void
 clawStart(void)
 {
-	chThdCreateStatic(waClaw, sizeof(waClaw), NORMALPRIO - 1, clawThread, NULL);
+	vexSchedAdd(&clawSched, "claw", clawUpdate, NULL, CLAW_FRAMES, CLAW_PRIORITY);
+	vexSchedModeCallbackSet(&clawSched, clawModeChange);
+	vexSchedCommandCallbackSet(&clawSched, clawCommandApply);
+	vexSchedPersistentSet(&clawSched, TRUE);
 	return;
 }
 
 /*-----------------------------------------------------------------------------*/
-/** @brief      The claw system thread                                         */
+/** @brief      Competition mode change, the joysticks take over for driver    */
 /** @param[in]  arg Unused                                                     */
-/** @return     (msg_t) 0                                                      */
+/** @param[in]  mode The new mode                                              */
 /*-----------------------------------------------------------------------------*/
-static msg_t
-clawThread(void *arg)
+static void
+clawModeChange(void *arg, tVexMode mode)
 {
+	// Unused
+	(void) arg;
+
+	if (mode == kVexModeOperator)
+		clawLockCurrent();
+	return;
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      The claw control loop, called each CLAW_FRAMES SPI frames      */
+/** @param[in]  arg Unused                                                     */
+/*-----------------------------------------------------------------------------*/
+static void
+clawUpdate(void *arg)
+{
+	const vexBoardFrame *board = vexBoardGetPtr();
 	int16_t clawCmd = 0;
 	int16_t leftClawCmd = 0;
 	int16_t rightClawCmd = 0;
+	short source;
 
 	// Unused
 	(void) arg;
 
-	// Register the task
-	vexTaskRegister("claw");
-
-	while (!chThdShouldTerminate()) {
-		if (claw.locked) {
-			clawCmd = clawSpeed( vexControllerGet( Ch2 ) );
-			//clawCmd = 0;
-			leftClawCmd = rightClawCmd = clawCmd;
-			if (clawCmd == 0) {
-				// claw open and grab
-				if (vexControllerGet( Btn6U ) || vexControllerGet( Btn6UXmtr2 )) {
-					claw.isGrabbing = TRUE;
-					claw.leftLock->enabled = 1;
-					claw.leftLock->target_value = claw.grabValue;
-					claw.rightLock->enabled = 1;
-					claw.rightLock->target_value = claw.grabValue;
-				} else if (vexControllerGet( Btn6D ) || vexControllerGet( Btn6DXmtr2 )) {
-					claw.isGrabbing = FALSE;
-					claw.leftLock->enabled = 1;
-					claw.leftLock->target_value = claw.openValue;
-					claw.rightLock->enabled = 1;
-					claw.rightLock->target_value = claw.openValue;
-				}
-				clawPIDUpdate(&leftClawCmd, &rightClawCmd);
-			} else {
+	// anything posted before the loop was started
+	clawCommandApply(NULL);
+
+	if (claw.locked && board->mode != kVexModeDisabled) {
+		clawCmd = clawSpeed( vexBoardControllerGet( board, Ch2 ) );
+		//clawCmd = 0;
+		leftClawCmd = rightClawCmd = clawCmd;
+		if (clawCmd == 0) {
+			// claw open and grab
+			if (vexBoardControllerGet( board, Btn6U ) || vexBoardControllerGet( board, Btn6UXmtr2 )) {
+				claw.isGrabbing = TRUE;
+				claw.leftLock->enabled = 1;
+				claw.leftLock->target_value = claw.grabValue;
+				claw.rightLock->enabled = 1;
+				claw.rightLock->target_value = claw.grabValue;
+			} else if (vexBoardControllerGet( board, Btn6D ) || vexBoardControllerGet( board, Btn6DXmtr2 )) {
 				claw.isGrabbing = FALSE;
-				claw.leftLock->enabled = 0;
-				claw.rightLock->enabled = 0;
-				claw.leftLock->target_value = claw.rightLock->target_value = vexAdcGet( claw.potentiometer );
-				PidControllerUpdate( claw.leftLock ); // zero out left PID
-				PidControllerUpdate( claw.rightLock ); // zero out right PID
-				// If claw is already grab or open, don't allow the motors to break the claw.
-				if ((leftClawCmd < 0 || rightClawCmd < 0) &&
-						((claw.leftLock->target_value >= (claw.openValue - 250)) || (claw.rightLock->target_value >= (claw.openValue - 250)))) {
-					leftClawCmd = rightClawCmd = 0;
-				} else if ((leftClawCmd > 0 || rightClawCmd > 0) &&
-						((claw.leftLock->target_value <= (claw.grabValue + 250)) || (claw.rightLock->target_value <= (claw.grabValue + 250)))) {
-					leftClawCmd = rightClawCmd = 0;
-				}
+				claw.leftLock->enabled = 1;
+				claw.leftLock->target_value = claw.openValue;
+				claw.rightLock->enabled = 1;
+				claw.rightLock->target_value = claw.openValue;
+			}
+			clawPIDUpdate(&leftClawCmd, &rightClawCmd);
+			source = kSmartMotorSourceLock;
+			clawRelease(kSmartMotorSourceDriver);
+		} else {
+			claw.isGrabbing = FALSE;
+			claw.leftLock->enabled = 0;
+			claw.rightLock->enabled = 0;
+			claw.leftLock->target_value = claw.rightLock->target_value = board->analog[claw.potentiometer];
+			PidControllerUpdate( claw.leftLock ); // zero out left PID
+			PidControllerUpdate( claw.rightLock ); // zero out right PID
+			// If claw is already grab or open, don't allow the motors to break the claw.
+			if ((leftClawCmd < 0 || rightClawCmd < 0) &&
+					((claw.leftLock->target_value >= (claw.openValue - 250)) || (claw.rightLock->target_value >= (claw.openValue - 250)))) {
+				leftClawCmd = rightClawCmd = 0;
+			} else if ((leftClawCmd > 0 || rightClawCmd > 0) &&
+					((claw.leftLock->target_value <= (claw.grabValue + 250)) || (claw.rightLock->target_value <= (claw.grabValue + 250)))) {
+				leftClawCmd = rightClawCmd = 0;
 			}
-			SetMotor( claw.leftMotor, leftClawCmd );
-			SetMotor( claw.rightMotor, rightClawCmd );
+			source = kSmartMotorSourceDriver;
+			clawRelease(kSmartMotorSourceLock);
 		}
-
-		// Don't hog cpu
-		vexSleep(25);
+		clawMoveSource( source, leftClawCmd, rightClawCmd, FALSE );
 	}
 
-	return ((msg_t) 0);
+	return;
 }
 
 static void
 clawPIDUpdate(int16_t *leftCmd, int16_t *rightCmd)
 {
+	int16_t pot = vexBoardGetPtr()->analog[claw.potentiometer];
+
 	// enable PID if not driving and already disabled
 	if (claw.leftLock->enabled == 0 || claw.rightLock->enabled == 0) {
 		claw.leftLock->enabled = 1;
-		claw.leftLock->target_value = vexAdcGet( claw.potentiometer );
+		claw.leftLock->target_value = pot;
 		claw.rightLock->enabled = 1;
-		claw.rightLock->target_value = vexAdcGet( claw.potentiometer );
+		claw.rightLock->target_value = pot;
 	}
 	// prevent PID from trying to lock outside bounds
 	if (claw.leftLock->target_value < claw.grabValue)
@@ -213,13 +261,13 @@ clawPIDUpdate(int16_t *leftCmd, int16_t *rightCmd)
 	else if (claw.rightLock->target_value > claw.openValue)
 		claw.rightLock->target_value = claw.openValue;
 	// update PID
-	claw.leftLock->sensor_value = vexAdcGet( claw.potentiometer );
+	claw.leftLock->sensor_value = pot;
 	claw.leftLock->error =
 		(claw.sensorReversed)
 		? (claw.leftLock->sensor_value - claw.leftLock->target_value)
 		: (claw.leftLock->target_value - claw.leftLock->sensor_value);
 	*leftCmd = PidControllerUpdate( claw.leftLock );
-	claw.rightLock->sensor_value = vexAdcGet( claw.potentiometer );
+	claw.rightLock->sensor_value = pot;
 	claw.rightLock->error =
 		(claw.sensorReversed)
 		? (claw.rightLock->sensor_value - claw.rightLock->target_value)
@@ -255,54 +303,137 @@ clawPIDUpdate(int16_t *leftCmd, int16_t *rightCmd)
 	return;
 }
 
+static void
+clawMoveSource(short source, int16_t leftCmd, int16_t rightCmd, bool_t immediate)
+{
+	SmartMotorSourceSet( source, claw.leftMotor,  leftCmd,  immediate );
+	SmartMotorSourceSet( source, claw.rightMotor, rightCmd, immediate );
+}
+
+static void
+clawRelease(short source)
+{
+	SmartMotorSourceRelease( source, claw.leftMotor );
+	SmartMotorSourceRelease( source, claw.rightMotor );
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Drive the claw from autonomous, the loop wins while locked     */
+/** @param[in]  cmd The motor command                                          */
+/** @param[in]  immediate Bypass the slew rate                                 */
+/*-----------------------------------------------------------------------------*/
 void
 clawMove(int16_t cmd, bool_t immediate)
 {
-	SetMotor( claw.leftMotor,  cmd, immediate );
-	SetMotor( claw.rightMotor, cmd, immediate );
+	clawMoveSource( kSmartMotorSourceAutonomous, cmd, cmd, immediate );
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Queue a command for the claw loop and wake it                  */
+/** @param[in]  cmd The command                                                */
+/** @param[in]  value Pot target for clawCommandLockPosition                   */
+/*-----------------------------------------------------------------------------*/
+static void
+clawCommandPost(clawCommand_t cmd, int16_t value)
+{
+	if (chMBPost(&clawCommands, CLAW_COMMAND(cmd, value), TIME_IMMEDIATE) != RDY_OK)
+		claw.commandsDropped++;
+	vexSchedWake(&clawSched);
+	return;
+}
+
+static void
+clawLockTarget(bool_t grabbing, int16_t value)
+{
+	claw.locked = TRUE;
+	claw.isGrabbing = grabbing;
+	claw.leftLock->enabled = 1;
+	claw.leftLock->target_value = value;
+	claw.rightLock->enabled = 1;
+	claw.rightLock->target_value = value;
+	return;
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Apply queued commands, runs on the scheduler thread            */
+/** @param[in]  arg Unused                                                     */
+/*-----------------------------------------------------------------------------*/
+static void
+clawCommandApply(void *arg)
+{
+	msg_t	msg;
+	int16_t	value;
+
+	// Unused
+	(void) arg;
+
+	while (chMBFetch(&clawCommands, &msg, TIME_IMMEDIATE) == RDY_OK) {
+		value = (int16_t)(msg & 0xFFFF);
+		// a lock hands the motors back to the loop, unlock hands them to autonomous
+		if ((clawCommand_t)((uint32_t)msg >> 16) == clawCommandUnlock) {
+			clawRelease(kSmartMotorSourceDriver);
+			clawRelease(kSmartMotorSourceLock);
+		} else {
+			clawRelease(kSmartMotorSourceAutonomous);
+		}
+
+		switch ((clawCommand_t)((uint32_t)msg >> 16)) {
+			case clawCommandLock:
+				claw.locked = TRUE;
+				break;
+			case clawCommandUnlock:
+				claw.locked = FALSE;
+				break;
+			case clawCommandLockGrab:
+				clawLockTarget(TRUE, claw.grabValue);
+				break;
+			case clawCommandLockOpen:
+				clawLockTarget(FALSE, claw.openValue);
+				break;
+			case clawCommandLockPosition:
+				clawLockTarget(FALSE, value);
+				break;
+			case clawCommandLockCurrent:
+				clawLockTarget(FALSE, vexBoardGetPtr()->analog[claw.potentiometer]);
+				break;
+		}
+		claw.commands++;
+	}
+	return;
 }
 
 void
 clawLock(void)
 {
-	claw.locked = TRUE;
+	clawCommandPost(clawCommandLock, 0);
 }
 
 void
 clawUnlock(void)
 {
-	claw.locked = FALSE;
+	clawCommandPost(clawCommandUnlock, 0);
 }
 
 void
 clawLockGrab(void)
 {
-	clawLock();
-	claw.isGrabbing = TRUE;
-	claw.leftLock->enabled = 1;
-	claw.leftLock->target_value = claw.grabValue;
-	claw.rightLock->enabled = 1;
-	claw.rightLock->target_value = claw.grabValue;
+	clawCommandPost(clawCommandLockGrab, 0);
 }
 
 void
 clawLockOpen(void)
 {
-	clawLock();
-	claw.isGrabbing = FALSE;
-	claw.leftLock->enabled = 1;
-	claw.leftLock->target_value = claw.openValue;
-	claw.rightLock->enabled = 1;
-	claw.rightLock->target_value = claw.openValue;
+	clawCommandPost(clawCommandLockOpen, 0);
+}
+
+void
+clawLockPosition(int16_t value)
+{
+	clawCommandPost(clawCommandLockPosition, value);
 }
 
 void
 clawLockCurrent(void)
 {
-	clawLock();
-	claw.isGrabbing = FALSE;
-	claw.leftLock->enabled = 1;
-	claw.leftLock->target_value = vexAdcGet( claw.potentiometer );
-	claw.rightLock->enabled = 1;
-	claw.rightLock->target_value = vexAdcGet( claw.potentiometer );
+	clawCommandPost(clawCommandLockCurrent, 0);
 }
\ No newline at end of file
@@ -10,11 +10,12 @@
 // storage for drive
 static drive_t drive;
 
-// working area for drive task
-static WORKING_AREA(waDrive, 512);
+// joystick drive loop, run by the scheduler
+static vexSchedTask driveSched;
 
 // private functions
-static msg_t	driveThread(void *arg);
+static void		driveUpdate(void *arg);
+static void		driveModeChange(void *arg, tVexMode mode);
 
 // drive speed adjustment
 #define USE_DRIVE_SPEED_TABLE 1
@@ -109,12 +110,30 @@ driveInit(void)
 }
 
 /*-----------------------------------------------------------------------------*/
-/** @brief      Start the drive system thread                                  */
+/** @brief      Start the joystick drive loop, it runs in every mode           */
 /*-----------------------------------------------------------------------------*/
 void
 driveStart(void)
 {
-	chThdCreateStatic(waDrive, sizeof(waDrive), NORMALPRIO - 1, driveThread, NULL);
+	vexSchedAdd(&driveSched, "drive", driveUpdate, NULL, DRIVE_FRAMES, DRIVE_PRIORITY);
+	vexSchedModeCallbackSet(&driveSched, driveModeChange);
+	vexSchedPersistentSet(&driveSched, TRUE);
+	return;
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Competition mode change, the joysticks take over for driver    */
+/** @param[in]  arg Unused                                                     */
+/** @param[in]  mode The new mode                                              */
+/*-----------------------------------------------------------------------------*/
+static void
+driveModeChange(void *arg, tVexMode mode)
+{
+	// Unused
+	(void) arg;
+
+	if (mode == kVexModeOperator)
+		driveLock();
 	return;
 }
 
@@ -176,13 +195,13 @@ maybeImmediate(void)
 }
 
 /*-----------------------------------------------------------------------------*/
-/** @brief      The drive system thread                                        */
+/** @brief      The joystick drive loop, called each DRIVE_FRAMES SPI frames   */
 /** @param[in]  arg Unused                                                     */
-/** @return     (msg_t) 0                                                      */
 /*-----------------------------------------------------------------------------*/
-static msg_t
-driveThread(void *arg)
+static void
+driveUpdate(void *arg)
 {
+	const vexBoardFrame *board = vexBoardGetPtr();
 	int16_t driveX = 0;
 	int16_t driveY = 0;
 	// it.decay = FALSE;
@@ -196,35 +215,27 @@ driveThread(void *arg)
 	// Unused
 	(void) arg;
 
-	// Register the task
-	vexTaskRegister("drive");
-
-	while (!chThdShouldTerminate()) {
-		if (drive.locked) {
-			driveX = driveSpeed( vexControllerGet( Ch4 ) );
-			driveY = driveSpeed( vexControllerGet( Ch3 ) );
-			// if (abs(driveX) > 0 || abs(driveY) > 0) {
-			// 	immediateTimeoutStart();
-			// 	// immediate = TRUE;
-			// } else {
-			// 	immediateTimeoutStop();
-			// 	// immediate = FALSE;
-			// }
-			// driveR = vexControllerGet( Ch1 ) + vexControllerGet( Ch1Xmtr2 );
-
-			driveMove(driveX, driveY, maybeImmediate());
-
-			// SetMotor( drive.northeast, driveSpeed( driveY - driveX - driveR ) );
-			// SetMotor( drive.northwest, driveSpeed( driveY + driveX + driveR ) );
-			// SetMotor( drive.southeast, driveSpeed( driveY + driveX - driveR ) );
-			// SetMotor( drive.southwest, driveSpeed( driveY - driveX + driveR ) );
-		}
+	if (drive.locked && board->mode != kVexModeDisabled) {
+		driveX = driveSpeed( vexBoardControllerGet( board, Ch4 ) );
+		driveY = driveSpeed( vexBoardControllerGet( board, Ch3 ) );
+		// if (abs(driveX) > 0 || abs(driveY) > 0) {
+		// 	immediateTimeoutStart();
+		// 	// immediate = TRUE;
+		// } else {
+		// 	immediateTimeoutStop();
+		// 	// immediate = FALSE;
+		// }
+		// driveR = vexControllerGet( Ch1 ) + vexControllerGet( Ch1Xmtr2 );
+
+		driveMove(driveX, driveY, maybeImmediate());
 
-		// Don't hog cpu
-		vexSleep(25);
+		// SetMotor( drive.northeast, driveSpeed( driveY - driveX - driveR ) );
+		// SetMotor( drive.northwest, driveSpeed( driveY + driveX + driveR ) );
+		// SetMotor( drive.southeast, driveSpeed( driveY + driveX - driveR ) );
+		// SetMotor( drive.southwest, driveSpeed( driveY - driveX + driveR ) );
 	}
 
-	return ((msg_t) 0);
+	return;
 }
 
 void
@@ -248,3 +259,176 @@ driveUnlock(void)
 {
 	drive.locked = FALSE;
 }
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Trapezoidal velocity profile, distance and velocity Q16.16     */
+/*-----------------------------------------------------------------------------*/
+typedef struct driveProfile_s {
+	fix16_t		position;
+	fix16_t		velocity;
+	fix16_t		target;
+	fix16_t		maxVelocity;
+	fix16_t		acceleration;
+} driveProfile_t;
+
+// loop timing for the motion primitives, they run in the calling task
+static vexPeriodic driveMotionPeriodic;
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Advance the profile one period                                 */
+/** @return     TRUE when the profile has reached the target                   */
+/*-----------------------------------------------------------------------------*/
+/** @details
+ *  Always moves towards a positive target, callers flip the sign. Starts
+ *  slowing down once the remaining distance is inside the stopping distance.
+ */
+static bool_t
+driveProfileStep(driveProfile_t *p)
+{
+	fix16_t	remaining = p->target - p->position;
+	fix16_t	stopping;
+
+	if (remaining <= 0) {
+		p->position = p->target;
+		p->velocity = 0;
+		return TRUE;
+	}
+
+	stopping = fixDiv(fixMul(p->velocity, p->velocity), 2 * p->acceleration);
+	if (remaining <= stopping) {
+		p->velocity -= p->acceleration;
+		// never stall short of the target
+		if (p->velocity < p->acceleration)
+			p->velocity = p->acceleration;
+	} else {
+		p->velocity += p->acceleration;
+		if (p->velocity > p->maxVelocity)
+			p->velocity = p->maxVelocity;
+	}
+
+	if (p->velocity > remaining)
+		p->velocity = remaining;
+	p->position += p->velocity;
+	return FALSE;
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Drive straight holding the starting heading                    */
+/** @param[in]  inches Distance to drive, negative is backwards                 */
+/** @param[in]  timeout Give up after this many mS                             */
+/** @return     TRUE if the distance was reached, FALSE on timeout             */
+/*-----------------------------------------------------------------------------*/
+/** @details
+ *  Blocks the calling task, call from autonomous. Distance comes from the
+ *  odometry encoders and heading from the odometry pose so the gyro filter
+ *  is used when there is one.
+ */
+bool_t
+driveStraight(float inches, int32_t timeout)
+{
+	driveProfile_t	profile;
+	odometryPose_t	pose;
+	systime_t	deadline;
+	fixangle_t	heading;
+	int32_t		start, travelled, error;
+	int32_t		sign = (inches < 0) ? -1 : 1;
+	int32_t		cmd, turn;
+	bool_t		profileDone;
+
+	driveUnlock();
+
+	profile.position = 0;
+	profile.velocity = 0;
+	profile.target = (fix16_t)(fabsf(inches) * 65536.0f / FIX16_TO_FLOAT(odometryGetPtr()->inchesPerTick));
+	profile.maxVelocity = DRIVE_MAX_VELOCITY;
+	profile.acceleration = DRIVE_ACCELERATION;
+
+	odometryGet(&pose);
+	heading = pose.heading;
+	start = pose.count;
+	deadline = chTimeNow() + MS2ST(timeout);
+
+	vexPeriodicInit(&driveMotionPeriodic, ODOMETRY_PERIOD);
+	while ((int32_t)(deadline - chTimeNow()) > 0) {
+		profileDone = driveProfileStep(&profile);
+
+		// distance and heading from the same odometry update
+		odometryGet(&pose);
+		travelled = (pose.count - start) * sign;
+		error = (profile.position >> 16) - travelled;
+		if (profileDone && abs(error) <= DRIVE_TOLERANCE) {
+			driveMove(0, 0, TRUE);
+			return TRUE;
+		}
+
+		// velocity feed forward plus position error, all towards +ve distance
+		cmd = (fixMul(DRIVE_KV, profile.velocity) + (DRIVE_KP * error)) >> 16;
+		cmd *= sign;
+
+		// hold the starting heading, CCW error needs a right turn which is +ve x
+		turn = fixMul(DRIVE_HEADING_KP, fixAngleToDeg10(pose.heading - heading) << 16) >> 16;
+
+		driveMove(turn, cmd, TRUE);
+		vexPeriodicWait(&driveMotionPeriodic);
+	}
+
+	driveMove(0, 0, TRUE);
+	return FALSE;
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Turn on the spot                                               */
+/** @param[in]  degrees Angle to turn, positive is CCW (left)                   */
+/** @param[in]  timeout Give up after this many mS                             */
+/** @return     TRUE if the angle was reached, FALSE on timeout                */
+/*-----------------------------------------------------------------------------*/
+bool_t
+driveTurn(float degrees, int32_t timeout)
+{
+	driveProfile_t	profile;
+	odometryPose_t	pose;
+	systime_t	deadline;
+	fixangle_t	last;
+	int64_t		turned = 0;
+	int32_t		sign = (degrees < 0) ? -1 : 1;
+	int32_t		error, cmd;
+	bool_t		profileDone;
+
+	driveUnlock();
+
+	profile.position = 0;
+	profile.velocity = 0;
+	profile.target = (fix16_t)(fabsf(degrees) * 10.0f * 65536.0f);
+	profile.maxVelocity = DRIVE_MAX_TURN_RATE;
+	profile.acceleration = DRIVE_TURN_ACCELERATION;
+
+	odometryGet(&pose);
+	last = pose.heading;
+	deadline = chTimeNow() + MS2ST(timeout);
+
+	vexPeriodicInit(&driveMotionPeriodic, ODOMETRY_PERIOD);
+	while ((int32_t)(deadline - chTimeNow()) > 0) {
+		profileDone = driveProfileStep(&profile);
+
+		// accumulate so turns past 180 deg work
+		odometryGet(&pose);
+		turned += fixAngleDiff(pose.heading, last);
+		last = pose.heading;
+
+		// binary angle to deg * 10 towards +ve angle
+		error = (profile.position >> 16) - (int32_t)((turned * 3600 * sign) >> 32);
+		if (profileDone && abs(error) <= DRIVE_TURN_TOLERANCE) {
+			driveMove(0, 0, TRUE);
+			return TRUE;
+		}
+
+		cmd = (fixMul(DRIVE_TURN_KV, profile.velocity) + fixMul(DRIVE_TURN_KP, error << 16)) >> 16;
+
+		// +ve x turns right, CW
+		driveMove(-cmd * sign, 0, TRUE);
+		vexPeriodicWait(&driveMotionPeriodic);
+	}
+
+	driveMove(0, 0, TRUE);
+	return FALSE;
+}
@@ -0,0 +1,427 @@
+/*-----------------------------------------------------------------------------*/
+/** @file    trajgen.c                                                         */
+/** @brief   Host tool, compiles trajectory descriptions into setpoint tables  */
+/*-----------------------------------------------------------------------------*/
+
+/*
+ * Host tool, NOT part of the cortex firmware.
+ *
+ * Reads a text description of the autonomous trajectories and writes a
+ * header of time indexed setpoints for the player in traj.c, so the robot
+ * only has to read one row per period.
+ *
+ *	trajgen header <file.traj>			write the header to stdout
+ *	trajgen check <file.traj> <budget>	print the size, fail if over budget
+ *
+ * See traj.mk for the make targets that use this.
+ *
+ * Description format, one command per line, # starts a comment
+ *
+ *	wheel <inches>			drive wheel diameter
+ *	track <inches>			distance between left and right wheels
+ *	ticks <count>			encoder ticks per wheel revolution
+ *	period <mS>				time between setpoints
+ *
+ *	trajectory <Name>		start a table, emitted as trajName
+ *	limits <in/s> <in/s^2>	wheel speed and acceleration
+ *	turnlimits <deg/s> <deg/s^2>
+ *	heading <deg>			start heading, CCW from +x
+ *	line <inches>			drive straight, negative is backwards
+ *	turn <deg>				turn on the spot, positive is CCW
+ *	arc <radius> <deg>		drive forward around an arc, positive is CCW
+ *	wait <mS>				stand still
+ *	arm <pot>				arm target from here on
+ *	claw <pot>				claw target from here on
+ *	end
+ *
+ * Every motion starts and ends stopped, the arm and claw move in parallel.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+
+#define TRAJGEN_MAX_TRAJECTORIES	16
+#define TRAJGEN_MAX_SETPOINTS		16384
+#define TRAJGEN_NAME_SIZE			32
+
+// must match trajSetpoint_t and trajectory_t on the cortex
+#define TRAJGEN_SETPOINT_SIZE		10
+#define TRAJGEN_TRAJECTORY_SIZE		12
+
+// pot values are 12 bit, -1 is no target
+#define TRAJGEN_KEEP				(-1)
+
+typedef struct setpoint_s {
+	int		left;
+	int		right;
+	unsigned	heading;
+	int		arm;
+	int		claw;
+} setpoint_t;
+
+typedef struct trajectory_s {
+	char		name[TRAJGEN_NAME_SIZE];
+	int			first;
+	int			count;
+	unsigned	heading;
+} trajectory_t;
+
+// robot and the trajectory being compiled
+static double	wheelDiameter = 4.0;
+static double	trackWidth = 15.0;
+static double	ticksPerRev = 261.333;
+static int		period = 20;
+
+static double	maxSpeed = 24.0;
+static double	maxAccel = 48.0;
+static double	maxTurnRate = 180.0;
+static double	maxTurnAccel = 360.0;
+static double	heading;
+static int		armTarget;
+static int		clawTarget;
+
+static setpoint_t	setpoints[TRAJGEN_MAX_SETPOINTS];
+static int			setpointCount;
+static trajectory_t	trajectories[TRAJGEN_MAX_TRAJECTORIES];
+static int			trajectoryCount;
+
+static const char	*fileName;
+static int			lineNumber;
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Report a description error and exit                            */
+/*-----------------------------------------------------------------------------*/
+static void
+fail(const char *msg)
+{
+	fprintf(stderr, "%s:%d: %s\n", fileName, lineNumber, msg);
+	exit(1);
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Heading in degrees to the top 16 bits of a binary angle        */
+/*-----------------------------------------------------------------------------*/
+static unsigned
+headingToAngle(double deg)
+{
+	long	a = lround(deg * 65536.0 / 360.0);
+
+	return ((unsigned)(a & 0xFFFF));
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Wheel speed in inches per second to encoder ticks per second   */
+/*-----------------------------------------------------------------------------*/
+static int
+speedToTicks(double speed)
+{
+	return ((int)lround(speed * ticksPerRev / (M_PI * wheelDiameter)));
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Add one setpoint to the current trajectory                     */
+/*-----------------------------------------------------------------------------*/
+static void
+emit(double left, double right, double deg)
+{
+	setpoint_t	*s;
+
+	if (setpointCount >= TRAJGEN_MAX_SETPOINTS)
+		fail("too many setpoints");
+
+	s = &setpoints[setpointCount++];
+	s->left = speedToTicks(left);
+	s->right = speedToTicks(right);
+	s->heading = headingToAngle(deg);
+	s->arm = armTarget;
+	s->claw = clawTarget;
+	trajectories[trajectoryCount - 1].count++;
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Trapezoid profile, position and velocity at time t             */
+/** @param[in]  length Distance to move, positive                              */
+/** @param[in]  vmax Speed limit                                               */
+/** @param[in]  accel Acceleration limit                                       */
+/** @param[out] pos Position, or the total time when t is negative             */
+/*-----------------------------------------------------------------------------*/
+static void
+profile(double length, double vmax, double accel, double t, double *pos, double *vel)
+{
+	double	ta, tc, peak;
+
+	// triangle when there is not room to reach full speed
+	peak = sqrt(length * accel);
+	if (peak > vmax)
+		peak = vmax;
+	ta = peak / accel;
+	tc = (length - peak * ta) / peak;
+
+	if (t < 0) {
+		*pos = 2 * ta + tc;
+		*vel = 0;
+	} else if (t < ta) {
+		*vel = accel * t;
+		*pos = 0.5 * accel * t * t;
+	} else if (t < ta + tc) {
+		*vel = peak;
+		*pos = 0.5 * peak * ta + peak * (t - ta);
+	} else if (t < 2 * ta + tc) {
+		double td = 2 * ta + tc - t;
+		*vel = accel * td;
+		*pos = length - 0.5 * accel * td * td;
+	} else {
+		*vel = 0;
+		*pos = length;
+	}
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Setpoints for one motion                                       */
+/** @param[in]  length Profiled distance, inches or degrees, positive          */
+/** @param[in]  left Left wheel speed per unit of profile speed                */
+/** @param[in]  right Right wheel speed per unit of profile speed              */
+/** @param[in]  turn Heading change in degrees per unit of profile distance    */
+/*-----------------------------------------------------------------------------*/
+static void
+motion(double length, double vmax, double accel, double left, double right, double turn)
+{
+	double	duration, pos, vel;
+	int		n, k;
+
+	if (length <= 0)
+		return;
+	if (vmax <= 0 || accel <= 0)
+		fail("limits must be positive");
+
+	profile(length, vmax, accel, -1, &duration, &vel);
+	n = (int)ceil(duration * 1000.0 / period);
+
+	// the last row is the end of the profile so the motion always finishes stopped
+	for (k = 1; k <= n; k++) {
+		profile(length, vmax, accel, (k == n) ? duration : k * period / 1000.0, &pos, &vel);
+		emit(vel * left, vel * right, heading + pos * turn);
+	}
+	heading += length * turn;
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Read the description                                           */
+/*-----------------------------------------------------------------------------*/
+static void
+parse(FILE *fp)
+{
+	char	buf[256];
+	char	cmd[32], name[TRAJGEN_NAME_SIZE];
+	double	a, b;
+	int		n, inside = 0;
+	char	*p;
+
+	while (fgets(buf, sizeof(buf), fp) != NULL) {
+		lineNumber++;
+		if ((p = strchr(buf, '#')) != NULL)
+			*p = '\0';
+
+		n = sscanf(buf, "%31s %lf %lf", cmd, &a, &b);
+		if (n <= 0)
+			continue;
+
+		if (strcmp(cmd, "trajectory") == 0) {
+			if (inside)
+				fail("missing end");
+			if (sscanf(buf, "%*s %31s", name) != 1)
+				fail("trajectory needs a name");
+			if (trajectoryCount >= TRAJGEN_MAX_TRAJECTORIES)
+				fail("too many trajectories");
+			strcpy(trajectories[trajectoryCount].name, name);
+			trajectories[trajectoryCount].first = setpointCount;
+			trajectories[trajectoryCount].count = 0;
+			trajectories[trajectoryCount].heading = 0;
+			trajectoryCount++;
+			heading = 0;
+			armTarget = TRAJGEN_KEEP;
+			clawTarget = TRAJGEN_KEEP;
+			inside = 1;
+			continue;
+		}
+
+		if (strcmp(cmd, "end") == 0) {
+			if (!inside)
+				fail("end without trajectory");
+			if (trajectories[trajectoryCount - 1].count == 0)
+				fail("empty trajectory");
+			inside = 0;
+			continue;
+		}
+
+		// robot settings are fixed once the first table has started
+		if (strcmp(cmd, "wheel") == 0 || strcmp(cmd, "track") == 0 ||
+			strcmp(cmd, "ticks") == 0 || strcmp(cmd, "period") == 0) {
+			if (n != 2 || a <= 0)
+				fail("expected a positive value");
+			if (trajectoryCount)
+				fail("robot settings must come before the first trajectory");
+			if (cmd[0] == 'w')
+				wheelDiameter = a;
+			else if (cmd[0] == 't' && cmd[1] == 'r')
+				trackWidth = a;
+			else if (cmd[0] == 't')
+				ticksPerRev = a;
+			else
+				period = (int)a;
+			continue;
+		}
+
+		if (strcmp(cmd, "limits") == 0 || strcmp(cmd, "turnlimits") == 0) {
+			if (n != 3 || a <= 0 || b <= 0)
+				fail("expected speed and acceleration");
+			if (cmd[0] == 'l') {
+				maxSpeed = a;
+				maxAccel = b;
+			} else {
+				maxTurnRate = a;
+				maxTurnAccel = b;
+			}
+			continue;
+		}
+
+		if (!inside)
+			fail("motion outside a trajectory");
+
+		if (strcmp(cmd, "heading") == 0 && n == 2) {
+			if (trajectories[trajectoryCount - 1].count)
+				fail("heading must come before the first motion");
+			heading = a;
+		} else if (strcmp(cmd, "line") == 0 && n == 2) {
+			double dir = (a < 0) ? -1 : 1;
+			motion(fabs(a), maxSpeed, maxAccel, dir, dir, 0);
+		} else if (strcmp(cmd, "turn") == 0 && n == 2) {
+			// profile is in degrees, wheels move half the track per radian
+			double wheel = (M_PI / 180.0) * (trackWidth / 2);
+			double dir = (a < 0) ? -1 : 1;
+			motion(fabs(a), maxTurnRate, maxTurnAccel, -dir * wheel, dir * wheel, dir);
+		} else if (strcmp(cmd, "arc") == 0 && n == 3) {
+			// profile the centre, slowed so the outside wheel keeps to the limits
+			double scale, inner, outer, dir = (b < 0) ? -1 : 1;
+			if (a <= trackWidth / 2)
+				fail("arc radius must be more than half the track");
+			inner = (a - trackWidth / 2) / a;
+			outer = (a + trackWidth / 2) / a;
+			scale = 1.0 / outer;
+			motion(fabs(b) * (M_PI / 180.0) * a, maxSpeed * scale, maxAccel * scale,
+				   (dir > 0) ? inner : outer, (dir > 0) ? outer : inner,
+				   dir * (180.0 / M_PI) / a);
+		} else if (strcmp(cmd, "wait") == 0 && n == 2) {
+			int k;
+			for (k = 0; k < (int)ceil(a / period); k++)
+				emit(0, 0, heading);
+		} else if (strcmp(cmd, "arm") == 0 && n == 2) {
+			if (a < 0 || a > 4095)
+				fail("arm target is a pot value 0 to 4095");
+			armTarget = (int)a;
+		} else if (strcmp(cmd, "claw") == 0 && n == 2) {
+			if (a < 0 || a > 4095)
+				fail("claw target is a pot value 0 to 4095");
+			clawTarget = (int)a;
+		} else {
+			fail("unknown command or wrong number of values");
+		}
+
+		if (trajectories[trajectoryCount - 1].count == 0)
+			trajectories[trajectoryCount - 1].heading = headingToAngle(heading);
+	}
+
+	if (inside)
+		fail("missing end");
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Flash used by the tables in bytes                              */
+/*-----------------------------------------------------------------------------*/
+static long
+flashSize(void)
+{
+	return ((long)setpointCount * TRAJGEN_SETPOINT_SIZE +
+			(long)trajectoryCount * TRAJGEN_TRAJECTORY_SIZE);
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Write the header                                               */
+/*-----------------------------------------------------------------------------*/
+static void
+header(void)
+{
+	trajectory_t	*t;
+	setpoint_t		*s;
+	int				i, k;
+
+	printf("/*\n");
+	printf(" * trajectories.h\n");
+	printf(" *\n");
+	printf(" * Generated by host/trajgen.c from %s, do not edit.\n", fileName);
+	printf(" * Run make traj after changing the description.\n");
+	printf(" */\n\n");
+	printf("#ifndef TRAJECTORIES_H_\n\n");
+	printf("#define TRAJECTORIES_H_\n\n");
+	printf("#include \"traj.h\"\n\n");
+	printf("// %d trajectories, %d setpoints, %ld bytes of flash\n",
+		   trajectoryCount, setpointCount, flashSize());
+	printf("typedef char trajSetpointSizeCheck[(sizeof(trajSetpoint_t) == %d) ? 1 : -1];\n",
+		   TRAJGEN_SETPOINT_SIZE);
+
+	for (i = 0; i < trajectoryCount; i++) {
+		t = &trajectories[i];
+		printf("\n// %s, %d mS\n", t->name, t->count * period);
+		printf("static const trajSetpoint_t traj%sPoints[%d] = {\n", t->name, t->count);
+		for (k = 0; k < t->count; k++) {
+			s = &setpoints[t->first + k];
+			printf("\t{ %5d, %5d, %5u, %4d, %4d },\n",
+				   s->left, s->right, s->heading, s->arm, s->claw);
+		}
+		printf("};\n\n");
+		printf("static const trajectory_t traj%s = { traj%sPoints, %d, %d, %u };\n",
+			   t->name, t->name, t->count, period, t->heading);
+	}
+
+	printf("\n#endif\n");
+}
+
+int
+main(int argc, char *argv[])
+{
+	FILE	*fp;
+	long	budget = 0;
+
+	if (argc < 3 || (strcmp(argv[1], "header") != 0 && strcmp(argv[1], "check") != 0) ||
+		(strcmp(argv[1], "check") == 0 && argc != 4)) {
+		fprintf(stderr, "usage: %s header <file.traj> | check <file.traj> <budget>\n", argv[0]);
+		return (1);
+	}
+
+	fileName = argv[2];
+	if ((fp = fopen(fileName, "r")) == NULL) {
+		perror(fileName);
+		return (1);
+	}
+	parse(fp);
+	fclose(fp);
+
+	if (strcmp(argv[1], "header") == 0) {
+		header();
+		return (0);
+	}
+
+	budget = atol(argv[3]);
+	printf("trajectories: %d tables, %d setpoints, %ld of %ld bytes\n",
+		   trajectoryCount, setpointCount, flashSize(), budget);
+	if (flashSize() > budget) {
+		fprintf(stderr, "%s: trajectories need %ld bytes, over the %ld byte flash budget\n",
+				fileName, flashSize(), budget);
+		return (1);
+	}
+
+	return (0);
+}
@@ -4,6 +4,7 @@
 /*-----------------------------------------------------------------------------*/
 
 #include "lcd.h"
+#include "vexrecord.h"
 
 #include <math.h>
 #include <stdlib.h>
@@ -20,6 +21,9 @@ user_param *userp;
 // working area for lcd task
 static WORKING_AREA(waLcd, 512);
 
+// loop timing for lcd task
+static vexPeriodic lcdPeriodic;
+
 static Thread	*lcdThreadPointer = NULL;
 static long		lcdThreadDeadTimer = 0;
 
@@ -95,8 +99,9 @@ lcdThread(void *arg)
 	// Unused
 	(void) arg;
 
-	// Register the task
-	vexTaskRegister("lcd");
+	// Register the task, it stays running across competition modes
+	vexTaskRegisterPersistant("lcd", TRUE);
+	vexPeriodicInit(&lcdPeriodic, 25);
 
 	vexLcdBacklight( lcd.display, 1);
 	vexLcdClearLine( lcd.display, VEX_LCD_LINE_1 );
@@ -106,8 +111,10 @@ lcdThread(void *arg)
 		lcdThreadDeadTimer = chTimeNow();
 		lcdRead();
 		lcdWrite();
+		// a driver recording is written to flash here, never while driving
+		vexRecordSavePoll();
 		// Don't hog cpu
-		vexSleep(25);
+		vexPeriodicWait(&lcdPeriodic);
 	}
 
 	lcdThreadPointer = NULL;
@@ -54,6 +54,11 @@
 
 #include "claw.h"
 #include "arm.h"
+#include "odometry.h"
+#include "vexrecord.h"
+#include "vexpt.h"
+#include "vexsched.h"
+#include "vexboard.h"
 
 /*-----------------------------------------------------------------------------*/
 /* Command line related.                                                       */
@@ -118,6 +123,7 @@ cmd_claw(vexStream *chp, int argc, char *argv[])
 	(void)chp;
 	(void)argc;
 
+	vex_printf("Claw commands %d dropped %d\r\n", clawGetPtr()->commands, clawGetPtr()->commandsDropped);
 	vex_printf("Claw Left Lock PID\r\n");
 	vex_pid_debug(clawGetPtr()->leftLock);
 	vex_printf("Claw Right Lock PID\r\n");
@@ -139,12 +145,39 @@ cmd_arm(vexStream *chp, int argc, char *argv[])
 	vex_printf("\tGear Ratio: %f\r\n", a->gearRatio);
 	vex_printf("\tDown:       %d\r\n", a->downValue);
 	vex_printf("\tUp:         %d\r\n", a->upValue);
+	vex_printf("\tAngle:      %f\r\n", FIX16_TO_FLOAT(a->estimator.angle));
+	vex_printf("\tRate:       %f\r\n", FIX16_TO_FLOAT(a->estimator.rate) * (1000.0 / ARM_PERIOD));
+	vex_printf("\tIME Reject: %d\r\n", a->estimator.imeRejects);
+	vex_printf("\tCommands:   %d dropped %d\r\n", a->commands, a->commandsDropped);
 	vex_printf("Arm Lock PID\r\n");
 	vex_pid_debug(a->lock);
 
 	return;
 }
 
+static void
+cmd_odom(vexStream *chp, int argc, char *argv[])
+{
+	(void)argv;
+	(void)chp;
+	(void)argc;
+
+	odometryPose_t pose;
+	odometry_t *o = odometryGetPtr();
+
+	odometryGet(&pose);
+	vex_printf("Odometry\r\n");
+	vex_printf("\tX:          %f\r\n", FIX16_TO_FLOAT(pose.x));
+	vex_printf("\tY:          %f\r\n", FIX16_TO_FLOAT(pose.y));
+	vex_printf("\tHeading:    %d\r\n", fixAngleToDeg10(pose.heading));
+	vex_printf("\tCount:      %d\r\n", pose.count);
+	vex_printf("\tTime:       %d\r\n", pose.time);
+	vex_printf("\tUpdates:    %d\r\n", o->updates);
+	vex_printf("\tOverruns:   %d\r\n", o->periodic.overruns);
+
+	return;
+}
+
 #define SHELL_WA_SIZE THD_WA_SIZE(512)
 
 // Shell command
@@ -161,6 +194,17 @@ static const ShellCommand commands[] = {
 	{"apollo",	cmd_apollo},
 	{"claw",	cmd_claw},
 	{"arm",		cmd_arm},
+	{"odom",	cmd_odom},
+	{"heading",	vexHeadingDebug},
+	{"rec",		vexRecordDebug},
+	{"pt",		vexPtDebug},
+	{"sched",	vexSchedDebug},
+	{"board",	vexBoardDebug},
+	{"mode",	vexModeDebug},
+	{"estop",	vexTaskEmergencyDebug},
+	{"task",	vexTaskDebug},
+	{"time",	vexTimeDebug},
+	{"stack",	vexStackDebug},
 	{NULL,		NULL}
 };
 
@@ -0,0 +1,256 @@
+/*-----------------------------------------------------------------------------*/
+/** @file    odometry.c                                                        */
+/** @brief   Robot position tracking from the drive IMEs and gyro              */
+/*-----------------------------------------------------------------------------*/
+
+#include "odometry.h"
+
+#include <stdlib.h>
+
+// storage for odometry
+static odometry_t odometry;
+
+// working area for odometry task
+static WORKING_AREA(waOdometry, 512);
+
+// private functions
+static msg_t	odometryThread(void *arg);
+static void		odometryUpdate(void);
+
+// keep the compiler from moving pose accesses across the sequence counter
+#define odometryBarrier()	__asm__ volatile("" ::: "memory")
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Get pointer to odometry structure - not used locally           */
+/** @return     A odometry_t pointer                                           */
+/*-----------------------------------------------------------------------------*/
+odometry_t *
+odometryGetPtr(void)
+{
+	return (&odometry);
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Assign encoders and gyro to the odometry system.               */
+/** @param[in]  left The left drive motor with an IME                          */
+/** @param[in]  leftReversed Flag indicating the left count should be reversed */
+/** @param[in]  right The right drive motor with an IME                        */
+/** @param[in]  rightReversed Flag indicating the right count should be reversed */
+/** @param[in]  gyro The gyro analog port or kVexAnalog_None to use encoders   */
+/** @param[in]  wheelDiameter The drive wheel diameter in inches               */
+/** @param[in]  trackWidth The distance between left and right wheels in inches */
+/*-----------------------------------------------------------------------------*/
+void
+odometrySetup(tVexMotor left, bool_t leftReversed, tVexMotor right, bool_t rightReversed,
+			  tVexAnalogPin gyro, float wheelDiameter, float trackWidth)
+{
+	odometry.left = left;
+	odometry.leftReversed = leftReversed;
+	odometry.right = right;
+	odometry.rightReversed = rightReversed;
+	odometry.gyro = gyro;
+	odometry.wheelDiameter = wheelDiameter;
+	odometry.trackWidth = trackWidth;
+	odometry.thread = NULL;
+	return;
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Initialize the odometry system.                                */
+/** @note       Call after SmartMotorsInit, ticks per rev come from there.     */
+/*-----------------------------------------------------------------------------*/
+void
+odometryInit(void)
+{
+	float	ticksPerRev;
+	float	inchesPerTick;
+
+	// one encoder for both wheels never sees a turn, the heading would not move
+	odometry.valid = !vexMotorSensorShared(odometry.left, odometry.right);
+	if (!odometry.valid) {
+		vex_printf("odometry: left and right drive share an encoder, not started\r\n");
+		return;
+	}
+
+	ticksPerRev = SmartMotorGetPtr(odometry.left)->ticks_per_rev;
+	if (ticksPerRev <= 0)
+		ticksPerRev = SMLIB_TPR_393R;
+
+	// all the float math happens once here
+	inchesPerTick = (3.14159265f * odometry.wheelDiameter) / ticksPerRev;
+	odometry.inchesPerTick = (fix16_t)(inchesPerTick * 65536.0f);
+	odometry.anglePerTick = (int32_t)((inchesPerTick / odometry.trackWidth) * (4294967296.0f / (2.0f * 3.14159265f)));
+
+	// the heading filter uses the same encoders to correct the gyro
+	if (odometry.gyro != kVexAnalog_None) {
+		vexHeadingEncoderSet(odometry.left, odometry.leftReversed,
+							 odometry.right, odometry.rightReversed, odometry.anglePerTick);
+		vexHeadingInit(odometry.gyro);
+	}
+
+	odometryReset(0, 0, 0);
+	return;
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Start the odometry system thread                               */
+/*-----------------------------------------------------------------------------*/
+void
+odometryStart(void)
+{
+	if (odometry.thread != NULL || !odometry.valid)
+		return;
+
+	// above the user tasks so the pose is sampled on time
+	odometry.thread = chThdCreateStatic(waOdometry, sizeof(waOdometry), USER_THREAD_PRIORITY + 2, odometryThread, NULL);
+	return;
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Get the latest pose, safe to call from any thread              */
+/** @param[out] pose Where to copy the pose                                    */
+/*-----------------------------------------------------------------------------*/
+/** @details
+ *  The odometry thread is the only writer, readers retry if an update
+ *  happened while they were copying so no lock is needed.
+ */
+void
+odometryGet(odometryPose_t *pose)
+{
+	uint32_t	sequence;
+
+	do {
+		sequence = odometry.sequence;
+		odometryBarrier();
+		*pose = odometry.pose;
+		odometryBarrier();
+	} while ((sequence & 1) || sequence != odometry.sequence);
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Set the current pose                                           */
+/** @param[in]  x The x position in inches Q16.16                              */
+/** @param[in]  y The y position in inches Q16.16                              */
+/** @param[in]  heading The heading                                            */
+/*-----------------------------------------------------------------------------*/
+void
+odometryReset(fix16_t x, fix16_t y, fixangle_t heading)
+{
+	vexHeadingData	h;
+
+	if (odometry.gyro != kVexAnalog_None)
+		vexHeadingGet(&h);
+
+	chSysLock();
+	odometry.headingOffset = heading;
+	if (odometry.gyro != kVexAnalog_None)
+		odometry.headingOffset -= h.heading;
+	odometry.heading = heading;
+
+	odometry.sequence++;
+	odometryBarrier();
+	odometry.pose.x = x;
+	odometry.pose.y = y;
+	odometry.pose.heading = heading;
+	odometry.pose.time = chTimeNow();
+	odometryBarrier();
+	odometry.sequence++;
+	chSysUnlock();
+	return;
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Read an encoder count, reversed if necessary                   */
+/*-----------------------------------------------------------------------------*/
+static inline int32_t
+odometryCount(tVexMotor motor, bool_t reversed)
+{
+	int32_t count = vexMotorPositionGet(motor);
+	return (reversed ? -count : count);
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Integrate one period of encoder and gyro data                  */
+/*-----------------------------------------------------------------------------*/
+static void
+odometryUpdate(void)
+{
+	int32_t		leftCount, rightCount;
+	int32_t		dl, dr;
+	fixangle_t	gyroAngle = 0;
+	fixangle_t	heading, mid;
+	fix16_t		ds;
+	vexHeadingData	h;
+
+	leftCount = odometryCount(odometry.left, odometry.leftReversed);
+	rightCount = odometryCount(odometry.right, odometry.rightReversed);
+	if (odometry.gyro != kVexAnalog_None) {
+		vexHeadingGet(&h);
+		gyroAngle = h.heading;
+	}
+
+	dl = leftCount - odometry.leftCount;
+	dr = rightCount - odometry.rightCount;
+	odometry.leftCount = leftCount;
+	odometry.rightCount = rightCount;
+
+	// count was reset or the IME renegotiated, lose this period rather than jump
+	if (abs(dl) > ODOMETRY_MAX_DELTA || abs(dr) > ODOMETRY_MAX_DELTA)
+		dl = dr = 0;
+
+	// distance travelled by the center of the robot
+	ds = ((dl + dr) * odometry.inchesPerTick) / 2;
+
+	chSysLock();
+	if (odometry.gyro != kVexAnalog_None)
+		heading = gyroAngle + odometry.headingOffset;
+	else
+		heading = odometry.heading + (fixangle_t)((dr - dl) * odometry.anglePerTick);
+
+	// integrate along the average heading for the period
+	mid = odometry.heading + (fixAngleDiff(heading, odometry.heading) / 2);
+	odometry.heading = heading;
+
+	odometry.sequence++;
+	odometryBarrier();
+	odometry.pose.x += fixMul(ds, fixCos(mid));
+	odometry.pose.y += fixMul(ds, fixSin(mid));
+	odometry.pose.heading = heading;
+	odometry.pose.count = (leftCount + rightCount) / 2;
+	odometry.pose.time = chTimeNow();
+	odometryBarrier();
+	odometry.sequence++;
+	chSysUnlock();
+
+	odometry.updates++;
+	return;
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      The odometry system thread                                     */
+/** @param[in]  arg Unused                                                     */
+/** @return     (msg_t) 0                                                      */
+/*-----------------------------------------------------------------------------*/
+static msg_t
+odometryThread(void *arg)
+{
+	// Unused
+	(void) arg;
+
+	// Register the task, keep running across competition modes
+	vexTaskRegisterPersistant("odometry", TRUE);
+
+	odometry.leftCount = odometryCount(odometry.left, odometry.leftReversed);
+	odometry.rightCount = odometryCount(odometry.right, odometry.rightReversed);
+
+	vexPeriodicInit(&odometry.periodic, ODOMETRY_PERIOD);
+	while (!chThdShouldTerminate()) {
+		odometryUpdate();
+
+		// late, the encoder deltas already cover the missed periods
+		vexPeriodicWait(&odometry.periodic);
+	}
+
+	odometry.thread = NULL;
+	return ((msg_t) 0);
+}
@@ -0,0 +1,191 @@
+/*-----------------------------------------------------------------------------*/
+/** @file    path.c                                                            */
+/** @brief   Pure pursuit path follower for waypoint tables                    */
+/*-----------------------------------------------------------------------------*/
+
+#include "path.h"
+
+// storage for follower state
+static pathState_t path;
+
+// loop timing for the follower, runs in the calling task
+static vexPeriodic pathPeriodic;
+
+// half the track width in inches Q16.16
+static fix16_t halfTrack;
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Get pointer to path follower state - not used locally          */
+/** @return     A pathState_t pointer                                          */
+/*-----------------------------------------------------------------------------*/
+pathState_t *
+pathGetPtr(void)
+{
+	return (&path);
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Project the robot onto the current segment                     */
+/** @return     Distance along the segment, inches Q16.16                      */
+/*-----------------------------------------------------------------------------*/
+static fix16_t
+pathProject(const pathPoint_t *a, const pathPoint_t *b, fix16_t x, fix16_t y)
+{
+	int64_t	dot;
+	fix16_t	len = b->s - a->s;
+
+	if (len <= 0)
+		return (0);
+
+	dot = ((int64_t)(x - a->x) * (b->x - a->x) + (int64_t)(y - a->y) * (b->y - a->y)) >> 16;
+	return ((fix16_t)((dot << 16) / len));
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      One follower update                                            */
+/** @param[in]  pose The current pose                                          */
+/** @param[out] turn The drive x command                                       */
+/** @param[out] speed The drive y command                                      */
+/** @return     TRUE when the end of the path has been reached                 */
+/*-----------------------------------------------------------------------------*/
+/** @details
+ *  The closest segment and lookahead segment only move forward and at most
+ *  PATH_SEARCH_MAX segments each update, so the cost is fixed no matter how
+ *  long the path is.
+ */
+static bool_t
+pathUpdate(const odometryPose_t *pose, int16_t *turn, int16_t *speed)
+{
+	const path_t		*p = path.path;
+	const pathPoint_t	*a, *b;
+	int16_t		last = p->count - 1;
+	int16_t		n;
+	fix16_t		proj, len, sl, frac, remaining;
+	fix16_t		dx, dy, lx, ly, c, sn;
+	int64_t		d2;
+	int32_t		v;
+
+	// closest point, move on while past the end of the current segment
+	for (n = 0; n < PATH_SEARCH_MAX; n++) {
+		a = &p->points[path.segment];
+		b = &p->points[path.segment + 1];
+		proj = pathProject(a, b, pose->x, pose->y);
+		if (proj < (b->s - a->s) || path.segment >= last - 1)
+			break;
+		path.segment++;
+	}
+
+	// the search may have stopped on a segment it has not projected onto yet
+	a = &p->points[path.segment];
+	b = &p->points[path.segment + 1];
+	if (n == PATH_SEARCH_MAX)
+		proj = pathProject(a, b, pose->x, pose->y);
+	len = b->s - a->s;
+	if (proj < 0)
+		proj = 0;
+	else if (proj > len)
+		proj = len;
+	path.s = a->s + proj;
+
+	remaining = p->points[last].s - path.s;
+	if (remaining <= PATH_TOLERANCE)
+		return TRUE;
+
+	// lookahead point, lookahead distance further along the path
+	sl = path.s + p->lookahead;
+	if (path.lookSegment < path.segment)
+		path.lookSegment = path.segment;
+	for (n = 0; n < PATH_SEARCH_MAX; n++) {
+		if (path.lookSegment >= last - 1 || p->points[path.lookSegment + 1].s >= sl)
+			break;
+		path.lookSegment++;
+	}
+
+	a = &p->points[path.lookSegment];
+	b = &p->points[path.lookSegment + 1];
+	len = b->s - a->s;
+	frac = (len > 0) ? fixDiv(sl - a->s, len) : FIX16_ONE;
+	if (frac < 0)
+		frac = 0;
+	else if (frac > FIX16_ONE)
+		frac = FIX16_ONE;
+	path.goalX = a->x + fixMul(b->x - a->x, frac);
+	path.goalY = a->y + fixMul(b->y - a->y, frac);
+
+	// goal in the robot frame, x forward and y to the left
+	c = fixCos(pose->heading);
+	sn = fixSin(pose->heading);
+	dx = path.goalX - pose->x;
+	dy = path.goalY - pose->y;
+	lx = fixMul(c, dx) + fixMul(sn, dy);
+	ly = fixMul(c, dy) - fixMul(sn, dx);
+
+	// curvature of the arc through the goal, 2y / d^2
+	d2 = ((int64_t)lx * lx + (int64_t)ly * ly) >> 16;
+	if (d2 < FIX16(0.01))
+		path.curvature = 0;
+	else
+		path.curvature = (fix16_t)(((int64_t)(2 * ly) << 16) / d2);
+
+	// slow down for the end of the path
+	v = p->speed;
+	if (remaining < PATH_SLOWDOWN) {
+		v = (int32_t)(((int64_t)v * remaining) / PATH_SLOWDOWN);
+		if (v < PATH_MIN_SPEED)
+			v = PATH_MIN_SPEED;
+	}
+
+	// CCW curvature needs the right side faster, right side is y - x
+	*speed = v;
+	*turn = -(fixMul(fixMul(path.curvature, halfTrack), v << 16) >> 16);
+	return FALSE;
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Follow a path                                                  */
+/** @param[in]  p The path, must have at least two points                     */
+/** @param[in]  timeout Give up after this many mS                             */
+/** @return     TRUE if the end was reached, FALSE on timeout                  */
+/*-----------------------------------------------------------------------------*/
+/** @details
+ *  Blocks the calling task, call from autonomous. The pose comes from
+ *  odometry so waypoints are in the odometry frame.
+ */
+bool_t
+pathFollow(const path_t *p, int32_t timeout)
+{
+	odometryPose_t	pose;
+	systime_t	deadline;
+	int16_t		turn, speed;
+
+	if (p->count < 2)
+		return FALSE;
+
+	driveUnlock();
+
+	path.path = p;
+	path.segment = 0;
+	path.lookSegment = 0;
+	path.s = 0;
+	path.curvature = 0;
+	path.updates = 0;
+	halfTrack = (fix16_t)(odometryGetPtr()->trackWidth * 32768.0f);
+
+	deadline = chTimeNow() + MS2ST(timeout);
+
+	vexPeriodicInit(&pathPeriodic, PATH_PERIOD);
+	while ((int32_t)(deadline - chTimeNow()) > 0) {
+		odometryGet(&pose);
+		path.updates++;
+		if (pathUpdate(&pose, &turn, &speed)) {
+			driveMove(0, 0, TRUE);
+			return TRUE;
+		}
+
+		driveMove(turn, speed, TRUE);
+		vexPeriodicWait(&pathPeriodic);
+	}
+
+	driveMove(0, 0, TRUE);
+	return FALSE;
+}
@@ -13,3 +13,6 @@ VEXUSERSRC = vexuser.c $(filter-out main.c vexuser.c, $(wildcard *.c))
 
 # Uncomment and add/modify user include files
 VEXUSERINC = ../include
+
+# Flash in bytes the autonomous trajectory tables may use, see traj.mk
+TRAJ_FLASH_BUDGET = 8192
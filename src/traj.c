@@ -0,0 +1,97 @@
+/*-----------------------------------------------------------------------------*/
+/** @file    traj.c                                                            */
+/** @brief   Plays precomputed trajectory tables from flash                    */
+/*-----------------------------------------------------------------------------*/
+
+#include "traj.h"
+
+// storage for player state
+static trajState_t traj;
+
+// loop timing for the player, runs in the calling task
+static vexPeriodic trajPeriodic;
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Get pointer to player state - not used locally                 */
+/** @return     A trajState_t pointer                                          */
+/*-----------------------------------------------------------------------------*/
+trajState_t *
+trajGetPtr(void)
+{
+	return (&traj);
+}
+
+/*-----------------------------------------------------------------------------*/
+/** @brief      Play a trajectory table                                        */
+/** @param[in]  t The table, see trajectories.h                                */
+/*-----------------------------------------------------------------------------*/
+/** @details
+ *  Blocks the calling task, call from autonomous. The profile, wheel speeds
+ *  and heading were all worked out by trajgen, each row is a feed forward
+ *  per side and a heading correction. The heading is relative to where the
+ *  robot points when the table starts so odometry does not need a reset.
+ *  Like autoSeqRun the table is cut off AUTOSEQ_SAFE_MARGIN before the end
+ *  of the period with the drive stopped and the arm and claw locked.
+ */
+void
+trajPlay(const trajectory_t *t)
+{
+	const trajSetpoint_t	*sp;
+	odometryPose_t	pose;
+	fixangle_t		offset;
+	int32_t			left, right, turn;
+	systime_t		end;
+
+	driveUnlock();
+
+	traj.traj = t;
+	traj.arm = TRAJ_KEEP;
+	traj.claw = TRAJ_KEEP;
+	traj.windowClosed = FALSE;
+	end = autoSeqMatchEnd();
+
+	odometryGet(&pose);
+	offset = pose.heading - ((fixangle_t)t->heading << 16);
+
+	vexPeriodicInit(&trajPeriodic, t->period);
+	for (traj.index = 0; traj.index < t->count; traj.index++) {
+		if ((int32_t)(end - chTimeNow()) <= 0) {
+			traj.windowClosed = TRUE;
+			break;
+		}
+
+		sp = &t->points[traj.index];
+
+		// targets only change now and then, only tell the arm and claw when they do
+		if (sp->arm != traj.arm) {
+			traj.arm = sp->arm;
+			if (traj.arm != TRAJ_KEEP)
+				armLockPosition(traj.arm);
+		}
+		if (sp->claw != traj.claw) {
+			traj.claw = sp->claw;
+			if (traj.claw != TRAJ_KEEP)
+				clawLockPosition(traj.claw);
+		}
+
+		// CCW error needs a right turn which is +ve x
+		odometryGet(&pose);
+		traj.headingError = fixAngleToDeg10(pose.heading - offset - ((fixangle_t)sp->heading << 16));
+		turn = fixMul(DRIVE_HEADING_KP, traj.headingError << 16) >> 16;
+
+		// left is y + x and right is y - x
+		left = (sp->left * TRAJ_KV) >> 16;
+		right = (sp->right * TRAJ_KV) >> 16;
+		driveMove((left - right) / 2 + turn, (left + right) / 2, TRUE);
+
+		vexPeriodicWait(&trajPeriodic);
+	}
+
+	traj.overruns = trajPeriodic.overruns;
+	driveMove(0, 0, TRUE);
+	if (traj.windowClosed) {
+		armLockCurrent();
+		clawLockCurrent();
+	}
+	return;
+}
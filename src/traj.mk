@@ -0,0 +1,32 @@
+# Host compiled autonomous trajectory tables.
+# Include after rules.mk so the build check runs as part of "all".
+#
+#   make traj       regenerate trajectories.h from trajectories.traj
+#   make trajcheck  check trajectories.h is up to date and fits the budget
+#
+HOSTCC            ?= cc
+TRAJ_FLASH_BUDGET ?= 8192
+TRAJDIR            = $(BUILDDIR)/traj
+TRAJGEN            = $(TRAJDIR)/trajgen
+TRAJSRC            = trajectories.traj
+TRAJHDR            = ../include/trajectories.h
+
+$(TRAJGEN): host/trajgen.c
+	@mkdir -p $(TRAJDIR)
+	$(HOSTCC) -O1 -Wall -o $@ $< -lm
+
+traj: $(TRAJGEN)
+	$(TRAJGEN) check $(TRAJSRC) $(TRAJ_FLASH_BUDGET)
+	$(TRAJGEN) header $(TRAJSRC) > $(TRAJHDR)
+
+trajcheck: $(TRAJGEN)
+	@$(TRAJGEN) check $(TRAJSRC) $(TRAJ_FLASH_BUDGET)
+	@$(TRAJGEN) header $(TRAJSRC) | cmp -s - $(TRAJHDR) || \
+	    (echo "trajectories.h is out of date, run make traj"; exit 1)
+
+.PHONY: traj trajcheck
+
+# Only check when a host compiler is available
+ifneq ($(shell command -v $(HOSTCC) 2>/dev/null),)
+MAKE_ALL_RULE_HOOK: trajcheck
+endif
@@ -53,6 +53,7 @@
 #include "arm.h"
 #include "claw.h"
 #include "lcd.h"
+#include "odometry.h"
 #include "autonomous.h"
 
 // Digital I/O configuration
@@ -74,9 +75,10 @@ static vexDigiCfg dConfig[kVexDigital_Num] = {
 // Port 1 has no power expander
 // port 9 SW
 // port 2 NE                                          36 inches tall 30 inches deep 49 inches wide
-// Motor configuration
+// Motor configuration, IME channels follow the daisy chain from the cortex,
+// arm (8), right claw (7), left claw (5), then drive southwest (1) and southeast (10)
 static vexMotorCfg mConfig[kVexMotorNum] = {
-	{ kVexMotor_1,		kVexMotor393R,			kVexMotorNormal,		kVexSensorIME,			0 },
+	{ kVexMotor_1,		kVexMotor393R,			kVexMotorNormal,		kVexSensorIME,			kImeChannel_4 },
 	{ kVexMotor_2,		kVexMotor393R,			kVexMotorNormal,		kVexSensorNone,			0 },
 	{ kVexMotor_3,		kVexMotorUndefined,		kVexMotorNormal,		kVexSensorNone,			0 },
 	{ kVexMotor_4,		kVexMotor393S,			kVexMotorReversed,		kVexSensorNone,			0 },
@@ -85,7 +87,7 @@ static vexMotorCfg mConfig[kVexMotorNum] = {
 	{ kVexMotor_7,		kVexMotor393T,			kVexMotorNormal,		kVexSensorIME,			kImeChannel_2 },
 	{ kVexMotor_8,		kVexMotor393S,			kVexMotorReversed,		kVexSensorIME,			kImeChannel_1 },
 	{ kVexMotor_9,		kVexMotor393R,			kVexMotorReversed,		kVexSensorNone,			0 },
-	{ kVexMotor_10,		kVexMotor393R,			kVexMotorNormal,		kVexSensorIME,			0 }
+	{ kVexMotor_10,		kVexMotor393R,			kVexMotorNormal,		kVexSensorIME,			kImeChannel_5 }
 };
 
 /*-----------------------------------------------------------------------------*/
@@ -127,6 +129,15 @@ vexUserSetup()
 		1725,					// grab potentiometer value
 		2880					// open potentiometer value
 	);
+	odometrySetup(
+		kVexMotor_1,			// left drive IME (southwest)
+		FALSE,					// left encoder not reversed
+		kVexMotor_10,			// right drive IME (southeast)
+		FALSE,					// right encoder not reversed
+		kVexAnalog_None,		// no gyro configured, heading from the encoders
+		4.0,					// drive wheel diameter in inches
+		15.0					// distance between left and right wheels in inches
+	);
 	lcdSetup(VEX_LCD_DISPLAY_1);
 }
 
@@ -150,8 +161,17 @@ vexUserInit()
 	clawInit();
 	driveInit();
 	SmartMotorRun();
+	odometryInit();
+	odometryStart();
 	lcdInit();
 	lcdStart();
+
+	// control loops and the lcd run in every mode, they switch over on the mode change
+	// the board goes first, every loop reads its sensors from there
+	vexBoardInit();
+	armStart();
+	clawStart();
+	driveStart();
 }
 
 // static inline int
@@ -185,61 +205,19 @@ vexAutonomous( void *arg )
 {
 	(void)arg;
 
+	// the 15 second budget starts now
+	autoSeqMatchStart();
+
 	// Must call this
 	vexTaskRegister("auton");
 
-	armStart();
-	clawStart();
-	driveStart();
-
 	// // Lock arm in down position
 	// armLockDown();
 
 	// // Lock claw to grab position
 	// clawLockGrab();
 
-	// Give the system half a second to restart the LCD
-	vexSleep( 500 );
-	lcdStart();
-
-	while (1) {
-		switch (lcdGetMode()) {
-			case kLcdMode0:
-				autonomousMode0();
-				break;
-			case kLcdMode1:
-				autonomousMode1();
-				break;
-			case kLcdMode2:
-				autonomousMode2();
-				break;
-			case kLcdMode3:
-				autonomousMode3();
-				break;
-			case kLcdMode4:
-				autonomousMode4();
-				break;
-			case kLcdMode5:
-				autonomousMode5();
-				break;
-			case kLcdMode6:
-				autonomousMode6();
-				break;
-			case kLcdMode7:
-				autonomousMode7();
-				break;
-			case kLcdMode8:
-				autonomousMode8();
-				break;
-			case kLcdMode9:
-				autonomousMode9();
-				break;
-			default:
-				vexSleep(25); // wait 25ms before retry
-				break;
-		}
-		break;
-	}
+	autonomousRun(lcdGetMode());
 
 	armLockCurrent();
 	clawLockCurrent();
@@ -275,6 +253,9 @@ vexAutonomous( void *arg )
 // static bool_t leftPressed = FALSE;
 // static bool_t rightPressed = FALSE;
 
+// loop timing for the operator task
+static vexPeriodic operatorPeriodic;
+
 /*-----------------------------------------------------------------------------*/
 /** @brief      Driver control                                                 */
 /*-----------------------------------------------------------------------------*/
@@ -291,17 +272,16 @@ vexOperator( void *arg )
 	// Must call this
 	vexTaskRegister("operator");
 
-	armStart();
-	clawStart();
-	driveStart();
+	// joysticks are live again if autonomous ended part way through a replay
+	vexReplayStop();
 
-	armLockCurrent();
-	clawLockCurrent();
-	driveLock();
+	// arm, claw and drive were locked to the joysticks by the mode change
 
-	// Give the system half a second to restart the LCD
-	vexSleep( 500 );
-	lcdStart();
+	// the lcd task saves the recording once the robot is disabled
+	if (lcdGetMode() == AUTONOMOUS_REPLAY_MODE) {
+		vexRecordStart();
+		vexRecordSaveRequest();
+	}
 
 	// char buf[100] = "ABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789";
 	// size_t buflen = strnlen(buf, 100);
@@ -317,6 +297,7 @@ vexOperator( void *arg )
 	// int16_t cmd = 0;
 
 	// Run until asked to terminate
+	vexPeriodicInit( &operatorPeriodic, 25 );
 	while (!chThdShouldTerminate()) {
 		// flash led/digi out
 		// vexDigitalPinSet( kVexDigital_1, (blink++ >> 3) & 1);
@@ -394,7 +375,7 @@ vexOperator( void *arg )
 		// vexMotorSet( kVexMotor_10, cmd );
 
 		// Don't hog cpu
-		vexSleep( 25 );
+		vexPeriodicWait( &operatorPeriodic );
 	}
 
 	return (msg_t)0;